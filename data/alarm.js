@@ -5,6 +5,7 @@ var timeout = 3; // Temporizador para control de conexiones
 var savecounter = 0; // Contador de guardados (si aplica)
 var connection; // WebSocket para manejar la conexión
 let fftChartData = []; // Datos del gráfico FFT
+var channelCount = 14; // Canales del perfil; el servidor los manda con channel_count, las páginas traen los del más grande
 
 // Ejecutar lógica solo después de que el DOM esté cargado
 document.addEventListener('DOMContentLoaded', function () {
@@ -82,6 +83,11 @@ function getconnect() {
         }
 
         // Actualizaciones específicas de elementos en el DOM
+        if (partsarry[0] == 'channel_count') {
+            set_channel_count(parseInt(partsarry[1], 10));
+            return;
+        }
+
         if (partsarry[0] == 'get_channel_list') {
             const label = document.getElementById(partsarry[1]);
             if (label) label.textContent = partsarry[2];
@@ -180,6 +186,28 @@ function sendCMD(value) {
         console.warn("No active connection. Command not sent:", value);
     }
 }
+// Quita de la página los canales que el perfil no tiene: opciones de las listas con clase
+// channel_list, casillas del osciloscopio y filas de la tabla de grupos.
+function set_channel_count(count) {
+    channelCount = count;
+
+    document.querySelectorAll('select.channel_list').forEach(select => {
+        for (let i = select.options.length - 1; i >= 0; i--) {
+            if (parseInt(select.options[i].value, 10) >= count) select.remove(i);
+        }
+    });
+
+    for (let i = count; ; i++) {
+        const checkbox = document.getElementById(`channel${i}`);
+        const label = document.getElementById(`channel_${i}_name`);
+        const radio = document.getElementById(`channel${i}_0`);
+        if (!checkbox && !label && !radio) break;
+        if (radio) radio.closest('tr').remove();
+        if (checkbox) checkbox.remove();
+        if (label) label.remove();
+    }
+}
+
 function check_opcode_and_options(id, option) {
     const element = document.getElementById(id);
     const selectElement = document.getElementById(option);
@@ -208,9 +236,10 @@ function check_opcode_and_options(id, option) {
     };
 
     if (['1', '2', '3', '8', 'c', '9', 'b'].includes(value)) {
-        // Copiar opciones del elemento "channel"
+        // Copiar opciones del elemento "channel", los operandos de canales que el perfil no tiene no valen
+        const channelSelect = document.getElementById("channel");
         for (let i = 0; i < 13; i++) {
-            selectElement.options[i].text = document.getElementById("channel").options[i].text;
+            selectElement.options[i].text = (i < channelSelect.options.length) ? channelSelect.options[i].text : "not available";
         }
     } else {
         const options = optionSets[value] || optionSets['default'];
@@ -363,7 +392,7 @@ function refreshOpcodeStr(value) {
 }
 
 window.OScopeProbe = function() {
-    const channelListStr = Array.from({ length: 13 })
+    const channelListStr = Array.from({ length: channelCount })
         .reduce((acc, _, i) => {
             const channelElement = document.getElementById(`channel${i}`);
             return acc + (channelElement && channelElement.checked ? "1" : "0");
@@ -474,9 +503,11 @@ function GotOScope(data) {
         const channelData = parts[5];
         const fftData = parts[6];
         const activeChannels = decodeActiveChannels(parts[7]);
+        // Canales con espectro, en el orden en que vienen en fftData; un servidor viejo no los manda
+        const spectrumChannels = parts[8] ? decodeActiveChannels(parts[8]) : [0, 1, 4, 5, 8, 9];
 
         const oscilloscopeDatasets = prepareOscilloscopeData(activeChannels, numSamples, channelData);
-        const fftDatasets = prepareFFTData(activeChannels, fftSamples, fftData);
+        const fftDatasets = prepareFFTData(activeChannels, spectrumChannels, fftSamples, fftData);
 
         if (updateOscChart) {
             createOrUpdateChart('oscilloscopeChart', oscilloscopeDatasets, numSamples, 'Osciloscopio', 'Amplitud');
@@ -490,8 +521,8 @@ function GotOScope(data) {
 
 
 function decodeActiveChannels(activeChannelsHex) {
-    // Convertir el hexadecimal a binario, rellenando hasta 13 bits
-    const binaryString = parseInt(activeChannelsHex, 16).toString(2).padStart(13, '0');
+    // Convertir el hexadecimal a binario, rellenando hasta un bit por canal; el canal 0 es el más alto
+    const binaryString = parseInt(activeChannelsHex, 16).toString(2).padStart(channelCount, '0');
 
     // Crear un array con los índices de los canales activos (bits '1')
     return binaryString
@@ -537,9 +568,8 @@ datasets.push({
     return datasets;
 }
 
-function prepareFFTData(activeChannels, fftSamples, data) {
+function prepareFFTData(activeChannels, allowedChannels, fftSamples, data) {
     const datasets = [];
-    const allowedChannels = [0, 1, 4, 5, 8, 9]; // Canales permitidos
     const numRealChannels = Math.floor(data.length / (fftSamples * 3)); // Número de canales con datos reales
     const channelOffsets = {}; // Mapeo de offsets fijos por canal
 
@@ -5,6 +5,7 @@
     #if CONFIG_FREERTOS_UNICORE  //corre freertos sólo en el primer núcleo
     
         #define _MEASURE_TASKCORE    1
+        #define _MEASURE_ACQ_TASKCORE 1
         #define _MQTT_TASKCORE       1
         #define _WEBSOCK_TASKCORE    1
         #define _OTA_TASKCORE        1
@@ -13,7 +14,8 @@
 
     #else
     
-        #define _MEASURE_TASKCORE    0
+        #define _MEASURE_TASKCORE    0  // DSP de la medición, solo en su núcleo
+        #define _MEASURE_ACQ_TASKCORE 1 // lectura del I2S, casi siempre bloqueada, con prioridad sobre las tareas de red
         #define _MQTT_TASKCORE       1
         #define _WEBSOCK_TASKCORE    1
         #define _OTA_TASKCORE        1
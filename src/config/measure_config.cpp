@@ -23,6 +23,7 @@
  */ 
 #include "measure_config.h"
 #include "measure.h"
+#include "dsp/adccal.h"
 
 measure_config_t::measure_config_t() : BaseJsonConfig( MEASURE_JSON_CONFIG_FILE ) {}
 
@@ -30,6 +31,21 @@ bool measure_config_t::onSave(JsonDocument& doc) {
 
     doc["samplerate_corr"] = samplerate_corr;
     doc["network_frequency"] = network_frequency;
+    doc["dsp_mode"] = dsp_mode;
+    doc["high_pass_coef"] = high_pass_coef;
+    doc["window_mode"] = window_mode;
+    doc["sample_pll"] = sample_pll;
+    doc["adc_skew_correction"] = adc_skew_correction;
+    doc["adc_calibration"] = adc_calibration;
+    doc["oversampling"] = oversampling;
+    {
+        char points[ ADCCAL_MAX_POINTS * 16 ] = "";
+        doc["adc_calibration_points"] = measure_get_adc_calibration_points_str( sizeof( points ), points );
+    }
+    doc["analysis_period"] = analysis_period;
+    doc["phasor_harmonics"] = phasor_harmonics;
+    doc["iec_harmonics"] = iec_harmonics;
+    doc["iec_max_order"] = iec_max_order;
 
     for( int i = 0 ; i < MAX_GROUPS ; i++ ) {
         doc["group"][ i ]["name"] = measure_get_group_name( i );
@@ -37,7 +53,7 @@ bool measure_config_t::onSave(JsonDocument& doc) {
     }
 
     for( int i = 0 ; i < VIRTUAL_CHANNELS ; i++ ) {
-        char microcode[ VIRTUAL_CHANNELS * 3 ] = "";
+        char microcode[ MEASURE_PROGRAM_MAX * 2 + 1 ] = "";
         doc["channel"][ i ]["name"] = measure_get_channel_name( i );
         doc["channel"][ i ]["type"] = measure_get_channel_type( i );
         doc["channel"][ i ]["true_rms"] = measure_get_channel_true_rms( i );
@@ -45,8 +61,10 @@ bool measure_config_t::onSave(JsonDocument& doc) {
         doc["channel"][ i ]["offset"] = measure_get_channel_offset( i );
         doc["channel"][ i ]["ratio"] = measure_get_channel_ratio( i );
         doc["channel"][ i ]["phaseshift"] = measure_get_channel_phaseshift( i );
+        doc["channel"][ i ]["phase_correction"] = measure_get_channel_phase_correction( i );
         doc["channel"][ i ]["group_id"] = measure_get_channel_group_id( i );
         doc["channel"][ i ]["mircocode"] = measure_get_channel_opcodeseq_str( i, sizeof( microcode ), microcode );
+        doc["channel"][ i ]["harmonics"] = measure_get_channel_harmonics( i );
     }
 
     return true;
@@ -56,6 +74,29 @@ bool measure_config_t::onLoad(JsonDocument& doc) {
 
     samplerate_corr = doc["samplerate_corr"] | 0;
     network_frequency = doc["network_frequency"] | 50;
+    /**
+     * los valores con rango pasan por sus setters, que descartan los que están fuera y dejan el valor por defecto
+     */
+    dsp_mode = MEASURE_DSP_SAMPLE_MAJOR;
+    measure_set_dsp_mode( (measure_dsp_mode_t)( doc["dsp_mode"] | MEASURE_DSP_SAMPLE_MAJOR ) );
+    high_pass_coef = 0.9989;
+    measure_set_high_pass_coef( doc["high_pass_coef"] | 0.9989 );
+    window_mode = MEASURE_WINDOW_1S;
+    measure_set_window_mode( (measure_window_mode_t)( doc["window_mode"] | MEASURE_WINDOW_1S ) );
+    sample_pll = doc["sample_pll"] | false;
+    adc_skew_correction = doc["adc_skew_correction"] | true;
+    /**
+     * la tabla del ADC se arma en measure_init() con los puntos y el origen cargados
+     */
+    measure_set_adc_calibration_points_str( doc["adc_calibration_points"] | "" );
+    adc_calibration = doc["adc_calibration"] | MEASURE_ADC_CAL_NONE;
+    measure_set_oversampling( doc["oversampling"] | 1 );
+    analysis_period = 1000;
+    measure_set_analysis_period( doc["analysis_period"] | 1000 );
+    measure_set_phasor_harmonics( doc["phasor_harmonics"] | MEASURE_PHASOR_DEFAULT );
+    iec_harmonics = doc["iec_harmonics"] | false;
+    iec_max_order = MEASURE_IEC_DEFAULT_ORDER;
+    measure_set_iec_max_order( doc["iec_max_order"] | MEASURE_IEC_DEFAULT_ORDER );
 
     for( int i = 0 ; i < MAX_GROUPS ; i++ ) {
         if( !doc["group"][ i ]["name"] )
@@ -65,6 +106,11 @@ bool measure_config_t::onLoad(JsonDocument& doc) {
     }
 
     for( int i = 0 ; i < VIRTUAL_CHANNELS ; i++ ) {
+        /**
+         * un archivo de un perfil con menos canales deja los que faltan con la configuración por defecto
+         */
+        if( !doc["channel"][ i ]["name"] )
+            continue;
         measure_set_channel_name( i, (char*) doc["channel"][ i ]["name"].as<String>().c_str() );
         measure_set_channel_type( i, doc["channel"][ i ]["type"] | AC_CURRENT );
         measure_set_channel_true_rms( i, doc["channel"][ i ]["true_rms"] | false );
@@ -72,9 +118,15 @@ bool measure_config_t::onLoad(JsonDocument& doc) {
         measure_set_channel_offset( i, doc["channel"][ i ]["offset"] | 0.0 );
         measure_set_channel_ratio( i, doc["channel"][ i ]["ratio"] | 1.0);
         measure_set_channel_phaseshift( i, doc["channel"][ i ]["phaseshift"] | 0 );
+        measure_set_channel_phase_correction( i, doc["channel"][ i ]["phase_correction"] | 0.0 );
         measure_set_channel_group_id( i, doc["channel"][ i ]["group_id"] | 0 );
+        /**
+         * sin armónicas guardadas, los canales de tensión y corriente alterna evalúan las impares hasta la novena
+         */
+        bool ac_channel = measure_get_channel_type( i ) == AC_VOLTAGE || measure_get_channel_type( i ) == AC_CURRENT;
+        measure_set_channel_harmonics( i, doc["channel"][ i ]["harmonics"] | ( ac_channel ? MEASURE_HARMONICS_DEFAULT : 0 ) );
         const char *opcodeseq_str = doc["channel"][ i ]["mircocode"].as<String>().c_str() ;
-        measure_set_channel_opcodeseq_str( i, opcodeseq_str );        
+        measure_set_channel_opcodeseq_str( i, opcodeseq_str, NULL, 0 );        
     }
 
     return true;
@@ -18,6 +18,17 @@
             float network_frequency = 50;
             int samplerate_corr = 0;
             bool true_rms = false;
+            int dsp_mode = 0;               /** @brief motor de procesamiento, ver measure_dsp_mode_t */
+            float high_pass_coef = 0.9989;  /** @brief coeficiente del pasa alto del opcode FILTER */
+            int window_mode = 0;            /** @brief ventana de medición, ver measure_window_mode_t */
+            bool sample_pll = false;        /** @brief ajusta la tasa de muestreo a la frecuencia de red medida */
+            bool adc_skew_correction = true; /** @brief compensa el desfasaje entre canales del barrido del ADC */
+            int adc_calibration = 0;        /** @brief origen de la tabla de corrección del ADC, ver measure_adc_calibration_t */
+            int oversampling = 1;           /** @brief factor de sobremuestreo del ADC: 1, 2 o 4, se aplica al reiniciar */
+            int analysis_period = 1000;     /** @brief período del análisis armónico en ms */
+            uint16_t phasor_harmonics = 0x0001; /** @brief armónicas cuyos fasores se siguen ciclo a ciclo */
+            bool iec_harmonics = false;     /** @brief calcula los grupos de IEC 61000-4-7 en las ventanas de ciclos */
+            int iec_max_order = 40;         /** @brief orden más alto de los grupos de IEC 61000-4-7 */
             
         protected:
             ////////////// Available for overloading: //////////////
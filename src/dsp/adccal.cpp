@@ -0,0 +1,38 @@
+/**
+ * @file adccal.cpp
+ * @brief Tabla de corrección de la alinealidad del ADC
+ */
+#include <math.h>
+#include "adccal.h"
+
+void adccal_identity( uint16_t *lut ) {
+    for( int code = 0 ; code < ADCCAL_CODES ; code++ )
+        lut[ code ] = code << ADCCAL_FRACTION_BITS;
+}
+
+bool adccal_build( uint16_t *lut, const adccal_point_t *point, int count ) {
+    if( count < 2 || count > ADCCAL_MAX_POINTS )
+        return( false );
+
+    for( int i = 1 ; i < count ; i++ ) {
+        if( !( point[ i ].raw > point[ i - 1 ].raw ) )
+            return( false );
+    }
+    /**
+     * segment es el tramo [ point[ segment ], point[ segment + 1 ] ] que contiene a code, o el
+     * primero y el último para los códigos de afuera
+     */
+    int segment = 0;
+    for( int code = 0 ; code < ADCCAL_CODES ; code++ ) {
+        while( segment < count - 2 && code > point[ segment + 1 ].raw )
+            segment++;
+
+        const adccal_point_t *a = &point[ segment ];
+        const adccal_point_t *b = &point[ segment + 1 ];
+        float ideal = a->ideal + ( code - a->raw ) * ( b->ideal - a->ideal ) / ( b->raw - a->raw );
+
+        ideal = roundf( ideal * ( 1 << ADCCAL_FRACTION_BITS ) );
+        lut[ code ] = ideal < 0.0 ? 0 : ideal > ADCCAL_MAX_VALUE ? ADCCAL_MAX_VALUE : (uint16_t)ideal;
+    }
+    return( true );
+}
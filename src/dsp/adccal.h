@@ -0,0 +1,51 @@
+/**
+ * @file adccal.h
+ * @brief Tabla de corrección de la alinealidad del ADC
+ *
+ * El ADC SAR del ESP32 se aparta de una recta cerca de los extremos. La corrección es una tabla
+ * de ADCCAL_CODES entradas indexada con el código crudo, así que al separar las muestras por canal
+ * cuesta una lectura de tabla. La tabla se arma interpolando linealmente entre puntos de
+ * calibración ( código crudo, código ideal ), vengan de la característica grabada en los eFuse o
+ * de un barrido con una tensión conocida. Las entradas llevan ADCCAL_FRACTION_BITS bits
+ * fraccionarios, así la corrección no agrega escalones de un código ni pierde la resolución
+ * que gana el sobremuestreo.
+ */
+#ifndef _ADCCAL_H
+    #define _ADCCAL_H
+
+    #include <stdint.h>
+
+    #define ADCCAL_CODES        4096        /** @brief códigos del ADC de 12 bits */
+    #define ADCCAL_MAX_POINTS   33          /** @brief puntos de calibración como máximo */
+    #define ADCCAL_FRACTION_BITS 4          /** @brief bits fraccionarios de la tabla: un código vale 16 */
+    #define ADCCAL_MAX_VALUE    ( ( ADCCAL_CODES << ADCCAL_FRACTION_BITS ) - 1 )   /** @brief valor más alto de la tabla */
+
+    /**
+     * @brief punto de calibración
+     */
+    typedef struct {
+        float raw;                          /** @brief código que entrega el ADC */
+        float ideal;                        /** @brief código que entregaría un ADC lineal */
+    } adccal_point_t;
+
+    /**
+     * @brief arma la tabla identidad, sin corrección: cada código por 16
+     *
+     * @param lut       destino, ADCCAL_CODES entradas
+     */
+    void adccal_identity( uint16_t *lut );
+    /**
+     * @brief arma la tabla con los puntos de calibración
+     *
+     * Entre dos puntos se interpola linealmente y fuera de los extremos se prolongan el primer y el
+     * último tramo; el resultado se limita a 0 .. ADCCAL_MAX_VALUE.
+     *
+     * @param lut       destino, ADCCAL_CODES entradas
+     * @param point     puntos ordenados por raw creciente, sin repetir
+     * @param count     cantidad de puntos, 2 .. ADCCAL_MAX_POINTS
+     * @return true     tabla armada
+     * @return false    puntos inválidos, lut queda sin tocar
+     */
+    bool adccal_build( uint16_t *lut, const adccal_point_t *point, int count );
+
+#endif // _ADCCAL_H
@@ -0,0 +1,81 @@
+/**
+ * @file decimator.cpp
+ * @brief Diezmado polifásico del ADC sobremuestreado
+ */
+#include <math.h>
+#include <string.h>
+#include "decimator.h"
+
+/**
+ * @brief función de Bessel modificada de orden 0, por su serie
+ */
+static double decimator_i0( double x ) {
+    double sum = 1.0, term = 1.0;
+
+    for( int k = 1 ; term > 1e-12 * sum ; k++ ) {
+        term *= ( x / ( 2.0 * k ) ) * ( x / ( 2.0 * k ) );
+        sum += term;
+    }
+    return( sum );
+}
+
+void decimator_design( decimator_design_t *d, int factor ) {
+    double coef[ DECIMATOR_MAX_TAPS ];
+    double sum = 0.0;
+    int total = 0;
+
+    if( factor < 2 )
+        factor = 2;
+    if( factor > DECIMATOR_MAX_FACTOR )
+        factor = DECIMATOR_MAX_FACTOR;
+    d->factor = factor;
+    d->taps = factor * DECIMATOR_TAPS_PER_PHASE;
+    /**
+     * sinc con corte en la mitad de la tasa de salida, centrado entre las muestras taps / 2 - 1 y taps / 2
+     */
+    for( int k = 0 ; k < d->taps ; k++ ) {
+        double t = k - ( d->taps - 1 ) / 2.0;
+        double r = 2.0 * t / ( d->taps - 1 );
+        double sinc = ( M_PI * t / factor );
+
+        sinc = sin( sinc ) / sinc;
+        coef[ k ] = sinc * decimator_i0( DECIMATOR_BETA * sqrt( 1.0 - r * r ) ) / decimator_i0( DECIMATOR_BETA );
+        sum += coef[ k ];
+    }
+    /**
+     * redondeo a Q14 y el resto de la suma al centro, así la continua pasa sin error
+     */
+    for( int k = 0 ; k < d->taps ; k++ ) {
+        d->coef[ k ] = lround( coef[ k ] / sum * ( 1 << DECIMATOR_COEF_BITS ) );
+        total += d->coef[ k ];
+    }
+    d->coef[ d->taps / 2 ] += ( 1 << DECIMATOR_COEF_BITS ) - total;
+}
+
+void decimator_reset( decimator_t *s ) {
+    memset( s, 0, sizeof( decimator_t ) );
+}
+
+bool decimator_push( decimator_t *s, const decimator_design_t *d, uint16_t x, uint16_t *y ) {
+    int16_t value = (int32_t)x - DECIMATOR_MIDSCALE;
+
+    s->history[ s->pos ] = value;
+    s->history[ s->pos + d->taps ] = value;
+    if( ++s->pos == d->taps )
+        s->pos = 0;
+    if( ++s->phase < d->factor )
+        return( false );
+    s->phase = 0;
+    /**
+     * history[ pos .. pos + taps - 1 ] va de la muestra más vieja a la última; con
+     * |muestra| <= 32768 y la suma de |coef| cerca de 1,1 en Q14 el acumulador no pasa de 2^30
+     */
+    const int16_t *h = &s->history[ s->pos ];
+    int32_t acc = 1 << ( DECIMATOR_COEF_BITS - 1 );
+
+    for( int k = 0 ; k < d->taps ; k++ )
+        acc += h[ k ] * d->coef[ k ];
+    acc = ( acc >> DECIMATOR_COEF_BITS ) + DECIMATOR_MIDSCALE;
+    *y = acc < 0 ? 0 : acc > 65535 ? 65535 : acc;
+    return( true );
+}
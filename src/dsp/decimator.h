@@ -0,0 +1,68 @@
+/**
+ * @file decimator.h
+ * @brief Diezmado polifásico del ADC sobremuestreado
+ *
+ * Con sobremuestreo el ADC convierte factor veces más rápido y cada canal pasa por un FIR pasa
+ * bajos con corte en la mitad de la tasa de salida que sólo se evalúa en las muestras que quedan,
+ * una de cada factor: cada salida combina DECIMATOR_TAPS_PER_PHASE muestras de cada fase. El FIR
+ * quita lo que se plegaría sobre la banda de las armónicas y promedia el ruido, que baja
+ * sqrt( factor ) veces. Los coeficientes son Q14 calculados una vez con una ventana de Kaiser;
+ * la historia guarda las muestras en 16 bits sin la mitad de la escala y duplicada, así los
+ * coeficientes se recorren sin dar la vuelta. Con 6400 muestras por segundo a la salida la
+ * respuesta cae 0,06 dB en 2,5 kHz y atenúa más de 60 dB desde 4 kHz, que se plegaría en 2,4 kHz.
+ */
+#ifndef _DECIMATOR_H
+    #define _DECIMATOR_H
+
+    #include <stdint.h>
+
+    #define DECIMATOR_MAX_FACTOR        4       /** @brief factor de diezmado más alto */
+    #define DECIMATOR_TAPS_PER_PHASE    16      /** @brief coeficientes de cada fase */
+    #define DECIMATOR_MAX_TAPS          ( DECIMATOR_MAX_FACTOR * DECIMATOR_TAPS_PER_PHASE )
+    #define DECIMATOR_COEF_BITS         14      /** @brief bits fraccionarios de los coeficientes */
+    #define DECIMATOR_BETA              6.0     /** @brief parámetro de la ventana de Kaiser */
+    #define DECIMATOR_MIDSCALE          32768   /** @brief mitad de la escala de las muestras de 16 bits */
+
+    /**
+     * @brief coeficientes de un factor de diezmado, compartidos por todos los canales
+     */
+    typedef struct {
+        int factor;                                 /** @brief muestras de entrada por muestra de salida */
+        int taps;                                   /** @brief factor * DECIMATOR_TAPS_PER_PHASE */
+        int16_t coef[ DECIMATOR_MAX_TAPS ];         /** @brief coef[ k ] multiplica a la muestra k desde la más vieja */
+    } decimator_design_t;
+    /**
+     * @brief estado de un canal
+     */
+    typedef struct {
+        int16_t history[ 2 * DECIMATOR_MAX_TAPS ];  /** @brief muestras menos DECIMATOR_MIDSCALE, escritas en pos y pos + taps */
+        int pos;                                    /** @brief próxima posición a escribir */
+        int phase;                                  /** @brief muestras de entrada desde la última salida */
+    } decimator_t;
+
+    /**
+     * @brief calcula los coeficientes de un factor, con ganancia exacta 1 en continua
+     *
+     * @param d         destino
+     * @param factor    2 .. DECIMATOR_MAX_FACTOR, con factor 1 no se diezma
+     */
+    void decimator_design( decimator_design_t *d, int factor );
+    /**
+     * @brief vacía la historia de un canal
+     *
+     * @param s         estado del canal
+     */
+    void decimator_reset( decimator_t *s );
+    /**
+     * @brief agrega una muestra de entrada
+     *
+     * @param s         estado del canal
+     * @param d         coeficientes
+     * @param x         muestra de 16 bits sin signo
+     * @param y         destino de la salida
+     * @return true     hay una salida nueva en y
+     * @return false    faltan muestras de entrada
+     */
+    bool decimator_push( decimator_t *s, const decimator_design_t *d, uint16_t x, uint16_t *y );
+
+#endif // _DECIMATOR_H
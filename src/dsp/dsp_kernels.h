@@ -0,0 +1,111 @@
+/**
+ * @file dsp_kernels.h
+ * @brief Núcleos vectoriales sobre arreglos float para el motor de bloques de measure.cpp
+ *
+ * Si el proyecto se compila con ESP-DSP disponible se usan sus rutinas optimizadas para el
+ * ESP32, si no (por ejemplo en el host) se usan bucles simples con la misma semántica.
+ * Todas las funciones admiten que la salida sea el mismo arreglo que la entrada.
+ */
+#ifndef _DSP_KERNELS_H
+    #define _DSP_KERNELS_H
+
+    #include <math.h>
+
+    #if defined( __has_include )
+        #if __has_include( <dsps_add.h> ) && __has_include( <dsps_sub.h> ) && __has_include( <dsps_mul.h> ) && __has_include( <dsps_mulc.h> )
+            #include <dsps_add.h>
+            #include <dsps_sub.h>
+            #include <dsps_mul.h>
+            #include <dsps_mulc.h>
+            #define DSP_KERNELS_USE_ESP_DSP
+        #endif
+    #endif
+
+    /**
+     * @brief out[n] = a[n] + b[n]
+     */
+    static inline void dsp_add_f32( const float *a, const float *b, float *out, int len ) {
+    #ifdef DSP_KERNELS_USE_ESP_DSP
+        dsps_add_f32( a, b, out, len, 1, 1, 1 );
+    #else
+        for( int n = 0 ; n < len ; n++ )
+            out[ n ] = a[ n ] + b[ n ];
+    #endif
+    }
+    /**
+     * @brief out[n] = a[n] - b[n]
+     */
+    static inline void dsp_sub_f32( const float *a, const float *b, float *out, int len ) {
+    #ifdef DSP_KERNELS_USE_ESP_DSP
+        dsps_sub_f32( a, b, out, len, 1, 1, 1 );
+    #else
+        for( int n = 0 ; n < len ; n++ )
+            out[ n ] = a[ n ] - b[ n ];
+    #endif
+    }
+    /**
+     * @brief out[n] = a[n] * b[n]
+     */
+    static inline void dsp_mul_f32( const float *a, const float *b, float *out, int len ) {
+    #ifdef DSP_KERNELS_USE_ESP_DSP
+        dsps_mul_f32( a, b, out, len, 1, 1, 1 );
+    #else
+        for( int n = 0 ; n < len ; n++ )
+            out[ n ] = a[ n ] * b[ n ];
+    #endif
+    }
+    /**
+     * @brief out[n] = a[n] * c
+     */
+    static inline void dsp_mulc_f32( const float *a, float *out, int len, float c ) {
+    #ifdef DSP_KERNELS_USE_ESP_DSP
+        dsps_mulc_f32( a, out, len, c, 1, 1 );
+    #else
+        for( int n = 0 ; n < len ; n++ )
+            out[ n ] = a[ n ] * c;
+    #endif
+    }
+    /**
+     * @brief out[n] = c
+     */
+    static inline void dsp_fill_f32( float *out, int len, float c ) {
+        for( int n = 0 ; n < len ; n++ )
+            out[ n ] = c;
+    }
+    /**
+     * @brief out[n] = |a[n]|
+     */
+    static inline void dsp_abs_f32( const float *a, float *out, int len ) {
+        for( int n = 0 ; n < len ; n++ )
+            out[ n ] = fabsf( a[ n ] );
+    }
+    /**
+     * @brief out[n] = -a[n]
+     */
+    static inline void dsp_neg_f32( const float *a, float *out, int len ) {
+        for( int n = 0 ; n < len ; n++ )
+            out[ n ] = -a[ n ];
+    }
+    /**
+     * @brief out[n] = a[n] si a[n] <= 0, si no 0
+     */
+    static inline void dsp_clamp_max_zero_f32( const float *a, float *out, int len ) {
+        for( int n = 0 ; n < len ; n++ )
+            out[ n ] = ( a[ n ] > 0.0f ) ? 0.0f : a[ n ];
+    }
+    /**
+     * @brief out[n] = a[n] si a[n] >= 0, si no 0
+     */
+    static inline void dsp_clamp_min_zero_f32( const float *a, float *out, int len ) {
+        for( int n = 0 ; n < len ; n++ )
+            out[ n ] = ( a[ n ] < 0.0f ) ? 0.0f : a[ n ];
+    }
+    /**
+     * @brief out[n] = a[n] * signo( b[n] ), con signo( 0 ) = -1
+     */
+    static inline void dsp_mulsign_f32( const float *a, const float *b, float *out, int len ) {
+        for( int n = 0 ; n < len ; n++ )
+            out[ n ] = ( b[ n ] > 0.0f ) ? a[ n ] : -a[ n ];
+    }
+
+#endif // _DSP_KERNELS_H
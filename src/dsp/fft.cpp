@@ -0,0 +1,113 @@
+/**
+ * @file fft.cpp
+ * @brief FFT real de 4 a FFT_MAX_LEN puntos en simple precisión, con tablas en flash
+ */
+#include <math.h>
+#include "fft.h"
+#include "fft_tables.h"
+
+static_assert( FFT_TABLES_LEN == FFT_MAX_LEN, "fft_tables.h no coincide con FFT_MAX_LEN, regenerar con tools/gen_fft_tables.py" );
+
+/**
+ * @brief log2 de una potencia de 2
+ */
+static int fft_log2( int len ) {
+    int bits = 0;
+
+    while( ( 1 << bits ) < len )
+        bits++;
+    return( bits );
+}
+
+/**
+ * @brief FFT compleja in place de half puntos, partes real e imaginaria intercaladas
+ *
+ * @param z         half valores complejos
+ * @param half      puntos, la mitad de la FFT real
+ */
+static void fft_complex( float *z, int half ) {
+    int shift = fft_log2( FFT_MAX_LEN / 2 ) - fft_log2( half );
+
+    for( int i = 0 ; i < half ; i++ ) {
+        int j = fft_bitrev[ i ] >> shift;
+        if( j > i ) {
+            float t = z[ 2 * i ]; z[ 2 * i ] = z[ 2 * j ]; z[ 2 * j ] = t;
+            t = z[ 2 * i + 1 ]; z[ 2 * i + 1 ] = z[ 2 * j + 1 ]; z[ 2 * j + 1 ] = t;
+        }
+    }
+
+    for( int len = 2 ; len <= half ; len <<= 1 ) {
+        int span = len / 2;
+        int step = FFT_MAX_LEN / len;
+
+        for( int j = 0 ; j < span ; j++ ) {
+            float wr = fft_twiddle[ 2 * j * step ];
+            float wi = fft_twiddle[ 2 * j * step + 1 ];
+
+            for( int a = j ; a < half ; a += len ) {
+                int b = a + span;
+                float tr = wr * z[ 2 * b ] - wi * z[ 2 * b + 1 ];
+                float ti = wr * z[ 2 * b + 1 ] + wi * z[ 2 * b ];
+
+                z[ 2 * b ] = z[ 2 * a ] - tr;
+                z[ 2 * b + 1 ] = z[ 2 * a + 1 ] - ti;
+                z[ 2 * a ] += tr;
+                z[ 2 * a + 1 ] += ti;
+            }
+        }
+    }
+}
+
+void fft_real( float *x, int len ) {
+    int half = len / 2;
+    int step = FFT_MAX_LEN / len;
+    /**
+     * z[ m ] = x[ 2m ] + i x[ 2m + 1 ] ya está así en memoria
+     */
+    fft_complex( x, half );
+
+    float z0r = x[ 0 ], z0i = x[ 1 ];
+    x[ 0 ] = z0r + z0i;
+    x[ 1 ] = z0r - z0i;
+    /**
+     * X[ k ] = E[ k ] + w^k O[ k ] con E = ( Z[ k ] + Z*[ M - k ] ) / 2, O = ( Z[ k ] - Z*[ M - k ] ) / 2i
+     * y X[ M - k ] = ( E[ k ] - w^k O[ k ] )*
+     */
+    for( int k = 1 ; k <= half / 2 ; k++ ) {
+        int m = half - k;
+        float ar = x[ 2 * k ], ai = x[ 2 * k + 1 ];
+        float br = x[ 2 * m ], bi = -x[ 2 * m + 1 ];
+        float er = 0.5 * ( ar + br ), ei = 0.5 * ( ai + bi );
+        float or_ = 0.5 * ( ai - bi ), oi = -0.5 * ( ar - br );
+        float wr = fft_twiddle[ 2 * k * step ], wi = fft_twiddle[ 2 * k * step + 1 ];
+        float tr = wr * or_ - wi * oi;
+        float ti = wr * oi + wi * or_;
+
+        x[ 2 * k ] = er + tr;
+        x[ 2 * k + 1 ] = ei + ti;
+        x[ 2 * m ] = er - tr;
+        x[ 2 * m + 1 ] = ti - ei;
+    }
+}
+
+void fft_window( float *x, int len, fft_window_t window ) {
+    if( window >= FFT_WINDOW_END )
+        return;
+
+    const float *w = fft_window_table[ window ];
+    int step = FFT_MAX_LEN / len;
+
+    x[ 0 ] *= w[ 0 ];
+    x[ len / 2 ] *= w[ FFT_MAX_LEN / 2 ];
+    for( int n = 1 ; n < len / 2 ; n++ ) {
+        x[ n ] *= w[ n * step ];
+        x[ len - n ] *= w[ n * step ];
+    }
+}
+
+void fft_magnitude( const float *x, int len, uint16_t *out, int bins, float scale ) {
+    for( int k = 0 ; k < bins && k <= len / 2 ; k++ ) {
+        float magnitude = sqrtf( fft_power( x, len, k ) ) * scale;
+        out[ k ] = ( magnitude >= 65535.0 ) ? 65535 : magnitude;
+    }
+}
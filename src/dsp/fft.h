@@ -0,0 +1,71 @@
+/**
+ * @file fft.h
+ * @brief FFT real de 4 a FFT_MAX_LEN puntos en simple precisión, con tablas en flash
+ *
+ * La FFT real de N puntos se hace con una FFT compleja de N/2 puntos (radix 2, in place) sobre las
+ * muestras pares e impares empaquetadas, y un paso final que separa los dos espectros. Los factores
+ * de giro, la inversión de bits y las ventanas están tabulados para FFT_MAX_LEN puntos en
+ * fft_tables.h (tools/gen_fft_tables.py) y las longitudes menores los recorren con paso
+ * FFT_MAX_LEN / N, así la transformada no llama a sin() ni cos() ni usa RAM para las tablas.
+ */
+#ifndef _FFT_H
+    #define _FFT_H
+
+    #include <stdint.h>
+
+    #define FFT_MAX_LEN     2048            /** @brief puntos de la FFT real más larga */
+
+    /**
+     * @brief ventanas tabuladas, normalizadas a ganancia coherente 1
+     */
+    typedef enum {
+        FFT_WINDOW_HANN = 0,                /** @brief Hann, para armónicas sin sincronizar */
+        FFT_WINDOW_HAMMING,                 /** @brief Hamming */
+        FFT_WINDOW_FLATTOP,                 /** @brief flat-top, para amplitudes entre bins */
+        FFT_WINDOW_END
+    } fft_window_t;
+
+    /**
+     * @brief FFT real in place
+     *
+     * El resultado queda empaquetado: x[ 0 ] = X[ 0 ], x[ 1 ] = X[ N/2 ] (los dos son reales) y
+     * x[ 2k ], x[ 2k + 1 ] son la parte real e imaginaria de X[ k ] para k = 1 .. N/2 - 1.
+     *
+     * @param x         len muestras, se reemplazan por el espectro
+     * @param len       potencia de 2 entre 4 y FFT_MAX_LEN
+     */
+    void fft_real( float *x, int len );
+    /**
+     * @brief multiplica len muestras por una ventana
+     *
+     * @param x         muestras
+     * @param len       potencia de 2 entre 4 y FFT_MAX_LEN
+     * @param window    ventana
+     */
+    void fft_window( float *x, int len, fft_window_t window );
+    /**
+     * @brief |X[ k ]| * scale de los primeros bins de un espectro empaquetado, saturado a 16 bits
+     *
+     * @param x         espectro de fft_real()
+     * @param len       puntos de la FFT
+     * @param out       destino de bins magnitudes, out[ k ] para el bin k
+     * @param bins      bins a escribir, hasta len / 2 + 1
+     * @param scale     factor de escala, 1 / len da la amplitud de una FFT normalizada
+     */
+    void fft_magnitude( const float *x, int len, uint16_t *out, int bins, float scale );
+    /**
+     * @brief |X[ k ]|^2 de un espectro empaquetado por fft_real()
+     *
+     * @param x         espectro
+     * @param len       puntos de la FFT
+     * @param k         bin, 0 .. len / 2
+     */
+    static inline float fft_power( const float *x, int len, int k ) {
+        if( k == 0 )
+            return( x[ 0 ] * x[ 0 ] );
+        if( k == len / 2 )
+            return( x[ 1 ] * x[ 1 ] );
+        return( x[ 2 * k ] * x[ 2 * k ] + x[ 2 * k + 1 ] * x[ 2 * k + 1 ] );
+    }
+
+#endif // _FFT_H
@@ -0,0 +1,744 @@
+/**
+ * @file fft_tables.h
+ * @brief Tablas de la FFT real, generadas por tools/gen_fft_tables.py: no editar
+ */
+#ifndef _FFT_TABLES_H
+    #define _FFT_TABLES_H
+
+    #define FFT_TABLES_LEN  2048
+
+/**
+ * @brief e^( -2 pi i k / FFT_TABLES_LEN ), k < FFT_TABLES_LEN / 2, parte real e imaginaria intercaladas
+ */
+static const float fft_twiddle[ 2048 ] = {
+    1.0f, -0.0f, 0.999995294f, -0.00306795676f, 0.999981175f, -0.00613588465f, 0.999957645f, -0.00920375478f,
+    0.999924702f, -0.0122715383f, 0.999882347f, -0.0153392063f, 0.999830582f, -0.0184067299f, 0.999769405f, -0.0214740803f,
+    0.999698819f, -0.0245412285f, 0.999618822f, -0.0276081458f, 0.999529418f, -0.0306748032f, 0.999430605f, -0.0337411719f,
+    0.999322385f, -0.0368072229f, 0.999204759f, -0.0398729276f, 0.999077728f, -0.0429382569f, 0.998941293f, -0.0460031821f,
+    0.998795456f, -0.0490676743f, 0.998640218f, -0.0521317047f, 0.998475581f, -0.0551952443f, 0.998301545f, -0.0582582645f,
+    0.998118113f, -0.0613207363f, 0.997925286f, -0.0643826309f, 0.997723067f, -0.0674439196f, 0.997511456f, -0.0705045734f,
+    0.997290457f, -0.0735645636f, 0.99706007f, -0.0766238614f, 0.996820299f, -0.079682438f, 0.996571146f, -0.0827402645f,
+    0.996312612f, -0.0857973123f, 0.996044701f, -0.0888535526f, 0.995767414f, -0.0919089565f, 0.995480755f, -0.0949634953f,
+    0.995184727f, -0.0980171403f, 0.994879331f, -0.101069863f, 0.994564571f, -0.104121634f, 0.994240449f, -0.107172425f,
+    0.99390697f, -0.110222207f, 0.993564136f, -0.113270952f, 0.993211949f, -0.116318631f, 0.992850414f, -0.119365215f,
+    0.992479535f, -0.122410675f, 0.992099313f, -0.125454983f, 0.991709754f, -0.128498111f, 0.99131086f, -0.131540029f,
+    0.990902635f, -0.134580709f, 0.990485084f, -0.137620122f, 0.99005821f, -0.140658239f, 0.989622017f, -0.143695033f,
+    0.98917651f, -0.146730474f, 0.988721692f, -0.149764535f, 0.988257568f, -0.152797185f, 0.987784142f, -0.155828398f,
+    0.987301418f, -0.158858143f, 0.986809402f, -0.161886394f, 0.986308097f, -0.16491312f, 0.985797509f, -0.167938295f,
+    0.985277642f, -0.170961889f, 0.984748502f, -0.173983873f, 0.984210092f, -0.17700422f, 0.983662419f, -0.180022901f,
+    0.983105487f, -0.183039888f, 0.982539302f, -0.186055152f, 0.981963869f, -0.189068664f, 0.981379193f, -0.192080397f,
+    0.98078528f, -0.195090322f, 0.980182136f, -0.198098411f, 0.979569766f, -0.201104635f, 0.978948175f, -0.204108966f,
+    0.978317371f, -0.207111376f, 0.977677358f, -0.210111837f, 0.977028143f, -0.21311032f, 0.976369731f, -0.216106797f,
+    0.97570213f, -0.21910124f, 0.975025345f, -0.222093621f, 0.974339383f, -0.225083911f, 0.97364425f, -0.228072083f,
+    0.972939952f, -0.231058108f, 0.972226497f, -0.234041959f, 0.971503891f, -0.237023606f, 0.970772141f, -0.240003022f,
+    0.970031253f, -0.24298018f, 0.969281235f, -0.24595505f, 0.968522094f, -0.248927606f, 0.967753837f, -0.251897818f,
+    0.966976471f, -0.25486566f, 0.966190003f, -0.257831102f, 0.965394442f, -0.260794118f, 0.964589793f, -0.263754679f,
+    0.963776066f, -0.266712757f, 0.962953267f, -0.269668326f, 0.962121404f, -0.272621355f, 0.961280486f, -0.275571819f,
+    0.960430519f, -0.278519689f, 0.959571513f, -0.281464938f, 0.958703475f, -0.284407537f, 0.957826413f, -0.28734746f,
+    0.956940336f, -0.290284677f, 0.956045251f, -0.293219163f, 0.955141168f, -0.296150888f, 0.954228095f, -0.299079826f,
+    0.95330604f, -0.302005949f, 0.952375013f, -0.30492923f, 0.951435021f, -0.30784964f, 0.950486074f, -0.310767153f,
+    0.949528181f, -0.31368174f, 0.94856135f, -0.316593376f, 0.947585591f, -0.319502031f, 0.946600913f, -0.322407679f,
+    0.945607325f, -0.325310292f, 0.944604837f, -0.328209844f, 0.943593458f, -0.331106306f, 0.942573198f, -0.333999651f,
+    0.941544065f, -0.336889853f, 0.940506071f, -0.339776884f, 0.939459224f, -0.342660717f, 0.938403534f, -0.345541325f,
+    0.937339012f, -0.34841868f, 0.936265667f, -0.351292756f, 0.93518351f, -0.354163525f, 0.93409255f, -0.357030961f,
+    0.932992799f, -0.359895037f, 0.931884266f, -0.362755724f, 0.930766961f, -0.365612998f, 0.929640896f, -0.36846683f,
+    0.92850608f, -0.371317194f, 0.927362526f, -0.374164063f, 0.926210242f, -0.37700741f, 0.925049241f, -0.379847209f,
+    0.923879533f, -0.382683432f, 0.922701128f, -0.385516054f, 0.921514039f, -0.388345047f, 0.920318277f, -0.391170384f,
+    0.919113852f, -0.39399204f, 0.917900776f, -0.396809987f, 0.91667906f, -0.3996242f, 0.915448716f, -0.402434651f,
+    0.914209756f, -0.405241314f, 0.91296219f, -0.408044163f, 0.911706032f, -0.410843171f, 0.910441292f, -0.413638312f,
+    0.909167983f, -0.41642956f, 0.907886116f, -0.419216888f, 0.906595705f, -0.422000271f, 0.905296759f, -0.424779681f,
+    0.903989293f, -0.427555093f, 0.902673318f, -0.430326481f, 0.901348847f, -0.433093819f, 0.900015892f, -0.43585708f,
+    0.898674466f, -0.438616239f, 0.897324581f, -0.441371269f, 0.89596625f, -0.444122145f, 0.894599486f, -0.44686884f,
+    0.893224301f, -0.44961133f, 0.891840709f, -0.452349587f, 0.890448723f, -0.455083587f, 0.889048356f, -0.457813304f,
+    0.88763962f, -0.460538711f, 0.88622253f, -0.463259784f, 0.884797098f, -0.465976496f, 0.883363339f, -0.468688822f,
+    0.881921264f, -0.471396737f, 0.880470889f, -0.474100215f, 0.879012226f, -0.47679923f, 0.87754529f, -0.479493758f,
+    0.876070094f, -0.482183772f, 0.874586652f, -0.484869248f, 0.873094978f, -0.48755016f, 0.871595087f, -0.490226483f,
+    0.870086991f, -0.492898192f, 0.868570706f, -0.495565262f, 0.867046246f, -0.498227667f, 0.865513624f, -0.500885383f,
+    0.863972856f, -0.503538384f, 0.862423956f, -0.506186645f, 0.860866939f, -0.508830143f, 0.859301818f, -0.51146885f,
+    0.85772861f, -0.514102744f, 0.856147328f, -0.516731799f, 0.854557988f, -0.51935599f, 0.852960605f, -0.521975293f,
+    0.851355193f, -0.524589683f, 0.849741768f, -0.527199135f, 0.848120345f, -0.529803625f, 0.846490939f, -0.532403128f,
+    0.844853565f, -0.53499762f, 0.84320824f, -0.537587076f, 0.841554977f, -0.540171473f, 0.839893794f, -0.542750785f,
+    0.838224706f, -0.545324988f, 0.836547727f, -0.547894059f, 0.834862875f, -0.550457973f, 0.833170165f, -0.553016706f,
+    0.831469612f, -0.555570233f, 0.829761234f, -0.558118531f, 0.828045045f, -0.560661576f, 0.826321063f, -0.563199344f,
+    0.824589303f, -0.565731811f, 0.822849781f, -0.568258953f, 0.821102515f, -0.570780746f, 0.81934752f, -0.573297167f,
+    0.817584813f, -0.575808191f, 0.815814411f, -0.578313796f, 0.81403633f, -0.580813958f, 0.812250587f, -0.583308653f,
+    0.810457198f, -0.585797857f, 0.808656182f, -0.588281548f, 0.806847554f, -0.590759702f, 0.805031331f, -0.593232295f,
+    0.803207531f, -0.595699304f, 0.801376172f, -0.598160707f, 0.799537269f, -0.600616479f, 0.797690841f, -0.603066599f,
+    0.795836905f, -0.605511041f, 0.793975478f, -0.607949785f, 0.792106577f, -0.610382806f, 0.790230221f, -0.612810082f,
+    0.788346428f, -0.615231591f, 0.786455214f, -0.617647308f, 0.784556597f, -0.620057212f, 0.782650596f, -0.622461279f,
+    0.780737229f, -0.624859488f, 0.778816512f, -0.627251815f, 0.776888466f, -0.629638239f, 0.774953107f, -0.632018736f,
+    0.773010453f, -0.634393284f, 0.771060524f, -0.636761861f, 0.769103338f, -0.639124445f, 0.767138912f, -0.641481013f,
+    0.765167266f, -0.643831543f, 0.763188417f, -0.646176013f, 0.761202385f, -0.648514401f, 0.759209189f, -0.650846685f,
+    0.757208847f, -0.653172843f, 0.755201377f, -0.655492853f, 0.753186799f, -0.657806693f, 0.751165132f, -0.660114342f,
+    0.749136395f, -0.662415778f, 0.747100606f, -0.664710978f, 0.745057785f, -0.666999922f, 0.743007952f, -0.669282588f,
+    0.740951125f, -0.671558955f, 0.738887324f, -0.673829f, 0.736816569f, -0.676092704f, 0.734738878f, -0.678350043f,
+    0.732654272f, -0.680600998f, 0.730562769f, -0.682845546f, 0.72846439f, -0.685083668f, 0.726359155f, -0.687315341f,
+    0.724247083f, -0.689540545f, 0.722128194f, -0.691759258f, 0.720002508f, -0.693971461f, 0.717870045f, -0.696177131f,
+    0.715730825f, -0.698376249f, 0.713584869f, -0.700568794f, 0.711432196f, -0.702754744f, 0.709272826f, -0.70493408f,
+    0.707106781f, -0.707106781f, 0.70493408f, -0.709272826f, 0.702754744f, -0.711432196f, 0.700568794f, -0.713584869f,
+    0.698376249f, -0.715730825f, 0.696177131f, -0.717870045f, 0.693971461f, -0.720002508f, 0.691759258f, -0.722128194f,
+    0.689540545f, -0.724247083f, 0.687315341f, -0.726359155f, 0.685083668f, -0.72846439f, 0.682845546f, -0.730562769f,
+    0.680600998f, -0.732654272f, 0.678350043f, -0.734738878f, 0.676092704f, -0.736816569f, 0.673829f, -0.738887324f,
+    0.671558955f, -0.740951125f, 0.669282588f, -0.743007952f, 0.666999922f, -0.745057785f, 0.664710978f, -0.747100606f,
+    0.662415778f, -0.749136395f, 0.660114342f, -0.751165132f, 0.657806693f, -0.753186799f, 0.655492853f, -0.755201377f,
+    0.653172843f, -0.757208847f, 0.650846685f, -0.759209189f, 0.648514401f, -0.761202385f, 0.646176013f, -0.763188417f,
+    0.643831543f, -0.765167266f, 0.641481013f, -0.767138912f, 0.639124445f, -0.769103338f, 0.636761861f, -0.771060524f,
+    0.634393284f, -0.773010453f, 0.632018736f, -0.774953107f, 0.629638239f, -0.776888466f, 0.627251815f, -0.778816512f,
+    0.624859488f, -0.780737229f, 0.622461279f, -0.782650596f, 0.620057212f, -0.784556597f, 0.617647308f, -0.786455214f,
+    0.615231591f, -0.788346428f, 0.612810082f, -0.790230221f, 0.610382806f, -0.792106577f, 0.607949785f, -0.793975478f,
+    0.605511041f, -0.795836905f, 0.603066599f, -0.797690841f, 0.600616479f, -0.799537269f, 0.598160707f, -0.801376172f,
+    0.595699304f, -0.803207531f, 0.593232295f, -0.805031331f, 0.590759702f, -0.806847554f, 0.588281548f, -0.808656182f,
+    0.585797857f, -0.810457198f, 0.583308653f, -0.812250587f, 0.580813958f, -0.81403633f, 0.578313796f, -0.815814411f,
+    0.575808191f, -0.817584813f, 0.573297167f, -0.81934752f, 0.570780746f, -0.821102515f, 0.568258953f, -0.822849781f,
+    0.565731811f, -0.824589303f, 0.563199344f, -0.826321063f, 0.560661576f, -0.828045045f, 0.558118531f, -0.829761234f,
+    0.555570233f, -0.831469612f, 0.553016706f, -0.833170165f, 0.550457973f, -0.834862875f, 0.547894059f, -0.836547727f,
+    0.545324988f, -0.838224706f, 0.542750785f, -0.839893794f, 0.540171473f, -0.841554977f, 0.537587076f, -0.84320824f,
+    0.53499762f, -0.844853565f, 0.532403128f, -0.846490939f, 0.529803625f, -0.848120345f, 0.527199135f, -0.849741768f,
+    0.524589683f, -0.851355193f, 0.521975293f, -0.852960605f, 0.51935599f, -0.854557988f, 0.516731799f, -0.856147328f,
+    0.514102744f, -0.85772861f, 0.51146885f, -0.859301818f, 0.508830143f, -0.860866939f, 0.506186645f, -0.862423956f,
+    0.503538384f, -0.863972856f, 0.500885383f, -0.865513624f, 0.498227667f, -0.867046246f, 0.495565262f, -0.868570706f,
+    0.492898192f, -0.870086991f, 0.490226483f, -0.871595087f, 0.48755016f, -0.873094978f, 0.484869248f, -0.874586652f,
+    0.482183772f, -0.876070094f, 0.479493758f, -0.87754529f, 0.47679923f, -0.879012226f, 0.474100215f, -0.880470889f,
+    0.471396737f, -0.881921264f, 0.468688822f, -0.883363339f, 0.465976496f, -0.884797098f, 0.463259784f, -0.88622253f,
+    0.460538711f, -0.88763962f, 0.457813304f, -0.889048356f, 0.455083587f, -0.890448723f, 0.452349587f, -0.891840709f,
+    0.44961133f, -0.893224301f, 0.44686884f, -0.894599486f, 0.444122145f, -0.89596625f, 0.441371269f, -0.897324581f,
+    0.438616239f, -0.898674466f, 0.43585708f, -0.900015892f, 0.433093819f, -0.901348847f, 0.430326481f, -0.902673318f,
+    0.427555093f, -0.903989293f, 0.424779681f, -0.905296759f, 0.422000271f, -0.906595705f, 0.419216888f, -0.907886116f,
+    0.41642956f, -0.909167983f, 0.413638312f, -0.910441292f, 0.410843171f, -0.911706032f, 0.408044163f, -0.91296219f,
+    0.405241314f, -0.914209756f, 0.402434651f, -0.915448716f, 0.3996242f, -0.91667906f, 0.396809987f, -0.917900776f,
+    0.39399204f, -0.919113852f, 0.391170384f, -0.920318277f, 0.388345047f, -0.921514039f, 0.385516054f, -0.922701128f,
+    0.382683432f, -0.923879533f, 0.379847209f, -0.925049241f, 0.37700741f, -0.926210242f, 0.374164063f, -0.927362526f,
+    0.371317194f, -0.92850608f, 0.36846683f, -0.929640896f, 0.365612998f, -0.930766961f, 0.362755724f, -0.931884266f,
+    0.359895037f, -0.932992799f, 0.357030961f, -0.93409255f, 0.354163525f, -0.93518351f, 0.351292756f, -0.936265667f,
+    0.34841868f, -0.937339012f, 0.345541325f, -0.938403534f, 0.342660717f, -0.939459224f, 0.339776884f, -0.940506071f,
+    0.336889853f, -0.941544065f, 0.333999651f, -0.942573198f, 0.331106306f, -0.943593458f, 0.328209844f, -0.944604837f,
+    0.325310292f, -0.945607325f, 0.322407679f, -0.946600913f, 0.319502031f, -0.947585591f, 0.316593376f, -0.94856135f,
+    0.31368174f, -0.949528181f, 0.310767153f, -0.950486074f, 0.30784964f, -0.951435021f, 0.30492923f, -0.952375013f,
+    0.302005949f, -0.95330604f, 0.299079826f, -0.954228095f, 0.296150888f, -0.955141168f, 0.293219163f, -0.956045251f,
+    0.290284677f, -0.956940336f, 0.28734746f, -0.957826413f, 0.284407537f, -0.958703475f, 0.281464938f, -0.959571513f,
+    0.278519689f, -0.960430519f, 0.275571819f, -0.961280486f, 0.272621355f, -0.962121404f, 0.269668326f, -0.962953267f,
+    0.266712757f, -0.963776066f, 0.263754679f, -0.964589793f, 0.260794118f, -0.965394442f, 0.257831102f, -0.966190003f,
+    0.25486566f, -0.966976471f, 0.251897818f, -0.967753837f, 0.248927606f, -0.968522094f, 0.24595505f, -0.969281235f,
+    0.24298018f, -0.970031253f, 0.240003022f, -0.970772141f, 0.237023606f, -0.971503891f, 0.234041959f, -0.972226497f,
+    0.231058108f, -0.972939952f, 0.228072083f, -0.97364425f, 0.225083911f, -0.974339383f, 0.222093621f, -0.975025345f,
+    0.21910124f, -0.97570213f, 0.216106797f, -0.976369731f, 0.21311032f, -0.977028143f, 0.210111837f, -0.977677358f,
+    0.207111376f, -0.978317371f, 0.204108966f, -0.978948175f, 0.201104635f, -0.979569766f, 0.198098411f, -0.980182136f,
+    0.195090322f, -0.98078528f, 0.192080397f, -0.981379193f, 0.189068664f, -0.981963869f, 0.186055152f, -0.982539302f,
+    0.183039888f, -0.983105487f, 0.180022901f, -0.983662419f, 0.17700422f, -0.984210092f, 0.173983873f, -0.984748502f,
+    0.170961889f, -0.985277642f, 0.167938295f, -0.985797509f, 0.16491312f, -0.986308097f, 0.161886394f, -0.986809402f,
+    0.158858143f, -0.987301418f, 0.155828398f, -0.987784142f, 0.152797185f, -0.988257568f, 0.149764535f, -0.988721692f,
+    0.146730474f, -0.98917651f, 0.143695033f, -0.989622017f, 0.140658239f, -0.99005821f, 0.137620122f, -0.990485084f,
+    0.134580709f, -0.990902635f, 0.131540029f, -0.99131086f, 0.128498111f, -0.991709754f, 0.125454983f, -0.992099313f,
+    0.122410675f, -0.992479535f, 0.119365215f, -0.992850414f, 0.116318631f, -0.993211949f, 0.113270952f, -0.993564136f,
+    0.110222207f, -0.99390697f, 0.107172425f, -0.994240449f, 0.104121634f, -0.994564571f, 0.101069863f, -0.994879331f,
+    0.0980171403f, -0.995184727f, 0.0949634953f, -0.995480755f, 0.0919089565f, -0.995767414f, 0.0888535526f, -0.996044701f,
+    0.0857973123f, -0.996312612f, 0.0827402645f, -0.996571146f, 0.079682438f, -0.996820299f, 0.0766238614f, -0.99706007f,
+    0.0735645636f, -0.997290457f, 0.0705045734f, -0.997511456f, 0.0674439196f, -0.997723067f, 0.0643826309f, -0.997925286f,
+    0.0613207363f, -0.998118113f, 0.0582582645f, -0.998301545f, 0.0551952443f, -0.998475581f, 0.0521317047f, -0.998640218f,
+    0.0490676743f, -0.998795456f, 0.0460031821f, -0.998941293f, 0.0429382569f, -0.999077728f, 0.0398729276f, -0.999204759f,
+    0.0368072229f, -0.999322385f, 0.0337411719f, -0.999430605f, 0.0306748032f, -0.999529418f, 0.0276081458f, -0.999618822f,
+    0.0245412285f, -0.999698819f, 0.0214740803f, -0.999769405f, 0.0184067299f, -0.999830582f, 0.0153392063f, -0.999882347f,
+    0.0122715383f, -0.999924702f, 0.00920375478f, -0.999957645f, 0.00613588465f, -0.999981175f, 0.00306795676f, -0.999995294f,
+    6.123234e-17f, -1.0f, -0.00306795676f, -0.999995294f, -0.00613588465f, -0.999981175f, -0.00920375478f, -0.999957645f,
+    -0.0122715383f, -0.999924702f, -0.0153392063f, -0.999882347f, -0.0184067299f, -0.999830582f, -0.0214740803f, -0.999769405f,
+    -0.0245412285f, -0.999698819f, -0.0276081458f, -0.999618822f, -0.0306748032f, -0.999529418f, -0.0337411719f, -0.999430605f,
+    -0.0368072229f, -0.999322385f, -0.0398729276f, -0.999204759f, -0.0429382569f, -0.999077728f, -0.0460031821f, -0.998941293f,
+    -0.0490676743f, -0.998795456f, -0.0521317047f, -0.998640218f, -0.0551952443f, -0.998475581f, -0.0582582645f, -0.998301545f,
+    -0.0613207363f, -0.998118113f, -0.0643826309f, -0.997925286f, -0.0674439196f, -0.997723067f, -0.0705045734f, -0.997511456f,
+    -0.0735645636f, -0.997290457f, -0.0766238614f, -0.99706007f, -0.079682438f, -0.996820299f, -0.0827402645f, -0.996571146f,
+    -0.0857973123f, -0.996312612f, -0.0888535526f, -0.996044701f, -0.0919089565f, -0.995767414f, -0.0949634953f, -0.995480755f,
+    -0.0980171403f, -0.995184727f, -0.101069863f, -0.994879331f, -0.104121634f, -0.994564571f, -0.107172425f, -0.994240449f,
+    -0.110222207f, -0.99390697f, -0.113270952f, -0.993564136f, -0.116318631f, -0.993211949f, -0.119365215f, -0.992850414f,
+    -0.122410675f, -0.992479535f, -0.125454983f, -0.992099313f, -0.128498111f, -0.991709754f, -0.131540029f, -0.99131086f,
+    -0.134580709f, -0.990902635f, -0.137620122f, -0.990485084f, -0.140658239f, -0.99005821f, -0.143695033f, -0.989622017f,
+    -0.146730474f, -0.98917651f, -0.149764535f, -0.988721692f, -0.152797185f, -0.988257568f, -0.155828398f, -0.987784142f,
+    -0.158858143f, -0.987301418f, -0.161886394f, -0.986809402f, -0.16491312f, -0.986308097f, -0.167938295f, -0.985797509f,
+    -0.170961889f, -0.985277642f, -0.173983873f, -0.984748502f, -0.17700422f, -0.984210092f, -0.180022901f, -0.983662419f,
+    -0.183039888f, -0.983105487f, -0.186055152f, -0.982539302f, -0.189068664f, -0.981963869f, -0.192080397f, -0.981379193f,
+    -0.195090322f, -0.98078528f, -0.198098411f, -0.980182136f, -0.201104635f, -0.979569766f, -0.204108966f, -0.978948175f,
+    -0.207111376f, -0.978317371f, -0.210111837f, -0.977677358f, -0.21311032f, -0.977028143f, -0.216106797f, -0.976369731f,
+    -0.21910124f, -0.97570213f, -0.222093621f, -0.975025345f, -0.225083911f, -0.974339383f, -0.228072083f, -0.97364425f,
+    -0.231058108f, -0.972939952f, -0.234041959f, -0.972226497f, -0.237023606f, -0.971503891f, -0.240003022f, -0.970772141f,
+    -0.24298018f, -0.970031253f, -0.24595505f, -0.969281235f, -0.248927606f, -0.968522094f, -0.251897818f, -0.967753837f,
+    -0.25486566f, -0.966976471f, -0.257831102f, -0.966190003f, -0.260794118f, -0.965394442f, -0.263754679f, -0.964589793f,
+    -0.266712757f, -0.963776066f, -0.269668326f, -0.962953267f, -0.272621355f, -0.962121404f, -0.275571819f, -0.961280486f,
+    -0.278519689f, -0.960430519f, -0.281464938f, -0.959571513f, -0.284407537f, -0.958703475f, -0.28734746f, -0.957826413f,
+    -0.290284677f, -0.956940336f, -0.293219163f, -0.956045251f, -0.296150888f, -0.955141168f, -0.299079826f, -0.954228095f,
+    -0.302005949f, -0.95330604f, -0.30492923f, -0.952375013f, -0.30784964f, -0.951435021f, -0.310767153f, -0.950486074f,
+    -0.31368174f, -0.949528181f, -0.316593376f, -0.94856135f, -0.319502031f, -0.947585591f, -0.322407679f, -0.946600913f,
+    -0.325310292f, -0.945607325f, -0.328209844f, -0.944604837f, -0.331106306f, -0.943593458f, -0.333999651f, -0.942573198f,
+    -0.336889853f, -0.941544065f, -0.339776884f, -0.940506071f, -0.342660717f, -0.939459224f, -0.345541325f, -0.938403534f,
+    -0.34841868f, -0.937339012f, -0.351292756f, -0.936265667f, -0.354163525f, -0.93518351f, -0.357030961f, -0.93409255f,
+    -0.359895037f, -0.932992799f, -0.362755724f, -0.931884266f, -0.365612998f, -0.930766961f, -0.36846683f, -0.929640896f,
+    -0.371317194f, -0.92850608f, -0.374164063f, -0.927362526f, -0.37700741f, -0.926210242f, -0.379847209f, -0.925049241f,
+    -0.382683432f, -0.923879533f, -0.385516054f, -0.922701128f, -0.388345047f, -0.921514039f, -0.391170384f, -0.920318277f,
+    -0.39399204f, -0.919113852f, -0.396809987f, -0.917900776f, -0.3996242f, -0.91667906f, -0.402434651f, -0.915448716f,
+    -0.405241314f, -0.914209756f, -0.408044163f, -0.91296219f, -0.410843171f, -0.911706032f, -0.413638312f, -0.910441292f,
+    -0.41642956f, -0.909167983f, -0.419216888f, -0.907886116f, -0.422000271f, -0.906595705f, -0.424779681f, -0.905296759f,
+    -0.427555093f, -0.903989293f, -0.430326481f, -0.902673318f, -0.433093819f, -0.901348847f, -0.43585708f, -0.900015892f,
+    -0.438616239f, -0.898674466f, -0.441371269f, -0.897324581f, -0.444122145f, -0.89596625f, -0.44686884f, -0.894599486f,
+    -0.44961133f, -0.893224301f, -0.452349587f, -0.891840709f, -0.455083587f, -0.890448723f, -0.457813304f, -0.889048356f,
+    -0.460538711f, -0.88763962f, -0.463259784f, -0.88622253f, -0.465976496f, -0.884797098f, -0.468688822f, -0.883363339f,
+    -0.471396737f, -0.881921264f, -0.474100215f, -0.880470889f, -0.47679923f, -0.879012226f, -0.479493758f, -0.87754529f,
+    -0.482183772f, -0.876070094f, -0.484869248f, -0.874586652f, -0.48755016f, -0.873094978f, -0.490226483f, -0.871595087f,
+    -0.492898192f, -0.870086991f, -0.495565262f, -0.868570706f, -0.498227667f, -0.867046246f, -0.500885383f, -0.865513624f,
+    -0.503538384f, -0.863972856f, -0.506186645f, -0.862423956f, -0.508830143f, -0.860866939f, -0.51146885f, -0.859301818f,
+    -0.514102744f, -0.85772861f, -0.516731799f, -0.856147328f, -0.51935599f, -0.854557988f, -0.521975293f, -0.852960605f,
+    -0.524589683f, -0.851355193f, -0.527199135f, -0.849741768f, -0.529803625f, -0.848120345f, -0.532403128f, -0.846490939f,
+    -0.53499762f, -0.844853565f, -0.537587076f, -0.84320824f, -0.540171473f, -0.841554977f, -0.542750785f, -0.839893794f,
+    -0.545324988f, -0.838224706f, -0.547894059f, -0.836547727f, -0.550457973f, -0.834862875f, -0.553016706f, -0.833170165f,
+    -0.555570233f, -0.831469612f, -0.558118531f, -0.829761234f, -0.560661576f, -0.828045045f, -0.563199344f, -0.826321063f,
+    -0.565731811f, -0.824589303f, -0.568258953f, -0.822849781f, -0.570780746f, -0.821102515f, -0.573297167f, -0.81934752f,
+    -0.575808191f, -0.817584813f, -0.578313796f, -0.815814411f, -0.580813958f, -0.81403633f, -0.583308653f, -0.812250587f,
+    -0.585797857f, -0.810457198f, -0.588281548f, -0.808656182f, -0.590759702f, -0.806847554f, -0.593232295f, -0.805031331f,
+    -0.595699304f, -0.803207531f, -0.598160707f, -0.801376172f, -0.600616479f, -0.799537269f, -0.603066599f, -0.797690841f,
+    -0.605511041f, -0.795836905f, -0.607949785f, -0.793975478f, -0.610382806f, -0.792106577f, -0.612810082f, -0.790230221f,
+    -0.615231591f, -0.788346428f, -0.617647308f, -0.786455214f, -0.620057212f, -0.784556597f, -0.622461279f, -0.782650596f,
+    -0.624859488f, -0.780737229f, -0.627251815f, -0.778816512f, -0.629638239f, -0.776888466f, -0.632018736f, -0.774953107f,
+    -0.634393284f, -0.773010453f, -0.636761861f, -0.771060524f, -0.639124445f, -0.769103338f, -0.641481013f, -0.767138912f,
+    -0.643831543f, -0.765167266f, -0.646176013f, -0.763188417f, -0.648514401f, -0.761202385f, -0.650846685f, -0.759209189f,
+    -0.653172843f, -0.757208847f, -0.655492853f, -0.755201377f, -0.657806693f, -0.753186799f, -0.660114342f, -0.751165132f,
+    -0.662415778f, -0.749136395f, -0.664710978f, -0.747100606f, -0.666999922f, -0.745057785f, -0.669282588f, -0.743007952f,
+    -0.671558955f, -0.740951125f, -0.673829f, -0.738887324f, -0.676092704f, -0.736816569f, -0.678350043f, -0.734738878f,
+    -0.680600998f, -0.732654272f, -0.682845546f, -0.730562769f, -0.685083668f, -0.72846439f, -0.687315341f, -0.726359155f,
+    -0.689540545f, -0.724247083f, -0.691759258f, -0.722128194f, -0.693971461f, -0.720002508f, -0.696177131f, -0.717870045f,
+    -0.698376249f, -0.715730825f, -0.700568794f, -0.713584869f, -0.702754744f, -0.711432196f, -0.70493408f, -0.709272826f,
+    -0.707106781f, -0.707106781f, -0.709272826f, -0.70493408f, -0.711432196f, -0.702754744f, -0.713584869f, -0.700568794f,
+    -0.715730825f, -0.698376249f, -0.717870045f, -0.696177131f, -0.720002508f, -0.693971461f, -0.722128194f, -0.691759258f,
+    -0.724247083f, -0.689540545f, -0.726359155f, -0.687315341f, -0.72846439f, -0.685083668f, -0.730562769f, -0.682845546f,
+    -0.732654272f, -0.680600998f, -0.734738878f, -0.678350043f, -0.736816569f, -0.676092704f, -0.738887324f, -0.673829f,
+    -0.740951125f, -0.671558955f, -0.743007952f, -0.669282588f, -0.745057785f, -0.666999922f, -0.747100606f, -0.664710978f,
+    -0.749136395f, -0.662415778f, -0.751165132f, -0.660114342f, -0.753186799f, -0.657806693f, -0.755201377f, -0.655492853f,
+    -0.757208847f, -0.653172843f, -0.759209189f, -0.650846685f, -0.761202385f, -0.648514401f, -0.763188417f, -0.646176013f,
+    -0.765167266f, -0.643831543f, -0.767138912f, -0.641481013f, -0.769103338f, -0.639124445f, -0.771060524f, -0.636761861f,
+    -0.773010453f, -0.634393284f, -0.774953107f, -0.632018736f, -0.776888466f, -0.629638239f, -0.778816512f, -0.627251815f,
+    -0.780737229f, -0.624859488f, -0.782650596f, -0.622461279f, -0.784556597f, -0.620057212f, -0.786455214f, -0.617647308f,
+    -0.788346428f, -0.615231591f, -0.790230221f, -0.612810082f, -0.792106577f, -0.610382806f, -0.793975478f, -0.607949785f,
+    -0.795836905f, -0.605511041f, -0.797690841f, -0.603066599f, -0.799537269f, -0.600616479f, -0.801376172f, -0.598160707f,
+    -0.803207531f, -0.595699304f, -0.805031331f, -0.593232295f, -0.806847554f, -0.590759702f, -0.808656182f, -0.588281548f,
+    -0.810457198f, -0.585797857f, -0.812250587f, -0.583308653f, -0.81403633f, -0.580813958f, -0.815814411f, -0.578313796f,
+    -0.817584813f, -0.575808191f, -0.81934752f, -0.573297167f, -0.821102515f, -0.570780746f, -0.822849781f, -0.568258953f,
+    -0.824589303f, -0.565731811f, -0.826321063f, -0.563199344f, -0.828045045f, -0.560661576f, -0.829761234f, -0.558118531f,
+    -0.831469612f, -0.555570233f, -0.833170165f, -0.553016706f, -0.834862875f, -0.550457973f, -0.836547727f, -0.547894059f,
+    -0.838224706f, -0.545324988f, -0.839893794f, -0.542750785f, -0.841554977f, -0.540171473f, -0.84320824f, -0.537587076f,
+    -0.844853565f, -0.53499762f, -0.846490939f, -0.532403128f, -0.848120345f, -0.529803625f, -0.849741768f, -0.527199135f,
+    -0.851355193f, -0.524589683f, -0.852960605f, -0.521975293f, -0.854557988f, -0.51935599f, -0.856147328f, -0.516731799f,
+    -0.85772861f, -0.514102744f, -0.859301818f, -0.51146885f, -0.860866939f, -0.508830143f, -0.862423956f, -0.506186645f,
+    -0.863972856f, -0.503538384f, -0.865513624f, -0.500885383f, -0.867046246f, -0.498227667f, -0.868570706f, -0.495565262f,
+    -0.870086991f, -0.492898192f, -0.871595087f, -0.490226483f, -0.873094978f, -0.48755016f, -0.874586652f, -0.484869248f,
+    -0.876070094f, -0.482183772f, -0.87754529f, -0.479493758f, -0.879012226f, -0.47679923f, -0.880470889f, -0.474100215f,
+    -0.881921264f, -0.471396737f, -0.883363339f, -0.468688822f, -0.884797098f, -0.465976496f, -0.88622253f, -0.463259784f,
+    -0.88763962f, -0.460538711f, -0.889048356f, -0.457813304f, -0.890448723f, -0.455083587f, -0.891840709f, -0.452349587f,
+    -0.893224301f, -0.44961133f, -0.894599486f, -0.44686884f, -0.89596625f, -0.444122145f, -0.897324581f, -0.441371269f,
+    -0.898674466f, -0.438616239f, -0.900015892f, -0.43585708f, -0.901348847f, -0.433093819f, -0.902673318f, -0.430326481f,
+    -0.903989293f, -0.427555093f, -0.905296759f, -0.424779681f, -0.906595705f, -0.422000271f, -0.907886116f, -0.419216888f,
+    -0.909167983f, -0.41642956f, -0.910441292f, -0.413638312f, -0.911706032f, -0.410843171f, -0.91296219f, -0.408044163f,
+    -0.914209756f, -0.405241314f, -0.915448716f, -0.402434651f, -0.91667906f, -0.3996242f, -0.917900776f, -0.396809987f,
+    -0.919113852f, -0.39399204f, -0.920318277f, -0.391170384f, -0.921514039f, -0.388345047f, -0.922701128f, -0.385516054f,
+    -0.923879533f, -0.382683432f, -0.925049241f, -0.379847209f, -0.926210242f, -0.37700741f, -0.927362526f, -0.374164063f,
+    -0.92850608f, -0.371317194f, -0.929640896f, -0.36846683f, -0.930766961f, -0.365612998f, -0.931884266f, -0.362755724f,
+    -0.932992799f, -0.359895037f, -0.93409255f, -0.357030961f, -0.93518351f, -0.354163525f, -0.936265667f, -0.351292756f,
+    -0.937339012f, -0.34841868f, -0.938403534f, -0.345541325f, -0.939459224f, -0.342660717f, -0.940506071f, -0.339776884f,
+    -0.941544065f, -0.336889853f, -0.942573198f, -0.333999651f, -0.943593458f, -0.331106306f, -0.944604837f, -0.328209844f,
+    -0.945607325f, -0.325310292f, -0.946600913f, -0.322407679f, -0.947585591f, -0.319502031f, -0.94856135f, -0.316593376f,
+    -0.949528181f, -0.31368174f, -0.950486074f, -0.310767153f, -0.951435021f, -0.30784964f, -0.952375013f, -0.30492923f,
+    -0.95330604f, -0.302005949f, -0.954228095f, -0.299079826f, -0.955141168f, -0.296150888f, -0.956045251f, -0.293219163f,
+    -0.956940336f, -0.290284677f, -0.957826413f, -0.28734746f, -0.958703475f, -0.284407537f, -0.959571513f, -0.281464938f,
+    -0.960430519f, -0.278519689f, -0.961280486f, -0.275571819f, -0.962121404f, -0.272621355f, -0.962953267f, -0.269668326f,
+    -0.963776066f, -0.266712757f, -0.964589793f, -0.263754679f, -0.965394442f, -0.260794118f, -0.966190003f, -0.257831102f,
+    -0.966976471f, -0.25486566f, -0.967753837f, -0.251897818f, -0.968522094f, -0.248927606f, -0.969281235f, -0.24595505f,
+    -0.970031253f, -0.24298018f, -0.970772141f, -0.240003022f, -0.971503891f, -0.237023606f, -0.972226497f, -0.234041959f,
+    -0.972939952f, -0.231058108f, -0.97364425f, -0.228072083f, -0.974339383f, -0.225083911f, -0.975025345f, -0.222093621f,
+    -0.97570213f, -0.21910124f, -0.976369731f, -0.216106797f, -0.977028143f, -0.21311032f, -0.977677358f, -0.210111837f,
+    -0.978317371f, -0.207111376f, -0.978948175f, -0.204108966f, -0.979569766f, -0.201104635f, -0.980182136f, -0.198098411f,
+    -0.98078528f, -0.195090322f, -0.981379193f, -0.192080397f, -0.981963869f, -0.189068664f, -0.982539302f, -0.186055152f,
+    -0.983105487f, -0.183039888f, -0.983662419f, -0.180022901f, -0.984210092f, -0.17700422f, -0.984748502f, -0.173983873f,
+    -0.985277642f, -0.170961889f, -0.985797509f, -0.167938295f, -0.986308097f, -0.16491312f, -0.986809402f, -0.161886394f,
+    -0.987301418f, -0.158858143f, -0.987784142f, -0.155828398f, -0.988257568f, -0.152797185f, -0.988721692f, -0.149764535f,
+    -0.98917651f, -0.146730474f, -0.989622017f, -0.143695033f, -0.99005821f, -0.140658239f, -0.990485084f, -0.137620122f,
+    -0.990902635f, -0.134580709f, -0.99131086f, -0.131540029f, -0.991709754f, -0.128498111f, -0.992099313f, -0.125454983f,
+    -0.992479535f, -0.122410675f, -0.992850414f, -0.119365215f, -0.993211949f, -0.116318631f, -0.993564136f, -0.113270952f,
+    -0.99390697f, -0.110222207f, -0.994240449f, -0.107172425f, -0.994564571f, -0.104121634f, -0.994879331f, -0.101069863f,
+    -0.995184727f, -0.0980171403f, -0.995480755f, -0.0949634953f, -0.995767414f, -0.0919089565f, -0.996044701f, -0.0888535526f,
+    -0.996312612f, -0.0857973123f, -0.996571146f, -0.0827402645f, -0.996820299f, -0.079682438f, -0.99706007f, -0.0766238614f,
+    -0.997290457f, -0.0735645636f, -0.997511456f, -0.0705045734f, -0.997723067f, -0.0674439196f, -0.997925286f, -0.0643826309f,
+    -0.998118113f, -0.0613207363f, -0.998301545f, -0.0582582645f, -0.998475581f, -0.0551952443f, -0.998640218f, -0.0521317047f,
+    -0.998795456f, -0.0490676743f, -0.998941293f, -0.0460031821f, -0.999077728f, -0.0429382569f, -0.999204759f, -0.0398729276f,
+    -0.999322385f, -0.0368072229f, -0.999430605f, -0.0337411719f, -0.999529418f, -0.0306748032f, -0.999618822f, -0.0276081458f,
+    -0.999698819f, -0.0245412285f, -0.999769405f, -0.0214740803f, -0.999830582f, -0.0184067299f, -0.999882347f, -0.0153392063f,
+    -0.999924702f, -0.0122715383f, -0.999957645f, -0.00920375478f, -0.999981175f, -0.00613588465f, -0.999995294f, -0.00306795676f
+};
+
+/**
+ * @brief índice con los 10 bits invertidos, para FFT complejas más cortas se desplaza a la derecha
+ */
+static const uint16_t fft_bitrev[ 1024 ] = {
+    0, 512, 256, 768, 128, 640, 384, 896, 64, 576, 320, 832, 192, 704, 448, 960,
+    32, 544, 288, 800, 160, 672, 416, 928, 96, 608, 352, 864, 224, 736, 480, 992,
+    16, 528, 272, 784, 144, 656, 400, 912, 80, 592, 336, 848, 208, 720, 464, 976,
+    48, 560, 304, 816, 176, 688, 432, 944, 112, 624, 368, 880, 240, 752, 496, 1008,
+    8, 520, 264, 776, 136, 648, 392, 904, 72, 584, 328, 840, 200, 712, 456, 968,
+    40, 552, 296, 808, 168, 680, 424, 936, 104, 616, 360, 872, 232, 744, 488, 1000,
+    24, 536, 280, 792, 152, 664, 408, 920, 88, 600, 344, 856, 216, 728, 472, 984,
+    56, 568, 312, 824, 184, 696, 440, 952, 120, 632, 376, 888, 248, 760, 504, 1016,
+    4, 516, 260, 772, 132, 644, 388, 900, 68, 580, 324, 836, 196, 708, 452, 964,
+    36, 548, 292, 804, 164, 676, 420, 932, 100, 612, 356, 868, 228, 740, 484, 996,
+    20, 532, 276, 788, 148, 660, 404, 916, 84, 596, 340, 852, 212, 724, 468, 980,
+    52, 564, 308, 820, 180, 692, 436, 948, 116, 628, 372, 884, 244, 756, 500, 1012,
+    12, 524, 268, 780, 140, 652, 396, 908, 76, 588, 332, 844, 204, 716, 460, 972,
+    44, 556, 300, 812, 172, 684, 428, 940, 108, 620, 364, 876, 236, 748, 492, 1004,
+    28, 540, 284, 796, 156, 668, 412, 924, 92, 604, 348, 860, 220, 732, 476, 988,
+    60, 572, 316, 828, 188, 700, 444, 956, 124, 636, 380, 892, 252, 764, 508, 1020,
+    2, 514, 258, 770, 130, 642, 386, 898, 66, 578, 322, 834, 194, 706, 450, 962,
+    34, 546, 290, 802, 162, 674, 418, 930, 98, 610, 354, 866, 226, 738, 482, 994,
+    18, 530, 274, 786, 146, 658, 402, 914, 82, 594, 338, 850, 210, 722, 466, 978,
+    50, 562, 306, 818, 178, 690, 434, 946, 114, 626, 370, 882, 242, 754, 498, 1010,
+    10, 522, 266, 778, 138, 650, 394, 906, 74, 586, 330, 842, 202, 714, 458, 970,
+    42, 554, 298, 810, 170, 682, 426, 938, 106, 618, 362, 874, 234, 746, 490, 1002,
+    26, 538, 282, 794, 154, 666, 410, 922, 90, 602, 346, 858, 218, 730, 474, 986,
+    58, 570, 314, 826, 186, 698, 442, 954, 122, 634, 378, 890, 250, 762, 506, 1018,
+    6, 518, 262, 774, 134, 646, 390, 902, 70, 582, 326, 838, 198, 710, 454, 966,
+    38, 550, 294, 806, 166, 678, 422, 934, 102, 614, 358, 870, 230, 742, 486, 998,
+    22, 534, 278, 790, 150, 662, 406, 918, 86, 598, 342, 854, 214, 726, 470, 982,
+    54, 566, 310, 822, 182, 694, 438, 950, 118, 630, 374, 886, 246, 758, 502, 1014,
+    14, 526, 270, 782, 142, 654, 398, 910, 78, 590, 334, 846, 206, 718, 462, 974,
+    46, 558, 302, 814, 174, 686, 430, 942, 110, 622, 366, 878, 238, 750, 494, 1006,
+    30, 542, 286, 798, 158, 670, 414, 926, 94, 606, 350, 862, 222, 734, 478, 990,
+    62, 574, 318, 830, 190, 702, 446, 958, 126, 638, 382, 894, 254, 766, 510, 1022,
+    1, 513, 257, 769, 129, 641, 385, 897, 65, 577, 321, 833, 193, 705, 449, 961,
+    33, 545, 289, 801, 161, 673, 417, 929, 97, 609, 353, 865, 225, 737, 481, 993,
+    17, 529, 273, 785, 145, 657, 401, 913, 81, 593, 337, 849, 209, 721, 465, 977,
+    49, 561, 305, 817, 177, 689, 433, 945, 113, 625, 369, 881, 241, 753, 497, 1009,
+    9, 521, 265, 777, 137, 649, 393, 905, 73, 585, 329, 841, 201, 713, 457, 969,
+    41, 553, 297, 809, 169, 681, 425, 937, 105, 617, 361, 873, 233, 745, 489, 1001,
+    25, 537, 281, 793, 153, 665, 409, 921, 89, 601, 345, 857, 217, 729, 473, 985,
+    57, 569, 313, 825, 185, 697, 441, 953, 121, 633, 377, 889, 249, 761, 505, 1017,
+    5, 517, 261, 773, 133, 645, 389, 901, 69, 581, 325, 837, 197, 709, 453, 965,
+    37, 549, 293, 805, 165, 677, 421, 933, 101, 613, 357, 869, 229, 741, 485, 997,
+    21, 533, 277, 789, 149, 661, 405, 917, 85, 597, 341, 853, 213, 725, 469, 981,
+    53, 565, 309, 821, 181, 693, 437, 949, 117, 629, 373, 885, 245, 757, 501, 1013,
+    13, 525, 269, 781, 141, 653, 397, 909, 77, 589, 333, 845, 205, 717, 461, 973,
+    45, 557, 301, 813, 173, 685, 429, 941, 109, 621, 365, 877, 237, 749, 493, 1005,
+    29, 541, 285, 797, 157, 669, 413, 925, 93, 605, 349, 861, 221, 733, 477, 989,
+    61, 573, 317, 829, 189, 701, 445, 957, 125, 637, 381, 893, 253, 765, 509, 1021,
+    3, 515, 259, 771, 131, 643, 387, 899, 67, 579, 323, 835, 195, 707, 451, 963,
+    35, 547, 291, 803, 163, 675, 419, 931, 99, 611, 355, 867, 227, 739, 483, 995,
+    19, 531, 275, 787, 147, 659, 403, 915, 83, 595, 339, 851, 211, 723, 467, 979,
+    51, 563, 307, 819, 179, 691, 435, 947, 115, 627, 371, 883, 243, 755, 499, 1011,
+    11, 523, 267, 779, 139, 651, 395, 907, 75, 587, 331, 843, 203, 715, 459, 971,
+    43, 555, 299, 811, 171, 683, 427, 939, 107, 619, 363, 875, 235, 747, 491, 1003,
+    27, 539, 283, 795, 155, 667, 411, 923, 91, 603, 347, 859, 219, 731, 475, 987,
+    59, 571, 315, 827, 187, 699, 443, 955, 123, 635, 379, 891, 251, 763, 507, 1019,
+    7, 519, 263, 775, 135, 647, 391, 903, 71, 583, 327, 839, 199, 711, 455, 967,
+    39, 551, 295, 807, 167, 679, 423, 935, 103, 615, 359, 871, 231, 743, 487, 999,
+    23, 535, 279, 791, 151, 663, 407, 919, 87, 599, 343, 855, 215, 727, 471, 983,
+    55, 567, 311, 823, 183, 695, 439, 951, 119, 631, 375, 887, 247, 759, 503, 1015,
+    15, 527, 271, 783, 143, 655, 399, 911, 79, 591, 335, 847, 207, 719, 463, 975,
+    47, 559, 303, 815, 175, 687, 431, 943, 111, 623, 367, 879, 239, 751, 495, 1007,
+    31, 543, 287, 799, 159, 671, 415, 927, 95, 607, 351, 863, 223, 735, 479, 991,
+    63, 575, 319, 831, 191, 703, 447, 959, 127, 639, 383, 895, 255, 767, 511, 1023
+};
+
+/**
+ * @brief ventanas hasta la mitad, w[ N - n ] = w[ n ], normalizadas a ganancia coherente 1
+ */
+static const float fft_window_table[ 3 ][ 1025 ] = {
+    /* FFT_WINDOW_HANN */
+    {
+        0.0f, 4.70619042e-06f, 1.88247174e-05f, 4.2355448e-05f, 7.52981609e-05f, 0.000117652546f, 0.000169418204f, 0.000230594649f,
+        0.000301181304f, 0.000381177505f, 0.000470582499f, 0.000569395445f, 0.000677615412f, 0.000795241382f, 0.000922272247f, 0.00105870681f,
+        0.00120454379f, 0.00135978182f, 0.00152441943f, 0.00169845507f, 0.0018818871f, 0.0020747138f, 0.00227693336f, 0.00248854386f,
+        0.00270954332f, 0.00293992966f, 0.00317970071f, 0.00342885421f, 0.00368738782f, 0.0039552991f, 0.00423258553f, 0.00451924451f,
+        0.00481527333f, 0.00512066921f, 0.00543542927f, 0.00575955055f, 0.00609303f, 0.00643586448f, 0.00678805077f, 0.00714958554f,
+        0.0075204654f, 0.00790068686f, 0.00829024633f, 0.00868914015f, 0.00909736457f, 0.00951491574f, 0.00994178974f, 0.0103779825f,
+        0.01082349f, 0.011278308f, 0.0117424323f, 0.0122158584f, 0.0126985818f, 0.0131905982f, 0.0136919028f, 0.0142024908f,
+        0.0147223576f, 0.0152514982f, 0.0157899076f, 0.0163375808f, 0.0168945126f, 0.0174606977f, 0.0180361309f, 0.0186208067f,
+        0.0192147196f, 0.019817864f, 0.0204302343f, 0.0210518247f, 0.0216826293f, 0.0223226422f, 0.0229718573f, 0.0236302687f,
+        0.02429787f, 0.0249746549f, 0.0256606172f, 0.0263557503f, 0.0270600478f, 0.0277735029f, 0.028496109f, 0.0292278593f,
+        0.0299687468f, 0.0307187646f, 0.0314779057f, 0.0322461629f, 0.033023529f, 0.0338099966f, 0.0346055583f, 0.0354102067f,
+        0.0362239342f, 0.0370467331f, 0.0378785957f, 0.0387195142f, 0.0395694806f, 0.0404284869f, 0.0412965251f, 0.042173587f,
+        0.0430596643f, 0.0439547487f, 0.0448588317f, 0.0457719049f, 0.0466939596f, 0.0476249873f, 0.048564979f, 0.0495139261f,
+        0.0504718194f, 0.0514386501f, 0.052414409f, 0.0533990869f, 0.0543926746f, 0.0553951627f, 0.0564065418f, 0.0574268024f,
+        0.0584559348f, 0.0594939294f, 0.0605407764f, 0.0615964659f, 0.0626609881f, 0.0637343328f, 0.0648164901f, 0.0659074496f,
+        0.0670072012f, 0.0681157344f, 0.0692330389f, 0.0703591042f, 0.0714939195f, 0.0726374743f, 0.0737897579f, 0.0749507592f,
+        0.0761204675f, 0.0772988717f, 0.0784859607f, 0.0796817233f, 0.0808861483f, 0.0820992244f, 0.0833209401f, 0.0845512839f,
+        0.0857902443f, 0.0870378096f, 0.088293968f, 0.0895587077f, 0.0908320169f, 0.0921138835f, 0.0934042955f, 0.0947032407f,
+        0.0960107069f, 0.0973266818f, 0.098651153f, 0.099984108f, 0.101325534f, 0.102675419f, 0.10403375f, 0.105400514f,
+        0.106775699f, 0.108159291f, 0.109551277f, 0.110951644f, 0.11236038f, 0.11377747f, 0.115202902f, 0.116636661f,
+        0.118078736f, 0.119529111f, 0.120987774f, 0.12245471f, 0.123929906f, 0.125413348f, 0.126905022f, 0.128404913f,
+        0.129913009f, 0.131429294f, 0.132953754f, 0.134486376f, 0.136027144f, 0.137576044f, 0.139133061f, 0.140698182f,
+        0.14227139f, 0.143852672f, 0.145442012f, 0.147039395f, 0.148644807f, 0.150258232f, 0.151879655f, 0.153509061f,
+        0.155146435f, 0.15679176f, 0.158445023f, 0.160106206f, 0.161775294f, 0.163452273f, 0.165137125f, 0.166829835f,
+        0.168530388f, 0.170238766f, 0.171954955f, 0.173678937f, 0.175410697f, 0.177150219f, 0.178897485f, 0.18065248f,
+        0.182415187f, 0.184185589f, 0.18596367f, 0.187749413f, 0.189542802f, 0.191343818f, 0.193152446f, 0.194968669f,
+        0.196792469f, 0.198623828f, 0.200462731f, 0.202309159f, 0.204163095f, 0.206024522f, 0.207893423f, 0.209769779f,
+        0.211653572f, 0.213544786f, 0.215443403f, 0.217349404f, 0.219262771f, 0.221183488f, 0.223111534f, 0.225046893f,
+        0.226989547f, 0.228939476f, 0.230896662f, 0.232861088f, 0.234832734f, 0.236811583f, 0.238797615f, 0.240790811f,
+        0.242791153f, 0.244798623f, 0.246813201f, 0.248834868f, 0.250863605f, 0.252899394f, 0.254942215f, 0.256992048f,
+        0.259048875f, 0.261112676f, 0.263183431f, 0.265261122f, 0.267345728f, 0.269437231f, 0.27153561f, 0.273640845f,
+        0.275752917f, 0.277871806f, 0.279997492f, 0.282129955f, 0.284269175f, 0.286415131f, 0.288567804f, 0.290727174f,
+        0.292893219f, 0.29506592f, 0.297245256f, 0.299431206f, 0.301623751f, 0.303822869f, 0.306028539f, 0.308240742f,
+        0.310459455f, 0.312684659f, 0.314916332f, 0.317154454f, 0.319399002f, 0.321649957f, 0.323907296f, 0.326171f,
+        0.328441045f, 0.330717412f, 0.333000078f, 0.335289022f, 0.337584222f, 0.339885658f, 0.342193307f, 0.344507147f,
+        0.346827157f, 0.349153315f, 0.351485599f, 0.353823987f, 0.356168457f, 0.358518987f, 0.360875555f, 0.363238139f,
+        0.365606716f, 0.367981264f, 0.370361761f, 0.372748185f, 0.375140512f, 0.377538721f, 0.379942788f, 0.382352692f,
+        0.384768409f, 0.387189918f, 0.389617194f, 0.392050215f, 0.394488959f, 0.396933401f, 0.399383521f, 0.401839293f,
+        0.404300696f, 0.406767705f, 0.409240298f, 0.411718452f, 0.414202143f, 0.416691347f, 0.419186042f, 0.421686204f,
+        0.424191809f, 0.426702833f, 0.429219254f, 0.431741047f, 0.434268189f, 0.436800656f, 0.439338424f, 0.441881469f,
+        0.444429767f, 0.446983294f, 0.449542027f, 0.452105941f, 0.454675012f, 0.457249215f, 0.459828527f, 0.462412924f,
+        0.46500238f, 0.467596872f, 0.470196375f, 0.472800865f, 0.475410317f, 0.478024707f, 0.48064401f, 0.483268201f,
+        0.485897256f, 0.48853115f, 0.491169857f, 0.493813355f, 0.496461616f, 0.499114617f, 0.501772333f, 0.504434738f,
+        0.507101808f, 0.509773517f, 0.51244984f, 0.515130752f, 0.517816228f, 0.520506242f, 0.52320077f, 0.525899785f,
+        0.528603263f, 0.531311178f, 0.534023504f, 0.536740216f, 0.539461289f, 0.542186696f, 0.544916413f, 0.547650413f,
+        0.55038867f, 0.55313116f, 0.555877855f, 0.558628731f, 0.561383761f, 0.56414292f, 0.566906181f, 0.569673519f,
+        0.572444907f, 0.575220319f, 0.577999729f, 0.580783112f, 0.58357044f, 0.586361688f, 0.589156829f, 0.591955837f,
+        0.594758686f, 0.597565349f, 0.6003758f, 0.603190013f, 0.60600796f, 0.608829616f, 0.611654953f, 0.614483946f,
+        0.617316568f, 0.620152791f, 0.62299259f, 0.625835937f, 0.628682806f, 0.63153317f, 0.634387002f, 0.637244276f,
+        0.640104963f, 0.642969039f, 0.645836475f, 0.648707244f, 0.65158132f, 0.654458675f, 0.657339283f, 0.660223116f,
+        0.663110147f, 0.666000349f, 0.668893694f, 0.671790156f, 0.674689708f, 0.677592321f, 0.680497969f, 0.683406624f,
+        0.68631826f, 0.689232847f, 0.69215036f, 0.69507077f, 0.697994051f, 0.700920174f, 0.703849112f, 0.706780837f,
+        0.709715323f, 0.71265254f, 0.715592463f, 0.718535062f, 0.721480311f, 0.724428181f, 0.727378645f, 0.730331674f,
+        0.733287243f, 0.736245321f, 0.739205882f, 0.742168898f, 0.74513434f, 0.748102182f, 0.751072394f, 0.75404495f,
+        0.75701982f, 0.759996978f, 0.762976394f, 0.765958041f, 0.768941892f, 0.771927917f, 0.774916089f, 0.777906379f,
+        0.78089876f, 0.783893203f, 0.78688968f, 0.789888163f, 0.792888624f, 0.795891034f, 0.798895365f, 0.801901589f,
+        0.804909678f, 0.807919603f, 0.810931336f, 0.813944848f, 0.816960112f, 0.819977099f, 0.82299578f, 0.826016127f,
+        0.829038111f, 0.832061705f, 0.83508688f, 0.838113606f, 0.841141857f, 0.844171602f, 0.847202815f, 0.850235465f,
+        0.853269526f, 0.856304967f, 0.859341761f, 0.862379878f, 0.865419291f, 0.868459971f, 0.871501889f, 0.874545017f,
+        0.877589325f, 0.880634785f, 0.883681369f, 0.886729048f, 0.889777793f, 0.892827575f, 0.895878366f, 0.898930137f,
+        0.90198286f, 0.905036505f, 0.908091044f, 0.911146447f, 0.914202688f, 0.917259735f, 0.920317562f, 0.923376139f,
+        0.926435436f, 0.929495427f, 0.93255608f, 0.935617369f, 0.938679264f, 0.941741735f, 0.944804756f, 0.947868295f,
+        0.950932326f, 0.953996818f, 0.957061743f, 0.960127072f, 0.963192777f, 0.966258828f, 0.969325197f, 0.972391854f,
+        0.975458771f, 0.97852592f, 0.98159327f, 0.984660794f, 0.987728462f, 0.990796245f, 0.993864115f, 0.996932043f,
+        1.0f, 1.00306796f, 1.00613588f, 1.00920375f, 1.01227154f, 1.01533921f, 1.01840673f, 1.02147408f,
+        1.02454123f, 1.02760815f, 1.0306748f, 1.03374117f, 1.03680722f, 1.03987293f, 1.04293826f, 1.04600318f,
+        1.04906767f, 1.0521317f, 1.05519524f, 1.05825826f, 1.06132074f, 1.06438263f, 1.06744392f, 1.07050457f,
+        1.07356456f, 1.07662386f, 1.07968244f, 1.08274026f, 1.08579731f, 1.08885355f, 1.09190896f, 1.0949635f,
+        1.09801714f, 1.10106986f, 1.10412163f, 1.10717242f, 1.11022221f, 1.11327095f, 1.11631863f, 1.11936521f,
+        1.12241068f, 1.12545498f, 1.12849811f, 1.13154003f, 1.13458071f, 1.13762012f, 1.14065824f, 1.14369503f,
+        1.14673047f, 1.14976453f, 1.15279719f, 1.1558284f, 1.15885814f, 1.16188639f, 1.16491312f, 1.16793829f,
+        1.17096189f, 1.17398387f, 1.17700422f, 1.1800229f, 1.18303989f, 1.18605515f, 1.18906866f, 1.1920804f,
+        1.19509032f, 1.19809841f, 1.20110463f, 1.20410897f, 1.20711138f, 1.21011184f, 1.21311032f, 1.2161068f,
+        1.21910124f, 1.22209362f, 1.22508391f, 1.22807208f, 1.23105811f, 1.23404196f, 1.23702361f, 1.24000302f,
+        1.24298018f, 1.24595505f, 1.24892761f, 1.25189782f, 1.25486566f, 1.2578311f, 1.26079412f, 1.26375468f,
+        1.26671276f, 1.26966833f, 1.27262136f, 1.27557182f, 1.27851969f, 1.28146494f, 1.28440754f, 1.28734746f,
+        1.29028468f, 1.29321916f, 1.29615089f, 1.29907983f, 1.30200595f, 1.30492923f, 1.30784964f, 1.31076715f,
+        1.31368174f, 1.31659338f, 1.31950203f, 1.32240768f, 1.32531029f, 1.32820984f, 1.33110631f, 1.33399965f,
+        1.33688985f, 1.33977688f, 1.34266072f, 1.34554132f, 1.34841868f, 1.35129276f, 1.35416353f, 1.35703096f,
+        1.35989504f, 1.36275572f, 1.365613f, 1.36846683f, 1.37131719f, 1.37416406f, 1.37700741f, 1.37984721f,
+        1.38268343f, 1.38551605f, 1.38834505f, 1.39117038f, 1.39399204f, 1.39680999f, 1.3996242f, 1.40243465f,
+        1.40524131f, 1.40804416f, 1.41084317f, 1.41363831f, 1.41642956f, 1.41921689f, 1.42200027f, 1.42477968f,
+        1.42755509f, 1.43032648f, 1.43309382f, 1.43585708f, 1.43861624f, 1.44137127f, 1.44412214f, 1.44686884f,
+        1.44961133f, 1.45234959f, 1.45508359f, 1.4578133f, 1.46053871f, 1.46325978f, 1.4659765f, 1.46868882f,
+        1.47139674f, 1.47410021f, 1.47679923f, 1.47949376f, 1.48218377f, 1.48486925f, 1.48755016f, 1.49022648f,
+        1.49289819f, 1.49556526f, 1.49822767f, 1.50088538f, 1.50353838f, 1.50618665f, 1.50883014f, 1.51146885f,
+        1.51410274f, 1.5167318f, 1.51935599f, 1.52197529f, 1.52458968f, 1.52719913f, 1.52980362f, 1.53240313f,
+        1.53499762f, 1.53758708f, 1.54017147f, 1.54275078f, 1.54532499f, 1.54789406f, 1.55045797f, 1.55301671f,
+        1.55557023f, 1.55811853f, 1.56066158f, 1.56319934f, 1.56573181f, 1.56825895f, 1.57078075f, 1.57329717f,
+        1.57580819f, 1.5783138f, 1.58081396f, 1.58330865f, 1.58579786f, 1.58828155f, 1.5907597f, 1.5932323f,
+        1.5956993f, 1.59816071f, 1.60061648f, 1.6030666f, 1.60551104f, 1.60794978f, 1.61038281f, 1.61281008f,
+        1.61523159f, 1.61764731f, 1.62005721f, 1.62246128f, 1.62485949f, 1.62725182f, 1.62963824f, 1.63201874f,
+        1.63439328f, 1.63676186f, 1.63912444f, 1.64148101f, 1.64383154f, 1.64617601f, 1.6485144f, 1.65084668f,
+        1.65317284f, 1.65549285f, 1.65780669f, 1.66011434f, 1.66241578f, 1.66471098f, 1.66699992f, 1.66928259f,
+        1.67155895f, 1.673829f, 1.6760927f, 1.67835004f, 1.680601f, 1.68284555f, 1.68508367f, 1.68731534f,
+        1.68954054f, 1.69175926f, 1.69397146f, 1.69617713f, 1.69837625f, 1.70056879f, 1.70275474f, 1.70493408f,
+        1.70710678f, 1.70927283f, 1.7114322f, 1.71358487f, 1.71573083f, 1.71787005f, 1.72000251f, 1.72212819f,
+        1.72424708f, 1.72635916f, 1.72846439f, 1.73056277f, 1.73265427f, 1.73473888f, 1.73681657f, 1.73888732f,
+        1.74095113f, 1.74300795f, 1.74505779f, 1.74710061f, 1.74913639f, 1.75116513f, 1.7531868f, 1.75520138f,
+        1.75720885f, 1.75920919f, 1.76120239f, 1.76318842f, 1.76516727f, 1.76713891f, 1.76910334f, 1.77106052f,
+        1.77301045f, 1.77495311f, 1.77688847f, 1.77881651f, 1.78073723f, 1.7826506f, 1.7845566f, 1.78645521f,
+        1.78834643f, 1.79023022f, 1.79210658f, 1.79397548f, 1.7958369f, 1.79769084f, 1.79953727f, 1.80137617f,
+        1.80320753f, 1.80503133f, 1.80684755f, 1.80865618f, 1.8104572f, 1.81225059f, 1.81403633f, 1.81581441f,
+        1.81758481f, 1.81934752f, 1.82110251f, 1.82284978f, 1.8245893f, 1.82632106f, 1.82804505f, 1.82976123f,
+        1.83146961f, 1.83317016f, 1.83486287f, 1.83654773f, 1.83822471f, 1.83989379f, 1.84155498f, 1.84320824f,
+        1.84485357f, 1.84649094f, 1.84812034f, 1.84974177f, 1.85135519f, 1.8529606f, 1.85455799f, 1.85614733f,
+        1.85772861f, 1.85930182f, 1.86086694f, 1.86242396f, 1.86397286f, 1.86551362f, 1.86704625f, 1.86857071f,
+        1.87008699f, 1.87159509f, 1.87309498f, 1.87458665f, 1.87607009f, 1.87754529f, 1.87901223f, 1.88047089f,
+        1.88192126f, 1.88336334f, 1.8847971f, 1.88622253f, 1.88763962f, 1.88904836f, 1.89044872f, 1.89184071f,
+        1.8932243f, 1.89459949f, 1.89596625f, 1.89732458f, 1.89867447f, 1.90001589f, 1.90134885f, 1.90267332f,
+        1.90398929f, 1.90529676f, 1.9065957f, 1.90788612f, 1.90916798f, 1.91044129f, 1.91170603f, 1.91296219f,
+        1.91420976f, 1.91544872f, 1.91667906f, 1.91790078f, 1.91911385f, 1.92031828f, 1.92151404f, 1.92270113f,
+        1.92387953f, 1.92504924f, 1.92621024f, 1.92736253f, 1.92850608f, 1.9296409f, 1.93076696f, 1.93188427f,
+        1.9329928f, 1.93409255f, 1.93518351f, 1.93626567f, 1.93733901f, 1.93840353f, 1.93945922f, 1.94050607f,
+        1.94154407f, 1.9425732f, 1.94359346f, 1.94460484f, 1.94560733f, 1.94660091f, 1.94758559f, 1.94856135f,
+        1.94952818f, 1.95048607f, 1.95143502f, 1.95237501f, 1.95330604f, 1.9542281f, 1.95514117f, 1.95604525f,
+        1.95694034f, 1.95782641f, 1.95870347f, 1.95957151f, 1.96043052f, 1.96128049f, 1.9621214f, 1.96295327f,
+        1.96377607f, 1.96458979f, 1.96539444f, 1.96619f, 1.96697647f, 1.96775384f, 1.96852209f, 1.96928124f,
+        1.97003125f, 1.97077214f, 1.97150389f, 1.9722265f, 1.97293995f, 1.97364425f, 1.97433938f, 1.97502535f,
+        1.97570213f, 1.97636973f, 1.97702814f, 1.97767736f, 1.97831737f, 1.97894818f, 1.97956977f, 1.98018214f,
+        1.98078528f, 1.98137919f, 1.98196387f, 1.9825393f, 1.98310549f, 1.98366242f, 1.98421009f, 1.9847485f,
+        1.98527764f, 1.98579751f, 1.9863081f, 1.9868094f, 1.98730142f, 1.98778414f, 1.98825757f, 1.98872169f,
+        1.98917651f, 1.98962202f, 1.99005821f, 1.99048508f, 1.99090264f, 1.99131086f, 1.99170975f, 1.99209931f,
+        1.99247953f, 1.99285041f, 1.99321195f, 1.99356414f, 1.99390697f, 1.99424045f, 1.99456457f, 1.99487933f,
+        1.99518473f, 1.99548076f, 1.99576741f, 1.9960447f, 1.99631261f, 1.99657115f, 1.9968203f, 1.99706007f,
+        1.99729046f, 1.99751146f, 1.99772307f, 1.99792529f, 1.99811811f, 1.99830154f, 1.99847558f, 1.99864022f,
+        1.99879546f, 1.99894129f, 1.99907773f, 1.99920476f, 1.99932238f, 1.9994306f, 1.99952942f, 1.99961882f,
+        1.99969882f, 1.99976941f, 1.99983058f, 1.99988235f, 1.9999247f, 1.99995764f, 1.99998118f, 1.99999529f,
+        2.0f
+    },
+    /* FFT_WINDOW_HAMMING */
+    {
+        0.148148148f, 0.148152157f, 0.148164184f, 0.148184229f, 0.148212291f, 0.148248371f, 0.148292467f, 0.148344581f,
+        0.14840471f, 0.148472855f, 0.148549015f, 0.148633189f, 0.148725376f, 0.148825576f, 0.148933787f, 0.14905001f,
+        0.149174241f, 0.149306481f, 0.149446728f, 0.14959498f, 0.149751237f, 0.149915497f, 0.150087758f, 0.150268019f,
+        0.150456278f, 0.150652533f, 0.150856782f, 0.151069024f, 0.151289256f, 0.151517477f, 0.151753684f, 0.151997875f,
+        0.152250048f, 0.1525102f, 0.152778329f, 0.153054432f, 0.153338507f, 0.153630551f, 0.153930562f, 0.154238536f,
+        0.154554471f, 0.154878363f, 0.15521021f, 0.155550008f, 0.155897755f, 0.156253447f, 0.15661708f, 0.156988652f,
+        0.157368158f, 0.157755596f, 0.158150961f, 0.15855425f, 0.158965459f, 0.159384584f, 0.159811621f, 0.160246566f,
+        0.160689416f, 0.161140165f, 0.16159881f, 0.162065347f, 0.16253977f, 0.163022076f, 0.16351226f, 0.164010317f,
+        0.164516243f, 0.165030032f, 0.165551681f, 0.166081184f, 0.166618536f, 0.167163732f, 0.167716767f, 0.168277636f,
+        0.168846334f, 0.169422854f, 0.170007192f, 0.170599343f, 0.1711993f, 0.171807058f, 0.172422611f, 0.173045954f,
+        0.173677081f, 0.174315985f, 0.17496266f, 0.175617102f, 0.176279302f, 0.176949256f, 0.177626957f, 0.178312398f,
+        0.179005574f, 0.179706476f, 0.1804151f, 0.181131438f, 0.181855483f, 0.18258723f, 0.18332667f, 0.184073796f,
+        0.184828603f, 0.185591082f, 0.186361227f, 0.18713903f, 0.187924484f, 0.188717582f, 0.189518315f, 0.190326678f,
+        0.191142661f, 0.191966257f, 0.19279746f, 0.193636259f, 0.194482649f, 0.19533662f, 0.196198165f, 0.197067276f,
+        0.197943944f, 0.198828162f, 0.199719921f, 0.200619212f, 0.201526027f, 0.202440358f, 0.203362195f, 0.204291531f,
+        0.205228357f, 0.206172663f, 0.207124441f, 0.208083681f, 0.209050376f, 0.210024515f, 0.21100609f, 0.211995091f,
+        0.212991509f, 0.213995335f, 0.215006559f, 0.216025172f, 0.217051163f, 0.218084524f, 0.219125245f, 0.220173316f,
+        0.221228727f, 0.222291467f, 0.223361528f, 0.224438899f, 0.22552357f, 0.22661553f, 0.22771477f, 0.228821279f,
+        0.229935047f, 0.231056062f, 0.232184315f, 0.233319796f, 0.234462492f, 0.235612394f, 0.236769491f, 0.237933771f,
+        0.239105225f, 0.24028384f, 0.241469606f, 0.242662512f, 0.243862546f, 0.245069697f, 0.246283953f, 0.247505304f,
+        0.248733738f, 0.249969243f, 0.251211807f, 0.252461419f, 0.253718068f, 0.254981741f, 0.256252426f, 0.257530111f,
+        0.258814785f, 0.260106436f, 0.26140505f, 0.262710617f, 0.264023123f, 0.265342556f, 0.266668904f, 0.268002155f,
+        0.269342295f, 0.270689313f, 0.272043195f, 0.273403929f, 0.274771502f, 0.276145901f, 0.277527114f, 0.278915126f,
+        0.280309926f, 0.2817115f, 0.283119834f, 0.284534916f, 0.285956732f, 0.287385269f, 0.288820514f, 0.290262452f,
+        0.291711071f, 0.293166356f, 0.294628295f, 0.296096872f, 0.297572075f, 0.29905389f, 0.300542302f, 0.302037298f,
+        0.303538863f, 0.305046983f, 0.306561645f, 0.308082834f, 0.309610535f, 0.311144734f, 0.312685417f, 0.31423257f,
+        0.315786177f, 0.317346224f, 0.318912697f, 0.32048558f, 0.322064859f, 0.323650519f, 0.325242545f, 0.326840922f,
+        0.328445636f, 0.33005667f, 0.33167401f, 0.33329764f, 0.334927546f, 0.336563712f, 0.338206122f, 0.339854761f,
+        0.341509614f, 0.343170665f, 0.344837898f, 0.346511297f, 0.348190848f, 0.349876533f, 0.351568338f, 0.353266246f,
+        0.354970242f, 0.356680309f, 0.35839643f, 0.360118591f, 0.361846775f, 0.363580965f, 0.365321146f, 0.3670673f,
+        0.368819412f, 0.370577464f, 0.372341441f, 0.374111326f, 0.375887102f, 0.377668752f, 0.37945626f, 0.381249609f,
+        0.383048781f, 0.384853761f, 0.38666453f, 0.388481073f, 0.390303371f, 0.392131408f, 0.393965167f, 0.395804629f,
+        0.397649779f, 0.399500598f, 0.40135707f, 0.403219176f, 0.405086899f, 0.406960221f, 0.408839126f, 0.410723595f,
+        0.41261361f, 0.414509154f, 0.416410209f, 0.418316757f, 0.42022878f, 0.42214626f, 0.424069178f, 0.425997518f,
+        0.427931261f, 0.429870388f, 0.431814881f, 0.433764722f, 0.435719893f, 0.437680375f, 0.43964615f, 0.441617199f,
+        0.443593504f, 0.445575046f, 0.447561807f, 0.449553767f, 0.451550908f, 0.453553211f, 0.455560658f, 0.457573229f,
+        0.459590906f, 0.461613669f, 0.4636415f, 0.465674379f, 0.467712288f, 0.469755206f, 0.471803116f, 0.473855997f,
+        0.47591383f, 0.477976596f, 0.480044276f, 0.48211685f, 0.484194298f, 0.486276601f, 0.48836374f, 0.490455694f,
+        0.492552444f, 0.494653971f, 0.496760254f, 0.498871274f, 0.50098701f, 0.503107444f, 0.505232554f, 0.507362322f,
+        0.509496726f, 0.511635747f, 0.513779365f, 0.515927559f, 0.518080309f, 0.520237596f, 0.522399398f, 0.524565696f,
+        0.526736468f, 0.528911695f, 0.531091356f, 0.533275431f, 0.535463899f, 0.537656739f, 0.539853931f, 0.542055454f,
+        0.544261287f, 0.54647141f, 0.548685801f, 0.550904441f, 0.553127307f, 0.55535438f, 0.557585638f, 0.55982106f,
+        0.562060625f, 0.564304313f, 0.566552101f, 0.568803969f, 0.571059895f, 0.573319859f, 0.575583839f, 0.577851814f,
+        0.580123762f, 0.582399662f, 0.584679493f, 0.586963233f, 0.589250861f, 0.591542355f, 0.593837693f, 0.596136854f,
+        0.598439817f, 0.600746559f, 0.603057059f, 0.605371295f, 0.607689246f, 0.61001089f, 0.612336204f, 0.614665166f,
+        0.616997756f, 0.619333951f, 0.621673729f, 0.624017067f, 0.626363945f, 0.628714339f, 0.631068228f, 0.63342559f,
+        0.635786402f, 0.638150642f, 0.640518288f, 0.642889317f, 0.645263708f, 0.647641438f, 0.650022484f, 0.652406824f,
+        0.654794436f, 0.657185297f, 0.659579385f, 0.661976677f, 0.664377151f, 0.666780784f, 0.669187553f, 0.671597436f,
+        0.674010409f, 0.676426452f, 0.678845539f, 0.68126765f, 0.683692761f, 0.686120849f, 0.688551891f, 0.690985864f,
+        0.693422747f, 0.695862515f, 0.698305145f, 0.700750615f, 0.703198902f, 0.705649982f, 0.708103833f, 0.710560432f,
+        0.713019755f, 0.715481778f, 0.71794648f, 0.720413837f, 0.722883825f, 0.725356422f, 0.727831603f, 0.730309347f,
+        0.732789629f, 0.735272425f, 0.737757714f, 0.740245471f, 0.742735673f, 0.745228296f, 0.747723317f, 0.750220713f,
+        0.75272046f, 0.755222534f, 0.757726913f, 0.760233571f, 0.762742487f, 0.765253635f, 0.767766994f, 0.770282537f,
+        0.772800244f, 0.775320088f, 0.777842048f, 0.780366098f, 0.782892216f, 0.785420377f, 0.787950558f, 0.790482735f,
+        0.793016884f, 0.795552981f, 0.798091002f, 0.800630924f, 0.803172723f, 0.805716374f, 0.808261853f, 0.810809138f,
+        0.813358203f, 0.815909025f, 0.818461579f, 0.821015843f, 0.823571791f, 0.826129399f, 0.828688644f, 0.831249502f,
+        0.833811948f, 0.836375958f, 0.838941508f, 0.841508575f, 0.844077132f, 0.846647158f, 0.849218627f, 0.851791515f,
+        0.854365798f, 0.856941452f, 0.859518453f, 0.862096776f, 0.864676396f, 0.867257291f, 0.869839435f, 0.872422804f,
+        0.875007374f, 0.87759312f, 0.880180018f, 0.882768045f, 0.885357174f, 0.887947383f, 0.890538646f, 0.89313094f,
+        0.89572424f, 0.898318521f, 0.900913759f, 0.90350993f, 0.906107009f, 0.908704971f, 0.911303793f, 0.91390345f,
+        0.916503917f, 0.919105171f, 0.921707185f, 0.924309937f, 0.926913401f, 0.929517552f, 0.932122368f, 0.934727822f,
+        0.93733389f, 0.939940549f, 0.942547772f, 0.945155537f, 0.947763817f, 0.950372589f, 0.952981829f, 0.955591511f,
+        0.958201611f, 0.960812104f, 0.963422966f, 0.966034173f, 0.968645699f, 0.97125752f, 0.973869612f, 0.97648195f,
+        0.979094509f, 0.981707265f, 0.984320193f, 0.986933269f, 0.989546467f, 0.992159764f, 0.994773135f, 0.997386555f,
+        1.0f, 1.00261344f, 1.00522686f, 1.00784024f, 1.01045353f, 1.01306673f, 1.01567981f, 1.01829274f,
+        1.02090549f, 1.02351805f, 1.02613039f, 1.02874248f, 1.0313543f, 1.03396583f, 1.03657703f, 1.0391879f,
+        1.04179839f, 1.04440849f, 1.04701817f, 1.04962741f, 1.05223618f, 1.05484446f, 1.05745223f, 1.06005945f,
+        1.06266611f, 1.06527218f, 1.06787763f, 1.07048245f, 1.0730866f, 1.07569006f, 1.07829281f, 1.08089483f,
+        1.08349608f, 1.08609655f, 1.08869621f, 1.09129503f, 1.09389299f, 1.09649007f, 1.09908624f, 1.10168148f,
+        1.10427576f, 1.10686906f, 1.10946135f, 1.11205262f, 1.11464283f, 1.11723196f, 1.11981998f, 1.12240688f,
+        1.12499263f, 1.1275772f, 1.13016057f, 1.13274271f, 1.1353236f, 1.13790322f, 1.14048155f, 1.14305855f,
+        1.1456342f, 1.14820848f, 1.15078137f, 1.15335284f, 1.15592287f, 1.15849143f, 1.16105849f, 1.16362404f,
+        1.16618805f, 1.1687505f, 1.17131136f, 1.1738706f, 1.17642821f, 1.17898416f, 1.18153842f, 1.18409098f,
+        1.1866418f, 1.18919086f, 1.19173815f, 1.19428363f, 1.19682728f, 1.19936908f, 1.201909f, 1.20444702f,
+        1.20698312f, 1.20951727f, 1.21204944f, 1.21457962f, 1.21710778f, 1.2196339f, 1.22215795f, 1.22467991f,
+        1.22719976f, 1.22971746f, 1.23223301f, 1.23474636f, 1.23725751f, 1.23976643f, 1.24227309f, 1.24477747f,
+        1.24727954f, 1.24977929f, 1.25227668f, 1.2547717f, 1.25726433f, 1.25975453f, 1.26224229f, 1.26472757f,
+        1.26721037f, 1.26969065f, 1.2721684f, 1.27464358f, 1.27711617f, 1.27958616f, 1.28205352f, 1.28451822f,
+        1.28698025f, 1.28943957f, 1.29189617f, 1.29435002f, 1.2968011f, 1.29924938f, 1.30169485f, 1.30413749f,
+        1.30657725f, 1.30901414f, 1.31144811f, 1.31387915f, 1.31630724f, 1.31873235f, 1.32115446f, 1.32357355f,
+        1.32598959f, 1.32840256f, 1.33081245f, 1.33321922f, 1.33562285f, 1.33802332f, 1.34042061f, 1.3428147f,
+        1.34520556f, 1.34759318f, 1.34997752f, 1.35235856f, 1.35473629f, 1.35711068f, 1.35948171f, 1.36184936f,
+        1.3642136f, 1.36657441f, 1.36893177f, 1.37128566f, 1.37363606f, 1.37598293f, 1.37832627f, 1.38066605f,
+        1.38300224f, 1.38533483f, 1.3876638f, 1.38998911f, 1.39231075f, 1.3946287f, 1.39694294f, 1.39925344f,
+        1.40156018f, 1.40386315f, 1.40616231f, 1.40845765f, 1.41074914f, 1.41303677f, 1.41532051f, 1.41760034f,
+        1.41987624f, 1.42214819f, 1.42441616f, 1.42668014f, 1.4289401f, 1.43119603f, 1.4334479f, 1.43569569f,
+        1.43793937f, 1.44017894f, 1.44241436f, 1.44464562f, 1.44687269f, 1.44909556f, 1.4513142f, 1.45352859f,
+        1.45573871f, 1.45794455f, 1.46014607f, 1.46234326f, 1.4645361f, 1.46672457f, 1.46890864f, 1.4710883f,
+        1.47326353f, 1.4754343f, 1.4776006f, 1.4797624f, 1.48191969f, 1.48407244f, 1.48622064f, 1.48836425f,
+        1.49050327f, 1.49263768f, 1.49476745f, 1.49689256f, 1.49901299f, 1.50112873f, 1.50323975f, 1.50534603f,
+        1.50744756f, 1.50954431f, 1.51163626f, 1.5137234f, 1.5158057f, 1.51788315f, 1.51995572f, 1.5220234f,
+        1.52408617f, 1.526144f, 1.52819688f, 1.53024479f, 1.53228771f, 1.53432562f, 1.5363585f, 1.53838633f,
+        1.54040909f, 1.54242677f, 1.54443934f, 1.54644679f, 1.54844909f, 1.55044623f, 1.55243819f, 1.55442495f,
+        1.5564065f, 1.5583828f, 1.56035385f, 1.56231962f, 1.56428011f, 1.56623528f, 1.56818512f, 1.57012961f,
+        1.57206874f, 1.57400248f, 1.57593082f, 1.57785374f, 1.57977122f, 1.58168324f, 1.58358979f, 1.58549085f,
+        1.58738639f, 1.58927641f, 1.59116087f, 1.59303978f, 1.5949131f, 1.59678082f, 1.59864293f, 1.6004994f,
+        1.60235022f, 1.60419537f, 1.60603483f, 1.60786859f, 1.60969663f, 1.61151893f, 1.61333547f, 1.61514624f,
+        1.61695122f, 1.61875039f, 1.62054374f, 1.62233125f, 1.6241129f, 1.62588867f, 1.62765856f, 1.62942254f,
+        1.63118059f, 1.6329327f, 1.63467885f, 1.63641903f, 1.63815322f, 1.63988141f, 1.64160357f, 1.64331969f,
+        1.64502976f, 1.64673375f, 1.64843166f, 1.65012347f, 1.65180915f, 1.6534887f, 1.6551621f, 1.65682934f,
+        1.65849039f, 1.66014524f, 1.66179388f, 1.66343629f, 1.66507245f, 1.66670236f, 1.66832599f, 1.66994333f,
+        1.67155436f, 1.67315908f, 1.67475745f, 1.67634948f, 1.67793514f, 1.67951442f, 1.6810873f, 1.68265378f,
+        1.68421382f, 1.68576743f, 1.68731458f, 1.68885527f, 1.69038947f, 1.69191717f, 1.69343835f, 1.69495302f,
+        1.69646114f, 1.6979627f, 1.6994577f, 1.70094611f, 1.70242792f, 1.70390313f, 1.70537171f, 1.70683364f,
+        1.70828893f, 1.70973755f, 1.71117949f, 1.71261473f, 1.71404327f, 1.71546508f, 1.71688017f, 1.7182885f,
+        1.71969007f, 1.72108487f, 1.72247289f, 1.7238541f, 1.7252285f, 1.72659607f, 1.7279568f, 1.72931069f,
+        1.7306577f, 1.73199785f, 1.7333311f, 1.73465744f, 1.73597688f, 1.73728938f, 1.73859495f, 1.73989356f,
+        1.74118521f, 1.74246989f, 1.74374757f, 1.74501826f, 1.74628193f, 1.74753858f, 1.74878819f, 1.75003076f,
+        1.75126626f, 1.7524947f, 1.75371605f, 1.7549303f, 1.75613745f, 1.75733749f, 1.75853039f, 1.75971616f,
+        1.76089478f, 1.76206623f, 1.76323051f, 1.76438761f, 1.76553751f, 1.7666802f, 1.76781568f, 1.76894394f,
+        1.77006495f, 1.77117872f, 1.77228523f, 1.77338447f, 1.77447643f, 1.7755611f, 1.77663847f, 1.77770853f,
+        1.77877127f, 1.77982668f, 1.78087475f, 1.78191548f, 1.78294884f, 1.78397483f, 1.78499344f, 1.78600466f,
+        1.78700849f, 1.78800491f, 1.78899391f, 1.78997548f, 1.79094962f, 1.79191632f, 1.79287556f, 1.79382734f,
+        1.79477164f, 1.79570847f, 1.7966378f, 1.79755964f, 1.79847397f, 1.79938079f, 1.80028008f, 1.80117184f,
+        1.80205606f, 1.80293272f, 1.80380183f, 1.80466338f, 1.80551735f, 1.80636374f, 1.80720254f, 1.80803374f,
+        1.80885734f, 1.80967332f, 1.81048168f, 1.81128242f, 1.81207552f, 1.81286097f, 1.81363877f, 1.81440892f,
+        1.8151714f, 1.8159262f, 1.81667333f, 1.81741277f, 1.81814452f, 1.81886856f, 1.8195849f, 1.82029352f,
+        1.82099443f, 1.8216876f, 1.82237304f, 1.82305074f, 1.8237207f, 1.8243829f, 1.82503734f, 1.82568402f,
+        1.82632292f, 1.82695405f, 1.82757739f, 1.82819294f, 1.8288007f, 1.82940066f, 1.82999281f, 1.83057715f,
+        1.83115367f, 1.83172236f, 1.83228323f, 1.83283627f, 1.83338146f, 1.83391882f, 1.83444832f, 1.83496997f,
+        1.83548376f, 1.83598968f, 1.83648774f, 1.83697792f, 1.83746023f, 1.83793465f, 1.83840119f, 1.83885983f,
+        1.83931058f, 1.83975343f, 1.84018838f, 1.84061542f, 1.84103454f, 1.84144575f, 1.84184904f, 1.8422444f,
+        1.84263184f, 1.84301135f, 1.84338292f, 1.84374655f, 1.84410224f, 1.84444999f, 1.84478979f, 1.84512164f,
+        1.84544553f, 1.84576146f, 1.84606944f, 1.84636945f, 1.84666149f, 1.84694557f, 1.84722167f, 1.8474898f,
+        1.84774995f, 1.84800213f, 1.84824632f, 1.84848252f, 1.84871074f, 1.84893098f, 1.84914322f, 1.84934747f,
+        1.84954372f, 1.84973198f, 1.84991224f, 1.8500845f, 1.85024876f, 1.85040502f, 1.85055327f, 1.85069352f,
+        1.85082576f, 1.85094999f, 1.85106621f, 1.85117442f, 1.85127462f, 1.85136681f, 1.85145099f, 1.85152715f,
+        1.85159529f, 1.85165542f, 1.85170753f, 1.85175163f, 1.85178771f, 1.85181577f, 1.85183582f, 1.85184784f,
+        1.85185185f
+    },
+    /* FFT_WINDOW_FLATTOP */
+    {
+        -0.00195311741f, -0.00195423882f, -0.00195760326f, -0.00196321134f, -0.00197106403f, -0.00198116275f, -0.00199350929f, -0.00200810584f,
+        -0.002024955f, -0.00204405975f, -0.0020654235f, -0.00208905001f, -0.00211494348f, -0.00214310848f, -0.00217354999f, -0.00220627337f,
+        -0.00224128438f, -0.00227858918f, -0.0023181943f, -0.0023601067f, -0.00240433369f, -0.00245088299f, -0.00249976271f, -0.00255098132f,
+        -0.00260454771f, -0.00266047113f, -0.00271876123f, -0.00277942802f, -0.00284248192f, -0.00290793368f, -0.00297579448f, -0.00304607584f,
+        -0.00311878967f, -0.00319394824f, -0.0032715642f, -0.00335165055f, -0.00343422067f, -0.00351928831f, -0.00360686757f, -0.0036969729f,
+        -0.00378961913f, -0.00388482143f, -0.00398259532f, -0.00408295669f, -0.00418592176f, -0.00429150708f, -0.00439972959f, -0.00451060653f,
+        -0.00462415548f, -0.00474039438f, -0.00485934149f, -0.00498101538f, -0.00510543497f, -0.00523261949f, -0.00536258851f, -0.00549536189f,
+        -0.00563095982f, -0.00576940281f, -0.00591071166f, -0.00605490747f, -0.00620201167f, -0.00635204596f, -0.00650503235f, -0.00666099314f,
+        -0.0068199509f, -0.00698192851f, -0.0071469491f, -0.00731503612f, -0.00748621324f, -0.00766050443f, -0.00783793393f, -0.00801852623f,
+        -0.00820230606f, -0.00838929843f, -0.0085795286f, -0.00877302204f, -0.00896980449f, -0.00916990193f, -0.00937334055f, -0.00958014678f,
+        -0.00979034727f, -0.0100039689f, -0.0102210387f, -0.010441584f, -0.0106656324f, -0.0108932114f, -0.011124349f, -0.0113590732f,
+        -0.0115974124f, -0.0118393949f, -0.0120850494f, -0.0123344047f, -0.0125874898f, -0.0128443337f, -0.0131049657f, -0.0133694152f,
+        -0.0136377118f, -0.0139098853f, -0.0141859653f, -0.014465982f, -0.0147499653f, -0.0150379456f, -0.015329953f, -0.015626018f,
+        -0.0159261712f, -0.0162304431f, -0.0165388644f, -0.016851466f, -0.0171682787f, -0.0174893333f, -0.017814661f, -0.0181442927f,
+        -0.0184782596f, -0.0188165928f, -0.0191593234f, -0.0195064828f, -0.0198581021f, -0.0202142127f, -0.0205748458f, -0.0209400327f,
+        -0.0213098047f, -0.021684193f, -0.0220632291f, -0.022446944f, -0.0228353691f, -0.0232285356f, -0.0236264745f, -0.0240292171f,
+        -0.0244367944f, -0.0248492374f, -0.025266577f, -0.0256888441f, -0.0261160694f, -0.0265482838f, -0.0269855177f, -0.0274278017f,
+        -0.0278751662f, -0.0283276415f, -0.0287852576f, -0.0292480446f, -0.0297160325f, -0.0301892509f, -0.0306677294f, -0.0311514975f,
+        -0.0316405844f, -0.0321350191f, -0.0326348307f, -0.0331400477f, -0.0336506987f, -0.0341668121f, -0.0346884158f, -0.0352155378f,
+        -0.0357482056f, -0.0362864468f, -0.0368302884f, -0.0373797573f, -0.0379348803f, -0.0384956835f, -0.0390621933f, -0.0396344352f,
+        -0.040212435f, -0.0407962177f, -0.0413858083f, -0.0419812314f, -0.0425825113f, -0.0431896718f, -0.0438027365f, -0.0444217287f,
+        -0.0450466713f, -0.0456775867f, -0.0463144971f, -0.0469574243f, -0.0476063896f, -0.0482614139f, -0.0489225178f, -0.0495897215f,
+        -0.0502630446f, -0.0509425064f, -0.0516281257f, -0.052319921f, -0.05301791f, -0.0537221104f, -0.0544325389f, -0.0551492122f,
+        -0.0558721462f, -0.0566013563f, -0.0573368576f, -0.0580786646f, -0.0588267911f, -0.0595812505f, -0.0603420556f, -0.0611092188f,
+        -0.0618827518f, -0.0626626657f, -0.0634489711f, -0.064241678f, -0.0650407957f, -0.065846333f, -0.0666582981f, -0.0674766985f,
+        -0.0683015411f, -0.0691328321f, -0.0699705772f, -0.0708147812f, -0.0716654486f, -0.0725225827f, -0.0733861867f, -0.0742562627f,
+        -0.0751328121f, -0.0760158359f, -0.076905334f, -0.0778013059f, -0.0787037501f, -0.0796126644f, -0.0805280461f, -0.0814498914f,
+        -0.0823781959f, -0.0833129544f, -0.0842541609f, -0.0852018086f, -0.0861558899f, -0.0871163962f, -0.0880833185f, -0.0890566465f,
+        -0.0900363694f, -0.0910224754f, -0.0920149518f, -0.0930137851f, -0.094018961f, -0.0950304641f, -0.0960482783f, -0.0970723866f,
+        -0.0981027709f, -0.0991394123f, -0.100182291f, -0.101231386f, -0.102286677f, -0.103348139f, -0.10441575f, -0.105489485f,
+        -0.106569319f, -0.107655224f, -0.108747174f, -0.10984514f, -0.110949092f, -0.112059f, -0.113174832f, -0.114296555f,
+        -0.115424137f, -0.116557542f, -0.117696734f, -0.118841676f, -0.119992332f, -0.121148661f, -0.122310624f, -0.12347818f,
+        -0.124651286f, -0.125829899f, -0.127013974f, -0.128203466f, -0.129398329f, -0.130598513f, -0.131803971f, -0.133014652f,
+        -0.134230506f, -0.135451478f, -0.136677516f, -0.137908565f, -0.139144569f, -0.14038547f, -0.141631211f, -0.142881732f,
+        -0.144136971f, -0.145396867f, -0.146661357f, -0.147930375f, -0.149203857f, -0.150481735f, -0.151763942f, -0.153050407f,
+        -0.15434106f, -0.155635829f, -0.15693464f, -0.15823742f, -0.159544091f, -0.160854578f, -0.162168802f, -0.163486683f,
+        -0.164808139f, -0.166133089f, -0.16746145f, -0.168793135f, -0.170128059f, -0.171466134f, -0.172807272f, -0.174151381f,
+        -0.175498371f, -0.176848148f, -0.178200618f, -0.179555685f, -0.180913253f, -0.182273223f, -0.183635494f, -0.184999967f,
+        -0.186366538f, -0.187735104f, -0.189105559f, -0.190477797f, -0.19185171f, -0.193227188f, -0.19460412f, -0.195982394f,
+        -0.197361897f, -0.198742514f, -0.200124128f, -0.201506621f, -0.202889874f, -0.204273767f, -0.205658177f, -0.207042981f,
+        -0.208428054f, -0.20981327f, -0.211198501f, -0.212583617f, -0.21396849f, -0.215352985f, -0.21673697f, -0.218120311f,
+        -0.21950287f, -0.220884511f, -0.222265093f, -0.223644477f, -0.225022521f, -0.22639908f, -0.227774012f, -0.229147168f,
+        -0.230518401f, -0.231887563f, -0.233254503f, -0.234619068f, -0.235981106f, -0.237340462f, -0.238696979f, -0.240050499f,
+        -0.241400865f, -0.242747915f, -0.244091487f, -0.245431419f, -0.246767545f, -0.248099699f, -0.249427713f, -0.25075142f,
+        -0.252070648f, -0.253385226f, -0.254694981f, -0.255999737f, -0.25729932f, -0.258593552f, -0.259882254f, -0.261165246f,
+        -0.262442347f, -0.263713374f, -0.264978143f, -0.266236468f, -0.267488163f, -0.268733038f, -0.269970905f, -0.271201573f,
+        -0.27242485f, -0.273640541f, -0.274848452f, -0.276048387f, -0.277240147f, -0.278423535f, -0.27959835f, -0.280764391f,
+        -0.281921455f, -0.283069337f, -0.284207833f, -0.285336736f, -0.286455838f, -0.28756493f, -0.288663801f, -0.289752241f,
+        -0.290830036f, -0.291896972f, -0.292952834f, -0.293997406f, -0.295030469f, -0.296051805f, -0.297061195f, -0.298058416f,
+        -0.299043246f, -0.300015462f, -0.30097484f, -0.301921152f, -0.302854174f, -0.303773675f, -0.304679428f, -0.305571202f,
+        -0.306448765f, -0.307311886f, -0.308160331f, -0.308993865f, -0.309812253f, -0.310615258f, -0.311402643f, -0.312174168f,
+        -0.312929595f, -0.313668683f, -0.314391191f, -0.315096875f, -0.315785492f, -0.316456799f, -0.317110549f, -0.317746496f,
+        -0.318364394f, -0.318963995f, -0.319545049f, -0.320107307f, -0.320650519f, -0.321174433f, -0.321678796f, -0.322163357f,
+        -0.322627861f, -0.323072054f, -0.32349568f, -0.323898484f, -0.324280208f, -0.324640597f, -0.32497939f, -0.325296331f,
+        -0.325591158f, -0.325863613f, -0.326113434f, -0.32634036f, -0.32654413f, -0.32672448f, -0.326881148f, -0.327013871f,
+        -0.327122384f, -0.327206422f, -0.327265721f, -0.327300014f, -0.327309037f, -0.327292522f, -0.327250203f, -0.327181813f,
+        -0.327087083f, -0.326965745f, -0.326817532f, -0.326642175f, -0.326439405f, -0.326208952f, -0.325950546f, -0.325663919f,
+        -0.3253488f, -0.325004919f, -0.324632006f, -0.324229789f, -0.323797998f, -0.323336362f, -0.322844611f, -0.322322473f,
+        -0.321769677f, -0.321185951f, -0.320571026f, -0.319924628f, -0.319246488f, -0.318536334f, -0.317793895f, -0.317018899f,
+        -0.316211077f, -0.315370156f, -0.314495867f, -0.313587939f, -0.312646101f, -0.311670084f, -0.310659618f, -0.309614432f,
+        -0.308534258f, -0.307418827f, -0.306267869f, -0.305081117f, -0.303858303f, -0.302599158f, -0.301303416f, -0.29997081f,
+        -0.298601073f, -0.29719394f, -0.295749145f, -0.294266424f, -0.292745512f, -0.291186146f, -0.289588062f, -0.287950999f,
+        -0.286274694f, -0.284558887f, -0.282803316f, -0.281007722f, -0.279171847f, -0.277295432f, -0.275378219f, -0.273419953f,
+        -0.271420377f, -0.269379237f, -0.267296278f, -0.265171248f, -0.263003894f, -0.260793966f, -0.258541213f, -0.256245386f,
+        -0.253906237f, -0.251523519f, -0.249096987f, -0.246626394f, -0.244111498f, -0.241552057f, -0.238947828f, -0.236298572f,
+        -0.23360405f, -0.230864024f, -0.228078259f, -0.225246519f, -0.22236857f, -0.21944418f, -0.21647312f, -0.213455158f,
+        -0.210390067f, -0.207277621f, -0.204117594f, -0.200909764f, -0.197653907f, -0.194349805f, -0.190997237f, -0.187595987f,
+        -0.18414584f, -0.180646582f, -0.177097999f, -0.173499883f, -0.169852025f, -0.166154217f, -0.162406255f, -0.158607935f,
+        -0.154759055f, -0.150859418f, -0.146908824f, -0.142907079f, -0.138853988f, -0.134749359f, -0.130593004f, -0.126384734f,
+        -0.122124364f, -0.11781171f, -0.113446591f, -0.109028827f, -0.104558242f, -0.100034659f, -0.095457907f, -0.0908278147f,
+        -0.086144214f, -0.0814069388f, -0.0766158254f, -0.0717707123f, -0.0668714405f, -0.0619178533f, -0.0569097964f, -0.0518471179f,
+        -0.0467296685f, -0.0415573012f, -0.0363298715f, -0.0310472375f, -0.0257092597f, -0.0203158015f, -0.0148667284f, -0.00936190894f,
+        -0.00380121402f, 0.00181548267f, 0.00748830479f, 0.0132173733f, 0.0190028065f, 0.0248447198f, 0.0307432259f, 0.0366984349f,
+        0.0427104537f, 0.0487793867f, 0.0549053352f, 0.0610883979f, 0.0673286703f, 0.0736262453f, 0.0799812124f, 0.0863936586f,
+        0.0928636677f, 0.0993913204f, 0.105976695f, 0.112619865f, 0.119320903f, 0.126079878f, 0.132896854f, 0.139771895f,
+        0.146705059f, 0.153696402f, 0.160745978f, 0.167853835f, 0.175020021f, 0.182244578f, 0.189527546f, 0.196868962f,
+        0.204268859f, 0.211727267f, 0.219244214f, 0.226819721f, 0.234453809f, 0.242146494f, 0.249897791f, 0.257707707f,
+        0.26557625f, 0.273503422f, 0.281489223f, 0.289533649f, 0.297636691f, 0.305798339f, 0.314018578f, 0.32229739f,
+        0.330634752f, 0.33903064f, 0.347485024f, 0.355997871f, 0.364569147f, 0.373198809f, 0.381886816f, 0.39063312f,
+        0.39943767f, 0.40830041f, 0.417221285f, 0.42620023f, 0.43523718f, 0.444332067f, 0.453484816f, 0.462695351f,
+        0.471963591f, 0.481289452f, 0.490672844f, 0.500113677f, 0.509611854f, 0.519167275f, 0.528779837f, 0.538449433f,
+        0.54817595f, 0.557959274f, 0.567799287f, 0.577695864f, 0.587648879f, 0.597658202f, 0.607723698f, 0.617845229f,
+        0.628022651f, 0.63825582f, 0.648544584f, 0.65888879f, 0.669288279f, 0.679742889f, 0.690252455f, 0.700816806f,
+        0.711435768f, 0.722109165f, 0.732836813f, 0.743618527f, 0.754454118f, 0.765343392f, 0.77628615f, 0.787282192f,
+        0.798331311f, 0.809433299f, 0.820587941f, 0.83179502f, 0.843054314f, 0.854365598f, 0.865728642f, 0.877143213f,
+        0.888609074f, 0.900125982f, 0.911693692f, 0.923311956f, 0.934980518f, 0.946699124f, 0.958467509f, 0.970285411f,
+        0.982152559f, 0.994068679f, 1.0060335f, 1.01804673f, 1.03010809f, 1.04221729f, 1.05437404f, 1.06657804f,
+        1.07882899f, 1.09112658f, 1.10347051f, 1.11586047f, 1.12829613f, 1.14077718f, 1.15330329f, 1.16587414f,
+        1.17848939f, 1.19114871f, 1.20385175f, 1.21659818f, 1.22938764f, 1.24221979f, 1.25509427f, 1.26801072f,
+        1.28096878f, 1.29396809f, 1.30700826f, 1.32008893f, 1.33320973f, 1.34637026f, 1.35957015f, 1.37280901f,
+        1.38608644f, 1.39940205f, 1.41275543f, 1.42614619f, 1.43957392f, 1.4530382f, 1.46653863f, 1.48007478f,
+        1.49364624f, 1.50725257f, 1.52089336f, 1.53456816f, 1.54827655f, 1.56201808f, 1.57579231f, 1.5895988f,
+        1.6034371f, 1.61730675f, 1.6312073f, 1.64513829f, 1.65909925f, 1.67308973f, 1.68710925f, 1.70115734f,
+        1.71523352f, 1.72933731f, 1.74346824f, 1.75762582f, 1.77180955f, 1.78601895f, 1.80025352f, 1.81451276f,
+        1.82879618f, 1.84310327f, 1.85743352f, 1.87178642f, 1.88616146f, 1.90055812f, 1.91497589f, 1.92941424f,
+        1.94387265f, 1.95835059f, 1.97284754f, 1.98736295f, 2.00189629f, 2.01644702f, 2.03101461f, 2.04559851f,
+        2.06019817f, 2.07481304f, 2.08944257f, 2.10408621f, 2.11874341f, 2.13341359f, 2.14809621f, 2.16279069f,
+        2.17749647f, 2.19221298f, 2.20693965f, 2.22167591f, 2.23642118f, 2.25117488f, 2.26593643f, 2.28070525f,
+        2.29548076f, 2.31026237f, 2.3250495f, 2.33984154f, 2.3546379f, 2.36943801f, 2.38424124f, 2.39904702f,
+        2.41385473f, 2.42866378f, 2.44347356f, 2.45828347f, 2.47309289f, 2.48790123f, 2.50270786f, 2.51751218f,
+        2.53231357f, 2.54711142f, 2.56190511f, 2.57669403f, 2.59147754f, 2.60625504f, 2.62102589f, 2.63578948f,
+        2.65054518f, 2.66529236f, 2.68003039f, 2.69475865f, 2.70947651f, 2.72418334f, 2.7388785f, 2.75356136f,
+        2.76823129f, 2.78288765f, 2.79752981f, 2.81215712f, 2.82676897f, 2.84136469f, 2.85594366f, 2.87050524f,
+        2.88504878f, 2.89957365f, 2.91407921f, 2.92856481f, 2.9430298f, 2.95747356f, 2.97189543f, 2.98629477f,
+        3.00067094f, 3.01502329f, 3.02935119f, 3.04365397f, 3.05793101f, 3.07218165f, 3.08640526f, 3.10060118f,
+        3.11476878f, 3.1289074f, 3.1430164f, 3.15709515f, 3.17114299f, 3.18515928f, 3.19914337f, 3.21309463f,
+        3.22701242f, 3.24089608f, 3.25474498f, 3.26855847f, 3.28233593f, 3.29607669f, 3.30978013f, 3.32344561f,
+        3.33707248f, 3.35066012f, 3.36420788f, 3.37771512f, 3.39118122f, 3.40460554f, 3.41798745f, 3.43132631f,
+        3.44462149f, 3.45787237f, 3.47107831f, 3.48423869f, 3.49735288f, 3.51042026f, 3.5234402f, 3.53641208f,
+        3.54933528f, 3.56220918f, 3.57503317f, 3.58780662f, 3.60052892f, 3.61319946f, 3.62581763f, 3.63838282f,
+        3.65089442f, 3.66335183f, 3.67575443f, 3.68810163f, 3.70039283f, 3.71262742f, 3.72480482f, 3.73692443f,
+        3.74898565f, 3.7609879f, 3.77293058f, 3.78481312f, 3.79663492f, 3.80839542f, 3.82009402f, 3.83173015f,
+        3.84330324f, 3.85481272f, 3.86625801f, 3.87763856f, 3.88895379f, 3.90020315f, 3.91138607f, 3.92250201f,
+        3.9335504f, 3.94453071f, 3.95544237f, 3.96628485f, 3.9770576f, 3.98776009f, 3.99839178f, 4.00895214f,
+        4.01944063f, 4.02985674f, 4.04019993f, 4.05046969f, 4.0606655f, 4.07078685f, 4.08083322f, 4.09080412f,
+        4.10069902f, 4.11051745f, 4.12025889f, 4.12992285f, 4.13950885f, 4.1490164f, 4.15844502f, 4.16779422f,
+        4.17706353f, 4.18625248f, 4.1953606f, 4.20438743f, 4.21333251f, 4.22219537f, 4.23097557f, 4.23967266f,
+        4.2482862f, 4.25681573f, 4.26526083f, 4.27362106f, 4.28189599f, 4.2900852f, 4.29818827f, 4.30620477f,
+        4.31413431f, 4.32197646f, 4.32973083f, 4.33739702f, 4.34497462f, 4.35246326f, 4.35986253f, 4.36717207f,
+        4.37439149f, 4.38152042f, 4.38855848f, 4.39550533f, 4.40236058f, 4.4091239f, 4.41579493f, 4.42237332f,
+        4.42885872f, 4.43525082f, 4.44154926f, 4.44775373f, 4.4538639f, 4.45987945f, 4.46580008f, 4.47162546f,
+        4.4773553f, 4.4829893f, 4.48852716f, 4.4939686f, 4.49931334f, 4.50456108f, 4.50971156f, 4.51476451f,
+        4.51971967f, 4.52457677f, 4.52933556f, 4.53399579f, 4.53855722f, 4.54301961f, 4.54738272f, 4.55164633f,
+        4.55581021f, 4.55987415f, 4.56383793f, 4.56770133f, 4.57146417f, 4.57512624f, 4.57868735f, 4.58214731f,
+        4.58550594f, 4.58876307f, 4.59191851f, 4.59497212f, 4.59792372f, 4.60077315f, 4.60352028f, 4.60616496f,
+        4.60870704f, 4.6111464f, 4.61348289f, 4.61571641f, 4.61784683f, 4.61987405f, 4.62179794f, 4.62361842f,
+        4.62533539f, 4.62694875f, 4.62845842f, 4.62986433f, 4.63116639f, 4.63236453f, 4.63345871f, 4.63444885f,
+        4.6353349f, 4.63611683f, 4.63679458f, 4.63736812f, 4.63783742f, 4.63820246f, 4.63846322f, 4.63861968f,
+        4.63867183f
+    }
+};
+
+#endif // _FFT_TABLES_H
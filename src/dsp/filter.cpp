@@ -0,0 +1,180 @@
+/**
+ * @file filter.cpp
+ * @brief Etapas de filtrado del opcode FILTER de measure.cpp
+ */
+#include <math.h>
+#include <string.h>
+#include "filter.h"
+#include "fixed_point.h"
+
+/**
+ * @brief coeficientes de un biquad en Q29, alcanza para |a1| < 2 sin saturar
+ */
+typedef struct {
+    int32_t b0, b1, b2;
+    int32_t a1, a2;
+} filter_biquad_q29_t;
+
+static filter_biquad_t biquad[ FILTER_BIQUAD_PRESETS ];             /** @brief biquads predefinidos */
+static filter_biquad_q29_t biquad_q29[ FILTER_BIQUAD_PRESETS ];     /** @brief los mismos biquads en Q29 */
+
+/**
+ * @brief calcula un biquad según las fórmulas del "Audio EQ Cookbook" de R. Bristow-Johnson
+ *
+ * @param bq            coeficientes resultantes
+ * @param band_pass     true pasa banda con ganancia 1 en el centro, false pasa bajo
+ * @param w0            frecuencia de corte o central en radianes por muestra
+ * @param q             factor de calidad
+ */
+static void filter_design_biquad( filter_biquad_t *bq, bool band_pass, double w0, double q ) {
+    double alpha = sin( w0 ) / ( 2.0 * q );
+    double a0 = 1.0 + alpha;
+
+    if( band_pass ) {
+        bq->b0 = alpha / a0;
+        bq->b1 = 0.0;
+        bq->b2 = -alpha / a0;
+    }
+    else {
+        bq->b0 = ( 1.0 - cos( w0 ) ) / 2.0 / a0;
+        bq->b1 = ( 1.0 - cos( w0 ) ) / a0;
+        bq->b2 = bq->b0;
+    }
+    bq->a1 = -2.0 * cos( w0 ) / a0;
+    bq->a2 = ( 1.0 - alpha ) / a0;
+}
+
+void filter_design_presets( float sample_rate, float network_frequency ) {
+    /**
+     * armónica de corte de los pasa bajo, 0 para el pasa banda en la fundamental
+     */
+    static const int harmonic[ FILTER_BIQUAD_PRESETS ] = { 40, 20, 10, 5, 0 };
+
+    if( sample_rate <= 0.0 || network_frequency <= 0.0 )
+        return;
+
+    for( int i = 0 ; i < FILTER_BIQUAD_PRESETS ; i++ ) {
+        double frequency = network_frequency * ( harmonic[ i ] ? harmonic[ i ] : 1 );
+        /**
+         * limita el corte por debajo de Nyquist
+         */
+        if( frequency > 0.45 * sample_rate )
+            frequency = 0.45 * sample_rate;
+
+        filter_design_biquad( &biquad[ i ], !harmonic[ i ], 2.0 * M_PI * frequency / sample_rate, harmonic[ i ] ? M_SQRT1_2 : 1.0 );
+
+        biquad_q29[ i ].b0 = q31_sat( llround( biquad[ i ].b0 * 536870912.0 ) );
+        biquad_q29[ i ].b1 = q31_sat( llround( biquad[ i ].b1 * 536870912.0 ) );
+        biquad_q29[ i ].b2 = q31_sat( llround( biquad[ i ].b2 * 536870912.0 ) );
+        biquad_q29[ i ].a1 = q31_sat( llround( biquad[ i ].a1 * 536870912.0 ) );
+        biquad_q29[ i ].a2 = q31_sat( llround( biquad[ i ].a2 * 536870912.0 ) );
+    }
+}
+
+int filter_boxcar_len( uint8_t operand ) {
+    if( operand >= 1 && operand <= 6 )
+        return( 1 << operand );
+    if( operand >= 7 && operand < FILTER_BIQUAD_FIRST )
+        return( FILTER_BOXCAR_ALT_LEN );
+    return( 0 );
+}
+
+void filter_reset( filter_state_t *state ) {
+    memset( state, 0, sizeof( filter_state_t ) );
+}
+
+void filter_reset_q31( filter_state_q31_t *state ) {
+    memset( state, 0, sizeof( filter_state_q31_t ) );
+}
+
+void filter_process( filter_state_t *state, uint8_t operand, float hp_coef, float *x, int len ) {
+    int box_len = filter_boxcar_len( operand );
+    const filter_biquad_t *bq = NULL;
+
+    if( operand >= FILTER_BIQUAD_FIRST && operand < FILTER_BIQUAD_FIRST + FILTER_BIQUAD_PRESETS )
+        bq = &biquad[ operand - FILTER_BIQUAD_FIRST ];
+    /**
+     * un cambio de ventana arranca la media móvil desde cero
+     */
+    if( box_len && state->box_len != box_len ) {
+        memset( state->box, 0, sizeof( state->box ) );
+        state->box_sum = 0.0;
+        state->box_pos = 0;
+        state->box_len = box_len;
+    }
+
+    for( int n = 0 ; n < len ; n++ ) {
+        /**
+         * pasa alto de primer orden: y = c * ( y_anterior + x - x_anterior )
+         */
+        float y = hp_coef * ( state->hp_out + x[ n ] - state->hp_in );
+        state->hp_in = x[ n ];
+        state->hp_out = y;
+
+        if( box_len ) {
+            state->box_sum += y - state->box[ state->box_pos ];
+            state->box[ state->box_pos ] = y;
+            /**
+             * al dar la vuelta se vuelve a sumar la ventana para que no se acumule error de redondeo
+             */
+            if( ++state->box_pos == box_len ) {
+                state->box_pos = 0;
+                state->box_sum = 0.0;
+                for( int j = 0 ; j < box_len ; j++ )
+                    state->box_sum += state->box[ j ];
+            }
+            y = state->box_sum / box_len;
+        }
+        else if( bq ) {
+            float out = bq->b0 * y + state->bq_z1;
+            state->bq_z1 = bq->b1 * y - bq->a1 * out + state->bq_z2;
+            state->bq_z2 = bq->b2 * y - bq->a2 * out;
+            y = out;
+        }
+
+        x[ n ] = y;
+    }
+}
+
+int32_t filter_process_q31( filter_state_q31_t *state, uint8_t operand, int32_t hp_coef_q30, int32_t x ) {
+    int box_len = filter_boxcar_len( operand );
+    /**
+     * pasa alto de primer orden, la suma de tres valores Q31 entra en 64 bits junto al coeficiente Q30
+     */
+    int64_t acc = (int64_t)state->hp_out + x - state->hp_in;
+    int32_t y = q31_sat( ( acc * hp_coef_q30 ) >> 30 );
+    state->hp_in = x;
+    state->hp_out = y;
+
+    if( box_len ) {
+        if( state->box_len != box_len ) {
+            memset( state->box, 0, sizeof( state->box ) );
+            state->box_sum = 0;
+            state->box_pos = 0;
+            state->box_len = box_len;
+        }
+        /**
+         * la suma es entera y por lo tanto exacta, no hace falta volver a sumar la ventana
+         */
+        state->box_sum += ( y >> 6 ) - state->box[ state->box_pos ];
+        state->box[ state->box_pos ] = y >> 6;
+        if( ++state->box_pos == box_len )
+            state->box_pos = 0;
+        y = ( ( box_len == FILTER_BOXCAR_ALT_LEN ) ? state->box_sum / box_len : state->box_sum >> operand ) << 6;
+    }
+    else if( operand >= FILTER_BIQUAD_FIRST && operand < FILTER_BIQUAD_FIRST + FILTER_BIQUAD_PRESETS ) {
+        const filter_biquad_q29_t *bq = &biquad_q29[ operand - FILTER_BIQUAD_FIRST ];
+        /**
+         * forma directa I, los productos Q29 * Q31 y su suma entran en 64 bits con filtros estables
+         */
+        int64_t out = (int64_t)bq->b0 * y + (int64_t)bq->b1 * state->bq_x1 + (int64_t)bq->b2 * state->bq_x2
+                    - (int64_t)bq->a1 * state->bq_y1 - (int64_t)bq->a2 * state->bq_y2;
+        state->bq_x2 = state->bq_x1;
+        state->bq_x1 = y;
+        state->bq_y2 = state->bq_y1;
+        state->bq_y1 = q31_sat( out >> 29 );
+        y = state->bq_y1;
+    }
+
+    return( y );
+}
@@ -0,0 +1,107 @@
+/**
+ * @file filter.h
+ * @brief Etapas de filtrado del opcode FILTER de measure.cpp
+ *
+ * El operando del opcode selecciona la etapa que sigue al pasa alto de primer orden:
+ *   0        sólo pasa alto (quita la continua del ADC)
+ *   1 .. 6   media móvil de 2^operando muestras
+ *   7 .. 15  media móvil de FILTER_BOXCAR_ALT_LEN muestras, como en el firmware original
+ *
+ * Los biquads de filter_design_presets() no tienen lugar en los cuatro bits del opcode: los pide
+ * el opcode extendido BIQUAD, que measure.cpp traduce a un FILTER con operando
+ * FILTER_BIQUAD_FIRST + preset. Así los programas guardados con FILTER 8 .. 15 siguen siendo
+ * la media móvil de siempre.
+ *
+ * Todo el estado vive en una estructura por canal; si un programa usa varios FILTER, éstos
+ * comparten el estado del canal. Las medias móviles llevan una suma corriente que se mantiene
+ * entre bloques, así el costo por muestra no depende del largo de la ventana.
+ */
+#ifndef _FILTER_H
+    #define _FILTER_H
+
+    #include <stdint.h>
+
+    #define FILTER_BOXCAR_MAX       64      /** @brief ventana máxima de la media móvil */
+    #define FILTER_BOXCAR_ALT_LEN   12      /** @brief ventana de los operandos 7 a 15 */
+    #define FILTER_BIQUAD_FIRST     16      /** @brief primer operando interno que selecciona un biquad */
+    #define FILTER_BIQUAD_PRESETS   5       /** @brief cantidad de biquads predefinidos */
+
+    /**
+     * @brief coeficientes de un biquad normalizados con a0 = 1
+     */
+    typedef struct {
+        float b0, b1, b2;                   /** @brief numerador */
+        float a1, a2;                       /** @brief denominador */
+    } filter_biquad_t;
+    /**
+     * @brief estado de filtrado de un canal en float
+     */
+    typedef struct {
+        float hp_in;                        /** @brief entrada anterior del pasa alto */
+        float hp_out;                       /** @brief salida anterior del pasa alto */
+        float box[ FILTER_BOXCAR_MAX ];     /** @brief ventana de la media móvil */
+        float box_sum;                      /** @brief suma corriente de la ventana */
+        uint8_t box_len;                    /** @brief largo de ventana en uso, 0 sin inicializar */
+        uint8_t box_pos;                    /** @brief próxima posición a escribir */
+        float bq_z1, bq_z2;                 /** @brief estado del biquad (forma directa II transpuesta) */
+    } filter_state_t;
+    /**
+     * @brief estado de filtrado de un canal en punto fijo Q31
+     */
+    typedef struct {
+        int32_t hp_in;                      /** @brief entrada anterior del pasa alto */
+        int32_t hp_out;                     /** @brief salida anterior del pasa alto */
+        int32_t box[ FILTER_BOXCAR_MAX ];   /** @brief ventana en Q25, así la suma entra en 32 bits */
+        int32_t box_sum;                    /** @brief suma corriente de la ventana, exacta */
+        uint8_t box_len;                    /** @brief largo de ventana en uso, 0 sin inicializar */
+        uint8_t box_pos;                    /** @brief próxima posición a escribir */
+        int32_t bq_x1, bq_x2;               /** @brief entradas anteriores del biquad */
+        int32_t bq_y1, bq_y2;               /** @brief salidas anteriores del biquad */
+    } filter_state_q31_t;
+
+    /**
+     * @brief calcula los biquads predefinidos para una frecuencia de muestreo por canal
+     *
+     * Las frecuencias de corte son múltiplos de la frecuencia de red, por número de preset:
+     *   0   pasa bajo Butterworth en la armónica 40
+     *   1   pasa bajo Butterworth en la armónica 20
+     *   2   pasa bajo Butterworth en la armónica 10
+     *   3   pasa bajo Butterworth en la armónica 5
+     *   4   pasa banda en la fundamental, Q = 1, ganancia 1 y fase 0 en el centro
+     * Los pasa bajo agregan retardo de fase: en un par tensión/corriente conviene usar el mismo.
+     *
+     * @param sample_rate           muestras por segundo de cada canal
+     * @param network_frequency     frecuencia de red en Hz
+     */
+    void filter_design_presets( float sample_rate, float network_frequency );
+    /**
+     * @brief devuelve el largo de la media móvil de un operando de FILTER, 0 si no tiene
+     */
+    int filter_boxcar_len( uint8_t operand );
+    /**
+     * @brief pone a cero el estado de un canal
+     */
+    void filter_reset( filter_state_t *state );
+    void filter_reset_q31( filter_state_q31_t *state );
+    /**
+     * @brief filtra un bloque de muestras en el lugar
+     *
+     * @param state     estado del canal
+     * @param operand   operando del opcode FILTER, o FILTER_BIQUAD_FIRST + preset
+     * @param hp_coef   coeficiente del pasa alto, entre 0 y 1
+     * @param x         muestras de entrada y salida
+     * @param len       cantidad de muestras
+     */
+    void filter_process( filter_state_t *state, uint8_t operand, float hp_coef, float *x, int len );
+    /**
+     * @brief filtra una muestra Q31
+     *
+     * @param state         estado del canal
+     * @param operand       operando del opcode FILTER, o FILTER_BIQUAD_FIRST + preset
+     * @param hp_coef_q30   coeficiente del pasa alto en Q30
+     * @param x             muestra de entrada
+     * @return int32_t      muestra filtrada
+     */
+    int32_t filter_process_q31( filter_state_q31_t *state, uint8_t operand, int32_t hp_coef_q30, int32_t x );
+
+#endif // _FILTER_H
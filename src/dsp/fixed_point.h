@@ -0,0 +1,51 @@
+/**
+ * @file fixed_point.h
+ * @brief Aritmética Q31 con saturación para el motor de punto fijo de measure.cpp
+ *
+ * Un valor Q31 representa x = q / 2^31, con q en [-2^31, 2^31). Los productos se calculan
+ * en 64 bits y todo resultado que no entra en 32 bits satura en vez de desbordar.
+ */
+#ifndef _FIXED_POINT_H
+    #define _FIXED_POINT_H
+
+    #include <stdint.h>
+
+    #define Q31_MAX     ( (int32_t)0x7fffffff )     /** @brief máximo valor Q31 (1 - 2^-31) */
+    #define Q31_MIN     ( (int32_t)0x80000000 )     /** @brief mínimo valor Q31 (-1) */
+
+    /**
+     * @brief satura un valor de 64 bits al rango de 32 bits
+     */
+    static inline int32_t q31_sat( int64_t x ) {
+        if( x > Q31_MAX )
+            return( Q31_MAX );
+        if( x < Q31_MIN )
+            return( Q31_MIN );
+        return( (int32_t)x );
+    }
+    /**
+     * @brief a * b en Q31
+     */
+    static inline int32_t q31_mul( int32_t a, int32_t b ) {
+        return( q31_sat( ( (int64_t)a * b ) >> 31 ) );
+    }
+    /**
+     * @brief -a en Q31, -1 satura a 1 - 2^-31
+     */
+    static inline int32_t q31_neg( int32_t a ) {
+        return( ( a == Q31_MIN ) ? Q31_MAX : -a );
+    }
+    /**
+     * @brief |a| en Q31, -1 satura a 1 - 2^-31
+     */
+    static inline int32_t q31_abs( int32_t a ) {
+        return( ( a < 0 ) ? q31_neg( a ) : a );
+    }
+    /**
+     * @brief convierte un float en [-1,1) a Q31 con redondeo y saturación
+     */
+    static inline int32_t q31_from_float( float x ) {
+        return( q31_sat( (int64_t)( (double)x * 2147483648.0 + ( ( x < 0 ) ? -0.5 : 0.5 ) ) ) );
+    }
+
+#endif // _FIXED_POINT_H
@@ -0,0 +1,25 @@
+/**
+ * @file fracdelay.cpp
+ * @brief Retardo fraccionario con interpolación de Lagrange de FRACDELAY_TAPS puntos
+ */
+#include <math.h>
+#include "fracdelay.h"
+
+void fracdelay_design( fracdelay_t *d, float delay ) {
+    int whole = floorf( delay );
+    float mu = delay - whole;
+    int first = 1 - FRACDELAY_TAPS / 2;
+    /**
+     * polinomio de Lagrange sobre los nodos first .. first + FRACDELAY_TAPS - 1 evaluado en mu
+     */
+    d->delay = whole + first;
+    for( int k = 0 ; k < FRACDELAY_TAPS ; k++ ) {
+        float coef = 1.0;
+
+        for( int j = 0 ; j < FRACDELAY_TAPS ; j++ ) {
+            if( j != k )
+                coef *= ( mu - ( first + j ) ) / ( k - j );
+        }
+        d->coef[ k ] = coef;
+    }
+}
@@ -0,0 +1,40 @@
+/**
+ * @file fracdelay.h
+ * @brief Retardo fraccionario con interpolación de Lagrange de FRACDELAY_TAPS puntos
+ *
+ * Un retardo de D muestras no entero se aproxima con el polinomio que pasa por las FRACDELAY_TAPS
+ * muestras que rodean a D, evaluado en D. Los coeficientes sólo dependen de D, así se calculan
+ * cuando cambia el retardo y cada muestra retardada cuesta FRACDELAY_TAPS multiplicaciones, sin
+ * trigonometría. Como el polinomio es simétrico, los mismos coeficientes leídos hacia adelante
+ * (muestras n + delay + k) dan un adelanto de D muestras.
+ *
+ * Error complejo máximo con 128 muestras por ciclo: 1e-10 en la fundamental, 5e-8 en la tercera,
+ * 3e-4 en la armónica 13 y 1.3% en la 25; arriba de eso atenúa.
+ */
+#ifndef _FRACDELAY_H
+    #define _FRACDELAY_H
+
+    #include <stdint.h>
+
+    #define FRACDELAY_TAPS      6           /** @brief muestras que se combinan por salida, par */
+
+    /**
+     * @brief coeficientes de un retardo
+     */
+    typedef struct {
+        int delay;                          /** @brief retardo de la primera muestra, floor( D ) - FRACDELAY_TAPS / 2 + 1 */
+        float coef[ FRACDELAY_TAPS ];       /** @brief coef[ k ] multiplica a la muestra de retardo delay + k */
+    } fracdelay_t;
+
+    /**
+     * @brief calcula los coeficientes de un retardo
+     *
+     * Para que todas las muestras sean anteriores a la actual D tiene que ser al menos
+     * FRACDELAY_TAPS / 2, y la historia tiene que guardar D + FRACDELAY_TAPS / 2 + 1 muestras.
+     *
+     * @param d         destino
+     * @param delay     retardo en muestras, puede ser negativo
+     */
+    void fracdelay_design( fracdelay_t *d, float delay );
+
+#endif // _FRACDELAY_H
@@ -0,0 +1,37 @@
+/**
+ * @file freqtrack.cpp
+ * @brief Estimador de la frecuencia de red a partir de cruces por cero interpolados
+ */
+#include <string.h>
+#include "freqtrack.h"
+
+void freqtrack_reset( freqtrack_t *ft ) {
+    memset( ft, 0, sizeof( freqtrack_t ) );
+}
+
+void freqtrack_block( freqtrack_t *ft, const float *crossing, int found, int len ) {
+    for( int k = 0 ; k < found ; k++ ) {
+        ft->crossing[ ft->head ] = (double)ft->sample + crossing[ k ];
+        ft->head = ( ft->head + 1 ) % ( FREQTRACK_MAX_CYCLES + 1 );
+        if( ft->count < FREQTRACK_MAX_CYCLES + 1 )
+            ft->count++;
+    }
+    ft->sample += len;
+}
+
+float freqtrack_frequency( freqtrack_t *ft, float sample_rate, uint32_t max_age ) {
+    if( ft->count < 2 )
+        return( 0.0 );
+
+    int newest = ( ft->head + FREQTRACK_MAX_CYCLES ) % ( FREQTRACK_MAX_CYCLES + 1 );
+    int oldest = ( ft->head + FREQTRACK_MAX_CYCLES + 1 - ft->count ) % ( FREQTRACK_MAX_CYCLES + 1 );
+    /**
+     * sin cruces recientes la red se cortó: se descarta lo guardado
+     */
+    if( ft->sample - ft->crossing[ newest ] > max_age ) {
+        ft->count = 0;
+        return( 0.0 );
+    }
+
+    return( ( ft->count - 1 ) * sample_rate / ( ft->crossing[ newest ] - ft->crossing[ oldest ] ) );
+}
@@ -0,0 +1,52 @@
+/**
+ * @file freqtrack.h
+ * @brief Estimador de la frecuencia de red a partir de cruces por cero interpolados
+ *
+ * Guarda la posición absoluta (en muestras) de los últimos cruces ascendentes y estima la
+ * frecuencia con el intervalo entre el más nuevo y el de FREQTRACK_MAX_CYCLES ciclos atrás:
+ * f = ciclos * fs / ( posición_nueva - posición_vieja ). Con cruces interpolados el error de
+ * posición queda en centésimas de muestra, así que a 50 Hz y 128 muestras por ciclo el error
+ * es de pocos mHz. Se actualiza con cada bloque y se asienta en
+ * FREQTRACK_MAX_CYCLES ciclos (200 ms a 50 Hz) después de un salto de frecuencia.
+ */
+#ifndef _FREQTRACK_H
+    #define _FREQTRACK_H
+
+    #include <stdint.h>
+
+    #define FREQTRACK_MAX_CYCLES    10      /** @brief ciclos usados para la estimación */
+
+    /**
+     * @brief estado del estimador
+     */
+    typedef struct {
+        double crossing[ FREQTRACK_MAX_CYCLES + 1 ];    /** @brief posiciones absolutas de los últimos cruces */
+        uint8_t count;                                  /** @brief cruces válidos guardados */
+        uint8_t head;                                   /** @brief posición del próximo cruce a guardar */
+        uint64_t sample;                                /** @brief posición absoluta de la primera muestra del bloque actual */
+    } freqtrack_t;
+
+    /**
+     * @brief pone el estimador en su estado inicial
+     */
+    void freqtrack_reset( freqtrack_t *ft );
+    /**
+     * @brief agrega los cruces de un bloque y avanza al siguiente
+     *
+     * @param ft        estado del estimador
+     * @param crossing  posiciones de los cruces dentro del bloque, como las da zerocross_find()
+     * @param found     cantidad de cruces
+     * @param len       muestras del bloque
+     */
+    void freqtrack_block( freqtrack_t *ft, const float *crossing, int found, int len );
+    /**
+     * @brief estima la frecuencia con los cruces guardados
+     *
+     * @param ft            estado del estimador
+     * @param sample_rate   muestras por segundo
+     * @param max_age       muestras sin cruces a partir de las cuales la estimación no vale
+     * @return float        frecuencia en Hz, 0 si no hay cruces suficientes o recientes
+     */
+    float freqtrack_frequency( freqtrack_t *ft, float sample_rate, uint32_t max_age );
+
+#endif // _FREQTRACK_H
@@ -0,0 +1,83 @@
+/**
+ * @file goertzel.cpp
+ * @brief Filtros de Goertzel para evaluar sólo las armónicas pedidas de un canal
+ */
+#include <math.h>
+#include <string.h>
+#include "goertzel.h"
+
+void goertzel_design( goertzel_coef_t *coef, float sample_rate, float network_frequency ) {
+    if( sample_rate <= 0.0 )
+        return;
+
+    for( int h = 1 ; h <= GOERTZEL_MAX_HARMONIC ; h++ ) {
+        coef[ h - 1 ].coef = 2.0 * cos( 2.0 * M_PI * h * network_frequency / sample_rate );
+    }
+}
+
+void goertzel_frame_window( float *window, bool *restart, int len, float *position, float frame_len ) {
+    float t = *position;
+
+    if( frame_len < 1.0 )
+        frame_len = 1.0;
+    /**
+     * t es la posición de la muestra dentro del cuadro, fraccionaria: el cuadro empieza entre muestras
+     */
+    for( int n = 0 ; n < len ; n++, t += 1.0 ) {
+        restart[ n ] = ( t >= frame_len );
+        if( restart[ n ] )
+            t = fmodf( t, frame_len );
+        window[ n ] = 0.5 - 0.5 * cosf( 2.0 * M_PI * t / frame_len );
+    }
+    *position = t;
+}
+
+void goertzel_reset( goertzel_t *g ) {
+    memset( g, 0, sizeof( goertzel_t ) );
+}
+
+void goertzel_close_frame( goertzel_t *g ) {
+    if( g->framed ) {
+        memcpy( g->frame_s1, g->s1, sizeof( g->frame_s1 ) );
+        memcpy( g->frame_s2, g->s2, sizeof( g->frame_s2 ) );
+        g->frame_weight = g->weight;
+        g->frame_sum = g->weighted_sum;
+        g->frame_sq = g->weighted_sq;
+    }
+    memset( g->s1, 0, sizeof( g->s1 ) );
+    memset( g->s2, 0, sizeof( g->s2 ) );
+    g->weight = 0.0;
+    g->weighted_sum = 0.0;
+    g->weighted_sq = 0.0;
+    g->framed = true;
+}
+
+float goertzel_rms( const goertzel_t *g, const goertzel_coef_t *coef, int h ) {
+    if( h < 1 || h > GOERTZEL_MAX_HARMONIC || g->frame_weight <= 0.0 )
+        return( 0.0 );
+    /**
+     * |X|^2 = s1^2 + s2^2 - 2 cos( w ) s1 s2, y el valor eficaz de una senoidal es |X| * sqrt( 2 )
+     * sobre la suma de los pesos, N sin ventana
+     */
+    float s1 = g->frame_s1[ h - 1 ], s2 = g->frame_s2[ h - 1 ];
+    float power = s1 * s1 + s2 * s2 - coef[ h - 1 ].coef * s1 * s2;
+
+    return( ( power > 0.0 ) ? sqrtf( 2.0 * power ) / g->frame_weight : 0.0 );
+}
+
+float goertzel_ac_rms( const goertzel_t *g ) {
+    if( g->frame_weight <= 0.0 )
+        return( 0.0 );
+
+    float mean = g->frame_sum / g->frame_weight;
+    float power = g->frame_sq / g->frame_weight - mean * mean;
+
+    return( ( power > 0.0 ) ? sqrtf( power ) : 0.0 );
+}
+
+void goertzel_next_block( goertzel_t *g ) {
+    if( g->len )
+        g->dc += g->sum / g->len;
+    g->sum = 0.0;
+    g->len = 0;
+}
@@ -0,0 +1,125 @@
+/**
+ * @file goertzel.h
+ * @brief Filtros de Goertzel para evaluar sólo las armónicas pedidas de un canal
+ *
+ * La armónica h de la frecuencia de red f se evalúa en w = 2*pi*h*f/fs, que no tiene que caer en
+ * un bin entero: con la frecuencia medida el filtro sigue a la red aunque el bloque no dure justo
+ * dos ciclos. El costo es de una multiplicación por muestra y por armónica, contra N*log(N) de la
+ * FFT completa. El estado se actualiza muestra por muestra, así lo puede alimentar cualquiera de
+ * los motores de measure.cpp, y se lee al final de cada bloque.
+ *
+ * Fuera de la frecuencia nominal un bloque no tiene un número entero de ciclos y la fundamental se
+ * derramaría sobre las demás armónicas. Por eso los resonadores no siguen a los bloques sino a cuadros
+ * de GOERTZEL_FRAME_CYCLES ciclos de la frecuencia medida, pesados con una ventana de Hann del largo
+ * del cuadro: cada armónica queda a GOERTZEL_FRAME_CYCLES bins de sus vecinas, justo en los ceros de
+ * la ventana, y el largo fraccionario del cuadro sólo corre la ventana dentro del bloque.
+ * goertzel_frame_window() arma los pesos y los comienzos de cuadro de cada bloque; el valor eficaz
+ * es el del último cuadro cerrado, dividido por la suma de sus pesos.
+ */
+#ifndef _GOERTZEL_H
+    #define _GOERTZEL_H
+
+    #include <stdint.h>
+
+    #define GOERTZEL_MAX_HARMONIC   15      /** @brief armónica más alta que se puede evaluar */
+    #define GOERTZEL_FRAME_CYCLES   2       /** @brief ciclos de red de un cuadro de los resonadores */
+
+    /**
+     * @brief coeficientes de una armónica
+     */
+    typedef struct {
+        float coef;                         /** @brief 2 * cos( w ) */
+    } goertzel_coef_t;
+    /**
+     * @brief estado de las armónicas de un canal
+     */
+    typedef struct {
+        float s1[ GOERTZEL_MAX_HARMONIC ];  /** @brief salida anterior del resonador de cada armónica */
+        float s2[ GOERTZEL_MAX_HARMONIC ];  /** @brief salida de hace dos muestras */
+        float weight;                       /** @brief suma de los pesos del cuadro en curso */
+        float weighted_sum;                 /** @brief suma de las entradas pesadas del cuadro en curso */
+        float weighted_sq;                  /** @brief suma de los cuadrados pesados del cuadro en curso */
+        float frame_s1[ GOERTZEL_MAX_HARMONIC ]; /** @brief s1 al cerrar el último cuadro */
+        float frame_s2[ GOERTZEL_MAX_HARMONIC ]; /** @brief s2 al cerrar el último cuadro */
+        float frame_weight;                 /** @brief suma de los pesos del último cuadro, 0 si no hay */
+        float frame_sum;                    /** @brief suma de las entradas pesadas del último cuadro */
+        float frame_sq;                     /** @brief suma de los cuadrados pesados del último cuadro */
+        bool framed;                        /** @brief el cuadro en curso empezó en su comienzo */
+        float dc;                           /** @brief continua del bloque anterior, se resta a la entrada */
+        float sum;                          /** @brief suma de las entradas sin continua del bloque */
+        int len;                            /** @brief muestras del bloque actual */
+    } goertzel_t;
+
+    /**
+     * @brief calcula los coeficientes de las armónicas 1 .. GOERTZEL_MAX_HARMONIC
+     *
+     * @param coef                  destino, coef[ h - 1 ] para la armónica h
+     * @param sample_rate           muestras por segundo del canal
+     * @param network_frequency     frecuencia fundamental en Hz
+     */
+    void goertzel_design( goertzel_coef_t *coef, float sample_rate, float network_frequency );
+    /**
+     * @brief calcula los pesos de Hann y los comienzos de cuadro de un bloque
+     *
+     * @param window        destino, un peso por muestra del bloque
+     * @param restart       destino, true en la muestra que empieza un cuadro
+     * @param len           muestras del bloque
+     * @param position      muestras del cuadro en curso antes del bloque, se actualiza
+     * @param frame_len     muestras de un cuadro, GOERTZEL_FRAME_CYCLES ciclos de la frecuencia medida
+     */
+    void goertzel_frame_window( float *window, bool *restart, int len, float *position, float frame_len );
+    /**
+     * @brief pone a cero el estado, incluida la continua
+     */
+    void goertzel_reset( goertzel_t *g );
+    /**
+     * @brief cierra el cuadro en curso y arranca el siguiente; el primero después de un reset se descarta
+     */
+    void goertzel_close_frame( goertzel_t *g );
+    /**
+     * @brief agrega una muestra a las armónicas seleccionadas
+     *
+     * @param g         estado del canal
+     * @param coef      coeficientes de goertzel_design()
+     * @param mask      armónicas a evaluar, bit h - 1 para la armónica h
+     * @param x         muestra
+     * @param w         peso de la ventana de goertzel_frame_window() para esta muestra
+     * @param restart   la muestra empieza un cuadro
+     */
+    static inline void goertzel_update( goertzel_t *g, const goertzel_coef_t *coef, uint16_t mask, float x, float w, bool restart ) {
+        if( restart )
+            goertzel_close_frame( g );
+        x -= g->dc;
+        float xw = x * w;
+        for( int h = 0 ; mask >> h ; h++ ) {
+            if( !( mask & ( 1 << h ) ) )
+                continue;
+            float s = xw + coef[ h ].coef * g->s1[ h ] - g->s2[ h ];
+            g->s2[ h ] = g->s1[ h ];
+            g->s1[ h ] = s;
+        }
+        g->weight += w;
+        g->weighted_sum += xw;
+        g->weighted_sq += xw * x;
+        g->sum += x;
+        g->len++;
+    }
+    /**
+     * @brief valor eficaz de una armónica en el último cuadro cerrado, en las unidades de la entrada
+     *
+     * @param g         estado del canal
+     * @param coef      coeficientes usados en el bloque
+     * @param h         armónica, 1 .. GOERTZEL_MAX_HARMONIC
+     * @return float    valor eficaz, 0 si todavía no se cerró ningún cuadro
+     */
+    float goertzel_rms( const goertzel_t *g, const goertzel_coef_t *coef, int h );
+    /**
+     * @brief valor eficaz de la parte alterna del último cuadro cerrado, con sus mismos pesos
+     */
+    float goertzel_ac_rms( const goertzel_t *g );
+    /**
+     * @brief cierra el bloque: guarda su continua y arranca el siguiente, el cuadro en curso sigue
+     */
+    void goertzel_next_block( goertzel_t *g );
+
+#endif // _GOERTZEL_H
@@ -0,0 +1,41 @@
+/**
+ * @file harmonic_groups.cpp
+ * @brief Grupos armónicos e interarmónicos de IEC 61000-4-7 a partir de una FFT sincronizada
+ */
+#include <math.h>
+#include "fft.h"
+#include "harmonic_groups.h"
+
+void harmonic_groups( const float *spectrum, int len, int cycles, int max_order, float scale, float *harmonic, float *interharmonic ) {
+    /**
+     * el valor eficaz de la componente del bin k es sqrt( 2 ) * |X[ k ]| / N, la continua |X[ 0 ]| / N
+     */
+    float gain = scale * scale * 2.0 / ( ( float )len * len );
+    int half = cycles / 2;
+    bool even = !( cycles & 1 );
+
+    if( max_order > HARMONIC_GROUPS_MAX_ORDER )
+        max_order = HARMONIC_GROUPS_MAX_ORDER;
+
+    harmonic[ 0 ] = sqrtf( fft_power( spectrum, len, 0 ) ) * fabs( scale ) / len;
+
+    for( int h = 0 ; h <= max_order ; h++ ) {
+        int k = cycles * h;
+        float sum = 0.0;
+
+        if( h > 0 ) {
+            for( int i = -half ; i <= half ; i++ ) {
+                if( k + i > len / 2 )
+                    break;
+                float power = fft_power( spectrum, len, k + i );
+                sum += ( even && ( i == half || i == -half ) ) ? 0.5 * power : power;
+            }
+            harmonic[ h ] = sqrtf( sum * gain );
+        }
+
+        sum = 0.0;
+        for( int i = 1 ; i < cycles && k + i <= len / 2 ; i++ )
+            sum += fft_power( spectrum, len, k + i );
+        interharmonic[ h ] = sqrtf( sum * gain );
+    }
+}
@@ -0,0 +1,30 @@
+/**
+ * @file harmonic_groups.h
+ * @brief Grupos armónicos e interarmónicos de IEC 61000-4-7 a partir de una FFT sincronizada
+ *
+ * La ventana tiene una cantidad entera de ciclos C (10 a 50 Hz, 12 a 60 Hz), así la armónica h cae
+ * en el bin C * h y los bins están separados 5 Hz. El grupo armónico suma la energía del bin de la
+ * armónica, de los C / 2 - 1 bins a cada lado y la mitad de los dos que quedan a C / 2; el grupo
+ * interarmónico suma los C - 1 bins entre dos armónicas.
+ */
+#ifndef _HARMONIC_GROUPS_H
+    #define _HARMONIC_GROUPS_H
+
+    #include <stdint.h>
+
+    #define HARMONIC_GROUPS_MAX_ORDER   50      /** @brief orden más alto que se puede pedir */
+
+    /**
+     * @brief calcula los grupos de una ventana
+     *
+     * @param spectrum          espectro empaquetado de fft_real()
+     * @param len               puntos de la FFT
+     * @param cycles            ciclos de red de la ventana
+     * @param max_order         orden más alto, hasta HARMONIC_GROUPS_MAX_ORDER
+     * @param scale             pasa de las unidades de la entrada de la FFT a las del canal
+     * @param harmonic          destino, valor eficaz del grupo h en harmonic[ h ], la continua en [ 0 ]
+     * @param interharmonic     destino, valor eficaz del grupo entre h y h + 1 en interharmonic[ h ]
+     */
+    void harmonic_groups( const float *spectrum, int len, int cycles, int max_order, float scale, float *harmonic, float *interharmonic );
+
+#endif // _HARMONIC_GROUPS_H
@@ -0,0 +1,83 @@
+/**
+ * @file resample.cpp
+ * @brief Remuestreo de una ventana periódica a una cantidad fija de puntos
+ */
+#include <math.h>
+#include "resample.h"
+
+#define RESAMPLE_HALF   ( RESAMPLE_TAPS / 2 )
+
+static float resample_coef[ RESAMPLE_PHASES + 1 ][ RESAMPLE_TAPS ];   /** @brief coeficiente t de la fase p, para la muestra t - RESAMPLE_HALF + 1 */
+static bool resample_ready = false;
+
+/**
+ * @brief función de Bessel modificada de orden 0, por su serie
+ */
+static double resample_i0( double x ) {
+    double sum = 1.0, term = 1.0;
+
+    for( int k = 1 ; term > 1e-12 * sum ; k++ ) {
+        term *= ( x / ( 2.0 * k ) ) * ( x / ( 2.0 * k ) );
+        sum += term;
+    }
+    return( sum );
+}
+
+void resample_init( void ) {
+    if( resample_ready )
+        return;
+
+    for( int p = 0 ; p <= RESAMPLE_PHASES ; p++ ) {
+        double sum = 0.0;
+
+        for( int t = 0 ; t < RESAMPLE_TAPS ; t++ ) {
+            double d = ( t - RESAMPLE_HALF + 1 ) - ( double )p / RESAMPLE_PHASES;
+            double r = d / RESAMPLE_HALF;
+            double w = resample_i0( RESAMPLE_BETA * sqrt( r < 1.0 && r > -1.0 ? 1.0 - r * r : 0.0 ) ) / resample_i0( RESAMPLE_BETA );
+            double s = ( d == 0.0 ) ? 1.0 : sin( M_PI * d ) / ( M_PI * d );
+
+            resample_coef[ p ][ t ] = s * w;
+            sum += s * w;
+        }
+        /**
+         * ganancia 1 en continua en todas las fases
+         */
+        for( int t = 0 ; t < RESAMPLE_TAPS ; t++ )
+            resample_coef[ p ][ t ] /= sum;
+    }
+    resample_ready = true;
+}
+
+void resample_window( const float *x, int len, float start, float period, float *y, int out_len ) {
+    float step = period / out_len;
+
+    for( int m = 0 ; m < out_len ; m++ ) {
+        /**
+         * posición en la entrada, sin redondeo acumulado; una negativa es del final de la ventana
+         */
+        float position = start + m * step;
+        if( position < 0.0 )
+            position += len;
+        int n = ( int )position;
+        float phase = ( position - n ) * RESAMPLE_PHASES;
+        int p = ( int )phase;
+        float a = phase - p;
+        const float *c0 = resample_coef[ p ];
+        const float *c1 = resample_coef[ p + 1 ];
+        float y0 = 0.0, y1 = 0.0;
+        int i = n - RESAMPLE_HALF + 1;
+
+        while( i < 0 )
+            i += len;
+        while( i >= len )
+            i -= len;
+        for( int t = 0 ; t < RESAMPLE_TAPS ; t++ ) {
+            float v = x[ i ];
+            y0 += c0[ t ] * v;
+            y1 += c1[ t ] * v;
+            if( ++i == len )
+                i = 0;
+        }
+        y[ m ] = y0 + a * ( y1 - y0 );
+    }
+}
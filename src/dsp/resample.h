@@ -0,0 +1,41 @@
+/**
+ * @file resample.h
+ * @brief Remuestreo de una ventana periódica a una cantidad fija de puntos
+ *
+ * Una ventana sincronizada con la red tiene la cantidad de muestras que den los ciclos medidos,
+ * pero la FFT necesita una longitud fija. La ventana se interpola con un sinc de RESAMPLE_TAPS
+ * coeficientes con ventana de Kaiser, tabulado en RESAMPLE_PHASES fases e interpolado linealmente
+ * entre fases. Como la ventana tiene ciclos enteros las muestras de los bordes se toman dando la
+ * vuelta. La respuesta es plana dentro del 0,5 % hasta 0,39 veces la tasa de entrada (la armónica
+ * 50 con 128 muestras por ciclo).
+ */
+#ifndef _RESAMPLE_H
+    #define _RESAMPLE_H
+
+    #include <stdint.h>
+
+    #define RESAMPLE_TAPS       16          /** @brief coeficientes por fase, la mitad a cada lado */
+    #define RESAMPLE_PHASES     32          /** @brief fases tabuladas entre dos muestras */
+    #define RESAMPLE_BETA       5.0         /** @brief parámetro de la ventana de Kaiser */
+
+    /**
+     * @brief calcula la tabla de coeficientes, hay que llamarla antes de resample_window()
+     */
+    void resample_init( void );
+    /**
+     * @brief remuestrea una ventana periódica
+     *
+     * La muestra de salida m cae en la posición start + m * period / out_len de la entrada. Los
+     * bordes de una ventana cortada en cruces por cero no caen en muestras enteras: start y period
+     * los ubican entre muestras, y len sólo dice cuántas hay para dar la vuelta.
+     *
+     * @param x         ventana de entrada
+     * @param len       muestras de la entrada, al menos RESAMPLE_TAPS
+     * @param start     posición de la primera muestra de salida, entre -1 y 0
+     * @param period    muestras de entrada que cubre la salida, a menos de una de len
+     * @param y         destino
+     * @param out_len   muestras de la salida
+     */
+    void resample_window( const float *x, int len, float start, float period, float *y, int out_len );
+
+#endif // _RESAMPLE_H
@@ -0,0 +1,64 @@
+/**
+ * @file sdft.cpp
+ * @brief DFT deslizante de un ciclo para seguir fasores muestra a muestra
+ */
+#include <math.h>
+#include <string.h>
+#include "sdft.h"
+
+static float sdft_cos[ SDFT_LEN ];     /** @brief cos( 2 pi m / SDFT_LEN ) para recalcular los bins */
+static float sdft_sin[ SDFT_LEN ];     /** @brief sin( 2 pi m / SDFT_LEN ) */
+
+void sdft_design( sdft_coef_t *coef ) {
+    for( int m = 0 ; m < SDFT_LEN ; m++ ) {
+        sdft_cos[ m ] = cos( 2.0 * M_PI * m / SDFT_LEN );
+        sdft_sin[ m ] = sin( 2.0 * M_PI * m / SDFT_LEN );
+    }
+
+    for( int h = 1 ; h <= SDFT_MAX_HARMONIC ; h++ ) {
+        coef->cos[ h - 1 ] = sdft_cos[ h % SDFT_LEN ];
+        coef->sin[ h - 1 ] = sdft_sin[ h % SDFT_LEN ];
+    }
+}
+
+void sdft_reset( sdft_t *s ) {
+    memset( s, 0, sizeof( sdft_t ) );
+}
+
+void sdft_anchor( sdft_t *s, uint16_t mask ) {
+    for( int h = 0 ; mask >> h ; h++ ) {
+        if( !( mask & ( 1 << h ) ) )
+            continue;
+        /**
+         * S = suma de x( n - m ) * e^( j 2 pi ( h + 1 ) m / N ), con x( n ) la muestra más nueva
+         */
+        float re = 0.0, im = 0.0;
+        int i = s->pos;
+
+        for( int m = 0 ; m < SDFT_LEN ; m++ ) {
+            int k = ( ( h + 1 ) * m ) % SDFT_LEN;
+
+            i = ( i == 0 ) ? SDFT_LEN - 1 : i - 1;
+            re += s->delay[ i ] * sdft_cos[ k ];
+            im += s->delay[ i ] * sdft_sin[ k ];
+        }
+        s->re[ h ] = re;
+        s->im[ h ] = im;
+    }
+}
+
+float sdft_rms( const sdft_t *s, int h ) {
+    if( h < 1 || h > SDFT_MAX_HARMONIC )
+        return( 0.0 );
+    /**
+     * |S| = N * A / 2 para una senoidal de amplitud A, el valor eficaz es A / sqrt( 2 )
+     */
+    return( sqrtf( 2.0 ) * sqrtf( s->re[ h - 1 ] * s->re[ h - 1 ] + s->im[ h - 1 ] * s->im[ h - 1 ] ) / SDFT_LEN );
+}
+
+float sdft_angle( const sdft_t *s, int h ) {
+    if( h < 1 || h > SDFT_MAX_HARMONIC )
+        return( 0.0 );
+
+    return( atan2f( s->im[ h - 1 ], s->re[ h - 1 ] ) );
+}
@@ -0,0 +1,91 @@
+/**
+ * @file sdft.h
+ * @brief DFT deslizante de un ciclo para seguir fasores muestra a muestra
+ *
+ * Cada bin k de una ventana de SDFT_LEN muestras (un ciclo nominal) se actualiza con una resta, una
+ * suma y un giro por muestra: S(n) = W * S(n-1) + x(n) - x(n-N) con W = e^( j 2 pi k / N ). El
+ * resultado es el fasor giratorio del último ciclo, que vuelve al mismo ángulo cada N muestras si la
+ * red está en la frecuencia nominal. Los errores de redondeo del giro se acumulan, así que de vez en
+ * cuando se recalculan los bins desde la línea de demora con sdft_anchor().
+ */
+#ifndef _SDFT_H
+    #define _SDFT_H
+
+    #include <stdint.h>
+
+    #define SDFT_LEN            128         /** @brief muestras de la ventana, un ciclo con 256 muestras cada dos */
+    #define SDFT_MAX_HARMONIC   15          /** @brief armónica más alta que se puede seguir */
+
+    /**
+     * @brief estado de un canal
+     */
+    typedef struct {
+        float delay[ SDFT_LEN ];            /** @brief últimas SDFT_LEN muestras, circular */
+        int pos;                            /** @brief posición de la muestra más vieja en delay */
+        float re[ SDFT_MAX_HARMONIC ];      /** @brief parte real del bin de cada armónica */
+        float im[ SDFT_MAX_HARMONIC ];      /** @brief parte imaginaria */
+    } sdft_t;
+    /**
+     * @brief giro por muestra de cada armónica
+     */
+    typedef struct {
+        float cos[ SDFT_MAX_HARMONIC ];     /** @brief cos( 2 pi h / SDFT_LEN ) */
+        float sin[ SDFT_MAX_HARMONIC ];     /** @brief sin( 2 pi h / SDFT_LEN ) */
+    } sdft_coef_t;
+
+    /**
+     * @brief calcula los giros de las armónicas 1 .. SDFT_MAX_HARMONIC
+     *
+     * @param coef      destino, [ h - 1 ] para la armónica h
+     */
+    void sdft_design( sdft_coef_t *coef );
+    /**
+     * @brief pone a cero la línea de demora y los bins
+     */
+    void sdft_reset( sdft_t *s );
+    /**
+     * @brief agrega una muestra y actualiza los bins seleccionados
+     *
+     * @param s         estado del canal
+     * @param coef      giros de sdft_design()
+     * @param mask      armónicas a seguir, bit h - 1 para la armónica h
+     * @param x         muestra
+     */
+    static inline void sdft_update( sdft_t *s, const sdft_coef_t *coef, uint16_t mask, float x ) {
+        float d = x - s->delay[ s->pos ];
+
+        s->delay[ s->pos ] = x;
+        if( ++s->pos == SDFT_LEN )
+            s->pos = 0;
+
+        for( int h = 0 ; mask >> h ; h++ ) {
+            if( !( mask & ( 1 << h ) ) )
+                continue;
+            float re = s->re[ h ], im = s->im[ h ];
+            s->re[ h ] = re * coef->cos[ h ] - im * coef->sin[ h ] + d;
+            s->im[ h ] = re * coef->sin[ h ] + im * coef->cos[ h ];
+        }
+    }
+    /**
+     * @brief recalcula los bins seleccionados desde la línea de demora, descarta el error acumulado
+     *
+     * @param s         estado del canal
+     * @param mask      armónicas a recalcular
+     */
+    void sdft_anchor( sdft_t *s, uint16_t mask );
+    /**
+     * @brief valor eficaz de una armónica en las unidades de la entrada
+     *
+     * @param s         estado del canal
+     * @param h         armónica, 1 .. SDFT_MAX_HARMONIC
+     */
+    float sdft_rms( const sdft_t *s, int h );
+    /**
+     * @brief fase de una armónica en radianes en la última muestra agregada
+     *
+     * @param s         estado del canal
+     * @param h         armónica, 1 .. SDFT_MAX_HARMONIC
+     */
+    float sdft_angle( const sdft_t *s, int h );
+
+#endif // _SDFT_H
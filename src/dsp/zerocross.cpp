@@ -0,0 +1,85 @@
+/**
+ * @file zerocross.cpp
+ * @brief Detector de cruces por cero ascendentes con histéresis
+ */
+#include <string.h>
+#include "zerocross.h"
+
+void zerocross_reset( zerocross_t *zc ) {
+    memset( zc, 0, sizeof( zerocross_t ) );
+}
+
+int zerocross_find( zerocross_t *zc, const float *x, int len, float *pos, int max ) {
+    float sum = 0.0, min = x[ 0 ], max_value = x[ 0 ];
+    int found = 0;
+    int cycles = 0;
+
+    if( zc->valid && zc->amplitude >= ZEROCROSS_MIN_AMPLITUDE ) {
+        float hysteresis = zc->amplitude * ZEROCROSS_HYSTERESIS;
+
+        for( int n = 0 ; n < len ; n++ ) {
+            float value = x[ n ] - zc->dc;
+            bool crossed = false;
+
+            if( value < -hysteresis )
+                zc->armed = true;
+            else if( zc->armed && value >= 0.0 && zc->last < 0.0 ) {
+                zc->armed = false;
+                if( found < max )
+                    pos[ found++ ] = n - value / ( value - zc->last );
+                /**
+                 * cierra el ciclo que empezó en el cruce anterior; las muestras de los bordes
+                 * están cerca de la continua, así que cortar en muestras enteras casi no la mueve
+                 */
+                if( zc->cycle_len ) {
+                    zc->dc += ( zc->cycle_sum / zc->cycle_len - zc->dc ) * 0.25;
+                    cycles++;
+                }
+                zc->cycle_sum = 0.0;
+                zc->cycle_len = 0;
+                crossed = true;
+                value = x[ n ] - zc->dc;
+            }
+            zc->last = value;
+            /**
+             * la muestra del cruce abre el ciclo siguiente; uno más largo que lo que entra en
+             * cycle_len no es de la red y espera al próximo cruce
+             */
+            if( crossed || ( zc->cycle_len && zc->cycle_len < UINT16_MAX ) ) {
+                zc->cycle_sum += x[ n ];
+                zc->cycle_len++;
+            }
+            else
+                zc->cycle_len = 0;
+        }
+    }
+    else {
+        zc->armed = false;
+        zc->cycle_sum = 0.0;
+        zc->cycle_len = 0;
+    }
+    /**
+     * actualiza continua y amplitud con este bloque para el siguiente
+     */
+    for( int n = 0 ; n < len ; n++ ) {
+        sum += x[ n ];
+        if( x[ n ] < min )
+            min = x[ n ];
+        if( x[ n ] > max_value )
+            max_value = x[ n ];
+    }
+
+    if( zc->valid ) {
+        if( !cycles )
+            zc->dc += ( sum / len - zc->dc ) * 0.25;
+        zc->amplitude += ( ( max_value - min ) / 2.0 - zc->amplitude ) * 0.25;
+    }
+    else {
+        zc->dc = sum / len;
+        zc->amplitude = ( max_value - min ) / 2.0;
+        zc->last = x[ len - 1 ] - zc->dc;
+        zc->valid = true;
+    }
+
+    return( found );
+}
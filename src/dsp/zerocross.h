@@ -0,0 +1,51 @@
+/**
+ * @file zerocross.h
+ * @brief Detector de cruces por cero ascendentes con histéresis
+ *
+ * Trabaja sobre las muestras crudas del ADC de un canal de tensión: estima la continua con el
+ * promedio de los ciclos entre cruces, o del bloque mientras no hay ciclos completos, y sólo acepta
+ * un cruce ascendente después de que la señal bajó de -histéresis, así el ruido y las armónicas
+ * cerca de cero no generan cruces dobles. La histéresis es una fracción de la amplitud medida en
+ * el bloque anterior. Fuera de la frecuencia nominal el bloque no tiene ciclos enteros y su
+ * promedio oscila con la fase; el de un ciclo no.
+ */
+#ifndef _ZEROCROSS_H
+    #define _ZEROCROSS_H
+
+    #include <stdint.h>
+
+    #define ZEROCROSS_MIN_AMPLITUDE     20.0    /** @brief amplitud mínima en cuentas para buscar cruces */
+    #define ZEROCROSS_HYSTERESIS        0.1     /** @brief histéresis como fracción de la amplitud */
+
+    /**
+     * @brief estado del detector
+     */
+    typedef struct {
+        float dc;                           /** @brief continua estimada en cuentas */
+        float amplitude;                    /** @brief amplitud pico estimada en cuentas */
+        float last;                         /** @brief última muestra sin continua */
+        bool armed;                         /** @brief la señal bajó de -histéresis desde el último cruce */
+        bool valid;                         /** @brief dc y amplitude ya tienen un bloque medido */
+        float cycle_sum;                    /** @brief suma de las muestras desde el último cruce */
+        uint16_t cycle_len;                 /** @brief muestras sumadas en cycle_sum, 0 antes del primer cruce */
+    } zerocross_t;
+
+    /**
+     * @brief pone el detector en su estado inicial
+     */
+    void zerocross_reset( zerocross_t *zc );
+    /**
+     * @brief busca los cruces ascendentes de un bloque
+     *
+     * @param zc        estado del detector, se mantiene entre bloques
+     * @param x         muestras del bloque
+     * @param len       cantidad de muestras
+     * @param pos       posiciones de los cruces interpoladas linealmente entre la última muestra
+     *                  negativa y la primera >= 0, que es ceil( pos ); puede ser negativa si el
+     *                  cruce quedó entre el bloque anterior y éste
+     * @param max       tamaño de pos
+     * @return int      cantidad de cruces encontrados
+     */
+    int zerocross_find( zerocross_t *zc, const float *x, int len, float *pos, int max );
+
+#endif // _ZEROCROSS_H
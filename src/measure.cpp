@@ -1,9 +1,28 @@
 
 #include <FreeRTOS.h>
 #include <driver/i2s.h>
-#include <arduinoFFT.h>
+#include <esp_timer.h>
+#include <esp_adc_cal.h>
 #include <math.h>
+#include <FS.h>
+#include <SPIFFS.h>
+#include <esp_attr.h>
+#include <rom/crc.h>
 #include "config/measure_config.h"
+#include "dsp/dsp_kernels.h"
+#include "dsp/fixed_point.h"
+#include "dsp/filter.h"
+#include "dsp/zerocross.h"
+#include "dsp/freqtrack.h"
+#include "dsp/goertzel.h"
+#include "dsp/fft.h"
+#include "dsp/resample.h"
+#include "dsp/harmonic_groups.h"
+#include "dsp/sdft.h"
+#include "dsp/fracdelay.h"
+#include "dsp/adccal.h"
+#include "dsp/decimator.h"
+#include "utils/spsc_ring.h"
 #include "measure.h"
 #include "config.h"
 extern "C"
@@ -19,20 +38,66 @@ measure_config_t measure_config;
  *
  * Por ejemplo: canal 5 mapea a canal virtual 0, 6 a 1 y 7 a 2
  */
+#if MEASURE_PROFILE == MEASURE_PROFILE_1P
+int8_t channelmapping[MAX_ADC_CHANNELS] = {CHANNEL_NOP, CHANNEL_NOP, CHANNEL_NOP, CHANNEL_NOP, CHANNEL_NOP, CHANNEL_0, CHANNEL_1, CHANNEL_NOP};
+static const uint8_t adc_pattern[VIRTUAL_ADC_CHANNELS] = {5, 6}; // Canales físicos en el orden en que los convierte el ADC SAR
+#elif MEASURE_PROFILE == MEASURE_PROFILE_3PN
+int8_t channelmapping[MAX_ADC_CHANNELS] = {CHANNEL_3, CHANNEL_6, CHANNEL_NOP, CHANNEL_4, CHANNEL_5, CHANNEL_0, CHANNEL_1, CHANNEL_2};
+static const uint8_t adc_pattern[VIRTUAL_ADC_CHANNELS] = {0, 3, 4, 5, 6, 7, 1}; // Canales físicos en el orden en que los convierte el ADC SAR
+#else
 int8_t channelmapping[MAX_ADC_CHANNELS] = {CHANNEL_3, CHANNEL_NOP, CHANNEL_NOP, CHANNEL_4, CHANNEL_5, CHANNEL_0, CHANNEL_1, CHANNEL_2};
 /*Mapea los canales de ADC para contar las cantidad de canales y si no se desea incluir
 entonces se utiliza el CHANNEL_NOP, por lo cual se usa el canal 3,4,5,0,1 y 2*/
+static const uint8_t adc_pattern[VIRTUAL_ADC_CHANNELS] = {0, 3, 4, 5, 6, 7}; // Canales físicos en el orden en que los convierte el ADC SAR
+#endif
+static_assert(VIRTUAL_CHANNELS <= CHANNEL_END, "los operandos de los opcodes direccionan a lo sumo CHANNEL_END canales");
+static_assert(VIRTUAL_ADC_CHANNELS <= MAX_ADC_CHANNELS, "el patrón del ADC SAR tiene a lo sumo MAX_ADC_CHANNELS lugares");
+static uint16_t adc_calibration_lut[ADCCAL_CODES];               // Código corregido de cada código crudo del ADC
+static adccal_point_t adc_calibration_point[ADCCAL_MAX_POINTS]; // Puntos del barrido de calibración del usuario
+static int adc_calibration_points = 0;                          // Cantidad de puntos del barrido
+static const float adc_scale = 1.0 / (1 << ADCCAL_FRACTION_BITS); // Códigos por unidad de las muestras separadas por canal
+static int adc_oversampling = 1;                                // Factor de sobremuestreo en uso, se fija al iniciar
+static decimator_design_t adc_decimator_design;                 // FIR del diezmado, compartido por los canales
+static decimator_t adc_decimator[VIRTUAL_ADC_CHANNELS + 1];     // Historia del diezmado de cada canal del ADC, más el descarte
+static int8_t adc_word_channel[16];                             // Fila de adc_samples de cada canal físico de la palabra del I2S, VIRTUAL_ADC_CHANNELS descarta
+static uint16_t *adc_words = NULL;                              // Palabras crudas del I2S de un bloque, VIRTUAL_ADC_CHANNELS * numbersOfSamples * adc_oversampling
+static measure_acquisition_stats_t acquisition_stats;           // Costo de la adquisición
+// Bloque separado por canal que la tarea de adquisición le pasa a la de medición
+typedef struct
+{
+    uint16_t adc_samples[VIRTUAL_ADC_CHANNELS + 1][numbersOfSamples]; // Códigos con ADCCAL_FRACTION_BITS bits fraccionarios, la última fila es el descarte
+    uint32_t sequence;                                                // Número de bloque leído, avanza aunque el bloque no entre en la cola
+    int64_t timestamp_us;                                             // Fin de la lectura en esp_timer_get_time()
+    bool rate_changed;                                                // Primer bloque después de cambiar la tasa del I2S
+} measure_block_t;
+static spsc_ring_t<measure_block_t, MEASURE_RING_BLOCKS> block_ring; // Bloques leídos y todavía no procesados
+static measure_block_t block_overflow;                          // Destino de la lectura cuando la cola está llena, se descarta
+static uint32_t block_sequence = 0;                             // Último bloque procesado por la tarea de medición
+#define MEASURE_ADC_HEAD 32                                      // Muestras del bloque anterior delante de cada fila de adc_extended
+#define MEASURE_ADC_TAIL (numbersOfSamples + FRACDELAY_TAPS)     // Continuación detrás del bloque: el mayor desfase más la interpolación
+#define MEASURE_ADC_ROW (MEASURE_ADC_HEAD + numbersOfSamples + MEASURE_ADC_TAIL)
+static uint16_t adc_extended[VIRTUAL_ADC_CHANNELS][MEASURE_ADC_ROW]; // Bloque en proceso con lo que GET_ADC lee antes y después de él
+static volatile uint32_t i2s_rate_request = 0;                  // Pedidos de cambio de tasa, la tarea de adquisición los aplica entre bloques
 // Estructura para conexión global de armónicos
-HarmonicData harmonic_values[VIRTUAL_CHANNELS]; // Definición del array global
+static HarmonicData harmonic_values[VIRTUAL_CHANNELS]; // Armónicas del último bloque, sólo para la tarea de medición
 
 /* Estructura que configura L1, L2, L3 según la cantidad máxima de grupos (MAX_GROUPS)*/
+#if MEASURE_PROFILE == MEASURE_PROFILE_1P
+struct groupconfig groupconfig[MAX_GROUPS] = {
+    {"L1", true}};
+#else
 struct groupconfig groupconfig[MAX_GROUPS] = {
     {"L1", true}, // Por default inicia con L1 como activo y los demás desactivados
     {"L2", true},
     {"L3", true},
     {"all power", false},
+#if MEASURE_PROFILE == MEASURE_PROFILE_3PN
+    {"N", true},
+#else
     {"unused", false},
+#endif
     {"unused", false}};
+#endif
 /*
  * Se define los tipos de canales virtuales, estos serán como canales ADC sólo que físicamente van a haber 6 canales, 3 de tensión y 3 de corriente, lo demás
     (potencia, potencia reactiva) saldrán de cálculos a partir de estos 6 canales físicos.
@@ -49,52 +114,476 @@ struct groupconfig groupconfig[MAX_GROUPS] = {
         int             report_exp;                         El exponente que lo conforma
         int             group_id;                           ID del grupo de salida que lo conforma
         float           sign;                               Signo del canal en potencia reactiva
-        uint8_t         operation[ MAX_MICROCODE_OPS ];     Secuencia del opcode
+        uint16_t        harmonics;                          Armónicas a evaluar (bit h-1 para la armónica h)
+        float           phase_correction;                   Corrección fina de fase en grados, 0 si se omite
 
     "Nombre del canal"      , tipo del canal    , desfasamiento en fase, factor de amplificación, desplazamiento en DC,
  */
 
 struct channelconfig channelconfig[VIRTUAL_CHANNELS] = {
-    {"L1 Corriente", AC_CURRENT, 0, 0.084, 0.0, 0.0, false, 0.0, 0, 0, 0.0, GET_ADC | CHANNEL_0, FILTER | 0, BRK, BRK, BRK, BRK, BRK, BRK, BRK, BRK},
-    {"L1 Tensión", AC_VOLTAGE, 30, 1.3, 0.0, 0.0, false, 0.0, 0, 0, 0.0, GET_ADC | CHANNEL_1, FILTER | 0, BRK, BRK, BRK, BRK, BRK, BRK, BRK, BRK},
-    {"L1 Potencia", AC_POWER, 0, 1.0, 0.0, 0.0, false, 0.0, 3, 0, 0.0, SET_TO | 1, MUL | CHANNEL_0, MUL | CHANNEL_1, MUL_RATIO | CHANNEL_0, MUL_RATIO | CHANNEL_1, ABS, BRK, BRK, BRK, BRK},
-    {"L1 Potencia Reactiva", AC_REACTIVE_POWER, 0, 1.0, 0.0, 0.0, false, 0.0, 3, 0, 0.0, SET_TO | 1, MUL | CHANNEL_0, MUL | CHANNEL_1, MUL_RATIO | CHANNEL_0, MUL_RATIO | CHANNEL_1, PASS_NEGATIVE, MUL_REACTIVE | CHANNEL_1, ABS, NEG, BRK},
-    {"L2 Corriente", AC_CURRENT, 0, 0.115, 0.0, 0.0, false, 0.0, 0, 1, 0.0, GET_ADC | CHANNEL_5, FILTER | 0, BRK, BRK, BRK, BRK, BRK, BRK, BRK, BRK},
-    {"L2 Tensión", AC_VOLTAGE, 30, 0.63, 0.0, 0.0, false, 0.0, 0, 1, 0.0, GET_ADC | CHANNEL_4, FILTER | 0, BRK, BRK, BRK, BRK, BRK, BRK, BRK, BRK},
-    {"L2 Potencia", AC_POWER, 0, 1.0, 0.0, 0.0, false, 0.0, 3, 1, 0.0, SET_TO | 1, MUL | CHANNEL_5, MUL | CHANNEL_4, MUL_RATIO | CHANNEL_5, MUL_RATIO | CHANNEL_4, ABS, BRK, BRK, BRK, BRK},
-    {"L2 Potencia Reactiva", AC_REACTIVE_POWER, 0, 1.0, 0.0, 0.0, false, 0.0, 3, 1, 0.0, SET_TO | 1, MUL | CHANNEL_5, MUL | CHANNEL_4, MUL_RATIO | CHANNEL_5, MUL_RATIO | CHANNEL_4, PASS_NEGATIVE, MUL_REACTIVE | CHANNEL_4, ABS, NEG, BRK},
-    {"L3 Corriente", AC_CURRENT, 0, 0.082, 0.0, 0.0, false, 0.0, 0, 2, 0.0, GET_ADC | CHANNEL_2, FILTER | 0, BRK, BRK, BRK, BRK, BRK, BRK, BRK, BRK},
-    {"L3 Tensión", AC_VOLTAGE, 30, 0.63, 0.0, 0.0, false, 0.0, 0, 2, 0.0, GET_ADC | CHANNEL_3, FILTER | 0, BRK, BRK, BRK, BRK, BRK, BRK, BRK, BRK},
-    {"L3 Potencia", AC_POWER, 0, 1.0, 0.0, 0.0, false, 0.0, 3, 2, 0.0, SET_TO | 1, MUL | CHANNEL_2, MUL | CHANNEL_3, MUL_RATIO | CHANNEL_2, MUL_RATIO | CHANNEL_3, ABS, BRK, BRK, BRK, BRK},
-    {"L3 Potencia Reactiva", AC_REACTIVE_POWER, 0, 1.0, 0.0, 0.0, false, 0.0, 3, 2, 0.0, SET_TO | 1, MUL | CHANNEL_2, MUL | CHANNEL_3, MUL_RATIO | CHANNEL_2, MUL_RATIO | CHANNEL_3, PASS_NEGATIVE, MUL_REACTIVE | CHANNEL_3, ABS, NEG, BRK},
-    {"Todas las Potencias", AC_POWER, 0, 1.0, 0.0, 0.0, false, 0.0, 3, 3, 0.0, SET_TO | 0, ADD | CHANNEL_0, ADD | CHANNEL_4, ADD | CHANNEL_2, BRK, BRK, BRK, BRK, BRK, BRK}
+    {"L1 Corriente", AC_CURRENT, 0, 0.084, 0.0, 0.0, false, 0.0, 0, 0, 0.0, MEASURE_HARMONICS_DEFAULT},
+    {"L1 Tensión", AC_VOLTAGE, 30, 1.3, 0.0, 0.0, false, 0.0, 0, 0, 0.0, MEASURE_HARMONICS_DEFAULT},
+    {"L1 Potencia", AC_POWER, 0, 1.0, 0.0, 0.0, false, 0.0, 3, 0, 0.0},
+    {"L1 Potencia Reactiva", AC_REACTIVE_POWER, 0, 1.0, 0.0, 0.0, false, 0.0, 3, 0, 0.0},
+#if MEASURE_PROFILE != MEASURE_PROFILE_1P
+    {"L2 Corriente", AC_CURRENT, 0, 0.115, 0.0, 0.0, false, 0.0, 0, 1, 0.0, MEASURE_HARMONICS_DEFAULT},
+    {"L2 Tensión", AC_VOLTAGE, 30, 0.63, 0.0, 0.0, false, 0.0, 0, 1, 0.0, MEASURE_HARMONICS_DEFAULT},
+    {"L2 Potencia", AC_POWER, 0, 1.0, 0.0, 0.0, false, 0.0, 3, 1, 0.0},
+    {"L2 Potencia Reactiva", AC_REACTIVE_POWER, 0, 1.0, 0.0, 0.0, false, 0.0, 3, 1, 0.0},
+    {"L3 Corriente", AC_CURRENT, 0, 0.082, 0.0, 0.0, false, 0.0, 0, 2, 0.0, MEASURE_HARMONICS_DEFAULT},
+    {"L3 Tensión", AC_VOLTAGE, 30, 0.63, 0.0, 0.0, false, 0.0, 0, 2, 0.0, MEASURE_HARMONICS_DEFAULT},
+    {"L3 Potencia", AC_POWER, 0, 1.0, 0.0, 0.0, false, 0.0, 3, 2, 0.0},
+    {"L3 Potencia Reactiva", AC_REACTIVE_POWER, 0, 1.0, 0.0, 0.0, false, 0.0, 3, 2, 0.0},
+    {"Todas las Potencias", AC_POWER, 0, 1.0, 0.0, 0.0, false, 0.0, 3, 3, 0.0},
+#endif
+#if MEASURE_PROFILE == MEASURE_PROFILE_3PN
+    {"N Corriente", AC_CURRENT, 0, 0.084, 0.0, 0.0, false, 0.0, 0, 4, 0.0, MEASURE_HARMONICS_DEFAULT},
+#endif
 
     // Cambio L1 current de 0,025989 a 0,06 al igual que L2 y L3.
     // La relación de voltaje se deja igual hasta que se encuentre el valor de calibración correcto.
-    // Potencia Reactivo Multiplica V1*I1*(ratioV1)*(ratioI1)*(deja pasar lo negativo)*(obtiene el signo del reactivo de V1)*(módulo)*(lo cambia de signo)
-    // Potencia Activa V1*I1*(ratioV1)*(ratioI1)*(módulo)
+    // Potencia Reactiva I1*(V1 retardada un cuarto de ciclo)*(ratioI1)*(ratioV1), positiva con carga inductiva
+    // Potencia Activa V1*I1*(ratioV1)*(ratioI1), con signo: negativa cuando se exporta
+};
+
+/**
+ * @brief lugar del programa de un canal en program_arena
+ */
+typedef struct
+{
+    uint16_t offset; /** @brief primer byte */
+    uint8_t len;     /** @brief bytes, sin los BRK del final */
+} channel_program_t;
+
+// Programas de todos los canales uno detrás del otro, los setters los vuelven a empaquetar.
+static uint8_t program_arena[MEASURE_PROGRAM_ARENA] = {
+    GET_ADC | CHANNEL_0, FILTER | 0,                                                                                    // L1 Corriente
+    GET_ADC | CHANNEL_1, FILTER | 0,                                                                                    // L1 Tensión
+    SET_TO | 1, MUL | CHANNEL_0, MUL | CHANNEL_1, MUL_RATIO | CHANNEL_0, MUL_RATIO | CHANNEL_1,                          // L1 Potencia
+    SET_TO | 1, MUL | CHANNEL_0, MUL_QUADRATURE | CHANNEL_1, MUL_RATIO | CHANNEL_0, MUL_RATIO | CHANNEL_1,               // L1 Potencia Reactiva
+#if MEASURE_PROFILE != MEASURE_PROFILE_1P
+    GET_ADC | CHANNEL_5, FILTER | 0,                                                                                    // L2 Corriente
+    GET_ADC | CHANNEL_4, FILTER | 0,                                                                                    // L2 Tensión
+    SET_TO | 1, MUL | CHANNEL_5, MUL | CHANNEL_4, MUL_RATIO | CHANNEL_5, MUL_RATIO | CHANNEL_4,                          // L2 Potencia
+    SET_TO | 1, MUL | CHANNEL_4, MUL_QUADRATURE | CHANNEL_5, MUL_RATIO | CHANNEL_4, MUL_RATIO | CHANNEL_5,               // L2 Potencia Reactiva
+    GET_ADC | CHANNEL_2, FILTER | 0,                                                                                    // L3 Corriente
+    GET_ADC | CHANNEL_3, FILTER | 0,                                                                                    // L3 Tensión
+    SET_TO | 1, MUL | CHANNEL_8, MUL | CHANNEL_9, MUL_RATIO | CHANNEL_8, MUL_RATIO | CHANNEL_9,                          // L3 Potencia
+    SET_TO | 1, MUL | CHANNEL_8, MUL_QUADRATURE | CHANNEL_9, MUL_RATIO | CHANNEL_8, MUL_RATIO | CHANNEL_9,               // L3 Potencia Reactiva
+    SET_TO | 0, ADD | CHANNEL_2, ADD | CHANNEL_6, ADD | CHANNEL_10,                                                     // Todas las Potencias
+#endif
+#if MEASURE_PROFILE == MEASURE_PROFILE_3PN
+    GET_ADC | CHANNEL_6, FILTER | 0,                                                                                    // N Corriente
+#endif
 };
+#if MEASURE_PROFILE == MEASURE_PROFILE_1P
+static channel_program_t channel_program[VIRTUAL_CHANNELS] = {{0, 2}, {2, 2}, {4, 5}, {9, 5}};
+#elif MEASURE_PROFILE == MEASURE_PROFILE_3PN
+static channel_program_t channel_program[VIRTUAL_CHANNELS] = {{0, 2}, {2, 2}, {4, 5}, {9, 5}, {14, 2}, {16, 2}, {18, 5}, {23, 5}, {28, 2}, {30, 2}, {32, 5}, {37, 5}, {42, 4}, {46, 2}};
+#else
+static channel_program_t channel_program[VIRTUAL_CHANNELS] = {{0, 2}, {2, 2}, {4, 5}, {9, 5}, {14, 2}, {16, 2}, {18, 5}, {23, 5}, {28, 2}, {30, 2}, {32, 5}, {37, 5}, {42, 4}};
+#endif
+
+/**
+ * @brief operación de microcódigo ya decodificada
+ */
+typedef struct
+{
+    uint8_t opcode;   /** @brief opcode sin el operando (valor & OPMASK), NOP para los opcodes extendidos */
+    uint8_t operand;  /** @brief canal u operando ya validado, el opcode extendido si opcode es NOP */
+    uint8_t argument; /** @brief argumento ya validado del opcode extendido */
+} compiled_op_t;
+
+/**
+ * @brief plan de ejecución precompilado de un canal
+ *
+ * Se genera con measure_compile_channel() cada vez que cambia la secuencia de opcodes.
+ * Contiene sólo las operaciones que realmente tienen efecto: los NOP, los operandos fuera
+ * de rango y todo lo que sigue al primer BRK ya fueron descartados. Los opcodes extendidos
+ * quedan como un NOP con el opcode en operand y su argumento en argument.
+ */
+typedef struct
+{
+    uint8_t len;                             /** @brief cantidad de operaciones válidas */
+    compiled_op_t op[MEASURE_PROGRAM_MAX];   /** @brief operaciones decodificadas */
+} channel_plan_t;
+
+static channel_plan_t channel_plan[VIRTUAL_CHANNELS]; // Planes de ejecución por canal virtual, copia de la tarea de medición
+
+/**
+ * @brief desplazamientos de índice precalculados para el desfase de un canal
+ *
+ * GET_ADC lee la muestra n + offset_0 de adc_extended, que sigue más allá del final del bloque;
+ * MUL_REACTIVE lee n + offset_90 del buffer, restando numbersOfSamples si se pasa del final. La
+ * parte fraccionaria (corrección de fase del canal y desfasaje del ADC) la agrega GET_ADC
+ * interpolando alrededor de ese índice. Se recalculan sólo cuando cambia el desfase, la corrección
+ * o el programa del canal.
+ */
+typedef struct
+{
+    uint16_t offset_0;  /** @brief desplazamiento para el desfase configurado (0°) */
+    uint16_t offset_90; /** @brief desplazamiento para el desfase configurado + 90° */
+    bool fractional;    /** @brief GET_ADC interpola con fraction */
+    fracdelay_t fraction; /** @brief adelanto fraccionario de GET_ADC en muestras, leído hacia adelante */
+#ifdef MEASURE_FIXED_POINT
+    int32_t coef[FRACDELAY_TAPS]; /** @brief coeficientes de fraction en Q31 */
+#endif
+} channel_phase_t;
+
+static channel_phase_t channel_phase[VIRTUAL_CHANNELS]; // Desplazamientos de fase por canal virtual, copia de la tarea de medición
+
+/**
+ * @brief orden de evaluación de los canales
+ *
+ * Lo arma measure_schedule_channels() con el grafo de dependencias de los planes. Sólo incluye los
+ * canales vivos: los que tienen tipo y los que alguno de ellos lee, directa o indirectamente.
+ */
+typedef struct
+{
+    uint8_t order[VIRTUAL_CHANNELS]; /** @brief canales vivos, cada uno después de los canales que lee */
+    uint8_t len;                     /** @brief cantidad de canales vivos */
+    uint32_t live;                   /** @brief canales vivos, un bit por canal */
+    bool block;                      /** @brief los motores de bloques y de punto fijo pueden reproducir al de muestras */
+    bool extended;                   /** @brief algún canal vivo usa opcodes extendidos, que sólo ejecuta el motor por muestras */
+} channel_schedule_t;
+
+static channel_schedule_t channel_schedule;                // Orden de evaluación de los canales en todos los motores, copia de la tarea de medición
+static bool channel_programs_loading = false;              // Se está cargando la configuración, measure_init() arma el orden al terminar
+
+/**
+ * @brief todo lo que los motores leen de los programas y desfases compilados
+ *
+ * Los setters lo arman en program_stage desde la tarea que los llame y measure_update_program() lo
+ * copia a channel_plan, channel_phase, channel_schedule y quadrature_sources en la tarea de medición,
+ * entre bloques. Así ningún motor ve un plan o un desfase a medio escribir.
+ */
+typedef struct
+{
+    channel_plan_t plan[VIRTUAL_CHANNELS];     /** @brief planes de ejecución */
+    channel_phase_t phase[VIRTUAL_CHANNELS];   /** @brief desplazamientos de fase */
+    channel_schedule_t schedule;               /** @brief orden de evaluación */
+    uint32_t quadrature_sources;               /** @brief canales operando de algún MUL_QUADRATURE */
+    uint8_t generation[VIRTUAL_CHANNELS];      /** @brief programas compilados por canal, los registros se limpian al cambiar */
+} measure_program_t;
+
+static measure_program_t program_stage;            // Programas compilados por los setters, sólo se leen con program_sequence
+static uint32_t program_sequence = 0;              // Seqlock de program_stage: impar mientras un setter lo escribe
+static int program_writing = 0;                    // Anidamiento de measure_program_begin() en la tarea que escribe
+
+/**
+ * @brief Abre la escritura de program_stage; las llamadas se pueden anidar.
+ */
+static void measure_program_begin(void)
+{
+    if (program_writing++ == 0)
+        __atomic_add_fetch(&program_sequence, 1, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Cierra la escritura de program_stage; la tarea de medición lo toma antes del próximo bloque.
+ */
+static void measure_program_end(void)
+{
+    if (--program_writing == 0)
+        __atomic_add_fetch(&program_sequence, 1, __ATOMIC_SEQ_CST);
+}
+static float (*block_sample)[numbersOfSamples] = NULL;     // Muestras procesadas por canal, se reserva al usar el motor de bloques
+
+/**
+ * @brief canales que recorren los motores en cada bloque
+ *
+ * La arma measure_update_work() en la tarea de medición, entre bloques, a partir de channel_schedule
+ * y de los grupos activos. Los canales vivos de un grupo inactivo quedan afuera de order junto con
+ * los muertos: se ponen en neutro una sola vez, al rearmar la lista, y ningún motor vuelve a tocarlos.
+ */
+typedef struct
+{
+    uint8_t order[VIRTUAL_CHANNELS]; /** @brief canales a procesar, en el orden de channel_schedule */
+    uint8_t len;                     /** @brief cantidad de canales a procesar */
+    uint32_t idle;                   /** @brief canales en neutro, un bit por canal */
+} channel_work_t;
+
+static channel_work_t channel_work;                        // Canales que procesan los motores, sólo para la tarea de medición
+static volatile uint32_t channel_work_request = 0;         // Pedidos de rearmar channel_work, la tarea de medición los aplica entre bloques
+
+/**
+ * @brief Pide rearmar channel_work antes del próximo bloque.
+ *
+ * Se llama desde cualquier tarea al cambiar el orden de los canales, el tipo o el grupo de un canal
+ * o el estado de un grupo.
+ */
+static void measure_request_work(void)
+{
+    __atomic_add_fetch(&channel_work_request, 1, __ATOMIC_RELEASE);
+}
+
+#define MEASURE_QUADRATURE_LEN 64 // Muestras de historia por canal para MUL_QUADRATURE, potencia de 2 mayor a un cuarto de ciclo a 27 Hz
+
+static fracdelay_t quadrature_delay;     // Cuarto de ciclo de la frecuencia medida, se recalcula en cada bloque
+static uint32_t quadrature_sources = 0;  // Canales que son operando de algún MUL_QUADRATURE, un bit por canal
+static uint32_t quadrature_pos = 0;      // Posición de la muestra actual en quadrature_history, cuenta muestras por canal
+
+#ifndef MEASURE_FIXED_POINT
+// Estado del procesamiento compartido por los motores de muestras y de bloques.
+static float adc_sample[VIRTUAL_CHANNELS];
+// adc_sample: Almacena las muestras actuales de los canales virtuales.
+
+static float temp_adc_sample[VIRTUAL_CHANNELS];
+// temp_adc_sample: Variable temporal para cálculos intermedios con las muestras de los canales.
+
+static filter_state_t filter_state[VIRTUAL_CHANNELS];
+// filter_state: Estado del opcode FILTER de cada canal (pasa alto, media móvil y biquad).
+
+static float window_tail_sum[VIRTUAL_CHANNELS];
+// window_tail_sum: Sumas de las muestras que siguen al cierre de una ventana de ciclos, inician la siguiente.
+
+static float square_sum[VIRTUAL_CHANNELS];
+// square_sum: Sumas de cuadrados de los canales AC_VOLTAGE y AC_CURRENT, con true_rms o sin él, para la potencia aparente.
+
+static float window_tail_square_sum[VIRTUAL_CHANNELS];
+// window_tail_square_sum: Como window_tail_sum para square_sum.
+
+static float quadrature_history[VIRTUAL_CHANNELS][MEASURE_QUADRATURE_LEN];
+// quadrature_history: Últimas muestras procesadas de los canales de quadrature_sources, circular.
+
+static float channel_register[VIRTUAL_CHANNELS][MEASURE_REGISTERS];
+// channel_register: Registros de STORE, LOAD e INTEGRATE de cada canal, se limpian al compilar el canal.
+
+#define MEASURE_DELAY_LEN 32 // Muestras de historia de SAMPLE_DELAY, potencia de 2 mayor a MEASURE_DELAY_MAX
+static_assert(MEASURE_DELAY_LEN > MEASURE_DELAY_MAX, "MEASURE_DELAY_LEN no alcanza para MEASURE_DELAY_MAX");
+
+static float delay_line[VIRTUAL_CHANNELS][MEASURE_DELAY_LEN];
+// delay_line: Valores de cada canal al llegar a su SAMPLE_DELAY, circular.
+
+static uint8_t delay_pos[VIRTUAL_CHANNELS];
+// delay_pos: Próxima posición de delay_line de cada canal.
+#else
+/**
+ * @brief operación de microcódigo compilada para el motor de punto fijo
+ *
+ * El valor de cada canal se guarda en Q31 con una escala fija por operación, conocida al compilar:
+ * valor real = q * unidad / 2^31. MUL_RATIO no genera ninguna operación, sólo cambia la unidad.
+ */
+typedef struct
+{
+    uint8_t opcode;  /** @brief opcode sin el operando */
+    uint8_t operand; /** @brief canal u operando ya validado */
+    int32_t k1;      /** @brief ADD/SUB: reescala del propio canal en Q31, SET_TO: valor en Q31 */
+    int32_t k2;      /** @brief ADD/SUB: reescala del operando en Q31 */
+} fixed_op_t;
+
+/**
+ * @brief plan de ejecución en punto fijo de un canal
+ */
+typedef struct
+{
+    bool valid;                          /** @brief false si no se pudo deducir la escala del canal */
+    uint8_t len;                         /** @brief cantidad de operaciones válidas */
+    fixed_op_t op[MEASURE_PROGRAM_MAX];  /** @brief operaciones decodificadas */
+    float unit;                          /** @brief escala del valor final: real = q * unit / 2^31 */
+    int32_t out_mantissa;                /** @brief unit * ratio normalizado a Q31 para el buffer de salida */
+    int out_shift;                       /** @brief salida = (q * out_mantissa) >> out_shift */
+    int64_t out_floor;                   /** @brief por debajo de este q la salida satura a 0 */
+} fixed_plan_t;
+
+static fixed_plan_t fixed_plan[VIRTUAL_CHANNELS]; // Planes de ejecución en punto fijo por canal virtual
+static int32_t fixed_high_pass_coef;              // Coeficiente del filtro pasa alto en Q30
+static filter_state_q31_t fixed_filter_state[VIRTUAL_CHANNELS]; // Estado del opcode FILTER en punto fijo
+
+// Estado del procesamiento en punto fijo, equivalente al de los motores float.
+static int32_t fixed_sample[VIRTUAL_CHANNELS];          // Valor Q31 actual de cada canal.
+static int64_t fixed_sum[VIRTUAL_CHANNELS];             // Sumas RMS/potencia, se pasan a channelconfig[].sum al final.
+static int64_t fixed_tail_sum[VIRTUAL_CHANNELS];        // Sumas posteriores al cierre de una ventana de ciclos.
+static int64_t fixed_square_sum[VIRTUAL_CHANNELS];      // Sumas de cuadrados de AC_VOLTAGE y AC_CURRENT para la potencia aparente.
+static int64_t fixed_tail_square_sum[VIRTUAL_CHANNELS]; // Como fixed_tail_sum para fixed_square_sum.
+static int32_t quadrature_history[VIRTUAL_CHANNELS][MEASURE_QUADRATURE_LEN]; // Últimas muestras Q31 de los canales de quadrature_sources.
+static int32_t quadrature_coef[FRACDELAY_TAPS];         // Coeficientes de quadrature_delay en Q31.
+#endif
 
 /* taske handle */
 TaskHandle_t _MEASURE_Task; // Creación de la tarea para medir
+TaskHandle_t _MEASURE_ACQ_Task; // Tarea que lee el I2S y llena block_ring
 
-volatile int TX_buffer = -1;                                // variable volátil para el buffer de transmisión iniciado vacío
 uint16_t buffer[VIRTUAL_CHANNELS][numbersOfSamples];        // buffer para las variables donde especifica [canal][número de muestras (256)]
-uint16_t buffer_fft[VIRTUAL_CHANNELS][numbersOfFFTSamples]; // buffer para la transf de fourier espeficando [canal][número de muestras para fft (32)]
-uint16_t buffer_probe[VIRTUAL_CHANNELS][numbersOfSamples];  // buffer para punteros para banderas
-double HerzvReal[numbersOfSamples * 4];                     /*variable de frecuencia real [n° de muestras *4] el 4 es porque se
-                                                              toma una muestra cada 4 muestras verdaderas, es decir que se está muestreando cada 4 muestras*/
-double HerzvImag[numbersOfSamples * 4];                     // lo mismo pasa con la variable de frecuencia imaginaria
-double netfrequency_phaseshift, netfrequency_oldphaseshift; // estas variables definen el desfaje de la frecuencia de linea, la actual y la anterior
+static uint16_t buffer_fft[VIRTUAL_CHANNELS][numbersOfFFTSamples]; // buffer para la transf de fourier espeficando [canal][número de muestras para fft (32)]
+
+/**
+ * @brief bloque de muestras publicado para los lectores (osciloscopio, FFT)
+ */
+typedef struct
+{
+    uint16_t sample[VIRTUAL_CHANNELS][numbersOfSamples]; /** @brief copia de buffer */
+    uint32_t sequence;                                   /** @brief número de bloque publicado */
+    int readers;                                         /** @brief lectores que lo están usando, atómico */
+} measure_snapshot_t;
+
+#define MEASURE_SNAPSHOT_SLOTS 3 // uno publicado, uno en escritura y uno de reserva para lectores lentos
+
+static measure_snapshot_t snapshot[MEASURE_SNAPSHOT_SLOTS]; // Bloques publicados, triple buffer
+static int snapshot_latest = -1;                            // Último bloque publicado, atómico, -1 ninguno
+static uint32_t snapshot_sequence = 0;                      // Contador de bloques publicados
+static uint32_t snapshot_dropped = 0;                       // Bloques no publicados por falta de un buffer libre
+
+/**
+ * @brief resultado del análisis armónico publicado para los lectores (WebSocket, MQTT)
+ */
+typedef struct
+{
+    HarmonicData harmonics[VIRTUAL_CHANNELS];                 /** @brief copia de harmonic_values */
+    uint16_t spectrum[VIRTUAL_CHANNELS][numbersOfFFTSamples]; /** @brief copia de buffer_fft */
+} measure_analysis_t;
+
+static measure_analysis_t analysis;     // Último análisis publicado, protegido por analysis_sequence
+static uint32_t analysis_sequence = 0;  // Seqlock: impar mientras se escribe, versión = analysis_sequence / 2
+static uint32_t analysis_next_ms = 0;   // millis() del próximo análisis
+
+/**
+ * @brief grupos de IEC 61000-4-7 publicados para los lectores
+ */
+typedef struct
+{
+    int8_t channel[MEASURE_IEC_CHANNELS];              /** @brief canal virtual de cada lugar, -1 libre */
+    measure_iec_groups_t groups[MEASURE_IEC_CHANNELS]; /** @brief grupos de cada lugar */
+} measure_iec_t;
+
+/**
+ * @brief bins de la DFT deslizante de un canal al final de un ciclo
+ */
+typedef struct
+{
+    float re[SDFT_MAX_HARMONIC]; /** @brief parte real de cada armónica */
+    float im[SDFT_MAX_HARMONIC]; /** @brief parte imaginaria */
+} measure_phasor_bins_t;
+
+#define MEASURE_PHASOR_CYCLES (numbersOfSamples / SDFT_LEN) // ciclos por bloque
+
+static_assert(numbersOfSamples % SDFT_LEN == 0, "el bloque tiene que tener ciclos enteros de la DFT deslizante");
+static_assert(SDFT_MAX_HARMONIC >= MEASURE_MAX_HARMONIC, "las máscaras de armónicas no entran en sdft_t");
+static sdft_coef_t phasor_coef;                                                   // Giros por muestra de cada armónica
+static sdft_t phasor_state[VIRTUAL_CHANNELS];                                     // DFT deslizante de cada canal
+static uint16_t phasor_mask[VIRTUAL_CHANNELS];                                    // Armónicas seguidas en cada canal, 0 ninguna
+static measure_phasor_bins_t phasor_cycle[MEASURE_PHASOR_CYCLES][VIRTUAL_CHANNELS]; // Bins al final de cada ciclo del bloque
+static float phasor_sum_sq[VIRTUAL_CHANNELS];                                     // Suma de cuadrados de la ventana en unidades del motor
+static float phasor_unit[VIRTUAL_CHANNELS];                                       // Pasa de unidades del motor a las del canal
+static uint32_t phasor_blocks = 0;                                                // Bloques desde el último recálculo completo
+static measure_phasor_t phasor_result[VIRTUAL_CHANNELS][MEASURE_MAX_HARMONIC];    // Fasores del ciclo, sólo para la tarea de medición
+static measure_phasor_t phasor_published[MEASURE_PHASOR_RING][VIRTUAL_CHANNELS][MEASURE_MAX_HARMONIC]; // Últimos ciclos publicados, protegidos por phasor_sequence
+static int64_t phasor_timestamp[MEASURE_PHASOR_RING];                             // Fin de cada ciclo publicado en esp_timer_get_time()
+static uint32_t phasor_sequence = 0;                                              // Seqlock como analysis_sequence, la mitad es el último ciclo
+
+static_assert(HARMONIC_GROUPS_MAX_ORDER >= MEASURE_IEC_MAX_ORDER, "harmonic_groups() no llega a MEASURE_IEC_MAX_ORDER");
+static float (*iec_capture)[MEASURE_IEC_MAX_SAMPLES] = NULL; // Muestras procesadas de la ventana por lugar, se reserva al habilitar los grupos
+static float *iec_work = NULL;                               // Ventana remuestreada a FFT_MAX_LEN puntos y su espectro
+static int8_t iec_slot[VIRTUAL_CHANNELS];                    // Lugar de cada canal en iec_capture, -1 si no se captura
+static int iec_len = 0;                                      // Muestras por canal en iec_capture
+static int iec_window_len = 0;                               // Muestras de la ventana que cerró, 0 si no cerró ninguna
+static float iec_start_fraction = 0.0;                       // El cruce que abrió la ventana está esta fracción de muestra antes de iec_capture[][0]
+static float iec_end_fraction = 0.0;                         // El cruce que la cerró está esta fracción antes de iec_window_len
+static bool iec_valid = false;                               // La captura cubre la ventana entera con los mismos canales
+static bool iec_overflow = false;                            // Se descartaron bloques viejos porque la ventana no entraba
+static measure_iec_t iec_result;                             // Grupos de la última ventana, sólo para la tarea de medición
+static measure_iec_t iec_published;                          // Grupos publicados, protegidos por iec_sequence
+static uint32_t iec_sequence = 0;                            // Seqlock como analysis_sequence
+static measure_iec_stats_t iec_stats;                        // Costo del análisis
+
+/**
+ * @brief resultado de buscar el cierre de una ventana de ciclos en un bloque
+ */
+typedef enum
+{
+    MEASURE_WINDOW_CONTINUE = 0, /** @brief el bloque entero pertenece a la ventana actual */
+    MEASURE_WINDOW_RESTART,      /** @brief primer cruce tras sincronizar, la ventana arranca en el cruce */
+    MEASURE_WINDOW_CLOSE         /** @brief la ventana cierra en el cruce, el resto del bloque es de la siguiente */
+} measure_window_status_t;
+
+static zerocross_t window_zc;              // Detector de cruces por cero del canal de tensión de referencia
+static bool window_synced = false;         // La ventana actual arrancó en un cruce por cero
+static uint16_t window_cycles = 0;         // Ciclos completos contados en la ventana actual
+static uint32_t window_tail_samples = 0;   // Muestras del bloque de cierre que ya pertenecen a la ventana siguiente
+static measure_window_t window_info;       // Datos de la última ventana publicada
 double netfrequency;                                        // esta variable guarda el valor de la frecuencia de línea
-double vReal[numbersOfSamples];                             // Buffer para los valores reales
-double vImag[numbersOfSamples];                             // Buffer para los valores imaginarios (en FFT se inicializan a cero)
-arduinoFFT FFT2 = arduinoFFT();
-arduinoFFT FFT = arduinoFFT();
+static zerocross_t frequency_zc;                            // Cruces por cero del canal de referencia, en orden temporal
+static freqtrack_t frequency_track;                         // Estimador de la frecuencia de red
+static bool frequency_valid = false;                        // netfrequency viene de cruces medidos y no de la configuración
+static int frequency_hold = 0;                              // Bloques a descartar después de cambiar la tasa de muestreo o perder un bloque
+static_assert(GOERTZEL_MAX_HARMONIC >= MEASURE_MAX_HARMONIC, "las máscaras de armónicas no entran en goertzel_t");
+static goertzel_coef_t harmonic_coef[GOERTZEL_MAX_HARMONIC];    // Coeficientes de las armónicas para la frecuencia medida
+static goertzel_t harmonic_state[VIRTUAL_CHANNELS];              // Armónicas de cada canal en el bloque actual
+static float harmonic_window[numbersOfSamples];                  // Peso de Hann de cada muestra del bloque en su cuadro de ciclos
+static bool harmonic_restart[numbersOfSamples];                  // Muestras del bloque que empiezan un cuadro de las armónicas
+static float harmonic_frame_position = 0.0;                      // Muestras del cuadro de las armónicas en curso antes del bloque
+static int pll_offset = 0;                                  // Corrección de la tasa de muestreo del lazo, en Hz
+static measure_pll_state_t pll_state = MEASURE_PLL_OFF;     // Estado del lazo de la tasa de muestreo
+static float pll_error = 0.0;                               // Frecuencia medida menos la frecuencia a la que el bloque es coherente, en Hz
+static int pll_locked_windows = 0;                          // Ventanas seguidas dentro de la banda muerta
+static float pll_integral = 0.0;                            // Término integral del lazo, sigue la deriva de la red en Hz del I2S por ventana
+static float pll_last_frequency = 0.0;                      // Frecuencia medida en la ventana anterior, 0 sin medida
+static float pll_drift = 0.0;                               // Deriva de la red promediada, en Hz del I2S por ventana
+static float pll_ramp = 0.0;                                // Parte de la deriva que todavía no llegó a 1 Hz del I2S, dentro de la banda muerta
+static measure_group_power_t group_power[MAX_GROUPS];      // Potencias de cada grupo en la última ventana
+
+#define MEASURE_ENERGY_MAGIC 0x454e5247 // "ENRG", marca de una copia de los registros de energía
+/**
+ * @brief copia de los registros de energía, en la memoria RTC y en los archivos de SPIFFS
+ */
+typedef struct
+{
+    uint32_t magic;                                       /** @brief MEASURE_ENERGY_MAGIC */
+    uint32_t sequence;                                    /** @brief aumenta con cada copia, la mayor es la más nueva */
+    uint16_t groups;                                      /** @brief MAX_GROUPS del perfil que la escribió */
+    uint16_t registers;                                   /** @brief MEASURE_ENERGY_REGISTERS */
+    uint32_t reserved;                                    /** @brief en cero, alinea los registros */
+    int64_t energy[MAX_GROUPS][MEASURE_ENERGY_REGISTERS]; /** @brief Wh con MEASURE_ENERGY_FRACTION_BITS bits fraccionarios */
+    uint32_t crc;                                         /** @brief crc32_le de todo lo anterior */
+} measure_energy_store_t;
+
+/**
+ * @brief canales de los que se integra la energía de un grupo
+ */
+typedef struct
+{
+    int8_t active;   /** @brief canal AC_POWER, -1 si no tiene */
+    int8_t reactive; /** @brief canal AC_REACTIVE_POWER, -1 si no tiene */
+    int8_t voltage;  /** @brief canal AC_VOLTAGE, -1 si no tiene */
+    int8_t current;  /** @brief canal AC_CURRENT, -1 si no tiene */
+} energy_channels_t;
+
+static energy_channels_t energy_channel[MAX_GROUPS];                   // Canales de energía de cada grupo activo, se rearman con channel_work
+static double energy_sum_start[VIRTUAL_CHANNELS];                      // Sumas de los canales de energía antes de procesar el bloque
+static double energy_square_start[VIRTUAL_CHANNELS];                   // Sumas de cuadrados de tensión y corriente antes de procesar el bloque
+static measure_energy_store_t energy_store;                            // Registros, sólo para la tarea de medición
+static RTC_NOINIT_ATTR measure_energy_store_t energy_rtc;              // Copia de cada ventana, sobrevive a un reinicio sin corte de alimentación
+static int64_t energy_published[MAX_GROUPS][MEASURE_ENERGY_REGISTERS]; // Registros publicados, protegidos por energy_sequence
+static uint32_t energy_sequence = 0;                                   // Seqlock como analysis_sequence
+static measure_energy_stats_t energy_stats;                            // Estado de la persistencia
+static int energy_file = 0;                                            // Archivo con la copia más nueva, 0 A y 1 B; la próxima va al otro
+static uint32_t energy_save_next_ms = 0;                               // millis() de la próxima copia en SPIFFS
+static measure_energy_store_t energy_save_copy;                        // Copia que escribe measure_energy_loop(), fuera de la tarea de medición
+static volatile uint32_t energy_save_request = 0;                      // Copias pedidas por la tarea de medición
+static volatile uint32_t energy_save_done = 0;                         // Último pedido que measure_energy_loop() escribió o no pudo escribir
+static bool energy_voltage_valid = false;                              // El bloque en proceso supera el umbral de tensión, se publica con él
 static int measurement_valid = 3; /** empieza a contar en 3 para evitar basura */
 
-const float high_pass_coef = 0.9989; // Coeficiente de filtro de paso alto, ajustado para reducir el DC residual
-const int low_pass_window_size = 12; // Tamaño de la ventana del filtro de media móvil (pasa bajo)
+static void measure_i2s_init(void);
+static void measure_acquire(void);
+static void measure_update_schedule(void);
+static void measure_energy_restore(void);
+
+/**
+ * @brief Tarea de adquisición: dueña del I2S, lee bloques y los deja separados por canal en block_ring.
+ *
+ * @param pvParameters Parámetros de entrada para la tarea (no utilizados en este caso)
+ */
+void measure_acquisition_Task(void *pvParameters)
+{
+    log_i("Iniciando tarea de adquisición en núcleo: %d", xPortGetCoreID());
+
+    measure_i2s_init();
+    while (true)
+    {
+        measure_acquire();
+    }
+}
 
 /**
  * @brief Tarea principal para gestionar las mediciones
@@ -106,9 +595,20 @@ void measure_Task(void *pvParameters)
     // Muestra en el log el núcleo del ESP32 donde se está ejecutando esta tarea
     log_i("Iniciando tarea de medición en núcleo: %d", xPortGetCoreID());
 
-    // Configuración inicial de los sistemas de medición (ADC, I2S, buffers, etc.)
+    // Configuración inicial de los sistemas de medición (buffers, tablas, programas de los canales, etc.)
     measure_init();
 
+    // La adquisición arranca con la configuración ya cargada; el I2S lo instala su propia tarea.
+    xTaskCreatePinnedToCore(
+        measure_acquisition_Task,   // Función que implementa la lógica de la tarea
+        "measure acquisition Task", // Nombre descriptivo de la tarea (para depuración)
+        4096,                       // Tamaño de la pila asignada a la tarea (en palabras)
+        NULL,                       // Parámetro de entrada para la tarea (no se utiliza en este caso)
+        3,                          // Prioridad sobre las tareas de red de su núcleo, casi siempre espera al DMA
+        &_MEASURE_ACQ_Task,         // Puntero al manejador de la tarea
+        _MEASURE_ACQ_TASKCORE       // Núcleo de la adquisición, definido en config.h
+    );
+
     // Bucle infinito para realizar mediciones continuamente
     while (true)
     {
@@ -129,23 +629,103 @@ void measure_StartTask(void)
         NULL,                       // Parámetro de entrada para la tarea (no se utiliza en este caso)
         2,                          // Prioridad de la tarea (a mayor valor, mayor prioridad)
         &_MEASURE_Task,             // Puntero al manejador de la tarea, para control y monitoreo
-        _MEASURE_TASKCORE           // Núcleo en el que se ejecutará la tarea (definido como 1)
+        _MEASURE_TASKCORE           // Núcleo en el que se ejecutará la tarea, definido en config.h
     );
 }
 
 /**
- * @brief Configura el sistema de medición inicializando el ADC, I2S y otros parámetros necesarios.
+ * @brief Frecuencia de muestreo después del diezmado: la nominal más la corrección manual y la del lazo.
+ *
+ * @return float muestras por segundo de todos los canales del ADC juntos.
+ */
+static float measure_sample_rate(void)
+{
+    return ((samplingFrequency * measure_config.network_frequency / 2) + measure_config.samplerate_corr + pll_offset);
+}
+
+/**
+ * @brief Frecuencia del I2S, adc_oversampling veces la de measure_sample_rate().
+ *
+ * @return uint32_t conversiones por segundo del ADC.
+ */
+static uint32_t measure_i2s_rate(void)
+{
+    return (measure_sample_rate() * adc_oversampling);
+}
+
+/**
+ * @brief Recalcula los biquads del opcode FILTER para la frecuencia de muestreo actual de cada canal.
+ */
+static void measure_update_filters(void)
+{
+    filter_design_presets(measure_sample_rate() / VIRTUAL_ADC_CHANNELS, measure_config.network_frequency);
+}
+
+/**
+ * @brief Pide a la tarea de adquisición que lleve el I2S a measure_i2s_rate() antes del próximo bloque.
+ *
+ * El primer bloque leído con la tasa nueva llega marcado y la medición descarta sus cruces por cero.
+ */
+static void measure_request_i2s_rate(void)
+{
+    __atomic_add_fetch(&i2s_rate_request, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Configura el sistema de medición: configuración, tablas del ADC y programas de los canales. El I2S lo instala la tarea de adquisición.
  */
 void measure_init(void)
 {
-    // Carga la configuración desde un archivo JSON almacenado en SPIFFS
+    // Carga la configuración desde un archivo JSON almacenado en SPIFFS; los programas se analizan todos juntos al final
+    channel_programs_loading = true;
     measure_config.load();
+    // El sobremuestreo se fija al iniciar porque cambia el tamaño del DMA y el desfasaje entre canales
+    adc_oversampling = measure_config.oversampling;
+    if (adc_oversampling != 2 && adc_oversampling != DECIMATOR_MAX_FACTOR)
+        adc_oversampling = 1;
+    decimator_design(&adc_decimator_design, adc_oversampling);
+    for (int i = 0; i <= VIRTUAL_ADC_CHANNELS; i++)
+        decimator_reset(&adc_decimator[i]);
+    // Los cuatro bits altos de cada palabra son el canal físico; los no mapeados van a la fila de descarte.
+    for (int tag = 0; tag < 16; tag++)
+        adc_word_channel[tag] = (tag < MAX_ADC_CHANNELS && channelmapping[tag] != CHANNEL_NOP) ? channelmapping[tag] : VIRTUAL_ADC_CHANNELS;
+    // Un bloque entero se lee de una vez.
+    adc_words = (uint16_t *)malloc(VIRTUAL_ADC_CHANNELS * numbersOfSamples * adc_oversampling * sizeof(uint16_t));
+    if (!adc_words)
+    {
+        log_e("sin memoria para el bloque del I2S");
+        while (true)
+            ;
+    }
+    // Compila los programas y desfases de todos los canales (también los valores por defecto)
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        measure_compile_channel(i);
+        measure_update_channel_phaseshift(i);
+    }
+    channel_programs_loading = false;
+    measure_update_schedule();
+    measure_update_filters();
+    // Tabla de corrección del ADC con el origen cargado
+    measure_set_adc_calibration(measure_get_adc_calibration());
+    // Tabla del remuestreo de los grupos de IEC 61000-4-7 y giros de la DFT deslizante
+    memset(iec_slot, -1, sizeof(iec_slot));
+    resample_init();
+    sdft_design(&phasor_coef);
     // Asigna la frecuencia de la red (ej. 50 Hz o 60 Hz) desde la configuración cargada
     netfrequency = measure_config.network_frequency;
+    // Registros de energía de la copia más nueva, RTC o SPIFFS
+    measure_energy_restore();
+}
 
+/**
+ * @brief Instala el driver I2S y programa el patrón del ADC SAR, desde la tarea de adquisición.
+ */
+static void measure_i2s_init(void)
+{
     // Calcula la tasa de muestreo del ADC basada en la frecuencia de red y una corrección adicional
-    int sample_rate = (samplingFrequency * measure_config.network_frequency / 2) + measure_config.samplerate_corr;
-    // Ejemplo de cálculo: 1536 Hz * 50 / 2 + 0 = 38400 Hz
+    int sample_rate = measure_i2s_rate();
+    // Ejemplo de cálculo: (1536 Hz * 50 / 2 + 0) * 1 = 38400 Hz
 
     // Configuración del bus I2S para lectura de datos desde el ADC interno
     const i2s_config_t i2s_config = {
@@ -155,7 +735,7 @@ void measure_init(void)
         .channel_format = I2S_CHANNEL_FMT_ONLY_RIGHT,                              // Usa solo un canal (derecho)
         .communication_format = I2S_COMM_FORMAT_I2S_MSB,                           // Formato de comunicación I2S (MSB primero)
         .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,                                  // Interrupción de nivel 1
-        .dma_buf_count = VIRTUAL_ADC_CHANNELS * 4,                                 // Tamaño del buffer DMA (24 bloques)
+        .dma_buf_count = VIRTUAL_ADC_CHANNELS * ((adc_oversampling > 1) ? 2 * adc_oversampling : 4), // Buffers DMA: 4 bloques de medición, 2 con sobremuestreo
         .dma_buf_len = numbersOfSamples,                                           // Longitud del buffer (256 muestras por bloque)
         .use_apll = false,                                                         // No usa el PLL auxiliar
         .tx_desc_auto_clear = true,                                                // Limpia automáticamente las descripciones de transmisión
@@ -185,9 +765,13 @@ void measure_init(void)
     vTaskDelay(100); // Pausa de 100 ms para asegurar la estabilidad del sistema
 
     // Configuración de los registros del ADC SAR para gestionar los canales virtuales
+    // Cada lugar del patrón es un byte, el primero en el byte alto: canal en el nibble alto, 12 bits y 11 dB en el bajo.
+    uint32_t pattern[2] = {0, 0};
+    for (int slot = 0; slot < VIRTUAL_ADC_CHANNELS; slot++)
+        pattern[slot / 4] |= (uint32_t)((adc_pattern[slot] << 4) | 0x0f) << (24 - 8 * (slot % 4));
     SYSCON.saradc_ctrl.sar1_patt_len = VIRTUAL_ADC_CHANNELS - 1; // Número de canales - 1
-    SYSCON.saradc_sar1_patt_tab[0] = 0x0f3f4f5f;                 // Configuración de patrones para los primeros canales
-    SYSCON.saradc_sar1_patt_tab[1] = 0x6f7f0000;                 // Configuración de patrones para los siguientes canales
+    SYSCON.saradc_sar1_patt_tab[0] = pattern[0];                 // Patrón de los primeros cuatro canales (0x0f3f4f5f)
+    SYSCON.saradc_sar1_patt_tab[1] = pattern[1];                 // Patrón de los siguientes canales (0x6f7f0000)
     SYSCON.saradc_ctrl.sar_clk_div = 6;                          // Divisor de reloj del ADC
 
     // Mensaje en el log indicando que el controlador I2S está listo
@@ -198,544 +782,3232 @@ void measure_init(void)
 }
 
 /**
- * @brief Realiza una medición y procesa los datos de los canales.
+ * @brief Guarda una muestra procesada en la captura de IEC 61000-4-7 si el canal tiene lugar.
+ *
+ * @param channel Canal virtual.
+ * @param n Muestra dentro del bloque.
+ * @param value Valor en las unidades internas del motor.
  */
-void measure_mes(void)
+static inline void measure_iec_capture(int channel, int n, float value)
+{
+    if (iec_slot[channel] >= 0)
+        iec_capture[iec_slot[channel]][iec_len + n] = value;
+}
+
+/**
+ * @brief Agrega una muestra procesada a la DFT deslizante del canal y guarda los bins al final de cada ciclo.
+ *
+ * @param channel Canal virtual.
+ * @param n Muestra dentro del bloque.
+ * @param value Valor en las unidades internas del motor.
+ */
+static inline void measure_phasor_update(int channel, int n, float value)
 {
-    int round = 0; // Contador cíclico para realizar múltiples rondas de muestreo dentro de un periodo fijo.
+    if (!phasor_mask[channel])
+        return;
 
-    // Inicializa las sumas de cada canal virtual antes de comenzar el procesamiento.
-    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    sdft_t *s = &phasor_state[channel];
+    sdft_update(s, &phasor_coef, phasor_mask[channel], value);
+    phasor_sum_sq[channel] += value * value;
+
+    if ((n + 1) % SDFT_LEN == 0)
     {
-        channelconfig[i].sum = 0.0;
+        measure_phasor_bins_t *bins = &phasor_cycle[n / SDFT_LEN][channel];
+        memcpy(bins->re, s->re, sizeof(bins->re));
+        memcpy(bins->im, s->im, sizeof(bins->im));
     }
+}
 
-    // Define el tiempo límite de ejecución para la medición (1 segundo desde el momento actual).
-    uint64_t NextMillis = millis() + 1000l;
-    while (millis() < NextMillis)
-    {
-        // Buffers estáticos para almacenar datos temporales durante el procesamiento.
-        static float adc_sample[VIRTUAL_CHANNELS], last_adc_sample[VIRTUAL_CHANNELS];
-        // adc_sample: Almacena las muestras actuales de los canales virtuales.
-        // last_adc_sample: Guarda las muestras anteriores para aplicar filtros y cálculos diferenciales.
+#ifndef MEASURE_FIXED_POINT
+/**
+ * @brief Muestra del ADC para GET_ADC, con el desfase fraccionario del canal.
+ *
+ * @param adc Primera muestra del bloque en la fila de adc_extended del canal del ADC.
+ * @param index Índice ya desplazado por offset_0, puede pasar del final del bloque.
+ * @param phase Desfase del canal virtual.
+ * @return float muestra en cuentas del ADC.
+ */
+static inline float measure_adc_value(const uint16_t *adc, int index, const channel_phase_t *phase)
+{
+    if (!phase->fractional)
+        return (adc[index] * adc_scale);
 
-        static float temp_adc_sample[VIRTUAL_CHANNELS];
-        // temp_adc_sample: Variable temporal para cálculos intermedios con las muestras de los canales.
+    float value = 0.0;
+    for (int tap = 0; tap < FRACDELAY_TAPS; tap++)
+        value += phase->fraction.coef[tap] * adc[index + phase->fraction.delay + tap];
+    return (value * adc_scale);
+}
 
-        static float ac_filtered[VIRTUAL_CHANNELS], last_ac_filtered[VIRTUAL_CHANNELS];
-        // ac_filtered: Almacena las señales de corriente alterna (AC) después de aplicar un filtro de paso alto.
-        // last_ac_filtered: Guarda los valores filtrados anteriores, necesarios para cálculos iterativos.
+/**
+ * @brief Valor de un canal un cuarto de ciclo antes de la muestra actual, para MUL_QUADRATURE.
+ *
+ * Interpola con los coeficientes de quadrature_delay entre muestras de quadrature_history, que
+ * son todas anteriores a la actual; por eso el resultado no depende del orden de los canales.
+ *
+ * @param channel Canal operando, debe estar en quadrature_sources.
+ * @return float valor retardado en las unidades del motor.
+ */
+static inline float measure_quadrature_sample(int channel)
+{
+    const float *history = quadrature_history[channel];
+    uint32_t pos = quadrature_pos - quadrature_delay.delay;
+    float value = 0.0;
 
-        static float dc_filtered[VIRTUAL_CHANNELS][64];
-        // dc_filtered: Matriz que almacena las señales de corriente continua (DC) después de aplicar un filtro de paso bajo.
-        // Cada canal tiene un buffer circular de 64 muestras para realizar un filtrado promedio.
+    for (int tap = 0; tap < FRACDELAY_TAPS; tap++)
+        value += quadrature_delay.coef[tap] * history[(pos - tap) & (MEASURE_QUADRATURE_LEN - 1)];
+    return (value);
+}
 
-        uint16_t *channel[VIRTUAL_ADC_CHANNELS];
-        // channel: Arreglo de punteros que apunta a los datos de cada canal virtual para acceso rápido.
+/**
+ * @brief Guarda la muestra actual de los canales de quadrature_sources y avanza a la siguiente.
+ *
+ * @param value Valor actual de cada canal virtual.
+ */
+static inline void measure_quadrature_store(const float *value)
+{
+    for (uint32_t sources = quadrature_sources; sources; sources &= sources - 1)
+    {
+        int i = __builtin_ctz(sources);
+        quadrature_history[i][quadrature_pos & (MEASURE_QUADRATURE_LEN - 1)] = value[i];
+    }
+    quadrature_pos++;
+}
 
-        uint16_t adc_tempsamples[numbersOfSamples];
-        // adc_tempsamples: Buffer temporal para almacenar las muestras crudas leídas desde el ADC.
+/**
+ * @brief Valor del operando de DIV o CLAMP: un canal o un registro del propio canal.
+ *
+ * @param channel Canal que ejecuta el opcode.
+ * @param operand Canal o REGISTER_x.
+ * @param value Valor actual del propio canal.
+ * @return float
+ */
+static inline float measure_operand_value(int channel, int operand, float value)
+{
+    if (operand == channel)
+        return (value);
+    return ((operand < VIRTUAL_CHANNELS) ? adc_sample[operand] : channel_register[channel][operand - REGISTER_0]);
+}
 
-        uint16_t adc_samples[VIRTUAL_ADC_CHANNELS][numbersOfSamples];
-        // adc_samples: Matriz que organiza las muestras del ADC por canal virtual.
+/**
+ * @brief Ejecuta un opcode extendido sobre el valor actual de un canal.
+ *
+ * Todos entran al switch de measure_process_sample_major() por el case NOP, así el despacho de los
+ * opcodes de siempre no cambia.
+ *
+ * @param channel Canal que ejecuta el opcode.
+ * @param opcode Opcode extendido.
+ * @param argument Registro, operando o retardo ya validado.
+ * @param sample_period Segundos entre dos muestras de un canal, para INTEGRATE.
+ * @param value Valor actual del canal.
+ * @return float valor del canal después del opcode.
+ */
+static float measure_extended_op(int channel, uint8_t opcode, uint8_t argument, float sample_period, float value)
+{
+    switch (opcode)
+    {
+    case STORE:
+        channel_register[channel][argument] = value;
+        break;
+    case LOAD:
+        value = channel_register[channel][argument];
+        break;
+    case DIV:
+    {
+        float divisor = measure_operand_value(channel, argument, value);
+        value = (divisor != 0.0) ? value / divisor : 0.0;
+        break;
+    }
+    case SQRT:
+        value = (value > 0.0) ? sqrtf(value) : 0.0;
+        break;
+    case INTEGRATE:
+        channel_register[channel][argument] += value * sample_period;
+        value = channel_register[channel][argument];
+        break;
+    case SAMPLE_DELAY:
+        // El valor actual entra a la línea y sale el de hace argument muestras.
+        delay_line[channel][delay_pos[channel]] = value;
+        value = delay_line[channel][(delay_pos[channel] - argument) & (MEASURE_DELAY_LEN - 1)];
+        delay_pos[channel] = (delay_pos[channel] + 1) & (MEASURE_DELAY_LEN - 1);
+        break;
+    case CLAMP:
+    {
+        float limit = fabsf(measure_operand_value(channel, argument, value));
+        if (value > limit)
+            value = limit;
+        else if (value < -limit)
+            value = -limit;
+        break;
+    }
+    default:
+        break;
+    }
+    return (value);
+}
 
-        int phaseshift_0_degree;
-        // phaseshift_0_degree: Desfase de 0 grados, calculado en función de las configuraciones del canal.
+/**
+ * @brief Procesa un bloque de muestras recorriendo primero las muestras y luego los canales.
+ *
+ * @param adc_samples Filas de adc_extended del bloque, ya separadas por canal virtual del ADC.
+ * @param split Primera muestra que se suma a window_tail_sum en vez de channelconfig[].sum.
+ */
+static void measure_process_sample_major(uint16_t adc_samples[VIRTUAL_ADC_CHANNELS][MEASURE_ADC_ROW], int split)
+{
+    int phaseshift_0_degree;
+    // phaseshift_0_degree: Desfase de 0 grados, calculado en función de las configuraciones del canal.
 
-        int phaseshift_90_degree;
-        // phaseshift_90_degree: Desfase de 90 grados, usado para determinar si una carga es capacitiva o inductiva.
+    int phaseshift_90_degree;
+    // phaseshift_90_degree: Desfase de 90 grados, usado para determinar si una carga es capacitiva o inductiva.
 
-        static float rms_history[16] = {0}; // Buffer circular para almacenar valores RMS.
-        static int rms_index = 0;           // Índice actual del buffer.
+    float hp_coef = measure_config.high_pass_coef;
+    // hp_coef: Coeficiente del pasa alto del opcode FILTER, se lee una vez por bloque.
 
-        // Inicializa los punteros para cada canal virtual, apuntando al inicio del buffer correspondiente.
-        for (int i = 0; i < VIRTUAL_ADC_CHANNELS; i++)
-        {
-            channel[i] = &adc_samples[i][0];
-        }
+    float sample_period = VIRTUAL_ADC_CHANNELS / measure_sample_rate();
+    // sample_period: Segundos entre dos muestras de un canal, para INTEGRATE.
 
-        // Bucle para leer y procesar bloques de datos desde el ADC a través de I2S.
-        for (int adc_chunck = 0; adc_chunck < VIRTUAL_ADC_CHANNELS; adc_chunck++)
+    // Recorre todas las muestras de cada canal de channel_work, en el orden de sus dependencias.
+    for (int n = 0; n < numbersOfSamples; n++)
+    {
+        for (int k = 0; k < channel_work.len; k++)
         {
-            size_t num_bytes_read = 0; // Almacena la cantidad de bytes leídos.
-            esp_err_t err;
-
-            // Lee datos del ADC utilizando el driver I2S.
-            err = i2s_read(
-                I2S_PORT,                // Puerto I2S configurado previamente.
-                (char *)adc_tempsamples, // Buffer temporal para almacenar las muestras crudas.
-                sizeof(adc_tempsamples), // Tamaño del buffer en bytes.
-                &num_bytes_read,         // Puntero para almacenar el número de bytes leídos.
-                100                      // Tiempo de espera (100 ms).
-            );
-
-            // Verifica si la lectura fue exitosa.
-            if (err != ESP_OK)
-            {
-                log_e("Error al leer el buffer DMA: %d", err); // Muestra un mensaje de error en el log.
-                while (true)
-                    ; // Detiene el sistema si ocurre un error crítico.
-            }
+            int i = channel_work.order[k];
 
-            // Ajusta el número de muestras leídas dividiendo el tamaño en bytes entre 2 (tamaño de muestra en 16 bits).
-            num_bytes_read /= 2;
+            // Obtiene los índices desfasados 0° y 90° a partir de los desplazamientos precalculados; el de 0° puede pasar del bloque.
+            phaseshift_0_degree = n + channel_phase[i].offset_0;
 
-            // Verifica si el número de muestras leídas coincide con lo esperado.
-            if (num_bytes_read != numbersOfSamples)
-            {
-                log_e("El tamaño del bloque no coincide con el número de muestras: %d", num_bytes_read);
-                while (true)
-                    ;
-            }
+            phaseshift_90_degree = n + channel_phase[i].offset_90;
+            if (phaseshift_90_degree >= numbersOfSamples)
+                phaseshift_90_degree -= numbersOfSamples;
 
-            // Procesa cada muestra leída y la organiza en canales virtuales.
-            for (int i = 0; i < num_bytes_read; i++)
+            // Ejecuta el plan precompilado del canal, sin decodificar ni validar nada por muestra.
+            // El valor queda en un registro mientras dura el plan; un operando que es el propio canal lo lee de ahí.
+            const channel_plan_t *plan = &channel_plan[i];
+            float value = adc_sample[i];
+            for (int operation = 0; operation < plan->len; operation++)
             {
-                // Extrae el canal del ADC (bits 15 a 12) de la palabra de 16 bits.
-                int8_t chan = (adc_tempsamples[i] >> 12) & 0xf;
+                int op_channel = plan->op[operation].operand;
 
-                // Verifica si el canal está mapeado y asigna la muestra al canal virtual correspondiente.
-                if (chan < MAX_ADC_CHANNELS && channelmapping[chan] != CHANNEL_NOP)
+                // Ejecuta la operación correspondiente en el canal.
+                switch (plan->op[operation].opcode)
                 {
-                    *channel[channelmapping[chan]] = adc_tempsamples[i] & 0x0fff; // Extrae los 12 bits de la muestra.
-                    channel[channelmapping[chan]]++;                              // Avanza al siguiente espacio del buffer del canal.
+                case ADD:
+                    value += (op_channel == i) ? value : adc_sample[op_channel];
+                    break;
+                case SUB:
+                    value -= (op_channel == i) ? value : adc_sample[op_channel];
+                    break;
+                case MUL:
+                    value *= (op_channel == i) ? value : adc_sample[op_channel];
+                    break;
+                case MUL_RATIO:
+                    value *= channelconfig[op_channel].ratio;
+                    break;
+                case MUL_SIGN:
+                    value *= (((op_channel == i) ? value : adc_sample[op_channel]) > 0.0) ? 1.0 : -1.0;
+                    break;
+                case MUL_REACTIVE:
+                    // Multiplica por el signo reactivo basado en el desfase de 90°.
+                    temp_adc_sample[i] = buffer[op_channel][phaseshift_90_degree] - 2048.0;
+                    channelconfig[i].sign = (temp_adc_sample[i] > 0.0) ? 1.0 : -1.0;
+                    value *= channelconfig[i].sign;
+                    break;
+                case MUL_QUADRATURE:
+                    // Multiplica por el operando retardado un cuarto de ciclo de la frecuencia medida.
+                    value *= measure_quadrature_sample(op_channel);
+                    break;
+                case ABS:
+                    value = fabs(value);
+                    break;
+                case NEG:
+                    value = -value;
+                    break;
+                case PASS_NEGATIVE:
+                    if (value > 0.0)
+                        value = 0.0;
+                    break;
+                case PASS_POSITIVE:
+                    if (value < 0.0)
+                        value = 0.0;
+                    break;
+                case GET_ADC:
+                    value = measure_adc_value(adc_samples[op_channel] + MEASURE_ADC_HEAD, phaseshift_0_degree, &channel_phase[i]);
+                    break;
+                case SET_TO:
+                    value = op_channel;
+                    break;
+                case FILTER:
+                    // Pasa alto para eliminar la componente DC, seguido de la etapa que elija el operando.
+                    filter_process(&filter_state[i], op_channel, hp_coef, &value, 1);
+                    break;
+                case NOP:
+                    value = measure_extended_op(i, op_channel, plan->op[operation].argument, sample_period, value);
+                    break;
+                default:
+                    break;
                 }
             }
-        }
+            adc_sample[i] = value;
 
-        // Recorre todas las muestras de cada canal virtual para procesarlas.
-        for (int n = 0; n < numbersOfSamples; n++)
-        {
-            for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+            // Almacena las muestras procesadas en el buffer.
+            if (channelconfig[i].type == AC_VOLTAGE && measure_get_channel_ratio(i) > 5)
+            {
+                buffer[i][n] = 2048; // Saturación si el ratio es mayor a 5.
+            }
+            else
+            {
+                buffer[i][n] = (adc_sample[i] + 2048 < 0.0) ? 0 : (adc_sample[i] * measure_get_channel_ratio(i)) + 2048;
+            }
+
+            // Armónicas seleccionadas del canal, en cuadros de ciclos con ventana de Hann.
+            if (channelconfig[i].harmonics)
+                goertzel_update(&harmonic_state[i], harmonic_coef, channelconfig[i].harmonics, adc_sample[i], harmonic_window[n], harmonic_restart[n]);
+            measure_iec_capture(i, n, adc_sample[i]);
+            measure_phasor_update(i, n, adc_sample[i]);
+
+            // Suma los valores de la señal procesada para cálculos RMS o promedios.
+            float *sum = (n < split) ? &channelconfig[i].sum : &window_tail_sum[i];
+            switch (channelconfig[i].type)
             {
-                // Verifica si el canal está activo y configurado correctamente.
-                if (!groupconfig[channelconfig[i].group_id].active || channelconfig[i].type == NO_CHANNEL_TYPE)
+            case AC_CURRENT:
+            case AC_VOLTAGE:
+                if (channelconfig[i].true_rms)
                 {
-                    // Si el canal no está activo o no tiene un tipo definido, asigna valores neutros.
-                    buffer[i][n] = 2048;        // Valor neutral en el buffer.
-                    channelconfig[i].sum = 0.0; // Reinicia la suma acumulada del canal.
-                    adc_sample[i] = 0.0;        // Limpia el valor actual de la muestra.
-                    continue;                   // Pasa al siguiente canal.
+                    *sum += adc_sample[i] * adc_sample[i]; // Cuadrado para RMS.
                 }
-
-                // Procesa las operaciones configuradas en el canal.
-                for (int operation = 0; operation < MAX_MICROCODE_OPS; operation++)
+                else
                 {
-                    // Calcula el desfase en grados para 0° y 90°.
-                    phaseshift_0_degree = calculate_phaseshift(channelconfig[i].phaseshift, n, numbersOfSamples);
+                    *sum += fabs(adc_sample[i]); // Módulo de la señal.
+                }
+                // Cuadrado para la potencia aparente, que siempre es con valores eficaces.
+                *((n < split) ? &square_sum[i] : &window_tail_square_sum[i]) += adc_sample[i] * adc_sample[i];
+                break;
+            case AC_POWER:
+            case AC_REACTIVE_POWER:
+            case DC_CURRENT:
+            case DC_VOLTAGE:
+            case DC_POWER:
+                *sum += (channelconfig[i].true_rms) ? (adc_sample[i] * adc_sample[i]) : adc_sample[i];
+                break;
+            case NO_CHANNEL_TYPE:
+                break;
+            }
 
-                    if (phaseshift_0_degree == numbersOfSamples - 1)
-                        phaseshift_0_degree = 0;
-
-                    phaseshift_90_degree = ((numbersOfSamples / 2) / 360.0) * ((channelconfig[i].phaseshift + 90) % 360);
-                    phaseshift_90_degree = (n + phaseshift_90_degree) % numbersOfSamples;
-                    if (phaseshift_90_degree == numbersOfSamples - 1)
-                        phaseshift_90_degree = 0;
-
-                    // Obtiene el canal de operación y verifica que esté dentro del rango permitido.
-                    int op_channel = channelconfig[i].operation[operation] & ~OPMASK;
-                    if (op_channel >= VIRTUAL_CHANNELS)
-                        continue;
-
-                    // Ejecuta la operación correspondiente en el canal.
-                    switch (channelconfig[i].operation[operation] & OPMASK)
-                    {
-                    case ADD:
-                        adc_sample[i] += adc_sample[op_channel];
-                        break;
-                    case SUB:
-                        adc_sample[i] -= adc_sample[op_channel];
-                        break;
-                    case MUL:
-                        adc_sample[i] *= adc_sample[op_channel];
-                        break;
-                    case MUL_RATIO:
-                        adc_sample[i] *= channelconfig[op_channel].ratio;
-                        break;
-                    case MUL_SIGN:
-                        adc_sample[i] *= (adc_sample[op_channel] > 0.0) ? 1.0 : -1.0;
-                        break;
-                    case MUL_REACTIVE:
-                        // Multiplica por el signo reactivo basado en el desfase de 90°.
-                        temp_adc_sample[i] = buffer[op_channel][phaseshift_90_degree] - 2048.0;
-                        channelconfig[i].sign = (temp_adc_sample[i] > 0.0) ? 1.0 : -1.0;
-                        adc_sample[i] *= channelconfig[i].sign;
-                        break;
-                    case ABS:
-                        adc_sample[i] = fabs(adc_sample[i]);
-                        break;
-                    case NEG:
-                        adc_sample[i] = -adc_sample[i];
-                        break;
-                    case PASS_NEGATIVE:
-                        if (adc_sample[i] > 0.0)
-                            adc_sample[i] = 0.0;
-                        break;
-                    case PASS_POSITIVE:
-                        if (adc_sample[i] < 0.0)
-                            adc_sample[i] = 0.0;
-                        break;
-                    case GET_ADC:
-                        if (op_channel >= 0 && op_channel < VIRTUAL_ADC_CHANNELS)
-                        {
-                            adc_sample[i] = adc_samples[op_channel][phaseshift_0_degree];
-                        }
-                        break;
-                    case SET_TO:
-                        adc_sample[i] = op_channel;
-                        break;
-                    case FILTER:
-                        // Aplica un filtro de paso alto para eliminar la componente DC.
-                        ac_filtered[i] = HIGH_PASS_FILTER(last_adc_sample[i], last_ac_filtered[i], adc_sample[i]);
-                        last_ac_filtered[i] = ac_filtered[i];
-                        last_adc_sample[i] = adc_sample[i];
-                        adc_sample[i] = ac_filtered[i];
-
-                        // Aplica un filtro de paso bajo si corresponde.
-                        if (op_channel)
-                        {
-                            int mul = (op_channel <= 6) ? (1 << op_channel) : low_pass_window_size;
-                            dc_filtered[i][n % mul] = adc_sample[i];
-                            float sum = 0.0;
-                            for (int j = 0; j < mul; j++)
-                            {
-                                sum += dc_filtered[i][j];
-                            }
-                            adc_sample[i] = sum / mul; // Señal suavizada.
-                        }
-                        break;
-                    case NOP:
-                        break; // No hacer nada.
-                    default:
-                        operation = MAX_MICROCODE_OPS; // Salir del bucle si la operación no es válida.
-                        break;
-                    }
-                }
+        }
 
-                // Almacena las muestras procesadas en el buffer.
-                if (channelconfig[i].type == AC_VOLTAGE && measure_get_channel_ratio(i) > 5)
-                {
-                    buffer[i][n] = 2048; // Saturación si el ratio es mayor a 5.
-                }
-                else
-                {
-                    buffer[i][n] = (adc_sample[i] + 2048 < 0.0) ? 0 : (adc_sample[i] * measure_get_channel_ratio(i)) + 2048;
-                }
+        measure_quadrature_store(adc_sample);
+    }
+}
+#endif
 
-                // Suma los valores de la señal procesada para cálculos RMS o promedios.
-                switch (channelconfig[i].type)
-                {
-                case AC_CURRENT:
-                case AC_VOLTAGE:
-                    if (channelconfig[i].true_rms)
-                    {
-                        channelconfig[i].sum += adc_sample[i] * adc_sample[i]; // Cuadrado para RMS.
-                    }
-                    else
-                    {
-                        channelconfig[i].sum += fabs(adc_sample[i]); // Módulo de la señal.
-                    }
-                    break;
-                case AC_POWER:
-                case AC_REACTIVE_POWER:
-                case DC_CURRENT:
-                case DC_VOLTAGE:
-                case DC_POWER:
-                    channelconfig[i].sum += (channelconfig[i].true_rms) ? (adc_sample[i] * adc_sample[i]) : adc_sample[i];
-                    break;
-                case NO_CHANNEL_TYPE:
-                    break;
-                }
+/**
+ * @brief Arma el orden de evaluación de los canales a partir de sus planes.
+ *
+ * Cada canal que lee el valor de otro (ADD, SUB, MUL, MUL_SIGN, MUL_REACTIVE, MUL_QUADRATURE, DIV, CLAMP)
+ * se evalúa después de éste, así todos los motores leen la muestra actual del operando. Las dependencias
+ * circulares son un error. Los canales sin tipo que ningún canal vivo lee quedan afuera del orden.
+ * Un programa que parte del valor de la muestra anterior del propio canal (no empieza con GET_ADC
+ * o SET_TO) sólo lo puede reproducir el motor por muestras.
+ *
+ * @param plan Planes de todos los canales.
+ * @param schedule Destino.
+ * @param error Destino del mensaje de error, puede ser NULL.
+ * @param len Tamaño de error.
+ * @return true si el grafo no tiene ciclos.
+ */
+static bool measure_schedule_channels(const channel_plan_t *plan, channel_schedule_t *schedule, char *error, uint16_t len)
+{
+    uint32_t depends[VIRTUAL_CHANNELS];
+    uint32_t live = 0;
+    uint32_t done = 0;
+    int count = 0;
 
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        depends[i] = 0;
+        for (int operation = 0; operation < plan[i].len; operation++)
+        {
+            switch (plan[i].op[operation].opcode)
+            {
+            case ADD:
+            case SUB:
+            case MUL:
+            case MUL_SIGN:
+            case MUL_REACTIVE:
+            case MUL_QUADRATURE:
+                if (plan[i].op[operation].operand != i)
+                    depends[i] |= 1ul << plan[i].op[operation].operand;
+                break;
+            case NOP:
+                if ((plan[i].op[operation].operand == DIV || plan[i].op[operation].operand == CLAMP) && plan[i].op[operation].argument != i && plan[i].op[operation].argument < VIRTUAL_CHANNELS)
+                    depends[i] |= 1ul << plan[i].op[operation].argument;
+                break;
+            default:
+                break;
             }
         }
+        if (channelconfig[i].type != NO_CHANNEL_TYPE)
+            live |= 1ul << i;
+    }
 
+    // Los operandos de un canal vivo también están vivos.
+    for (uint32_t previous = 0; previous != live;)
+    {
+        previous = live;
+        for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+            if (live & (1ul << i))
+                live |= depends[i];
+    }
 
-        // Promedio acumulativo de RMS.
-        float rms_sum = 0;
+    schedule->len = 0;
+    schedule->live = live;
+    schedule->block = true;
+    schedule->extended = false;
+
+    // Ordenamiento topológico de todos los canales, eligiendo siempre el libre de menor índice.
+    while (count < VIRTUAL_CHANNELS)
+    {
+        int next = -1;
 
-        // Actualiza el buffer circular con el RMS calculado de AC_VOLTAGE.
         for (int i = 0; i < VIRTUAL_CHANNELS; i++)
         {
-            if (channelconfig[i].type == AC_VOLTAGE)
+            if (!(done & (1ul << i)) && !(depends[i] & ~done))
             {
-                rms_history[rms_index] = channelconfig[i].rms; // Almacena el valor RMS en el buffer.
+                next = i;
                 break;
             }
         }
 
-        // Incrementa el índice del buffer circular.
-        rms_index = (rms_index + 1) % 16;
+        if (next < 0)
+            break;
 
-        // Calcula el promedio RMS acumulado.
-        for (int i = 0; i < 16; i++)
-        {
-            rms_sum += rms_history[i];
-        }
-        float rms_avg = rms_sum / 16; // Promedio de los últimos 16 ciclos.
+        done |= 1ul << next;
+        count++;
+        if (!(live & (1ul << next)))
+            continue;
+        schedule->order[schedule->len++] = next;
+        if (plan[next].len && plan[next].op[0].opcode != GET_ADC && plan[next].op[0].opcode != SET_TO)
+            schedule->block = false;
+        for (int operation = 0; operation < plan[next].len; operation++)
+            if (plan[next].op[operation].opcode == NOP)
+                schedule->extended = true;
+    }
 
-        if (rms_avg >= 40)
-        {
-            // Si el promedio supera el umbral, copia y transmite los datos.
-            if (TX_buffer != -1)
-            {
-                memcpy(&buffer_probe[0][0], &buffer[0][0], sizeof(buffer));
-                TX_buffer = -1; // Marca el buffer como procesado.
-            }
-        }
-        else
-        {
-            // Si el promedio no supera el umbral, no se envía nada.
-            if (TX_buffer != -1)
-            {
-                memset(&buffer_probe[0][0], 0, sizeof(buffer_probe)); // Limpia el buffer para evitar ruido.
-                TX_buffer = -1;                                       // Marca el buffer como procesado.
-            }
-        }
+    if (count == VIRTUAL_CHANNELS)
+        return (true);
 
-        // Captura muestras para calcular la FFT durante las primeras 4 rondas.
-        if (round < 4)
-        {
-            // Busca el primer canal configurado como AC_VOLTAGE.
-            for (int i = 0; i < VIRTUAL_CHANNELS; i++)
-            {
-                // Si el canal es de tensión alterna (AC), copia las muestras al buffer de FFT.
-                if (channelconfig[i].type == AC_VOLTAGE)
-                {
-                    for (int sample = 0; sample < numbersOfSamples; sample++)
-                    {
-                        // Guarda las muestras reales y inicializa las imaginarias a cero.
-                        HerzvReal[(round * numbersOfSamples) + sample] = buffer[i][sample];
-                        HerzvImag[(round * numbersOfSamples) + sample] = 0;
-                    }
-                    break; // Termina la búsqueda después de encontrar el primer canal válido.
-                }
-            }
-        }
+    // Quita los canales que ningún otro pendiente lee; quedan los ciclos y lo que los une.
+    uint32_t cycle = ((1ul << VIRTUAL_CHANNELS) - 1) & ~done;
+    for (uint32_t previous = 0; previous != cycle;)
+    {
+        uint32_t read = 0;
 
-        round++;
+        previous = cycle;
+        for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+            if (cycle & (1ul << i))
+                read |= depends[i];
+        cycle &= read;
     }
-    // Verifica si el canal 1 es AC_VOLTAGE y su ratio es válido para el análisis.
-    if (channelconfig[1].type == AC_VOLTAGE && measure_get_channel_ratio(1) <= 5.0)
+
+    if (error && len)
     {
-        // Configura la FFT con los datos reales, imaginarios y parámetros de la señal.
-        FFT = arduinoFFT(HerzvReal, HerzvImag, numbersOfSamples * 4, (numbersOfSamples)*measure_get_network_frequency());
+        int pos = snprintf(error, len, "dependencia circular entre los canales");
+        for (int i = 0; i < VIRTUAL_CHANNELS && pos < len; i++)
+            if (cycle & (1ul << i))
+                pos += snprintf(error + pos, len - pos, " %d", i);
+    }
+    return (false);
+}
 
-        // Aplica una ventana Hamming para minimizar efectos de discontinuidad en los bordes.
-        for (int i = 0; i < numbersOfSamples * 4; i++)
-        {
-            HerzvReal[i] *= 0.54 - 0.46 * cos(2 * PI * i / (numbersOfSamples * 4));
-        }
+/**
+ * @brief Rearma el orden de evaluación de program_stage con los planes compilados.
+ *
+ * Con una dependencia circular, que sólo puede venir de una configuración guardada, los canales se
+ * evalúan en orden de índice como antes del análisis: un canal que lee a otro de índice mayor
+ * recibe su muestra anterior, y sólo el motor por muestras los procesa.
+ */
+static void measure_update_schedule(void)
+{
+    channel_schedule_t schedule;
+    char error[64];
 
-        // Realiza el cálculo de la FFT.
-        FFT.Compute(FFT_REVERSE);
+    if (!measure_schedule_channels(program_stage.plan, &schedule, error, sizeof(error)))
+    {
+        log_e("%s, se evalúan en orden de índice", error);
+        for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+            schedule.order[i] = i;
+        schedule.len = VIRTUAL_CHANNELS;
+        schedule.live = (1ul << VIRTUAL_CHANNELS) - 1;
+        schedule.block = false;
+    }
+    measure_program_begin();
+    program_stage.schedule = schedule;
+    measure_program_end();
+}
 
-        // Calcula el desplazamiento de fase actual en grados.
-        netfrequency_oldphaseshift = netfrequency_phaseshift;
-        netfrequency_phaseshift = atan2(HerzvReal[8], HerzvImag[8]) * (180.0 / PI) + 180;
+#ifdef MEASURE_FIXED_POINT
+static void measure_compile_fixed_point(void);
+#endif
 
-        // Verifica si el cambio de fase es válido para cálculos de frecuencia.
-        if ((netfrequency_phaseshift - netfrequency_oldphaseshift) < 180 &&
-            (netfrequency_phaseshift - netfrequency_oldphaseshift) > -180)
-        {
-            static float netfrequency_filter[16] = {0.0}; // Buffer para suavizar la frecuencia.
-            static int index = 0;                         // Índice del filtro circular.
-            static bool netfrequency_firstrun = true;     // Bandera para inicialización del filtro.
+/**
+ * @brief Toma los programas de program_stage si cambiaron desde el bloque anterior.
+ *
+ * Se copian sólo si ningún setter los estaba escribiendo durante la copia; si no, quedan los
+ * anteriores y se reintenta en el bloque siguiente, sin esperar al setter. Los canales con un programa
+ * recién compilado arrancan con registros y retardo en cero, y en punto fijo se recompilan las escalas.
+ * Sólo desde la tarea de medición, antes de measure_update_work().
+ */
+static void measure_update_program(void)
+{
+    static uint32_t program_applied = 0;   // Versión de program_stage que usan los motores.
+    static measure_program_t program;      // Copia en curso, fuera de la pila de la tarea.
+    uint32_t sequence = __atomic_load_n(&program_sequence, __ATOMIC_SEQ_CST);
 
-            // Inicializa el filtro con la frecuencia de la red en la primera ejecución.
-            if (netfrequency_firstrun)
-            {
-                for (int i = 0; i < 16; i++)
-                {
-                    netfrequency_filter[i] = measure_get_network_frequency();
-                }
-                netfrequency_firstrun = false;
-            }
+    if (sequence == program_applied || (sequence & 1))
+        return;
+    memcpy(&program, &program_stage, sizeof(program));
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (sequence != __atomic_load_n(&program_sequence, __ATOMIC_SEQ_CST))
+        return;
+    program_applied = sequence;
 
-            // Calcula la frecuencia ajustada basada en el desplazamiento de fase.
-            netfrequency_filter[index] = (netfrequency_phaseshift - netfrequency_oldphaseshift) * ((1.0f / PI) / 90) +
-                                         measure_get_network_frequency();
+#ifndef MEASURE_FIXED_POINT
+    static uint8_t generation[VIRTUAL_CHANNELS]; // Programas ya tomados por canal.
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        if (program.generation[i] == generation[i])
+            continue;
+        generation[i] = program.generation[i];
+        memset(channel_register[i], 0, sizeof(channel_register[i]));
+        memset(delay_line[i], 0, sizeof(delay_line[i]));
+        delay_pos[i] = 0;
+    }
+#endif
+
+    memcpy(channel_plan, program.plan, sizeof(channel_plan));
+    memcpy(channel_phase, program.phase, sizeof(channel_phase));
+    channel_schedule = program.schedule;
+    quadrature_sources = program.quadrature_sources;
+#ifdef MEASURE_FIXED_POINT
+    measure_compile_fixed_point();
+#endif
+    measure_request_work();
+}
 
-            // Calcula el promedio de las últimas 16 frecuencias para estabilizar el valor.
-            netfrequency = 0.0;
-            for (int i = 0; i < 16; i++)
-            {
-                netfrequency += netfrequency_filter[i];
-            }
-            netfrequency /= 16.0;
+#ifdef MEASURE_FIXED_POINT
+/**
+ * @brief Pide que la tarea de medición vuelva a tomar los programas y recompile las escalas de punto fijo.
+ */
+static void measure_request_program(void)
+{
+    measure_program_begin();
+    measure_program_end();
+}
+#endif
 
-            // Actualiza el índice del filtro para la próxima iteración.
-            index = (index + 1) % 16;
-        }
+/**
+ * @brief Rearma channel_work si hubo pedidos desde el bloque anterior.
+ *
+ * Quedan en la lista los canales vivos de grupos activos, en el orden de channel_schedule; en punto
+ * fijo también hace falta un plan válido. Los demás se ponen en neutro acá, una vez por cambio: los
+ * motores no los recorren, así su buffer, sus sumas y su muestra actual quedan en neutro y los canales
+ * que los leen ven un cero, como si se procesaran con el grupo apagado. Sólo desde la tarea de medición.
+ */
+static void measure_update_work(void)
+{
+    static uint32_t work_applied = 0; // Último pedido aplicado.
+    uint32_t work_request = __atomic_load_n(&channel_work_request, __ATOMIC_ACQUIRE);
+    channel_work_t work;
+
+    if (work_request == work_applied)
+        return;
+    work_applied = work_request;
+
+    work.len = 0;
+    for (int k = 0; k < channel_schedule.len; k++)
+    {
+        int i = channel_schedule.order[k];
+
+        if (!groupconfig[channelconfig[i].group_id].active)
+            continue;
+#ifdef MEASURE_FIXED_POINT
+        if (!fixed_plan[i].valid)
+            continue;
+#endif
+        work.order[work.len++] = i;
     }
+    work.idle = (1ul << VIRTUAL_CHANNELS) - 1;
+    for (int k = 0; k < work.len; k++)
+        work.idle &= ~(1ul << work.order[k]);
 
-    else
+    // Canales de energía de cada grupo: el primero de cada tipo que se procesa, como measure_update_power().
+    memset(energy_channel, -1, sizeof(energy_channel));
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
     {
-        // Si el cambio de fase está fuera del rango permitido (±180°),
-        // utiliza la frecuencia de red configurada como valor predeterminado.
-        netfrequency = measure_get_network_frequency();
+        energy_channels_t *energy = &energy_channel[channelconfig[i].group_id];
+
+        if (work.idle & (1ul << i))
+            continue;
+        if (channelconfig[i].type == AC_POWER && energy->active < 0)
+            energy->active = i;
+        else if (channelconfig[i].type == AC_REACTIVE_POWER && energy->reactive < 0)
+            energy->reactive = i;
+        else if (channelconfig[i].type == AC_VOLTAGE && energy->voltage < 0)
+            energy->voltage = i;
+        else if (channelconfig[i].type == AC_CURRENT && energy->current < 0)
+            energy->current = i;
     }
 
-    // Bandera para determinar si la señal AC_VOLTAGE es válida.
-    bool ac_voltage_valid = false;
+    // Sólo los canales que recién pasan a neutro, los que ya estaban no cambiaron.
+    uint32_t idle = work.idle & ~channel_work.idle;
+    channel_work = work;
 
-    // Recorre todos los canales para procesar el RMS.
-    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    while (idle)
     {
-        // Calcula el RMS base, evita divisiones por 0.
-        float rms_calc = (round > 0) ? sqrt(channelconfig[i].sum / (numbersOfSamples * round)) : 0.0;
+        int i = __builtin_ctz(idle);
 
-        // Procesa según el tipo de canal.
-        switch (channelconfig[i].type)
+        idle &= idle - 1;
+        for (int n = 0; n < numbersOfSamples; n++)
+            buffer[i][n] = 2048;
+        channelconfig[i].sum = 0.0;
+        memset(quadrature_history[i], 0, sizeof(quadrature_history[i]));
+#ifdef MEASURE_FIXED_POINT
+        fixed_sum[i] = 0;
+        fixed_tail_sum[i] = 0;
+        fixed_square_sum[i] = 0;
+        fixed_tail_square_sum[i] = 0;
+        fixed_sample[i] = 0;
+#else
+        window_tail_sum[i] = 0.0;
+        square_sum[i] = 0.0;
+        window_tail_square_sum[i] = 0.0;
+        adc_sample[i] = 0.0;
+        if (block_sample)
+            dsp_fill_f32(block_sample[i], numbersOfSamples, 0.0);
+#endif
+    }
+}
+
+#ifndef MEASURE_FIXED_POINT
+/**
+ * @brief Procesa un bloque de muestras canal por canal, aplicando cada opcode a todo el bloque.
+ *
+ * Los canales se evalúan en el orden de channel_schedule, así todo operando ya tiene el bloque
+ * actual, igual que en el motor por muestras. La única diferencia es MUL_REACTIVE, que lee el buffer de salida del bloque actual en
+ * lugar de una mezcla del bloque actual y el anterior; con bloques coherentes con la red ambos
+ * coinciden. MUL_QUADRATURE lee muestras ya pasadas del operando y da lo mismo en ambos motores.
+ * Los opcodes extendidos guardan estado muestra a muestra y quedan para el motor por muestras.
+ *
+ * @param adc_samples Filas de adc_extended del bloque, ya separadas por canal virtual del ADC.
+ * @param split Primera muestra que se suma a window_tail_sum en vez de channelconfig[].sum.
+ * @return true si el bloque fue procesado, false si hay que usar el motor por muestras.
+ */
+static bool measure_process_block_major(uint16_t adc_samples[VIRTUAL_ADC_CHANNELS][MEASURE_ADC_ROW], int split)
+{
+    if (!channel_schedule.block || channel_schedule.extended)
+        return (false);
+
+    // Reserva los buffers de bloque la primera vez que se usa este motor.
+    if (!block_sample)
+    {
+        block_sample = (float(*)[numbersOfSamples])calloc(VIRTUAL_CHANNELS, sizeof(*block_sample));
+        if (!block_sample)
         {
-        case DC_CURRENT:
-            if (channelconfig[i].ratio > 5)
+            log_e("sin memoria para el motor de bloques");
+            return (false);
+        }
+    }
+
+    for (int k = 0; k < channel_work.len; k++)
+    {
+        int i = channel_work.order[k];
+        float *x = block_sample[i];
+        const channel_plan_t *plan = &channel_plan[i];
+
+        // Un programa vacío mantiene el último valor del canal.
+        if (!plan->len)
+            dsp_fill_f32(x, numbersOfSamples, adc_sample[i]);
+
+        for (int operation = 0; operation < plan->len; operation++)
+        {
+            int op_channel = plan->op[operation].operand;
+            const float *operand = block_sample[op_channel];
+
+            switch (plan->op[operation].opcode)
             {
-                channelconfig[i].rms = channelconfig[i].ratio + channelconfig[i].offset;
-            }
-            else
+            case ADD:
+                dsp_add_f32(x, operand, x, numbersOfSamples);
+                break;
+            case SUB:
+                dsp_sub_f32(x, operand, x, numbersOfSamples);
+                break;
+            case MUL:
+                dsp_mul_f32(x, operand, x, numbersOfSamples);
+                break;
+            case MUL_RATIO:
+                dsp_mulc_f32(x, x, numbersOfSamples, channelconfig[op_channel].ratio);
+                break;
+            case MUL_SIGN:
+                dsp_mulsign_f32(x, operand, x, numbersOfSamples);
+                break;
+            case MUL_REACTIVE:
             {
-                if (channelconfig[i].true_rms)
-                {
-                    channelconfig[i].rms = (channelconfig[i].ratio * rms_calc) + channelconfig[i].offset;
-                }
-                else
+                // Multiplica por el signo reactivo basado en el desfase de 90°.
+                int index = channel_phase[i].offset_90;
+                for (int n = 0; n < numbersOfSamples; n++)
                 {
-                    channelconfig[i].rms = (channelconfig[i].ratio * (channelconfig[i].sum / (numbersOfSamples * round))) + channelconfig[i].offset;
+                    temp_adc_sample[i] = buffer[op_channel][index] - 2048.0;
+                    channelconfig[i].sign = (temp_adc_sample[i] > 0.0) ? 1.0 : -1.0;
+                    x[n] *= channelconfig[i].sign;
+                    if (++index >= numbersOfSamples)
+                        index = 0;
                 }
+                break;
             }
-            break;
-
-        case AC_CURRENT:
-            if (channelconfig[i].ratio > 5)
-            {
-                channelconfig[i].rms = channelconfig[i].ratio + channelconfig[i].offset;
-            }
-            else
+            case MUL_QUADRATURE:
             {
-                if (channelconfig[i].true_rms)
+                // Operando retardado un cuarto de ciclo: del bloque actual o, al principio, del anterior.
+                const float *history = quadrature_history[op_channel];
+                for (int n = 0; n < numbersOfSamples; n++)
                 {
-                    channelconfig[i].rms = (channelconfig[i].ratio * rms_calc > 0)
-                                               ? (channelconfig[i].ratio * rms_calc) + channelconfig[i].offset
-                                               : 0;
+                    float value = 0.0;
+                    for (int tap = 0; tap < FRACDELAY_TAPS; tap++)
+                    {
+                        int index = n - quadrature_delay.delay - tap;
+                        value += quadrature_delay.coef[tap] * ((index >= 0) ? block_sample[op_channel][index] : history[(quadrature_pos + index) & (MEASURE_QUADRATURE_LEN - 1)]);
+                    }
+                    x[n] *= value;
                 }
-                else
+                break;
+            }
+            case ABS:
+                dsp_abs_f32(x, x, numbersOfSamples);
+                break;
+            case NEG:
+                dsp_neg_f32(x, x, numbersOfSamples);
+                break;
+            case PASS_NEGATIVE:
+                dsp_clamp_max_zero_f32(x, x, numbersOfSamples);
+                break;
+            case PASS_POSITIVE:
+                dsp_clamp_min_zero_f32(x, x, numbersOfSamples);
+                break;
+            case GET_ADC:
+            {
+                const uint16_t *adc = adc_samples[op_channel] + MEASURE_ADC_HEAD;
+                // Con desfase fraccionario se interpola muestra a muestra.
+                if (channel_phase[i].fractional)
                 {
-                    channelconfig[i].rms = (channelconfig[i].ratio * (channelconfig[i].sum / (numbersOfSamples * round)) > 0.05)
-                                               ? (channelconfig[i].ratio * (channelconfig[i].sum / (numbersOfSamples * round))) + channelconfig[i].offset
-                                               : 0;
+                    for (int n = 0; n < numbersOfSamples; n++)
+                        x[n] = measure_adc_value(adc, channel_phase[i].offset_0 + n, &channel_phase[i]);
+                    break;
                 }
+                // Lectura desfasada del canal ADC, contigua en adc_extended.
+                adc += channel_phase[i].offset_0;
+                for (int n = 0; n < numbersOfSamples; n++)
+                    x[n] = adc[n] * adc_scale;
+                break;
             }
-            break;
+            case SET_TO:
+                dsp_fill_f32(x, numbersOfSamples, op_channel);
+                break;
+            case FILTER:
+                filter_process(&filter_state[i], op_channel, measure_config.high_pass_coef, x, numbersOfSamples);
+                break;
+            default:
+                break;
+            }
+        }
 
-        case DC_POWER:
-        case AC_POWER:
-        case AC_REACTIVE_POWER:
-            if (channelconfig[i].ratio > 5)
+        // Almacena las muestras procesadas y acumula la suma del canal.
+        for (int n = 0; n < numbersOfSamples; n++)
+        {
+            if (channelconfig[i].type == AC_VOLTAGE && measure_get_channel_ratio(i) > 5)
             {
-                channelconfig[i].rms = channelconfig[i].ratio + channelconfig[i].offset;
+                buffer[i][n] = 2048;
             }
             else
             {
-                if (channelconfig[i].true_rms)
-                {
-                    channelconfig[i].rms = (channelconfig[i].ratio * rms_calc > 0)
-                                               ? (channelconfig[i].ratio * rms_calc) + channelconfig[i].offset
-                                               : 0;
-                }
-                else
-                {
-                    channelconfig[i].rms = (channelconfig[i].ratio * (channelconfig[i].sum / (numbersOfSamples * round)) > 0.1)
-                                               ? (channelconfig[i].ratio * (channelconfig[i].sum / (numbersOfSamples * round))) + channelconfig[i].offset
-                                               : 0;
-                }
+                buffer[i][n] = (x[n] + 2048 < 0.0) ? 0 : (x[n] * measure_get_channel_ratio(i)) + 2048;
             }
-            break;
 
-        case AC_VOLTAGE:
-        case DC_VOLTAGE:
-            if (channelconfig[i].ratio > 5)
-            {
-                channelconfig[i].rms = channelconfig[i].ratio + channelconfig[i].offset;
-            }
-            else
+            // Armónicas seleccionadas del canal, en cuadros de ciclos con ventana de Hann.
+            if (channelconfig[i].harmonics)
+                goertzel_update(&harmonic_state[i], harmonic_coef, channelconfig[i].harmonics, x[n], harmonic_window[n], harmonic_restart[n]);
+            measure_iec_capture(i, n, x[n]);
+            measure_phasor_update(i, n, x[n]);
+
+            float *sum = (n < split) ? &channelconfig[i].sum : &window_tail_sum[i];
+            switch (channelconfig[i].type)
             {
+            case AC_CURRENT:
+            case AC_VOLTAGE:
                 if (channelconfig[i].true_rms)
                 {
-                    channelconfig[i].rms = (channelconfig[i].ratio * rms_calc > 0)
-                                               ? (channelconfig[i].ratio * rms_calc) + channelconfig[i].offset
-                                               : 0;
+                    *sum += x[n] * x[n];
                 }
                 else
                 {
-                    channelconfig[i].rms = (channelconfig[i].ratio * (channelconfig[i].sum / (numbersOfSamples * round)) > 40)
-                                               ? (channelconfig[i].ratio * (channelconfig[i].sum / (numbersOfSamples * round))) + channelconfig[i].offset
-                                               : 0;
+                    *sum += fabs(x[n]);
                 }
+                *((n < split) ? &square_sum[i] : &window_tail_square_sum[i]) += x[n] * x[n];
+                break;
+            case AC_POWER:
+            case AC_REACTIVE_POWER:
+            case DC_CURRENT:
+            case DC_VOLTAGE:
+            case DC_POWER:
+                *sum += (channelconfig[i].true_rms) ? (x[n] * x[n]) : x[n];
+                break;
+            case NO_CHANNEL_TYPE:
+                break;
             }
+        }
 
-            // Actualiza la bandera si la señal de AC_VOLTAGE es válida.
-            if (channelconfig[i].rms >= 40)
-            {
-                ac_voltage_valid = true;
-            }
-            break;
+        adc_sample[i] = x[numbersOfSamples - 1];
+    }
 
-        case NO_CHANNEL_TYPE:
-            // No se realiza ninguna acción si el canal no tiene un tipo definido.
-            break;
-        }
+    // Historia para MUL_QUADRATURE del bloque siguiente, igual que la deja el motor por muestras.
+    for (uint32_t sources = quadrature_sources; sources; sources &= sources - 1)
+    {
+        int i = __builtin_ctz(sources);
+        for (int n = numbersOfSamples - MEASURE_QUADRATURE_LEN; n < numbersOfSamples; n++)
+            quadrature_history[i][(quadrature_pos + n) & (MEASURE_QUADRATURE_LEN - 1)] = block_sample[i][n];
+    }
+    quadrature_pos += numbersOfSamples;
+
+    return (true);
+}
+#else
+/**
+ * @brief Muestra Q31 del ADC para GET_ADC, con unidad 4096 y el desfase fraccionario del canal.
+ *
+ * @param adc Primera muestra del bloque en la fila de adc_extended del canal del ADC.
+ * @param index Índice ya desplazado por offset_0, puede pasar del final del bloque.
+ * @param phase Desfase del canal virtual.
+ * @return int32_t muestra en Q31.
+ */
+static inline int32_t measure_adc_value(const uint16_t *adc, int index, const channel_phase_t *phase)
+{
+    if (!phase->fractional)
+        return ((int32_t)adc[index] << (19 - ADCCAL_FRACTION_BITS));
+
+    // coef en Q31 por cuentas con ADCCAL_FRACTION_BITS bits fraccionarios: se lleva a Q31 con unidad 4096.
+    int64_t value = 0;
+    for (int tap = 0; tap < FRACDELAY_TAPS; tap++)
+        value += (int64_t)phase->coef[tap] * adc[index + phase->fraction.delay + tap];
+    return (q31_sat(value >> (12 + ADCCAL_FRACTION_BITS)));
+}
 
+/**
+ * @brief Valor Q31 de un canal un cuarto de ciclo antes de la muestra actual, para MUL_QUADRATURE.
+ *
+ * @param channel Canal operando, debe estar en quadrature_sources.
+ * @return int32_t valor retardado en la escala del canal operando.
+ */
+static inline int32_t measure_quadrature_sample(int channel)
+{
+    const int32_t *history = quadrature_history[channel];
+    uint32_t pos = quadrature_pos - quadrature_delay.delay;
+    int64_t value = 0;
+
+    for (int tap = 0; tap < FRACDELAY_TAPS; tap++)
+        value += ((int64_t)quadrature_coef[tap] * history[(pos - tap) & (MEASURE_QUADRATURE_LEN - 1)]) >> 31;
+    return (q31_sat(value));
+}
+
+/**
+ * @brief Guarda la muestra Q31 actual de los canales de quadrature_sources y avanza a la siguiente.
+ *
+ * @param value Valor actual de cada canal virtual.
+ */
+static inline void measure_quadrature_store(const int32_t *value)
+{
+    for (uint32_t sources = quadrature_sources; sources; sources &= sources - 1)
+    {
+        int i = __builtin_ctz(sources);
+        quadrature_history[i][quadrature_pos & (MEASURE_QUADRATURE_LEN - 1)] = value[i];
+    }
+    quadrature_pos++;
+}
+
+/**
+ * @brief Procesa un bloque de muestras en punto fijo, recorriendo primero las muestras y luego los canales.
+ *
+ * Reproduce al motor por muestras con valores Q31 y sumas de 64 bits. Las escalas de cada canal,
+ * incluidos los MUL_RATIO, se resuelven en measure_compile_fixed_point() y recién se aplican al
+ * pasar las sumas a channelconfig[].sum en measure_fixed_point_sums().
+ *
+ * @param adc_samples Filas de adc_extended del bloque, ya separadas por canal virtual del ADC.
+ * @param split Primera muestra que se suma a fixed_tail_sum en vez de fixed_sum.
+ */
+static void measure_process_fixed_point(uint16_t adc_samples[VIRTUAL_ADC_CHANNELS][MEASURE_ADC_ROW], int split)
+{
+    int phaseshift_0_degree;
+    int phaseshift_90_degree;
+
+    for (int n = 0; n < numbersOfSamples; n++)
+    {
+        for (int k = 0; k < channel_work.len; k++)
+        {
+            int i = channel_work.order[k];
+            const fixed_plan_t *plan = &fixed_plan[i];
+            int32_t q = fixed_sample[i];
+
+            phaseshift_0_degree = n + channel_phase[i].offset_0;
+
+            phaseshift_90_degree = n + channel_phase[i].offset_90;
+            if (phaseshift_90_degree >= numbersOfSamples)
+                phaseshift_90_degree -= numbersOfSamples;
+
+            for (int operation = 0; operation < plan->len; operation++)
+            {
+                const fixed_op_t *op = &plan->op[operation];
+                int op_channel = op->operand;
+
+                switch (op->opcode)
+                {
+                case ADD:
+                    q = q31_sat((int64_t)q31_mul(q, op->k1) + q31_mul((op_channel == i) ? q : fixed_sample[op_channel], op->k2));
+                    break;
+                case SUB:
+                    q = q31_sat((int64_t)q31_mul(q, op->k1) - q31_mul((op_channel == i) ? q : fixed_sample[op_channel], op->k2));
+                    break;
+                case MUL:
+                    q = q31_mul(q, (op_channel == i) ? q : fixed_sample[op_channel]);
+                    break;
+                case MUL_SIGN:
+                    if (!(((op_channel == i) ? q : fixed_sample[op_channel]) > 0))
+                        q = q31_neg(q);
+                    break;
+                case MUL_REACTIVE:
+                    channelconfig[i].sign = (buffer[op_channel][phaseshift_90_degree] > 2048) ? 1.0 : -1.0;
+                    if (channelconfig[i].sign < 0.0)
+                        q = q31_neg(q);
+                    break;
+                case MUL_QUADRATURE:
+                    q = q31_mul(q, measure_quadrature_sample(op_channel));
+                    break;
+                case ABS:
+                    q = q31_abs(q);
+                    break;
+                case NEG:
+                    q = q31_neg(q);
+                    break;
+                case PASS_NEGATIVE:
+                    if (q > 0)
+                        q = 0;
+                    break;
+                case PASS_POSITIVE:
+                    if (q < 0)
+                        q = 0;
+                    break;
+                case GET_ADC:
+                    // 12 bits del ADC con unidad 4096.
+                    q = measure_adc_value(adc_samples[op_channel] + MEASURE_ADC_HEAD, phaseshift_0_degree, &channel_phase[i]);
+                    break;
+                case SET_TO:
+                    q = op->k1;
+                    break;
+                case FILTER:
+                    q = filter_process_q31(&fixed_filter_state[i], op_channel, fixed_high_pass_coef, q);
+                    break;
+                default:
+                    break;
+                }
+            }
+            fixed_sample[i] = q;
+
+            // Buffer de salida: q * unidad * ratio + 2048, sin pasar por float.
+            if (channelconfig[i].type == AC_VOLTAGE && measure_get_channel_ratio(i) > 5)
+            {
+                buffer[i][n] = 2048;
+            }
+            else if (q < plan->out_floor)
+            {
+                buffer[i][n] = 0;
+            }
+            else
+            {
+                int64_t out = (((int64_t)q * plan->out_mantissa) >> plan->out_shift) + 2048;
+                buffer[i][n] = (out < 0) ? 0 : (out > 0xffff) ? 0xffff : out;
+            }
+
+            // Armónicas seleccionadas del canal, en cuadros de ciclos con ventana de Hann.
+            if (channelconfig[i].harmonics)
+                goertzel_update(&harmonic_state[i], harmonic_coef, channelconfig[i].harmonics, q, harmonic_window[n], harmonic_restart[n]);
+            measure_iec_capture(i, n, q);
+            measure_phasor_update(i, n, q);
+
+            // Cuadrados con q >> 8 para que un segundo de muestras a fondo de escala entre en 64 bits.
+            int32_t q_sq = q >> 8;
+            int64_t *sum = (n < split) ? &fixed_sum[i] : &fixed_tail_sum[i];
+            switch (channelconfig[i].type)
+            {
+            case AC_CURRENT:
+            case AC_VOLTAGE:
+                *sum += (channelconfig[i].true_rms) ? (int64_t)q_sq * q_sq : (int64_t)q31_abs(q);
+                *((n < split) ? &fixed_square_sum[i] : &fixed_tail_square_sum[i]) += (int64_t)q_sq * q_sq;
+                break;
+            case AC_POWER:
+            case AC_REACTIVE_POWER:
+            case DC_CURRENT:
+            case DC_VOLTAGE:
+            case DC_POWER:
+                *sum += (channelconfig[i].true_rms) ? (int64_t)q_sq * q_sq : (int64_t)q;
+                break;
+            case NO_CHANNEL_TYPE:
+                break;
+            }
+        }
+
+        measure_quadrature_store(fixed_sample);
+    }
+}
+
+/**
+ * @brief Pasa una suma de punto fijo de un canal a las unidades del motor float.
+ *
+ * Es el único lugar donde se aplica la escala de cada canal, que ya incluye sus MUL_RATIO.
+ *
+ * @param channel Canal virtual.
+ * @param sum Suma de punto fijo del canal.
+ * @return double suma en las unidades de channelconfig[].sum.
+ */
+static double measure_fixed_point_sum(int channel, int64_t sum)
+{
+    double unit = fixed_plan[channel].unit;
+
+    if (channelconfig[channel].true_rms)
+        return ((double)sum * unit * unit / 70368744177664.0); // (q >> 8)^2 -> 2^46
+    return ((double)sum * unit / 2147483648.0);                // q -> 2^31
+}
+
+/**
+ * @brief Pasa las sumas de punto fijo a channelconfig[].sum en las unidades del motor float.
+ */
+static void measure_fixed_point_sums(void)
+{
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        channelconfig[i].sum = measure_fixed_point_sum(i, fixed_sum[i]);
+}
+
+/**
+ * @brief Deduce la escala de cada canal y compila los planes de punto fijo.
+ *
+ * Lo llama measure_update_program() en la tarea de medición, cada vez que toma programas nuevos o
+ * cambia un ratio o el pasa alto. Los canales vivos se compilan en el orden de channel_schedule, así la escala final de
+ * todo operando ya se conoce. Si el orden no existe (dependencias circulares o programas que
+ * parten de la muestra anterior) no hay escala fija posible y los canales quedan en cero. Lo mismo
+ * pasa con los canales que usan opcodes extendidos y con los que leen su valor.
+ *
+ * Escalas: GET_ADC 4096, SET_TO k la potencia de dos mayor a k, MUL el producto de ambas,
+ * MUL_RATIO multiplica la escala por el ratio y ADD/SUB llevan ambos operandos al doble de la
+ * mayor para no desbordar.
+ *
+ * Error frente al motor float (host, señales de 50 Hz con tercera armónica y ruido): menor a
+ * 0.01% en los RMS de tensión, corriente y potencia, dominado por la acumulación en float del
+ * propio motor float. El buffer de salida difiere a lo sumo en 1 cuenta; los valores fuera de
+ * 0..65535 saturan en vez de desbordar.
+ */
+static void measure_compile_fixed_point(void)
+{
+    fixed_high_pass_coef = q31_sat(llround(measure_config.high_pass_coef * 1073741824.0));
+
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        fixed_plan[i].valid = false;
+    // Los canales sin plan válido salen de channel_work.
+    measure_request_work();
+
+    if (!channel_schedule.block)
+    {
+        log_e("los programas de los canales no tienen una escala fija, el motor de punto fijo no los procesa");
+        return;
+    }
+
+    for (int s = 0; s < channel_schedule.len; s++)
+    {
+        int i = channel_schedule.order[s];
+        const channel_plan_t *plan = &channel_plan[i];
+        fixed_plan_t fixed;
+        double unit = 1.0;
+
+        fixed.valid = true;
+        fixed.len = 0;
+        for (int operation = 0; operation < plan->len; operation++)
+        {
+            fixed_op_t op = {plan->op[operation].opcode, plan->op[operation].operand, 0, 0};
+            bool reads = op.opcode == ADD || op.opcode == SUB || op.opcode == MUL || op.opcode == MUL_SIGN || op.opcode == MUL_QUADRATURE;
+
+            // Los opcodes extendidos no tienen una escala fija, ni los canales que leen su resultado.
+            if (op.opcode == NOP || (reads && op.operand != i && !fixed_plan[op.operand].valid))
+            {
+                fixed.valid = false;
+                break;
+            }
+
+            double op_unit = (op.operand == i) ? unit : fixed_plan[op.operand].unit;
+
+            switch (op.opcode)
+            {
+            case GET_ADC:
+                unit = 4096.0;
+                break;
+            case SET_TO:
+            {
+                double value = op.operand;
+
+                unit = 1.0;
+                while (unit <= value)
+                    unit *= 2.0;
+                op.k1 = q31_from_float(value / unit);
+                break;
+            }
+            case ADD:
+            case SUB:
+            {
+                double sum_unit = 2.0 * ((unit > op_unit) ? unit : op_unit);
+
+                op.k1 = q31_from_float(unit / sum_unit);
+                op.k2 = q31_from_float(op_unit / sum_unit);
+                unit = sum_unit;
+                break;
+            }
+            case MUL:
+            case MUL_QUADRATURE:
+                unit *= op_unit;
+                break;
+            case MUL_RATIO:
+            {
+                double ratio = channelconfig[op.operand].ratio;
+
+                // El ratio sólo cambia la escala; su signo se traduce en un NEG y un cero en SET_TO 0.
+                if (ratio == 0.0)
+                {
+                    op.opcode = SET_TO;
+                    op.k1 = 0;
+                }
+                else if (ratio < 0.0)
+                {
+                    op.opcode = NEG;
+                    unit *= -ratio;
+                }
+                else
+                {
+                    unit *= ratio;
+                    continue;
+                }
+                break;
+            }
+            default:
+                break;
+            }
+
+            fixed.op[fixed.len++] = op;
+        }
+
+        if (!fixed.valid)
+        {
+            log_e("canal %d: usa opcodes extendidos o lee un canal que los usa, el motor de punto fijo no lo procesa", i);
+            continue;
+        }
+
+        // Ganancia de salida unit * ratio como mantisa Q31 y exponente.
+        int exponent;
+        double mantissa = frexp(unit * channelconfig[i].ratio, &exponent);
+        int shift = 62 - exponent;
+
+        fixed.unit = unit;
+        fixed.out_mantissa = q31_from_float(mantissa);
+        fixed.out_shift = (shift < 0) ? 0 : (shift > 63) ? 63 : shift;
+        fixed.out_floor = (int64_t)fmax(ceil(-2048.0 * 2147483648.0 / unit), -4294967296.0);
+        fixed_plan[i] = fixed;
+    }
+}
+#endif
+
+/**
+ * @brief Publica el bloque actual de buffer sin esperar a los lectores.
+ *
+ * Escribe en un buffer que no sea el último publicado ni esté tomado por un lector, y recién al
+ * terminar lo marca como el último. Los lectores de measure_acquire_buffer() nunca ven un bloque
+ * a medio escribir. Si todos los buffers están tomados el bloque se descarta.
+ *
+ * @param valid true copia buffer, false publica un bloque en cero.
+ */
+static void measure_publish_snapshot(bool valid)
+{
+    int latest = __atomic_load_n(&snapshot_latest, __ATOMIC_SEQ_CST);
+    int slot = -1;
+
+    for (int i = 0; i < MEASURE_SNAPSHOT_SLOTS; i++)
+    {
+        if (i != latest && __atomic_load_n(&snapshot[i].readers, __ATOMIC_SEQ_CST) == 0)
+        {
+            slot = i;
+            break;
+        }
+    }
+
+    if (slot < 0)
+    {
+        snapshot_dropped++;
+        return;
+    }
+
+    if (valid)
+        memcpy(&snapshot[slot].sample[0][0], &buffer[0][0], sizeof(buffer));
+    else
+        memset(&snapshot[slot].sample[0][0], 0, sizeof(snapshot[slot].sample));
+    snapshot[slot].sequence = ++snapshot_sequence;
+
+    __atomic_store_n(&snapshot_latest, slot, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Calcula el espectro de los canales con tensión y corriente para el osciloscopio.
+ *
+ * Toma 64 muestras de cada 6 del bloque; como el bloque dura dos ciclos, las muestras que dan la
+ * vuelta siguen la misma señal y la ventana cubre tres ciclos, con la fundamental en el bin 3.
+ * Los canales los elige measure_get_spectrum_channel() por su tipo, así cada perfil y cada
+ * configuración tienen los suyos; los demás quedan en cero.
+ *
+ * @param valid false deja el espectro en cero, como el bloque publicado.
+ */
+static void measure_update_spectrum(bool valid)
+{
+    // Muestras del canal y, después de la FFT, su espectro empaquetado.
+    static float spectrum[numbersOfFFTSamples * 2];
+
+    for (int channel = 0; channel < VIRTUAL_CHANNELS; channel++)
+    {
+        if (!valid || !measure_get_spectrum_channel(channel))
+        {
+            memset(buffer_fft[channel], 0, sizeof(buffer_fft[channel]));
+            continue;
+        }
+        float ratio = measure_get_channel_ratio(channel);
+
+        // Llena el buffer con datos del canal actual; ventana rectangular, el bloque ya es periódico.
+        for (int i = 0; i < numbersOfFFTSamples * 2; i++)
+            spectrum[i] = ratio * buffer[channel][(i * 6) % numbersOfSamples];
+
+        // FFT real y magnitudes normalizadas directo al espectro publicado; la continua no se muestra.
+        fft_real(spectrum, numbersOfFFTSamples * 2);
+        fft_magnitude(spectrum, numbersOfFFTSamples * 2, buffer_fft[channel], numbersOfFFTSamples, 1.0 / (numbersOfFFTSamples * 2));
+        buffer_fft[channel][0] = 0;
+    }
+}
+
+/**
+ * @brief Publica las armónicas del último bloque y el espectro para los lectores.
+ *
+ * Es un seqlock con un solo escritor: la secuencia es impar mientras se copia y los lectores
+ * repiten la lectura si la vieron impar o cambió. El espectro se calcula antes de abrir la
+ * escritura, así los lectores nunca esperan a la FFT.
+ *
+ * @param valid false publica el espectro en cero.
+ */
+static void measure_publish_analysis(bool valid)
+{
+    measure_update_spectrum(valid);
+
+    __atomic_add_fetch(&analysis_sequence, 1, __ATOMIC_SEQ_CST);
+    memcpy(analysis.harmonics, harmonic_values, sizeof(analysis.harmonics));
+    memcpy(analysis.spectrum, buffer_fft, sizeof(analysis.spectrum));
+    __atomic_add_fetch(&analysis_sequence, 1, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Calcula el RMS, promedio o potencia de cada canal a partir de sus sumas.
+ *
+ * @param samples Cantidad de muestras por canal integradas en las sumas.
+ */
+static void measure_update_rms(uint32_t samples)
+{
+    // Bandera para determinar si la señal AC_VOLTAGE es válida.
+    bool ac_voltage_valid = false;
+
+    // Recorre todos los canales para procesar el RMS.
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        // Calcula el RMS base, evita divisiones por 0.
+        float rms_calc = (samples > 0) ? sqrt(channelconfig[i].sum / samples) : 0.0;
+
+        // Procesa según el tipo de canal.
+        switch (channelconfig[i].type)
+        {
+        case DC_CURRENT:
+            if (channelconfig[i].ratio > 5)
+            {
+                channelconfig[i].rms = channelconfig[i].ratio + channelconfig[i].offset;
+            }
+            else
+            {
+                if (channelconfig[i].true_rms)
+                {
+                    channelconfig[i].rms = (channelconfig[i].ratio * rms_calc) + channelconfig[i].offset;
+                }
+                else
+                {
+                    channelconfig[i].rms = (channelconfig[i].ratio * (channelconfig[i].sum / samples)) + channelconfig[i].offset;
+                }
+            }
+            break;
+
+        case AC_CURRENT:
+            if (channelconfig[i].ratio > 5)
+            {
+                channelconfig[i].rms = channelconfig[i].ratio + channelconfig[i].offset;
+            }
+            else
+            {
+                if (channelconfig[i].true_rms)
+                {
+                    channelconfig[i].rms = (channelconfig[i].ratio * rms_calc > 0)
+                                               ? (channelconfig[i].ratio * rms_calc) + channelconfig[i].offset
+                                               : 0;
+                }
+                else
+                {
+                    channelconfig[i].rms = (channelconfig[i].ratio * (channelconfig[i].sum / samples) > 0.05)
+                                               ? (channelconfig[i].ratio * (channelconfig[i].sum / samples)) + channelconfig[i].offset
+                                               : 0;
+                }
+            }
+            break;
+
+        case AC_REACTIVE_POWER:
+            // Con signo: positiva con carga inductiva, negativa con carga capacitiva.
+            if (channelconfig[i].ratio > 5)
+            {
+                channelconfig[i].rms = channelconfig[i].ratio + channelconfig[i].offset;
+            }
+            else if (channelconfig[i].true_rms)
+            {
+                channelconfig[i].rms = (channelconfig[i].ratio * rms_calc > 0)
+                                           ? (channelconfig[i].ratio * rms_calc) + channelconfig[i].offset
+                                           : 0;
+            }
+            else
+            {
+                channelconfig[i].rms = (fabs(channelconfig[i].ratio * (channelconfig[i].sum / samples)) > 0.1)
+                                           ? (channelconfig[i].ratio * (channelconfig[i].sum / samples)) + channelconfig[i].offset
+                                           : 0;
+            }
+            break;
+
+        case DC_POWER:
+        case AC_POWER:
+            if (channelconfig[i].ratio > 5)
+            {
+                channelconfig[i].rms = channelconfig[i].ratio + channelconfig[i].offset;
+            }
+            else
+            {
+                if (channelconfig[i].true_rms)
+                {
+                    channelconfig[i].rms = (channelconfig[i].ratio * rms_calc > 0)
+                                               ? (channelconfig[i].ratio * rms_calc) + channelconfig[i].offset
+                                               : 0;
+                }
+                else
+                {
+                    // Con signo, como la reactiva: negativa cuando la potencia se exporta.
+                    channelconfig[i].rms = (fabs(channelconfig[i].ratio * (channelconfig[i].sum / samples)) > 0.1)
+                                               ? (channelconfig[i].ratio * (channelconfig[i].sum / samples)) + channelconfig[i].offset
+                                               : 0;
+                }
+            }
+            break;
+
+        case AC_VOLTAGE:
+        case DC_VOLTAGE:
+            if (channelconfig[i].ratio > 5)
+            {
+                channelconfig[i].rms = channelconfig[i].ratio + channelconfig[i].offset;
+            }
+            else
+            {
+                if (channelconfig[i].true_rms)
+                {
+                    channelconfig[i].rms = (channelconfig[i].ratio * rms_calc > 0)
+                                               ? (channelconfig[i].ratio * rms_calc) + channelconfig[i].offset
+                                               : 0;
+                }
+                else
+                {
+                    channelconfig[i].rms = (channelconfig[i].ratio * (channelconfig[i].sum / samples) > 40)
+                                               ? (channelconfig[i].ratio * (channelconfig[i].sum / samples)) + channelconfig[i].offset
+                                               : 0;
+                }
+            }
+
+            // Actualiza la bandera si la señal de AC_VOLTAGE es válida.
+            if (channelconfig[i].rms >= 40)
+            {
+                ac_voltage_valid = true;
+            }
+            break;
+
+        case NO_CHANNEL_TYPE:
+            // No se realiza ninguna acción si el canal no tiene un tipo definido.
+            break;
+        }
+
+        // Si la medición no es válida, reinicia el RMS del canal a 0.
+        if (measurement_valid > 0)
+        {
+            channelconfig[i].rms = 0.0;
+            measurement_valid--;
+        }
+    }
+
+    // Si la señal de AC_VOLTAGE no es válida, fuerza todos los canales a 0; recién se sabe después de recorrerlos todos.
+    if (!ac_voltage_valid)
+    {
+        for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        {
+            channelconfig[i].rms = 0.0;
+        }
+    }
+}
+
+/**
+ * @brief Suma de cuadrados de un canal de tensión o corriente, en unidades del motor float al cuadrado.
+ *
+ * @param channel Canal virtual.
+ * @param tail true suma también la parte posterior al cierre de la ventana.
+ * @return double
+ */
+static double measure_channel_square_sum(int channel, bool tail)
+{
+#ifdef MEASURE_FIXED_POINT
+    double unit = fixed_plan[channel].unit;
+
+    return ((double)(fixed_square_sum[channel] + (tail ? fixed_tail_square_sum[channel] : 0)) * unit * unit / 70368744177664.0);
+#else
+    return ((double)square_sum[channel] + (tail ? window_tail_square_sum[channel] : 0.0));
+#endif
+}
+
+/**
+ * @brief Valor eficaz de un canal de tensión o corriente a partir de una suma de cuadrados.
+ *
+ * No depende de true_rms: sin él channelconfig[].rms es el valor medio rectificado, que no sirve
+ * para la potencia aparente. Un canal que la última ventana dejó en cero da cero.
+ *
+ * @param channel Canal virtual.
+ * @param square Suma de cuadrados de measure_channel_square_sum().
+ * @param samples Muestras de la suma.
+ * @return double valor eficaz en las unidades del canal.
+ */
+static double measure_channel_rms(int channel, double square, uint32_t samples)
+{
+    if (channelconfig[channel].rms == 0.0 || !samples)
+        return (0.0);
+    if (channelconfig[channel].ratio > 5)
+        return (channelconfig[channel].rms);
+    return (channelconfig[channel].ratio * sqrt(fmax(square / samples, 0.0)) + channelconfig[channel].offset);
+}
+
+/**
+ * @brief Calcula la potencia aparente y el factor de potencia de cada grupo.
+ *
+ * La aparente es el producto de los valores eficaces de tensión y corriente del grupo, y el factor
+ * de potencia la activa sobre la aparente; así incluye la distorsión y no sólo el desfase de la
+ * fundamental. Los valores eficaces salen de las sumas de cuadrados aunque el canal no tenga
+ * true_rms. Debe llamarse después de measure_update_rms().
+ *
+ * @param samples Cantidad de muestras por canal integradas en las sumas.
+ */
+static void measure_update_power(uint32_t samples)
+{
+    for (int group_id = 0; group_id < MAX_GROUPS; group_id++)
+    {
+        measure_group_power_t power = {0.0, 0.0, 0.0, 0.0};
+        int voltage = measure_get_channel_with_group_id_and_type(group_id, AC_VOLTAGE);
+        int current = measure_get_channel_with_group_id_and_type(group_id, AC_CURRENT);
+        int active = measure_get_channel_with_group_id_and_type(group_id, AC_POWER);
+        int reactive = measure_get_channel_with_group_id_and_type(group_id, AC_REACTIVE_POWER);
+
+        if (groupconfig[group_id].active)
+        {
+            if (active >= 0)
+                power.active = channelconfig[active].rms;
+            if (reactive >= 0)
+                power.reactive = channelconfig[reactive].rms;
+            if (voltage >= 0 && current >= 0)
+                power.apparent = measure_channel_rms(voltage, measure_channel_square_sum(voltage, false), samples) *
+                                 measure_channel_rms(current, measure_channel_square_sum(current, false), samples);
+            if (power.apparent > 0.0)
+                power.power_factor = fmin(fabs(power.active) / power.apparent, 1.0);
+        }
+        group_power[group_id] = power;
+    }
+}
+
+/**
+ * @brief Suma de un canal en lo que va de la ventana, con la parte posterior al cierre, en unidades del motor float.
+ *
+ * @param channel Canal virtual.
+ * @return double
+ */
+static double measure_channel_sum(int channel)
+{
+#ifdef MEASURE_FIXED_POINT
+    return (measure_fixed_point_sum(channel, fixed_sum[channel] + fixed_tail_sum[channel]));
+#else
+    return ((double)channelconfig[channel].sum + window_tail_sum[channel]);
+#endif
+}
+
+/**
+ * @brief Guarda las sumas de los canales de energía antes de procesar el bloque.
+ *
+ * La energía de un bloque sale de lo que crecen las sumas de la ventana durante el bloque, así los
+ * motores no hacen nada más por muestra.
+ */
+static void measure_energy_begin(void)
+{
+    for (int group_id = 0; group_id < MAX_GROUPS; group_id++)
+    {
+        const energy_channels_t *energy = &energy_channel[group_id];
+        int8_t channel[] = {energy->active, energy->reactive, energy->voltage, energy->current};
+
+        for (int k = 0; k < 4; k++)
+            if (channel[k] >= 0)
+                energy_sum_start[channel[k]] = measure_channel_sum(channel[k]);
+        if (energy->voltage >= 0 && energy->current >= 0)
+        {
+            energy_square_start[energy->voltage] = measure_channel_square_sum(energy->voltage, true);
+            energy_square_start[energy->current] = measure_channel_square_sum(energy->current, true);
+        }
+    }
+}
+
+/**
+ * @brief Valor de un canal en el bloque recién procesado, con la cuenta de measure_update_rms() sin umbrales.
+ *
+ * Un canal que la última ventana dejó en cero, por su umbral o por falta de tensión, no acumula
+ * energía; así el ruido sin carga no se integra. Con true_rms la potencia pierde el signo.
+ *
+ * @param channel Canal virtual.
+ * @return double valor en las unidades del canal.
+ */
+static double measure_energy_value(int channel)
+{
+    double mean = (measure_channel_sum(channel) - energy_sum_start[channel]) / numbersOfSamples;
+
+    if (channelconfig[channel].rms == 0.0)
+        return (0.0);
+    if (channelconfig[channel].ratio > 5)
+        return (channelconfig[channel].rms);
+    if (channelconfig[channel].true_rms)
+        mean = sqrt(fmax(mean, 0.0));
+    return (channelconfig[channel].ratio * mean + channelconfig[channel].offset);
+}
+
+/**
+ * @brief Valor eficaz de un canal de tensión o corriente en el bloque recién procesado.
+ *
+ * @param channel Canal virtual.
+ * @return double valor eficaz en las unidades del canal.
+ */
+static double measure_energy_rms(int channel)
+{
+    return (measure_channel_rms(channel, measure_channel_square_sum(channel, true) - energy_square_start[channel], numbersOfSamples));
+}
+
+/**
+ * @brief Integra en los registros de energía el bloque recién procesado.
+ *
+ * La activa y la reactiva van al registro de importación o de exportación según su signo, y la
+ * aparente es tensión eficaz por corriente eficaz de las sumas de cuadrados del bloque, como en
+ * measure_update_power(). Cada bloque
+ * se redondea una sola vez a los bits fraccionarios del registro y el resto es aritmética entera.
+ *
+ * @param blocks Bloques que cubre: 1 más los perdidos justo antes, que se completan con su potencia.
+ */
+static void measure_energy_block(uint32_t blocks)
+{
+    if (!energy_voltage_valid)
+        return;
+
+    // Wh por unidad de potencia, ya con los bits fraccionarios de los registros.
+    double scale = blocks * numbersOfSamples * VIRTUAL_ADC_CHANNELS / measure_sample_rate() / 3600.0 * (double)(1ull << MEASURE_ENERGY_FRACTION_BITS);
+
+    for (int group_id = 0; group_id < MAX_GROUPS; group_id++)
+    {
+        const energy_channels_t *channel = &energy_channel[group_id];
+        int64_t *energy = energy_store.energy[group_id];
+
+        if (channel->active >= 0)
+        {
+            int64_t e = llround(measure_energy_value(channel->active) * scale);
+            if (e >= 0)
+                energy[MEASURE_ENERGY_ACTIVE_IMPORT] += e;
+            else
+                energy[MEASURE_ENERGY_ACTIVE_EXPORT] -= e;
+        }
+        if (channel->reactive >= 0)
+        {
+            int64_t e = llround(measure_energy_value(channel->reactive) * scale);
+            if (e >= 0)
+                energy[MEASURE_ENERGY_REACTIVE_IMPORT] += e;
+            else
+                energy[MEASURE_ENERGY_REACTIVE_EXPORT] -= e;
+        }
+        if (channel->voltage >= 0 && channel->current >= 0)
+            energy[MEASURE_ENERGY_APPARENT] += llround(measure_energy_rms(channel->voltage) * measure_energy_rms(channel->current) * scale);
+    }
+}
+
+/**
+ * @brief CRC de una copia de los registros de energía.
+ *
+ * @param store Copia.
+ * @return uint32_t crc32_le de todo lo que precede al campo crc.
+ */
+static uint32_t measure_energy_crc(const measure_energy_store_t *store)
+{
+    return (crc32_le(0, (const uint8_t *)store, offsetof(measure_energy_store_t, crc)));
+}
+
+/**
+ * @brief Verifica una copia de los registros de energía.
+ *
+ * @param store Copia.
+ * @return true si es de este perfil y su CRC coincide.
+ */
+static bool measure_energy_check(const measure_energy_store_t *store)
+{
+    return (store->magic == MEASURE_ENERGY_MAGIC && store->groups == MAX_GROUPS && store->registers == MEASURE_ENERGY_REGISTERS && store->crc == measure_energy_crc(store));
+}
+
+/**
+ * @brief Lee una copia de los registros de energía de SPIFFS.
+ *
+ * @param name Archivo.
+ * @param store Destino.
+ * @return true si el archivo existe y la copia es válida.
+ */
+static bool measure_energy_read(const char *name, measure_energy_store_t *store)
+{
+    if (!SPIFFS.exists(name))
+        return (false);
+
+    fs::File file = SPIFFS.open(name, FILE_READ);
+    if (!file)
+        return (false);
+    bool read = (file.read((uint8_t *)store, sizeof(*store)) == sizeof(*store));
+    file.close();
+
+    return (read && measure_energy_check(store));
+}
+
+/**
+ * @brief Escribe energy_save_copy en el archivo que no tiene la copia más nueva.
+ *
+ * Los archivos se alternan: si la escritura se corta, el otro conserva la copia anterior y al
+ * arrancar se descarta la que no pasa el CRC. Sólo desde measure_energy_loop().
+ */
+static void measure_energy_save(void)
+{
+    const char *name = energy_file ? MEASURE_ENERGY_FILE_A : MEASURE_ENERGY_FILE_B;
+    fs::File file = SPIFFS.open(name, FILE_WRITE);
+
+    if (!file || file.write((const uint8_t *)&energy_save_copy, sizeof(energy_save_copy)) != sizeof(energy_save_copy))
+    {
+        if (file)
+            file.close();
+        energy_stats.save_errors++;
+        log_e("no se pudieron guardar los registros de energía en %s", name);
+        return;
+    }
+    file.close();
+    energy_file ^= 1;
+    energy_stats.saves++;
+}
+
+/**
+ * @brief Publica los registros de energía para los lectores.
+ */
+static void measure_energy_publish(void)
+{
+    __atomic_add_fetch(&energy_sequence, 1, __ATOMIC_SEQ_CST);
+    memcpy(energy_published, energy_store.energy, sizeof(energy_published));
+    __atomic_add_fetch(&energy_sequence, 1, __ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief Recupera los registros de energía al arrancar.
+ *
+ * Toma la copia válida más nueva entre la de la memoria RTC, que sólo sobrevive a reinicios sin
+ * corte de alimentación y a lo sumo pierde una ventana, y las dos de SPIFFS, que pierden a lo
+ * sumo MEASURE_ENERGY_SAVE_PERIOD. Sin ninguna válida los registros arrancan en cero.
+ */
+static void measure_energy_restore(void)
+{
+    measure_energy_store_t copy;
+
+    memset(&energy_store, 0, sizeof(energy_store));
+    energy_stats.source = MEASURE_ENERGY_SOURCE_NONE;
+    for (int i = 0; i < 2; i++)
+    {
+        if (!measure_energy_read(i ? MEASURE_ENERGY_FILE_B : MEASURE_ENERGY_FILE_A, &copy))
+            continue;
+        if (energy_stats.source == MEASURE_ENERGY_SOURCE_NONE || copy.sequence > energy_store.sequence)
+        {
+            energy_store = copy;
+            energy_file = i;
+            energy_stats.source = MEASURE_ENERGY_SOURCE_FLASH;
+        }
+    }
+    if (measure_energy_check(&energy_rtc) && (energy_stats.source == MEASURE_ENERGY_SOURCE_NONE || energy_rtc.sequence > energy_store.sequence))
+    {
+        energy_store = energy_rtc;
+        energy_stats.source = MEASURE_ENERGY_SOURCE_RTC;
+    }
+
+    energy_store.magic = MEASURE_ENERGY_MAGIC;
+    energy_store.groups = MAX_GROUPS;
+    energy_store.registers = MEASURE_ENERGY_REGISTERS;
+    if (energy_stats.source == MEASURE_ENERGY_SOURCE_NONE)
+        log_w("sin copia válida de los registros de energía, arrancan en cero");
+    else
+        log_i("registros de energía recuperados de %s, copia %u", (energy_stats.source == MEASURE_ENERGY_SOURCE_RTC) ? "RTC" : "SPIFFS", energy_store.sequence);
+
+    measure_energy_publish();
+    energy_save_next_ms = millis() + MEASURE_ENERGY_SAVE_PERIOD * 1000ul;
+}
+
+/**
+ * @brief Cierra la ventana de los registros de energía: los publica, los copia en la memoria RTC y,
+ * cada MEASURE_ENERGY_SAVE_PERIOD segundos, le pasa una copia a measure_energy_loop() para SPIFFS.
+ *
+ * La tarea de medición no escribe la flash. Si la copia anterior todavía no se escribió, se vuelve
+ * a intentar en la ventana siguiente.
+ */
+static void measure_energy_window(void)
+{
+    measure_energy_publish();
+
+    energy_store.sequence++;
+    energy_store.crc = measure_energy_crc(&energy_store);
+    energy_rtc = energy_store;
+
+    if ((int32_t)(millis() - energy_save_next_ms) >= 0 && __atomic_load_n(&energy_save_done, __ATOMIC_ACQUIRE) == energy_save_request)
+    {
+        energy_save_next_ms = millis() + MEASURE_ENERGY_SAVE_PERIOD * 1000ul;
+        energy_save_copy = energy_store;
+        __atomic_add_fetch(&energy_save_request, 1, __ATOMIC_RELEASE);
+    }
+}
+
+void measure_energy_loop(void)
+{
+    uint32_t request = __atomic_load_n(&energy_save_request, __ATOMIC_ACQUIRE);
+
+    if (request == energy_save_done)
+        return;
+    measure_energy_save();
+    __atomic_store_n(&energy_save_done, request, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Busca el canal de tensión de referencia para cruces por cero y frecuencia.
+ *
+ * @return int primer canal AC_VOLTAGE activo cuyo programa empieza con GET_ADC, -1 si no hay.
+ */
+static int measure_reference_channel(void)
+{
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        const channel_plan_t *plan = &channel_plan[i];
+
+        if (channelconfig[i].type == AC_VOLTAGE && groupconfig[channelconfig[i].group_id].active && plan->len && plan->op[0].opcode == GET_ADC)
+            return (i);
+    }
+    return (-1);
+}
+
+/**
+ * @brief Actualiza la frecuencia de red con los cruces por cero de un bloque.
+ *
+ * Usa las muestras crudas del canal de referencia en orden temporal (sin el desfase del canal,
+ * que rota el bloque). Sin tensión, o con una estimación fuera de 16..120 Hz, vuelve a la
+ * frecuencia de red configurada.
+ *
+ * @param adc_samples Muestras del ADC ya separadas por canal virtual.
+ */
+static void measure_update_frequency(uint16_t adc_samples[VIRTUAL_ADC_CHANNELS][numbersOfSamples])
+{
+    float reference[numbersOfSamples];
+    float crossing[4];
+    int found = 0;
+    float channel_rate = measure_sample_rate() / VIRTUAL_ADC_CHANNELS;
+    int reference_channel = measure_reference_channel();
+
+    if (reference_channel >= 0)
+    {
+        const uint16_t *adc = adc_samples[channel_plan[reference_channel].op[0].operand];
+
+        for (int n = 0; n < numbersOfSamples; n++)
+            reference[n] = adc[n] * adc_scale;
+        found = zerocross_find(&frequency_zc, reference, numbersOfSamples, crossing, 4);
+    }
+
+    // Después de un cambio de tasa o de un bloque perdido falta continuidad: se descartan los cruces
+    // y se mantiene la última frecuencia hasta volver a medir.
+    if (frequency_hold > 0)
+    {
+        frequency_hold--;
+        freqtrack_reset(&frequency_track);
+        return;
+    }
+    freqtrack_block(&frequency_track, crossing, found, numbersOfSamples);
+
+    // Sin cruces por más de 5 ciclos nominales la estimación deja de valer.
+    float frequency = freqtrack_frequency(&frequency_track, channel_rate, 5 * numbersOfSamples / 2);
+    frequency_valid = (frequency >= 16.0 && frequency <= 120.0);
+    netfrequency = frequency_valid ? frequency : measure_config.network_frequency;
+}
+
+/**
+ * @brief Calcula el retardo de un cuarto de ciclo de MUL_QUADRATURE para la frecuencia de red actual.
+ *
+ * Se llama una vez por bloque después de measure_update_frequency(); por muestra sólo quedan las
+ * FRACDELAY_TAPS multiplicaciones de la interpolación. Por debajo de unos 27 Hz el retardo no entra
+ * en la historia y queda limitado.
+ */
+static void measure_design_quadrature(void)
+{
+    float channel_rate = measure_sample_rate() / VIRTUAL_ADC_CHANNELS;
+    float delay;
+
+    if (netfrequency <= 0.0)
+        return;
+
+    delay = channel_rate / (4.0 * netfrequency);
+    delay = fmax(delay, FRACDELAY_TAPS / 2);
+    delay = fmin(delay, MEASURE_QUADRATURE_LEN - FRACDELAY_TAPS / 2 - 1);
+    fracdelay_design(&quadrature_delay, delay);
+#ifdef MEASURE_FIXED_POINT
+    for (int tap = 0; tap < FRACDELAY_TAPS; tap++)
+        quadrature_coef[tap] = q31_from_float(quadrature_delay.coef[tap]);
+#endif
+}
+
+/**
+ * @brief Copia el bloque a adc_extended, con lo último del bloque anterior delante y la continuación que leen los desfases detrás.
+ *
+ * GET_ADC lee la muestra n + offset_0, que para las últimas del bloque todavía no llegó. La
+ * continuación es la señal de un número entero de ciclos de netfrequency antes, interpolada: fuera
+ * de la frecuencia nominal esos ciclos no son numbersOfSamples muestras y rotar el mismo bloque
+ * dejaba un salto de fase donde empieza lo rotado. Si el salto no entra en MEASURE_ADC_HEAD se
+ * rota como antes. Se llama una vez por bloque después de measure_update_frequency().
+ *
+ * @param adc_samples Muestras del ADC ya separadas por canal virtual.
+ * @param continuous El bloque sigue al anterior sin pérdidas ni cambio de tasa.
+ */
+static void measure_extend_adc(uint16_t adc_samples[VIRTUAL_ADC_CHANNELS][numbersOfSamples], bool continuous)
+{
+    float period = measure_sample_rate() / VIRTUAL_ADC_CHANNELS / netfrequency;
+    long cycles = lround(numbersOfSamples / period);
+    float shift = (cycles > 0) ? numbersOfSamples - cycles * period : 0.0;
+    fracdelay_t rotation;
+    int tail = 0;
+
+    // Muestras detrás del bloque que lee el mayor desfase, con la interpolación de la corrección fina.
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        int end = channel_phase[i].offset_0;
+        if (channel_phase[i].fractional)
+            end += channel_phase[i].fraction.delay + FRACDELAY_TAPS - 1;
+        if (end > tail)
+            tail = end;
+    }
+
+    if (fabs(shift) > MEASURE_ADC_HEAD - FRACDELAY_TAPS)
+        shift = 0.0;
+    fracdelay_design(&rotation, shift);
+
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+    {
+        uint16_t *row = adc_extended[c] + MEASURE_ADC_HEAD;
+
+        // Sin continuidad la cabeza es el final del mismo bloque, como la rotación.
+        memcpy(adc_extended[c], (continuous ? row : adc_samples[c]) + numbersOfSamples - MEASURE_ADC_HEAD, MEASURE_ADC_HEAD * sizeof(uint16_t));
+        memcpy(row, adc_samples[c], numbersOfSamples * sizeof(uint16_t));
+
+        // La muestra numbersOfSamples + j es la de j + shift; pasado el bloque lee la continuación ya armada.
+        for (int j = 0; j < tail; j++)
+        {
+            if (shift == 0.0)
+            {
+                row[numbersOfSamples + j] = row[j];
+                continue;
+            }
+            float value = 0.0;
+            for (int tap = 0; tap < FRACDELAY_TAPS; tap++)
+                value += rotation.coef[tap] * row[j + rotation.delay + tap];
+            row[numbersOfSamples + j] = (value <= 0.0) ? 0 : (value >= 65535.0) ? 65535 : (uint16_t)lroundf(value);
+        }
+    }
+}
+
+/**
+ * @brief Lazo de la tasa de muestreo: la lleva a 128 muestras por ciclo de la frecuencia medida.
+ *
+ * La frecuencia medida no depende de la tasa pedida (los cruces se cuentan en muestras de la
+ * misma tasa), así que el error en Hz del I2S es directo: (f - f_bloque) * samplingFrequency / 2.
+ * El controlador es PI: la parte proporcional corrige la mitad del error por ventana para promediar
+ * el ruido de la estimación y la integral sigue una red que deriva a ritmo constante. El paso
+ * máximo es MEASURE_PLL_MAX_STEP y el rango MEASURE_PLL_RANGE de la nominal. Dentro de la banda
+ * muerta no se corrige el error, porque cada cambio reinicia el I2S y pierde muestras; sólo se
+ * adelanta la deriva de la red medida ventana a ventana, que no depende de la tasa pedida, cuando
+ * pasa de MEASURE_PLL_MIN_DRIFT, juntando fracciones hasta 1 Hz. Así el lazo acompaña una red en
+ * rampa sin salir de la banda y sigue enganchado, y con la red quieta no toca el I2S.
+ */
+static void measure_update_pll(void)
+{
+    if (!measure_config.sample_pll)
+    {
+        pll_state = MEASURE_PLL_OFF;
+        pll_error = 0.0;
+        pll_locked_windows = 0;
+        pll_integral = 0.0;
+        pll_last_frequency = 0.0;
+        pll_drift = 0.0;
+        pll_ramp = 0.0;
+        if (pll_offset)
+        {
+            pll_offset = 0;
+            measure_set_samplerate_corr(measure_config.samplerate_corr);
+        }
+        return;
+    }
+
+    // Sin tensión se mantiene la tasa actual.
+    if (!frequency_valid)
+    {
+        pll_state = MEASURE_PLL_TRACKING;
+        pll_locked_windows = 0;
+        pll_last_frequency = 0.0;
+        return;
+    }
+
+    if (pll_last_frequency > 0.0)
+        pll_drift += ((netfrequency - pll_last_frequency) * samplingFrequency / 2 - pll_drift) * MEASURE_PLL_DRIFT_GAIN;
+    pll_last_frequency = netfrequency;
+
+    pll_error = netfrequency - measure_sample_rate() * 2 / (samplingFrequency);
+    float rate_error = pll_error * samplingFrequency / 2;
+
+    int range = samplingFrequency * measure_config.network_frequency / 2 * MEASURE_PLL_RANGE;
+
+    if (fabs(rate_error) <= MEASURE_PLL_DEADBAND)
+    {
+        if (pll_locked_windows < MEASURE_PLL_LOCK_WINDOWS)
+            pll_locked_windows++;
+        pll_state = (pll_locked_windows >= MEASURE_PLL_LOCK_WINDOWS) ? MEASURE_PLL_LOCKED : MEASURE_PLL_TRACKING;
+
+        // Sólo el adelanto de la deriva, en pasos enteros; una deriva chica es ruido de la medición.
+        if (fabs(pll_drift) < MEASURE_PLL_MIN_DRIFT)
+        {
+            pll_ramp = 0.0;
+            return;
+        }
+        pll_ramp += pll_drift;
+        long ramp_step = lround(pll_ramp);
+        if (!ramp_step)
+            return;
+        pll_ramp -= ramp_step;
+        int ramp_offset = constrain(pll_offset + ramp_step, -range, range);
+        if (ramp_offset == pll_offset)
+            return;
+        pll_offset = ramp_offset;
+        measure_request_i2s_rate();
+        measure_update_filters();
+        return;
+    }
+
+    pll_locked_windows = 0;
+    pll_state = MEASURE_PLL_TRACKING;
+    pll_ramp = 0.0;
+
+    // Mientras el paso está limitado la integral no acumula, así no se pasa de largo al enganchar.
+    long step = lround(rate_error * MEASURE_PLL_KP + pll_integral + rate_error * MEASURE_PLL_KI);
+    if (step > MEASURE_PLL_MAX_STEP || step < -MEASURE_PLL_MAX_STEP)
+        step = constrain(step, -MEASURE_PLL_MAX_STEP, MEASURE_PLL_MAX_STEP);
+    else
+        pll_integral += rate_error * MEASURE_PLL_KI;
+    if (!step)
+        step = (rate_error > 0) ? 1 : -1;
+
+    int offset = constrain(pll_offset + step, -range, range);
+    if (offset == pll_offset)
+        return;
+
+    pll_offset = offset;
+    measure_request_i2s_rate();
+    measure_update_filters();
+}
+
+/**
+ * @brief Calcula las armónicas seleccionadas de cada canal con el último cuadro de ciclos cerrado.
+ *
+ * Los filtros de Goertzel trabajan en las unidades internas de cada motor, así que el valor eficaz
+ * de cada armónica se lleva a las unidades del canal con la relación entre el RMS reportado y el
+ * valor eficaz alterno del mismo bloque. La THD es la de las armónicas seleccionadas.
+ */
+static void measure_update_harmonics(void)
+{
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        goertzel_t *g = &harmonic_state[i];
+        HarmonicData *data = &harmonic_values[i];
+        uint16_t mask = channelconfig[i].harmonics;
+
+        if (!g->len)
+            continue;
+
+        float ac_rms = goertzel_ac_rms(g);
+        float scale = (ac_rms > 0.0) ? measure_get_channel_rms(i) / ac_rms : 0.0;
+        float distortion = 0.0;
+
+        for (int h = 1; h <= MEASURE_MAX_HARMONIC; h++)
+        {
+            data->harmonic[h - 1] = (mask & (1 << (h - 1))) ? goertzel_rms(g, harmonic_coef, h) * scale : 0.0;
+            if (h > 1)
+                distortion += data->harmonic[h - 1] * data->harmonic[h - 1];
+        }
+        goertzel_next_block(g);
+
+        data->fundamental = data->harmonic[0];
+        data->thirdHarmonic = data->harmonic[2];
+        data->fifthHarmonic = data->harmonic[4];
+        data->seventhHarmonic = data->harmonic[6];
+        data->ninthHarmonic = data->harmonic[8];
+        data->thd = (data->fundamental > 0.0) ? sqrt(distortion) / data->fundamental * 100 : 0.0;
+        data->ffund = netfrequency;
+        data->fthird = netfrequency * 3;
+        data->ffifth = netfrequency * 5;
+        data->fsevent = netfrequency * 7;
+        data->fninth = netfrequency * 9;
+    }
+}
+
+/**
+ * @brief Cantidad de ciclos de red de una ventana: 10 a 50 Hz y 12 a 60 Hz (IEC 61000-4-30).
+ */
+static uint16_t measure_window_cycles(void)
+{
+    long cycles = lround(measure_config.network_frequency / 5.0);
+
+    return ((cycles < 1) ? 1 : cycles);
+}
+
+/**
+ * @brief Pasa las sumas posteriores al cierre de una ventana a las sumas de la ventana actual.
+ *
+ * @param carry true arranca la ventana con las sumas guardadas, false la arranca en cero.
+ */
+static void measure_window_carry(bool carry)
+{
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+#ifdef MEASURE_FIXED_POINT
+        fixed_sum[i] = carry ? fixed_tail_sum[i] : 0;
+        fixed_tail_sum[i] = 0;
+        fixed_square_sum[i] = carry ? fixed_tail_square_sum[i] : 0;
+        fixed_tail_square_sum[i] = 0;
+        channelconfig[i].sum = 0.0;
+#else
+        channelconfig[i].sum = carry ? window_tail_sum[i] : 0.0;
+        window_tail_sum[i] = 0.0;
+        square_sum[i] = carry ? window_tail_square_sum[i] : 0.0;
+        window_tail_square_sum[i] = 0.0;
+#endif
+    }
+}
+
+/**
+ * @brief Busca en un bloque los cruces por cero del canal de tensión de referencia y decide si la
+ * ventana de ciclos cierra en él.
+ *
+ * Los cruces se buscan en las muestras crudas del canal de referencia en orden temporal: con el
+ * desfase del canal el bloque da la vuelta y, si no dura justo dos ciclos, la costura agrega o
+ * quita cruces y la ventana sale con un ciclo de más o de menos. Si no hay cruces durante
+ * el doble de lo que dura una ventana (sin tensión), la ventana cierra al final del bloque y se
+ * vuelve a sincronizar con el próximo cruce.
+ *
+ * @param adc_samples Muestras del ADC ya separadas por canal virtual.
+ * @param samples Muestras por canal ya integradas en la ventana actual.
+ * @param split Devuelve la primera muestra del bloque que no pertenece a la ventana actual.
+ * @param fraction Devuelve cuánto antes de split está el cruce, entre 0 y 1 muestra.
+ * @param cycles Devuelve los ciclos de la ventana que cierra.
+ * @return measure_window_status_t
+ */
+static measure_window_status_t measure_window_split(uint16_t adc_samples[VIRTUAL_ADC_CHANNELS][numbersOfSamples], uint32_t samples, int *split, float *fraction, uint16_t *cycles)
+{
+    float reference[numbersOfSamples];
+    float crossing[4];
+    int found = 0;
+    uint16_t target = measure_window_cycles();
+    measure_window_status_t status = MEASURE_WINDOW_CONTINUE;
+
+    *split = numbersOfSamples;
+    *fraction = 0.0;
+
+    int reference_channel = measure_reference_channel();
+    if (reference_channel >= 0)
+    {
+        const uint16_t *adc = adc_samples[channel_plan[reference_channel].op[0].operand];
+
+        for (int n = 0; n < numbersOfSamples; n++)
+            reference[n] = adc[n] * adc_scale;
+        found = zerocross_find(&window_zc, reference, numbersOfSamples, crossing, 4);
+    }
+
+    for (int k = 0; k < found; k++)
+    {
+        int n = ceil(crossing[k]);
+
+        if (n < 0)
+            n = 0;
+
+        if (status == MEASURE_WINDOW_CONTINUE && !window_synced)
+        {
+            // Primer cruce: lo anterior se descarta y la ventana empieza acá.
+            window_synced = true;
+            window_cycles = 0;
+            *split = n;
+            *fraction = n - crossing[k];
+            status = MEASURE_WINDOW_RESTART;
+        }
+        else if (status == MEASURE_WINDOW_CONTINUE && ++window_cycles == target)
+        {
+            *cycles = window_cycles;
+            window_cycles = 0;
+            *split = n;
+            *fraction = n - crossing[k];
+            status = MEASURE_WINDOW_CLOSE;
+        }
+        else if (status != MEASURE_WINDOW_CONTINUE)
+        {
+            // Cruces posteriores al corte ya cuentan para la ventana siguiente.
+            window_cycles++;
+        }
+    }
+
+    // Sin cruces por el doble de una ventana: cierra igual y vuelve a sincronizar.
+    if (status == MEASURE_WINDOW_CONTINUE && samples + numbersOfSamples >= 2u * target * (numbersOfSamples / 2))
+    {
+        *cycles = 0;
+        window_synced = false;
+        window_cycles = 0;
+        status = MEASURE_WINDOW_CLOSE;
+    }
+
+    return (status);
+}
+
+/**
+ * @brief Selecciona las armónicas que sigue la DFT deslizante de cada canal para la ventana que empieza.
+ *
+ * Se siguen los canales de tensión y corriente alterna; la fundamental siempre, porque es la
+ * referencia de los ángulos. Un canal que empieza a seguirse arranca con la línea de demora en cero.
+ */
+static void measure_phasor_begin(void)
+{
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        uint16_t mask = 0;
+
+        if (measure_config.phasor_harmonics && (channelconfig[i].type == AC_VOLTAGE || channelconfig[i].type == AC_CURRENT))
+            mask = measure_config.phasor_harmonics | 0x0001;
+
+        if (mask && !phasor_mask[i])
+            sdft_reset(&phasor_state[i]);
+        else if (mask & ~phasor_mask[i])
+            sdft_anchor(&phasor_state[i], mask & ~phasor_mask[i]);
+        phasor_mask[i] = mask;
+        phasor_sum_sq[i] = 0.0;
+    }
+}
+
+/**
+ * @brief Publica los fasores de cada ciclo del bloque que se acaba de procesar.
+ *
+ * Los ángulos se dan respecto de la fundamental del canal de tensión de referencia, multiplicada
+ * por el orden de la armónica, así no giran aunque la red no esté en la frecuencia nominal. Cada
+ * ciclo va a su lugar de phasor_published con la marca de tiempo de su última muestra. Cada
+ * MEASURE_PHASOR_ANCHOR_BLOCKS bloques los bins se recalculan desde la línea de demora.
+ *
+ * @param timestamp_us Fin de la lectura del bloque en esp_timer_get_time().
+ */
+static void measure_phasor_publish(int64_t timestamp_us)
+{
+    int reference = measure_reference_channel();
+    float channel_rate = measure_sample_rate() / VIRTUAL_ADC_CHANNELS;
+
+    for (int c = 0; c < MEASURE_PHASOR_CYCLES; c++)
+    {
+        float reference_angle = 0.0;
+
+        if (reference >= 0 && phasor_mask[reference])
+            reference_angle = atan2f(phasor_cycle[c][reference].im[0], phasor_cycle[c][reference].re[0]);
+
+        for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        {
+            const measure_phasor_bins_t *bins = &phasor_cycle[c][i];
+
+            for (int h = 1; h <= MEASURE_MAX_HARMONIC; h++)
+            {
+                measure_phasor_t *phasor = &phasor_result[i][h - 1];
+
+                if (!(phasor_mask[i] & (1 << (h - 1))))
+                {
+                    phasor->magnitude = 0.0;
+                    phasor->angle = 0.0;
+                    continue;
+                }
+                float re = bins->re[h - 1], im = bins->im[h - 1];
+                float angle = remainderf(atan2f(im, re) - h * reference_angle, 2.0 * M_PI);
+
+                phasor->magnitude = sqrtf(2.0 * (re * re + im * im)) / SDFT_LEN * phasor_unit[i];
+                phasor->angle = angle * 180.0 / M_PI;
+            }
+        }
+
+        // El ciclo que se publica es el siguiente a phasor_sequence / 2.
+        int slot = (phasor_sequence / 2) % MEASURE_PHASOR_RING;
+
+        __atomic_add_fetch(&phasor_sequence, 1, __ATOMIC_SEQ_CST);
+        memcpy(phasor_published[slot], phasor_result, sizeof(phasor_result));
+        phasor_timestamp[slot] = timestamp_us - (int64_t)((MEASURE_PHASOR_CYCLES - 1 - c) * SDFT_LEN * 1000000.0 / channel_rate);
+        __atomic_add_fetch(&phasor_sequence, 1, __ATOMIC_SEQ_CST);
+    }
+
+    if (++phasor_blocks >= MEASURE_PHASOR_ANCHOR_BLOCKS)
+    {
+        phasor_blocks = 0;
+        for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+            if (phasor_mask[i])
+                sdft_anchor(&phasor_state[i], phasor_mask[i]);
+    }
+}
+
+/**
+ * @brief Calcula la relación entre las unidades del canal y las del motor con la ventana que cerró.
+ *
+ * El valor eficaz del canal sale de su suma de cuadrados, no de channelconfig[].rms, que sin
+ * true_rms es el valor medio rectificado. Debe llamarse después de measure_update_rms(); los
+ * fasores de la ventana siguiente la usan.
+ *
+ * @param samples Muestras por canal sumadas en phasor_sum_sq.
+ * @param window_samples Muestras por canal de las sumas de la ventana.
+ */
+static void measure_phasor_units(uint32_t samples, uint32_t window_samples)
+{
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        float rms = (samples && phasor_mask[i]) ? sqrt(phasor_sum_sq[i] / samples) : 0.0;
+
+        phasor_unit[i] = (rms > 0.0) ? measure_channel_rms(i, measure_channel_square_sum(i, false), window_samples) / rms : 0.0;
+    }
+}
+
+/**
+ * @brief Descarta las primeras muestras de la captura de IEC 61000-4-7.
+ *
+ * @param count Muestras por canal a descartar.
+ */
+static void measure_iec_shift(int count)
+{
+    for (int slot = 0; slot < MEASURE_IEC_CHANNELS; slot++)
+        memmove(iec_capture[slot], iec_capture[slot] + count, (iec_len - count) * sizeof(float));
+    iec_len -= count;
+}
+
+/**
+ * @brief Prepara la captura de IEC 61000-4-7 para la ventana que empieza.
+ *
+ * Reserva o libera la memoria según la configuración y asigna los lugares a los canales de tensión
+ * y corriente alterna en orden. Si los canales cambiaron, lo que quedó del bloque de cierre anterior
+ * no sirve y la ventana no se analiza.
+ *
+ * @param cycle_window true si la medición usa ventanas de ciclos.
+ */
+static void measure_iec_begin(bool cycle_window)
+{
+    bool enabled = cycle_window && measure_config.iec_harmonics;
+    int8_t slot[VIRTUAL_CHANNELS];
+    int used = 0;
+
+    if (enabled && !iec_capture)
+    {
+        iec_capture = (float(*)[MEASURE_IEC_MAX_SAMPLES])malloc(MEASURE_IEC_CHANNELS * sizeof(*iec_capture));
+        iec_work = (float *)malloc(FFT_MAX_LEN * sizeof(float));
+        if (!iec_capture || !iec_work)
+        {
+            log_e("sin memoria para los grupos de IEC 61000-4-7");
+            enabled = false;
+            measure_config.iec_harmonics = false;
+        }
+    }
+    if (!enabled && (iec_capture || iec_work))
+    {
+        free(iec_capture);
+        free(iec_work);
+        iec_capture = NULL;
+        iec_work = NULL;
+    }
+
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        slot[i] = -1;
+        if (enabled && used < MEASURE_IEC_CHANNELS && (channelconfig[i].type == AC_VOLTAGE || channelconfig[i].type == AC_CURRENT))
+            slot[i] = used++;
+    }
+
+    if (memcmp(slot, iec_slot, sizeof(slot)))
+    {
+        memcpy(iec_slot, slot, sizeof(slot));
+        iec_len = 0;
+        iec_window_len = 0;
+        iec_valid = false;
+        iec_overflow = false;
+    }
+}
+
+/**
+ * @brief Ubica en la captura de IEC 61000-4-7 el bloque que se acaba de procesar.
+ *
+ * @param status Resultado de measure_window_split() para el bloque.
+ * @param split Primera muestra del bloque que no pertenece a la ventana actual.
+ * @param fraction Fracción de muestra entre el cruce del corte y split.
+ */
+static void measure_iec_block(measure_window_status_t status, int split, float fraction)
+{
+    if (!iec_capture)
+        return;
+
+    iec_len += numbersOfSamples;
+
+    if (status == MEASURE_WINDOW_RESTART)
+    {
+        // La ventana arranca en el cruce: lo anterior no se analiza.
+        measure_iec_shift(iec_len - numbersOfSamples + split);
+        iec_start_fraction = fraction;
+        iec_valid = true;
+        iec_overflow = false;
+    }
+    else if (status == MEASURE_WINDOW_CLOSE)
+    {
+        iec_window_len = iec_len - numbersOfSamples + split;
+        iec_end_fraction = fraction;
+    }
+    else if (iec_len + numbersOfSamples > MEASURE_IEC_MAX_SAMPLES)
+    {
+        // La ventana no entra: se guardan los bloques más nuevos y se analiza sin sincronizar.
+        measure_iec_shift(numbersOfSamples);
+        iec_overflow = true;
+    }
+}
+
+/**
+ * @brief Calcula los grupos de IEC 61000-4-7 de la ventana que cerró y los publica.
+ *
+ * Cada canal se remuestrea a FFT_MAX_LEN puntos sobre los ciclos de la ventana, así la armónica h queda
+ * en el bin cycles * h aunque la red no esté en la frecuencia nominal, y la FFT usa ventana
+ * rectangular. Los ciclos van de cruce a cruce interpolados, no de las muestras enteras del corte:
+ * una muestra de más o de menos en unas 1280 corre la fundamental un centésimo de bin y la
+ * derrama en los grupos interarmónicos vecinos. Si la ventana no estaba sincronizada (sin cruces o más larga que la captura) se
+ * toman los ciclos nominales más recientes con ventana de Hann. Como en las armónicas de Goertzel,
+ * el resultado se lleva a las unidades del canal con la relación entre su RMS y el valor eficaz
+ * alterno de la captura. Debe llamarse después de measure_update_rms().
+ *
+ * @param cycles Ciclos de la ventana, 0 si cerró sin cruces.
+ * @param samples Muestras por canal de la ventana, para el costo relativo.
+ */
+static void measure_iec_analyze(uint16_t cycles, uint32_t samples)
+{
+    if (!iec_capture || !iec_window_len)
+        return;
+
+    int64_t start = esp_timer_get_time();
+    bool hann = (cycles == 0 || iec_overflow);
+    uint16_t window_cycles = hann ? measure_window_cycles() : cycles;
+    int offset = 0;
+    int len = iec_window_len;
+    float first = -iec_start_fraction;
+    float period = iec_window_len - iec_end_fraction + iec_start_fraction;
+
+    if (hann && len > window_cycles * (numbersOfSamples / 2))
+    {
+        offset = len - window_cycles * (numbersOfSamples / 2);
+        len -= offset;
+    }
+    if (hann)
+    {
+        first = 0.0;
+        period = len;
+    }
+
+    if (!iec_valid || len < RESAMPLE_TAPS)
+    {
+        iec_stats.skipped++;
+    }
+    else
+    {
+        for (int slot = 0; slot < MEASURE_IEC_CHANNELS; slot++)
+            iec_result.channel[slot] = -1;
+
+        for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        {
+            int slot = iec_slot[i];
+            if (slot < 0)
+                continue;
+
+            const float *x = iec_capture[slot] + offset;
+            measure_iec_groups_t *groups = &iec_result.groups[slot];
+            float sum = 0.0, sum_sq = 0.0, distortion = 0.0;
+
+            for (int n = 0; n < len; n++)
+            {
+                sum += x[n];
+                sum_sq += x[n] * x[n];
+            }
+            float power = sum_sq / len - (sum / len) * (sum / len);
+            float scale = (power > 0.0) ? measure_get_channel_rms(i) / sqrt(power) : 0.0;
+
+            resample_window(x, len, first, period, iec_work, FFT_MAX_LEN);
+            if (hann)
+                fft_window(iec_work, FFT_MAX_LEN, FFT_WINDOW_HANN);
+            fft_real(iec_work, FFT_MAX_LEN);
+
+            memset(groups, 0, sizeof(measure_iec_groups_t));
+            groups->cycles = hann ? 0 : cycles;
+            groups->max_order = measure_config.iec_max_order;
+            harmonic_groups(iec_work, FFT_MAX_LEN, window_cycles, groups->max_order, scale, groups->harmonic, groups->interharmonic);
+
+            for (int h = 2; h <= groups->max_order; h++)
+                distortion += groups->harmonic[h] * groups->harmonic[h];
+            groups->thd = (groups->harmonic[1] > 0.0) ? sqrt(distortion) / groups->harmonic[1] * 100 : 0.0;
+            iec_result.channel[slot] = i;
+        }
+
+        __atomic_add_fetch(&iec_sequence, 1, __ATOMIC_SEQ_CST);
+        memcpy(&iec_published, &iec_result, sizeof(iec_published));
+        __atomic_add_fetch(&iec_sequence, 1, __ATOMIC_SEQ_CST);
+
+        uint32_t elapsed = esp_timer_get_time() - start;
+        iec_stats.windows++;
+        iec_stats.last_us = elapsed;
+        if (elapsed > iec_stats.max_us)
+            iec_stats.max_us = elapsed;
+        iec_stats.window_us = samples * 1000000.0 / (measure_sample_rate() / VIRTUAL_ADC_CHANNELS);
+    }
+
+    // Lo que sigue al cierre arranca la ventana siguiente.
+    measure_iec_shift(iec_window_len);
+    iec_window_len = 0;
+    iec_start_fraction = iec_end_fraction;
+    iec_valid = true;
+    iec_overflow = false;
+}
+
+/**
+ * @brief Separa las palabras del I2S en las filas de cada canal del ADC.
+ *
+ * La fila de cada palabra sale de adc_word_channel con los cuatro bits altos, así no hay saltos
+ * por palabra; las palabras de canales no mapeados van a la fila de descarte VIRTUAL_ADC_CHANNELS
+ * y los índices se enmascaran, así una palabra de más no escribe fuera del bloque.
+ *
+ * @param words Palabras del I2S de un bloque.
+ * @param len Cantidad de palabras.
+ * @param adc_samples Destino, VIRTUAL_ADC_CHANNELS + 1 filas.
+ * @return true cada canal recibió numbersOfSamples muestras.
+ */
+static bool measure_demux(const uint16_t *words, int len, uint16_t adc_samples[VIRTUAL_ADC_CHANNELS + 1][numbersOfSamples])
+{
+    uint16_t count[VIRTUAL_ADC_CHANNELS + 1] = {0};
+
+    if (adc_oversampling == 1)
+    {
+        for (int i = 0; i < len; i++)
+        {
+            uint16_t word = words[i];
+            int row = adc_word_channel[word >> 12];
+            adc_samples[row][count[row]++ & (numbersOfSamples - 1)] = adc_calibration_lut[word & 0x0fff];
+        }
+    }
+    else
+    {
+        // Con sobremuestreo la muestra pasa por el FIR de su fila y sólo una de cada adc_oversampling queda.
+        for (int i = 0; i < len; i++)
+        {
+            uint16_t word = words[i];
+            int row = adc_word_channel[word >> 12];
+            uint16_t sample;
+            if (decimator_push(&adc_decimator[row], &adc_decimator_design, adc_calibration_lut[word & 0x0fff], &sample))
+                adc_samples[row][count[row]++ & (numbersOfSamples - 1)] = sample;
+        }
+    }
+
+    for (int i = 0; i < VIRTUAL_ADC_CHANNELS; i++)
+        if (count[i] != numbersOfSamples)
+            return (false);
+    return (true);
+}
+
+/**
+ * @brief Lee un bloque del I2S, lo separa por canal en el próximo lugar de block_ring y avisa a la tarea de medición.
+ *
+ * Los cambios de tasa pedidos se aplican acá, entre bloques, así el driver I2S sólo lo toca esta tarea.
+ * Si la cola está llena el bloque se lee igual para no atrasar el DMA y se descarta; su número de
+ * secuencia se saltea y la tarea de medición lo cuenta como perdido.
+ */
+static void measure_acquire(void)
+{
+    static uint32_t rate_applied = 0;   // Último pedido de cambio de tasa aplicado.
+    static uint32_t sequence = 0;       // Bloques leídos.
+    static bool rate_changed = false;   // Hay que marcar el próximo bloque que entre en la cola.
+
+    uint32_t rate_request = __atomic_load_n(&i2s_rate_request, __ATOMIC_ACQUIRE);
+    if (rate_request != rate_applied)
+    {
+        rate_applied = rate_request;
+        rate_changed = true;
+        if (i2s_set_sample_rates(I2S_PORT, measure_i2s_rate()) != ESP_OK)
+            log_e("no se pudo ajustar la tasa de muestreo a %d Hz", (int)measure_i2s_rate());
+    }
+
+    size_t num_bytes_read = 0; // Almacena la cantidad de bytes leídos.
+    size_t block_bytes = VIRTUAL_ADC_CHANNELS * numbersOfSamples * adc_oversampling * sizeof(uint16_t);
+    int64_t acquisition_start = esp_timer_get_time();
+
+    // Lee el bloque entero del ADC con una sola llamada al driver I2S; espera a lo sumo varios bloques.
+    esp_err_t err = i2s_read(I2S_PORT, (char *)adc_words, block_bytes, &num_bytes_read, 500);
+
+    // Verifica si la lectura fue exitosa.
+    if (err != ESP_OK)
+    {
+        log_e("Error al leer el buffer DMA: %d", err); // Muestra un mensaje de error en el log.
+        while (true)
+            ; // Detiene el sistema si ocurre un error crítico.
+    }
+
+    // Verifica si el número de muestras leídas coincide con lo esperado.
+    if (num_bytes_read != block_bytes)
+    {
+        log_e("El tamaño del bloque no coincide con el número de muestras: %d", num_bytes_read / 2);
+        while (true)
+            ;
+    }
+
+    int64_t demux_start = esp_timer_get_time();
+    measure_block_t *block = block_ring.acquire_write();
+    if (!block)
+        block = &block_overflow;
+    // adc_samples: Matriz que organiza las muestras del ADC por canal virtual, en códigos con ADCCAL_FRACTION_BITS bits fraccionarios;
+    // la última fila recibe las palabras de canales no mapeados.
+    if (!measure_demux(adc_words, num_bytes_read / 2, block->adc_samples))
+        acquisition_stats.misaligned++;
+    uint32_t demux_us = esp_timer_get_time() - demux_start;
+    acquisition_stats.blocks++;
+    acquisition_stats.read_us = demux_start - acquisition_start;
+    acquisition_stats.demux_us = demux_us;
+    if (demux_us > acquisition_stats.demux_max_us)
+        acquisition_stats.demux_max_us = demux_us;
+
+    sequence++;
+    if (block == &block_overflow)
+        return;
+    block->sequence = sequence;
+    block->timestamp_us = demux_start;
+    block->rate_changed = rate_changed;
+    rate_changed = false;
+    block_ring.commit_write();
+    xTaskNotifyGive(_MEASURE_Task);
+}
+
+/**
+ * @brief Realiza una medición y procesa los datos de los canales.
+ *
+ * En MEASURE_WINDOW_1S integra lo que entra en un segundo de millis(). En MEASURE_WINDOW_CYCLES
+ * integra una cantidad entera de ciclos de red entre cruces por cero y publica una ventana por
+ * llamada, con su cantidad exacta de muestras y su marca de tiempo en measure_get_window().
+ */
+void measure_mes(void)
+{
+    bool cycle_window = (measure_config.window_mode == MEASURE_WINDOW_CYCLES);
+    bool window_done = false;
+    uint32_t samples = 0;     // Muestras por canal integradas en esta medición.
+    uint16_t cycles = 0;      // Ciclos de red integrados, sólo en ventanas de ciclos.
+    int64_t window_end = 0;   // Fin de la ventana en esp_timer_get_time().
+    int64_t block_end = 0;    // Fin de la lectura del último bloque procesado.
+
+    // Inicializa las sumas de cada canal virtual; una ventana de ciclos arranca con el resto del bloque que cerró la anterior.
+    measure_window_carry(cycle_window);
+    samples = cycle_window ? window_tail_samples : 0;
+    window_tail_samples = 0;
+    measure_iec_begin(cycle_window);
+    measure_phasor_begin();
+    uint32_t phasor_samples = 0;  // Muestras por canal que recibió la DFT deslizante.
+
+    // Define el tiempo límite de ejecución para la medición (1 segundo desde el momento actual).
+    uint64_t NextMillis = millis() + 1000l;
+    while (cycle_window ? !window_done : millis() < NextMillis)
+    {
+        static float rms_history[16] = {0}; // Buffer circular para almacenar valores RMS.
+        static int rms_index = 0;           // Índice actual del buffer.
+
+        // Espera el próximo bloque de la tarea de adquisición y lo procesa en su lugar de la cola.
+        measure_block_t *block;
+        while (!(block = block_ring.acquire_read()))
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint16_t (*adc_samples)[numbersOfSamples] = block->adc_samples;
+
+        uint32_t queued = block_ring.count();
+        if (queued > acquisition_stats.queued_max)
+            acquisition_stats.queued_max = queued;
+        // Un salto en la secuencia o un cambio de tasa cortan la continuidad: se descartan los cruces por cero.
+        if (block->sequence != block_sequence + 1)
+            acquisition_stats.lost += block->sequence - block_sequence - 1;
+        bool continuous = (block->sequence == block_sequence + 1 && !block->rate_changed);
+        if (!continuous)
+            frequency_hold = 2;
+        // Los bloques perdidos justo antes se integran con la energía de éste, si no son demasiados.
+        uint32_t energy_blocks = block->sequence - block_sequence;
+        if (energy_blocks > MEASURE_ENERGY_MAX_GAP + 1)
+            energy_blocks = 1;
+        energy_stats.gap_blocks += energy_blocks - 1;
+        block_sequence = block->sequence;
+
+        // Programas cambiados por los setters desde el bloque anterior.
+        measure_update_program();
+
+        // Frecuencia de red, actualizada con cada bloque; las armónicas se evalúan en sus múltiplos.
+        measure_update_frequency(adc_samples);
+        goertzel_design(harmonic_coef, measure_sample_rate() / VIRTUAL_ADC_CHANNELS, netfrequency);
+        goertzel_frame_window(harmonic_window, harmonic_restart, numbersOfSamples, &harmonic_frame_position, GOERTZEL_FRAME_CYCLES * measure_sample_rate() / VIRTUAL_ADC_CHANNELS / netfrequency);
+        measure_design_quadrature();
+        measure_extend_adc(adc_samples, continuous);
+
+        // Busca el cierre de la ventana de ciclos; las muestras desde split van a la ventana siguiente.
+        int split = numbersOfSamples;
+        float split_fraction = 0.0;
+        measure_window_status_t window_status = MEASURE_WINDOW_CONTINUE;
+        if (cycle_window)
+            window_status = measure_window_split(adc_samples, samples, &split, &split_fraction, &cycles);
+
+        // Los motores sólo recorren los canales vivos de grupos activos; la lista se rearma si cambió algo.
+        measure_update_work();
+
+        // Promedio acumulativo de RMS. Sólo usa el RMS de la ventana anterior, así el umbral de tensión
+        // se conoce antes de integrar la energía del bloque.
+        float rms_sum = 0;
+
+        // Actualiza el buffer circular con el RMS calculado de AC_VOLTAGE.
+        for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        {
+            if (channelconfig[i].type == AC_VOLTAGE)
+            {
+                rms_history[rms_index] = channelconfig[i].rms; // Almacena el valor RMS en el buffer.
+                break;
+            }
+        }
+
+        // Incrementa el índice del buffer circular.
+        rms_index = (rms_index + 1) % 16;
+
+        // Calcula el promedio RMS acumulado.
+        for (int i = 0; i < 16; i++)
+        {
+            rms_sum += rms_history[i];
+        }
+        float rms_avg = rms_sum / 16; // Promedio de los últimos 16 ciclos.
+        energy_voltage_valid = (rms_avg >= 40);
+
+        measure_energy_begin();
+#ifdef MEASURE_FIXED_POINT
+        measure_process_fixed_point(adc_extended, split);
+#else
+        // Procesa el bloque con el motor seleccionado; el de bloques vuelve al de muestras si no puede.
+        if (measure_config.dsp_mode != MEASURE_DSP_BLOCK || !measure_process_block_major(adc_extended, split))
+        {
+            measure_process_sample_major(adc_extended, split);
+        }
+#endif
+        measure_energy_block(energy_blocks);
+        measure_update_harmonics();
+        measure_iec_block(window_status, split, split_fraction);
+        measure_phasor_publish(block->timestamp_us);
+        phasor_samples += numbersOfSamples;
+        samples += split;
+
+        if (window_status == MEASURE_WINDOW_RESTART)
+        {
+            // Descarta lo integrado antes del primer cruce.
+            measure_window_carry(true);
+            samples = numbersOfSamples - split;
+        }
+        else if (window_status == MEASURE_WINDOW_CLOSE)
+        {
+            float channel_rate = measure_sample_rate() / VIRTUAL_ADC_CHANNELS;
+
+            window_done = true;
+            window_tail_samples = numbersOfSamples - split;
+            window_end = block->timestamp_us - (int64_t)(window_tail_samples * 1000000.0 / channel_rate);
+        }
+
+        // Publica el bloque para los lectores; si el promedio no supera el umbral se publica en cero para evitar ruido.
+        measure_publish_snapshot(rms_avg >= 40);
+
+        // Análisis armónico con el período configurado; los lectores sólo leen lo publicado.
+        if ((int32_t)(millis() - analysis_next_ms) >= 0)
+        {
+            analysis_next_ms = millis() + measure_config.analysis_period;
+            measure_publish_analysis(rms_avg >= 40);
+        }
+
+        // Devuelve el lugar a la tarea de adquisición.
+        block_end = block->timestamp_us;
+        block_ring.release_read();
+    }
+#ifdef MEASURE_FIXED_POINT
+    measure_fixed_point_sums();
+#endif
+    if (!cycle_window)
+        window_end = block_end;
+
+    measure_update_rms(samples);
+    measure_update_power(samples);
+    measure_energy_window();
+    measure_update_pll();
+    measure_iec_analyze(cycles, samples);
+    measure_phasor_units(phasor_samples, samples);
+
+    // Publica los datos de la ventana.
+    window_info.samples = samples;
+    window_info.cycles = cycle_window ? cycles : 0;
+    window_info.timestamp_us = window_end;
+    window_info.sequence++;
+}
+
+int measure_get_samplerate_corr(void)
+{
+    return (measure_config.samplerate_corr);
+}
+
+void measure_set_samplerate_corr(int samplerate_corr)
+{ // esta función corrige la tasa de muestreo
+    measure_config.samplerate_corr = samplerate_corr;
+
+    // la tarea de adquisición aplica la tasa nueva entre bloques, el I2S es sólo suyo
+    measure_request_i2s_rate();
+    measure_update_filters();
+}
+
+/**
+ * @brief Bytes que ocupa una operación del programa.
+ *
+ * @param opcode Primer byte de la operación.
+ * @return int 2 para los opcodes extendidos con argumento, 1 para el resto.
+ */
+static int measure_opcode_size(uint8_t opcode)
+{
+    return ((opcode >= STORE && opcode < EXT_OPCODE_END && opcode != SQRT) ? 2 : 1);
+}
+
+/**
+ * @brief Decodifica el programa de un canal en un plan, descartando lo que no tiene efecto.
+ *
+ * Los NOP y todo lo que sigue al primer BRK no generan operaciones. Los operandos fuera de rango,
+ * MUL_QUADRATURE del propio canal, un segundo SAMPLE_DELAY y un opcode extendido sin su argumento
+ * también se descartan, pero son errores. BIQUAD se decodifica como un FILTER con el operando
+ * FILTER_BIQUAD_FIRST + preset, que no se puede escribir en los cuatro bits del opcode.
+ *
+ * @param channel Canal virtual dueño del programa.
+ * @param program Programa del canal.
+ * @param count Bytes de program.
+ * @param plan Destino.
+ * @param error Destino del mensaje del primer error, puede ser NULL.
+ * @param len Tamaño de error.
+ * @return true si no se descartó ninguna operación por error.
+ */
+static bool measure_decode_program(uint16_t channel, const uint8_t *program, uint16_t count, channel_plan_t *plan, char *error, uint16_t len)
+{
+    bool valid = true;
+    bool delayed = false;
+
+    plan->len = 0;
+    for (int pos = 0, size; pos < count; pos += size)
+    {
+        uint8_t opcode = program[pos] & OPMASK;
+        uint8_t op_channel = program[pos] & ~OPMASK;
+        uint8_t argument = 0;
+        const char *fault = NULL;
+
+        size = measure_opcode_size(program[pos]);
+        switch (opcode)
+        {
+        case NOP:
+            // Opcodes extendidos: el byte entero va como operando y el siguiente es su argumento.
+            if (program[pos] < STORE || program[pos] >= EXT_OPCODE_END)
+                continue;
+            op_channel = program[pos];
+            if (size > 1)
+            {
+                if (pos + 1 >= count)
+                {
+                    fault = "falta el argumento";
+                    break;
+                }
+                argument = program[pos + 1];
+            }
+            switch (op_channel)
+            {
+            case STORE:
+            case LOAD:
+            case INTEGRATE:
+                if (argument >= MEASURE_REGISTERS)
+                    fault = "registro fuera de rango";
+                break;
+            case DIV:
+            case CLAMP:
+                if (argument >= VIRTUAL_CHANNELS && (argument < REGISTER_0 || argument >= REGISTER_END))
+                    fault = "operando fuera de rango";
+                break;
+            case SAMPLE_DELAY:
+                // Una sola línea de retardo por canal.
+                if (argument < 1 || argument > MEASURE_DELAY_MAX)
+                    fault = "retardo fuera de rango";
+                else if (delayed)
+                    fault = "más de un SAMPLE_DELAY";
+                delayed = true;
+                break;
+            case BIQUAD:
+                // Es un FILTER más: comparte el estado del canal y lo corren todos los motores.
+                if (argument >= FILTER_BIQUAD_PRESETS)
+                    fault = "biquad fuera de rango";
+                opcode = FILTER;
+                op_channel = FILTER_BIQUAD_FIRST + argument;
+                argument = 0;
+                break;
+            default:
+                break;
+            }
+            break;
+        case GET_ADC:
+            if (op_channel >= VIRTUAL_ADC_CHANNELS)
+                fault = "canal del ADC fuera de rango";
+            break;
+        case ADD:
+        case SUB:
+        case MUL:
+        case MUL_RATIO:
+        case MUL_SIGN:
+        case MUL_REACTIVE:
+        case ABS:
+        case NEG:
+        case PASS_NEGATIVE:
+        case PASS_POSITIVE:
+        case SET_TO:
+            if (op_channel >= VIRTUAL_CHANNELS)
+                fault = "operando fuera de rango";
+            break;
+        case FILTER:
+            // El operando elige la etapa, no es un canal: 0 .. 15 son todos válidos.
+            break;
+        case MUL_QUADRATURE:
+            // El propio canal no tiene historia de su valor final mientras se calcula.
+            if (op_channel >= VIRTUAL_CHANNELS)
+                fault = "operando fuera de rango";
+            else if (op_channel == channel)
+                fault = "MUL_QUADRATURE del propio canal";
+            break;
+        default:
+            // BRK: termina el programa.
+            pos = count;
+            continue;
+        }
+
+        if (fault)
+        {
+            if (valid && error && len)
+                snprintf(error, len, "canal %d, byte %d (%02x): %s", channel, pos, program[pos], fault);
+            valid = false;
+            continue;
+        }
+
+        plan->op[plan->len].opcode = opcode;
+        plan->op[plan->len].operand = op_channel;
+        plan->op[plan->len].argument = argument;
+        plan->len++;
+    }
+    return (valid);
+}
+
+void measure_compile_channel(uint16_t channel)
+{
+    channel_plan_t plan;
+    char error[64];
+
+    if (channel >= VIRTUAL_CHANNELS)
+        return;
+
+    // Los programas guardados con errores se compilan igual, sin las operaciones inválidas.
+    if (!measure_decode_program(channel, &program_arena[channel_program[channel].offset], channel_program[channel].len, &plan, error, sizeof(error)))
+        log_e("%s", error);
+
+    // Todo el cambio llega junto a los motores: plan, historia de MUL_QUADRATURE, desfase y orden.
+    measure_program_begin();
+    program_stage.plan[channel] = plan;
+    // Registros y retardo arrancan en cero con cada programa nuevo.
+    program_stage.generation[channel]++;
+
+    // Canales cuya historia hace falta para MUL_QUADRATURE.
+    program_stage.quadrature_sources = 0;
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        for (int operation = 0; operation < program_stage.plan[i].len; operation++)
+            if (program_stage.plan[i].op[operation].opcode == MUL_QUADRATURE)
+                program_stage.quadrature_sources |= 1ul << program_stage.plan[i].op[operation].operand;
+
+    // El desfasaje del ADC depende del canal que lee GET_ADC.
+    measure_update_channel_phaseshift(channel);
+    // Mientras se carga la configuración el orden se arma una sola vez, al terminar.
+    if (!channel_programs_loading)
+        measure_update_schedule();
+    measure_program_end();
+}
+
+// Función auxiliar para calcular desfases
+int calculate_phaseshift(int base_shift, int n, int samples)
+{
+    int shift = ((samples / 2) / 360.0) * (base_shift % 360);
+    int index = (n + shift) % samples;
+    // Un desfase negativo envuelve hacia el final del bloque en vez de dar un índice negativo.
+    return (index < 0) ? index + samples : index;
+}
+
+/**
+ * @brief Lugar de un canal virtual del ADC en el patrón de conversión.
+ *
+ * @param adc_channel Canal virtual del ADC.
+ * @return int lugar, 0 .. VIRTUAL_ADC_CHANNELS - 1; el canal del lugar s se convierte s / (VIRTUAL_ADC_CHANNELS * adc_oversampling) muestras después del primero.
+ */
+static int measure_adc_slot(int adc_channel)
+{
+    for (int slot = 0; slot < VIRTUAL_ADC_CHANNELS; slot++)
+        if (channelmapping[adc_pattern[slot]] == adc_channel)
+            return (slot);
+    return (0);
+}
+
+void measure_update_channel_phaseshift(uint16_t channel)
+{
+    if (channel >= VIRTUAL_CHANNELS)
+        return;
+
+    channel_phase_t phase = program_stage.phase[channel];
+    const channel_plan_t *plan = &program_stage.plan[channel];
+    // Corrección fina en grados de la fundamental, con 128 muestras por ciclo.
+    float advance = channelconfig[channel].phase_correction * (numbersOfSamples / 2) / 360.0;
+
+    phase.offset_0 = calculate_phaseshift(channelconfig[channel].phaseshift, 0, numbersOfSamples);
+    phase.offset_90 = calculate_phaseshift(channelconfig[channel].phaseshift + 90, 0, numbersOfSamples);
+
+    // Lleva el canal al instante del primer lugar del patrón; se toma el primer GET_ADC del programa.
+    // Con sobremuestreo los lugares están adc_oversampling veces más juntos.
+    if (measure_config.adc_skew_correction)
+    {
+        for (int operation = 0; operation < plan->len; operation++)
+        {
+            if (plan->op[operation].opcode == GET_ADC)
+            {
+                advance -= (float)measure_adc_slot(plan->op[operation].operand) / (VIRTUAL_ADC_CHANNELS * adc_oversampling);
+                break;
+            }
+        }
+    }
+
+    phase.fractional = (advance != 0.0);
+    fracdelay_design(&phase.fraction, advance);
+#ifdef MEASURE_FIXED_POINT
+    for (int tap = 0; tap < FRACDELAY_TAPS; tap++)
+        phase.coef[tap] = q31_from_float(phase.fraction.coef[tap]);
+#endif
+    measure_program_begin();
+    program_stage.phase[channel] = phase;
+    measure_program_end();
+}
+
+int measure_set_phaseshift(int corr)
+{
+    // Aplica la corrección a todos los canales de tensión alterna.
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        if (channelconfig[i].type == AC_VOLTAGE)
+            measure_set_channel_phaseshift(i, corr);
+    }
+    return (0);
+}
+
+float measure_get_network_frequency(void)
+{
+    return (measure_config.network_frequency);
+}
+
+measure_dsp_mode_t measure_get_dsp_mode(void)
+{
+    return ((measure_dsp_mode_t)measure_config.dsp_mode);
+}
+
+void measure_set_dsp_mode(measure_dsp_mode_t dsp_mode)
+{
+    if ((int)dsp_mode < 0 || dsp_mode >= MEASURE_DSP_MODE_END)
+    {
+        log_w("motor fuera de rango: %d", (int)dsp_mode);
+        return;
+    }
+
+    measure_config.dsp_mode = dsp_mode;
+    // Al cargar la configuración los programas todavía no están compilados.
+    if (channel_programs_loading)
+        return;
+
+#ifdef MEASURE_FIXED_POINT
+    log_w("compilado con MEASURE_FIXED_POINT, se usa siempre el motor de punto fijo");
+#else
+    if (dsp_mode == MEASURE_DSP_BLOCK && !program_stage.schedule.block)
+        log_w("los programas de los canales no permiten el motor de bloques, se usa el de muestras");
+#endif
+}
+
+measure_window_mode_t measure_get_window_mode(void)
+{
+    return ((measure_window_mode_t)measure_config.window_mode);
+}
+
+void measure_set_window_mode(measure_window_mode_t window_mode)
+{
+    if ((int)window_mode < 0 || window_mode >= MEASURE_WINDOW_MODE_END)
+    {
+        log_w("ventana fuera de rango: %d", (int)window_mode);
+        return;
+    }
+
+    // La próxima ventana de ciclos vuelve a sincronizarse con un cruce por cero.
+    window_synced = false;
+    window_cycles = 0;
+    measure_config.window_mode = window_mode;
+}
+
+void measure_get_window(measure_window_t *window)
+{
+    *window = window_info;
+}
+
+bool measure_get_sample_pll(void)
+{
+    return (measure_config.sample_pll);
+}
+
+void measure_set_sample_pll(bool sample_pll)
+{
+    // Al deshabilitarlo, la próxima ventana vuelve a la tasa nominal.
+    measure_config.sample_pll = sample_pll;
+}
+
+/**
+ * @brief Puntos de calibración con la característica del ADC grabada en los eFuse.
+ *
+ * esp_adc_cal da la tensión en mV de cada código. Se ajusta una recta por cuadrados mínimos en la zona
+ * lineal y cada punto es su tensión expresada en códigos de esa recta, así la ganancia en el centro de
+ * la escala no cambia y los ratios ya calibrados siguen valiendo. Cada punto promedia
+ * MEASURE_ADC_CAL_SPAN códigos a cada lado para que la resolución de 1 mV no deje escalones.
+ *
+ * @param point Destino, ADCCAL_MAX_POINTS puntos.
+ * @return int cantidad de puntos.
+ */
+static int measure_adc_calibration_efuse(adccal_point_t *point)
+{
+    esp_adc_cal_characteristics_t characteristics;
+    double n = 0.0, sum_code = 0.0, sum_mv = 0.0, sum_code2 = 0.0, sum_code_mv = 0.0;
+
+    esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, MEASURE_ADC_CAL_VREF, &characteristics);
+
+    for (int code = MEASURE_ADC_CAL_FIT_LOW; code <= MEASURE_ADC_CAL_FIT_HIGH; code++)
+    {
+        double mv = esp_adc_cal_raw_to_voltage(code, &characteristics);
+        n++;
+        sum_code += code;
+        sum_mv += mv;
+        sum_code2 += (double)code * code;
+        sum_code_mv += code * mv;
+    }
+    double gain = (n * sum_code_mv - sum_code * sum_mv) / (n * sum_code2 - sum_code * sum_code);
+    double offset = (sum_mv - gain * sum_code) / n;
+
+    for (int i = 0; i < ADCCAL_MAX_POINTS; i++)
+    {
+        int center = i * ADCCAL_CODES / (ADCCAL_MAX_POINTS - 1);
+        int first = (center - MEASURE_ADC_CAL_SPAN < 0) ? 0 : center - MEASURE_ADC_CAL_SPAN;
+        int last = (center + MEASURE_ADC_CAL_SPAN > ADCCAL_CODES - 1) ? ADCCAL_CODES - 1 : center + MEASURE_ADC_CAL_SPAN;
+        double raw = 0.0, mv = 0.0;
+
+        for (int code = first; code <= last; code++)
+        {
+            raw += code;
+            mv += esp_adc_cal_raw_to_voltage(code, &characteristics);
+        }
+        point[i].raw = raw / (last - first + 1);
+        point[i].ideal = (mv / (last - first + 1) - offset) / gain;
+    }
+    return (ADCCAL_MAX_POINTS);
+}
+
+measure_adc_calibration_t measure_get_adc_calibration(void)
+{
+    return ((measure_adc_calibration_t)measure_config.adc_calibration);
+}
+
+void measure_set_adc_calibration(measure_adc_calibration_t adc_calibration)
+{
+    adccal_point_t point[ADCCAL_MAX_POINTS];
+    bool built = false;
+
+    if (adc_calibration < MEASURE_ADC_CAL_NONE || adc_calibration >= MEASURE_ADC_CAL_END)
+        adc_calibration = MEASURE_ADC_CAL_NONE;
+    measure_config.adc_calibration = adc_calibration;
+
+    // La tabla se reescribe en el lugar: a lo sumo un bloque mezcla la corrección vieja y la nueva.
+    switch (adc_calibration)
+    {
+    case MEASURE_ADC_CAL_EFUSE:
+        built = adccal_build(adc_calibration_lut, point, measure_adc_calibration_efuse(point));
+        break;
+    case MEASURE_ADC_CAL_USER:
+        built = adccal_build(adc_calibration_lut, adc_calibration_point, adc_calibration_points);
+        break;
+    default:
+        built = true;
+        adccal_identity(adc_calibration_lut);
+        break;
+    }
+
+    if (!built)
+    {
+        log_w("sin puntos válidos para la corrección del ADC, se usan los códigos crudos");
+        adccal_identity(adc_calibration_lut);
+    }
+}
+
+char *measure_get_adc_calibration_points_str(uint16_t len, char *dest)
+{
+    char point_tmp[24] = "";
+    *dest = '\0';
+
+    for (int i = 0; i < adc_calibration_points; i++)
+    {
+        snprintf(point_tmp, sizeof(point_tmp), *dest ? ",%.0f:%.1f" : "%.0f:%.1f", adc_calibration_point[i].raw, adc_calibration_point[i].ideal);
+        strlcat(dest, point_tmp, len);
+    }
+    return (dest);
+}
+
+bool measure_set_adc_calibration_points_str(const char *value)
+{
+    adccal_point_t point[ADCCAL_MAX_POINTS];
+    int count = 0;
+
+    while (value && *value)
+    {
+        const char *separator = strchr(value, ':');
+        if (!separator || count >= ADCCAL_MAX_POINTS)
+            return (false);
+        point[count].raw = atof(value);
+        point[count].ideal = atof(separator + 1);
+        if (count && !(point[count].raw > point[count - 1].raw))
+            return (false);
+        count++;
+        value = strchr(separator, ',');
+        if (value)
+            value++;
+    }
+    if (count == 1)
+        return (false);
+
+    memcpy(adc_calibration_point, point, sizeof(point));
+    adc_calibration_points = count;
+    // Con el barrido en uso la tabla toma los puntos nuevos.
+    if (measure_config.adc_calibration == MEASURE_ADC_CAL_USER)
+        measure_set_adc_calibration(MEASURE_ADC_CAL_USER);
+    return (true);
+}
+
+int measure_get_oversampling(void)
+{
+    return (measure_config.oversampling);
+}
 
-        // Si la señal de AC_VOLTAGE no es válida, fuerza todos los canales a 0.
-        if (!ac_voltage_valid)
-        {
-            for (int i = 0; i < VIRTUAL_CHANNELS; i++)
-            {
-                channelconfig[i].rms = 0.0;
-            }
-        }
+void measure_set_oversampling(int oversampling)
+{
+    if (oversampling != 2 && oversampling != DECIMATOR_MAX_FACTOR)
+        oversampling = 1;
+    // measure_init() lo toma al reiniciar.
+    measure_config.oversampling = oversampling;
+}
 
-        // Si la medición no es válida, reinicia el RMS del canal a 0.
-        if (measurement_valid > 0)
-        {
-            channelconfig[i].rms = 0.0;
-            measurement_valid--;
-        }
-    }
+bool measure_get_adc_skew_correction(void)
+{
+    return (measure_config.adc_skew_correction);
 }
 
-int measure_get_samplerate_corr(void)
+void measure_set_adc_skew_correction(bool adc_skew_correction)
 {
-    return (measure_config.samplerate_corr);
+    measure_config.adc_skew_correction = adc_skew_correction;
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        measure_update_channel_phaseshift(i);
 }
 
-void measure_set_samplerate_corr(int samplerate_corr)
-{ // esta función corrige la tasa de muestreo
-    measure_config.samplerate_corr = samplerate_corr;
+measure_pll_state_t measure_get_pll_state(void)
+{
+    return (pll_state);
+}
 
-    esp_err_t err; // crea una variable de error de muestreo (dif)
-    // ajusta la tasa de muestreo de error primero, llamando a i2s, luego haciendo un promedio entre la frecuencia de linea, la frecuencia muestreada y la corrección
-    err = i2s_set_sample_rates(I2S_PORT, (samplingFrequency * measure_config.network_frequency / 2) + measure_config.samplerate_corr);
-    if (err != ESP_OK)
-    { // si no devuelve un ok entonces marca un log con error
-        log_e("Failed set samplerate: %d", err);
-        esp_restart(); // Reinicia el sistema de manera controlada.
+float measure_get_pll_error(void)
+{
+    return (pll_error);
+}
 
-        // while (true);
-    }
+int measure_get_pll_offset(void)
+{
+    return (pll_offset);
 }
 
-// Función auxiliar para calcular desfases
-int calculate_phaseshift(int base_shift, int n, int samples)
+float measure_get_high_pass_coef(void)
 {
-    int shift = ((samples / 2) / 360.0) * (base_shift % 360);
-    return (n + shift) % samples;
+    return (measure_config.high_pass_coef);
 }
 
-float measure_get_network_frequency(void)
+void measure_set_high_pass_coef(float high_pass_coef)
 {
-    return (measure_config.network_frequency);
+    // Fuera de (0, 1) el pasa alto deja de ser estable o de pasar la señal.
+    if (high_pass_coef <= 0.0 || high_pass_coef >= 1.0)
+    {
+        log_w("coeficiente de pasa alto fuera de rango: %f", high_pass_coef);
+        return;
+    }
+
+    measure_config.high_pass_coef = high_pass_coef;
+#ifdef MEASURE_FIXED_POINT
+    measure_request_program();
+#endif
 }
 
 /**
@@ -750,25 +4022,19 @@ void measure_set_network_frequency(float network_frequency)
     {
         // Actualiza la configuración de frecuencia de red en la estructura global.
         measure_config.network_frequency = network_frequency;
-
-        // Calcula y establece la nueva frecuencia de muestreo para el ADC.
-        esp_err_t err = i2s_set_sample_rates(
-            I2S_PORT, 
-            (samplingFrequency * measure_config.network_frequency / 2) + measure_config.samplerate_corr
-        );
-
-        // Verifica si hubo un error al configurar la frecuencia de muestreo.
-        if (err != ESP_OK)
-        {
-            log_e("Error al configurar la frecuencia de muestreo: %d", err);
-            esp_restart(); // Reinicia el sistema de forma controlada.
-        }
-        else
-        {
-            log_i("Frecuencia de red configurada: %.2f Hz, Frecuencia de muestreo: %d Hz", 
-                  measure_config.network_frequency,
-                  (int)((samplingFrequency * measure_config.network_frequency / 2) + measure_config.samplerate_corr));
-        }
+        // El lazo vuelve a enganchar desde la tasa nominal nueva.
+        pll_offset = 0;
+        pll_locked_windows = 0;
+        pll_integral = 0.0;
+        measure_update_filters();
+        // Los cruces guardados están en muestras de la tasa anterior.
+        freqtrack_reset(&frequency_track);
+
+        // Pide la nueva frecuencia de muestreo del ADC a la tarea de adquisición.
+        measure_request_i2s_rate();
+        log_i("Frecuencia de red configurada: %.2f Hz, Frecuencia de muestreo: %d Hz", 
+              measure_config.network_frequency,
+              (int)measure_i2s_rate());
     }
     else
     {
@@ -777,115 +4043,291 @@ void measure_set_network_frequency(float network_frequency)
     }
 }
 
-/**
- * @brief Devuelve un puntero al buffer de medición procesado.
- * 
- * @return uint16_t* Puntero al inicio del buffer de prueba, o NULL si hay un timeout.
- */
-uint16_t *measure_get_buffer(void)
+const uint16_t *measure_acquire_buffer(uint32_t *sequence)
 {
-    // Marca el buffer de transmisión como disponible.
-    TX_buffer = 0;
+    while (true)
+    {
+        int slot = __atomic_load_n(&snapshot_latest, __ATOMIC_SEQ_CST);
 
-    // Límite de tiempo para salir del bucle.
-    unsigned long startTime = millis();
-    unsigned long timeout = 1000; // Timeout en milisegundos.
+        if (slot < 0)
+            return (NULL);
 
-    // Espera activa con límite de tiempo.
-    while (TX_buffer == 0)
+        // Toma el buffer y verifica que siga siendo el último; si no, la tarea de medición pudo
+        // haber empezado a escribirlo antes de que se tomara y hay que volver a intentar.
+        __atomic_fetch_add(&snapshot[slot].readers, 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&snapshot_latest, __ATOMIC_SEQ_CST) == slot)
+        {
+            if (sequence)
+                *sequence = snapshot[slot].sequence;
+            return (&snapshot[slot].sample[0][0]);
+        }
+        __atomic_fetch_sub(&snapshot[slot].readers, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+void measure_release_buffer(const uint16_t *sample_buffer)
+{
+    for (int i = 0; i < MEASURE_SNAPSHOT_SLOTS; i++)
     {
-        if (millis() - startTime > timeout)
+        if (sample_buffer == &snapshot[i].sample[0][0])
         {
-            log_e("Timeout al esperar el buffer de transmisión.");
-            return NULL; // Retorna NULL si se supera el tiempo límite.
+            __atomic_fetch_sub(&snapshot[i].readers, 1, __ATOMIC_SEQ_CST);
+            return;
         }
-        vTaskDelay(1); // Agrega un pequeño retraso para liberar CPU (solo si usas FreeRTOS).
     }
+}
 
-    // Devuelve un puntero al buffer de prueba.
-    return (&buffer_probe[0][0]);
+uint32_t measure_get_buffer_dropped(void)
+{
+    return (snapshot_dropped);
 }
+
 /**
- * @brief Realiza la transformada rápida de Fourier (FFT) para los canales virtuales,
- * calcula los armónicos principales (hasta el noveno) y la distorsión armónica total (THD).
- * 
- * @return uint16_t* Puntero al inicio del buffer FFT (buffer_fft).
+ * @brief Lee una parte de una publicación protegida por un seqlock como el de measure_publish_analysis().
+ *
+ * @param sequence Secuencia del seqlock.
+ * @param dest Destino.
+ * @param src Parte de la publicación a copiar.
+ * @param len Bytes a copiar.
+ * @return uint32_t versión leída, 0 si todavía no se publicó ninguna.
  */
-uint16_t *measure_get_fft(void)
+static uint32_t measure_read_analysis(const uint32_t *sequence, void *dest, const void *src, size_t len)
+{
+    uint32_t seq;
+
+    while (true)
+    {
+        seq = __atomic_load_n(sequence, __ATOMIC_SEQ_CST);
+        if (seq & 1)
+            continue;
+        memcpy(dest, src, len);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (seq == __atomic_load_n(sequence, __ATOMIC_SEQ_CST))
+            break;
+    }
+    return (seq / 2);
+}
+
+uint32_t measure_get_harmonics(uint16_t channel, HarmonicData *harmonics)
 {
-    // Buffers temporales para valores reales e imaginarios.
-    static double vReal[numbersOfFFTSamples * 2];
-    static double vImag[numbersOfFFTSamples * 2];
+    if (channel >= VIRTUAL_CHANNELS)
+        return (0);
+
+    return (measure_read_analysis(&analysis_sequence, harmonics, &analysis.harmonics[channel], sizeof(HarmonicData)));
+}
 
-    // Inicializa el objeto FFT con los parámetros necesarios.
-    arduinoFFT FFT(vReal, vImag, numbersOfFFTSamples * 2, samplingFrequency * measure_get_network_frequency() / 4);
+bool measure_get_spectrum_channel(uint16_t channel)
+{
+    if (channel >= VIRTUAL_CHANNELS)
+        return (false);
 
-    // Canales seleccionados a procesar
-    int selectedChannels[] = {0, 1, 4, 5, 8, 9};
-    size_t numSelectedChannels = sizeof(selectedChannels) / sizeof(selectedChannels[0]);
+    return (channelconfig[channel].type == AC_CURRENT || channelconfig[channel].type == AC_VOLTAGE);
+}
 
-    // Recorre solo los canales seleccionados.
-    for (size_t idx = 0; idx < numSelectedChannels; idx++) {
-        int channel = selectedChannels[idx];
+uint32_t measure_get_spectrum(uint16_t channel, uint16_t *spectrum)
+{
+    if (channel >= VIRTUAL_CHANNELS)
+        return (0);
 
-        // Llena los buffers con datos del canal actual.
-        for (int i = 0; i < numbersOfFFTSamples * 2; i++) {
-            vReal[i] = measure_get_channel_ratio(channel) * buffer_probe[channel][(i * 6) % numbersOfSamples];
-            vImag[i] = 0; // Parte imaginaria inicializada a 0.
-        }
+    return (measure_read_analysis(&analysis_sequence, spectrum, analysis.spectrum[channel], sizeof(analysis.spectrum[channel])));
+}
+
+uint32_t measure_get_analysis_version(void)
+{
+    return (__atomic_load_n(&analysis_sequence, __ATOMIC_SEQ_CST) / 2);
+}
 
-        // Aplica la ventana de Hann para reducir efectos de discontinuidad.
-        FFT.Windowing(FFT_WIN_TYP_RECTANGLE, FFT_REVERSE);
+int measure_get_analysis_period(void)
+{
+    return (measure_config.analysis_period);
+}
 
-        // Calcula la transformada rápida de Fourier.
-        FFT.Compute(FFT_REVERSE);
+void measure_set_analysis_period(int analysis_period)
+{
+    if (analysis_period < MEASURE_ANALYSIS_MIN_PERIOD || analysis_period > MEASURE_ANALYSIS_MAX_PERIOD)
+    {
+        log_w("período de análisis fuera de rango: %d ms", analysis_period);
+        return;
+    }
 
-        // Convierte los resultados complejos a magnitudes.
-        FFT.ComplexToMagnitude();
+    measure_config.analysis_period = analysis_period;
+    analysis_next_ms = millis();
+}
 
-        // Calcula el RMS del canal actual fuera del bucle para evitar redundancia.
-        double channel_rms = measure_get_channel_rms(channel);
+/**
+ * @brief Escribe una máscara de armónicas como lista separada por comas.
+ *
+ * @param harmonics Máscara, bit h - 1 para la armónica h.
+ * @param len Tamaño de dest.
+ * @param dest Destino.
+ * @return char* dest.
+ */
+static char *measure_harmonics_to_str(uint16_t harmonics, uint16_t len, char *dest)
+{
+    char harmonic_tmp[4] = "";
+    *dest = '\0';
 
-        // Si la frecuencia fundamental es 0, omitir el canal.
-        if (vReal[3] == 0) {
+    for (int h = 1; h <= MEASURE_MAX_HARMONIC; h++)
+    {
+        if (!(harmonics & (1 << (h - 1))))
             continue;
-        }
+        snprintf(harmonic_tmp, sizeof(harmonic_tmp), *dest ? ",%d" : "%d", h);
+        strlcat(dest, harmonic_tmp, len);
+    }
+    return (dest);
+}
+
+/**
+ * @brief Lee una lista de armónicas separada por comas; se ignoran las fuera de rango.
+ *
+ * @param value Lista, por ejemplo "1,3,5".
+ * @return uint16_t máscara, bit h - 1 para la armónica h.
+ */
+static uint16_t measure_harmonics_from_str(const char *value)
+{
+    uint16_t harmonics = 0;
 
-        // Factor de escala basado en la frecuencia fundamental.
-        double temp = channel_rms / vReal[3];
+    while (value && *value)
+    {
+        int h = atoi(value);
+        if (h >= 1 && h <= MEASURE_MAX_HARMONIC)
+            harmonics |= 1 << (h - 1);
+        value = strchr(value, ',');
+        if (value)
+            value++;
+    }
+    return (harmonics);
+}
 
-        // Procesa los resultados de la FFT para cada canal.
-        for (int i = 1; i < numbersOfFFTSamples; i++) {
-            buffer_fft[channel][i] = vReal[i];
-        }
+uint16_t measure_get_phasor_harmonics(void)
+{
+    return (measure_config.phasor_harmonics);
+}
+
+void measure_set_phasor_harmonics(uint16_t harmonics)
+{
+    harmonics &= (1 << MEASURE_MAX_HARMONIC) - 1;
+    // La fundamental es la referencia de los ángulos.
+    if (harmonics)
+        harmonics |= 1;
+
+    // measure_phasor_begin() toma la máscara nueva al empezar la próxima ventana.
+    measure_config.phasor_harmonics = harmonics;
+}
+
+char *measure_get_phasor_harmonics_str(uint16_t len, char *dest)
+{
+    return (measure_harmonics_to_str(measure_config.phasor_harmonics, len, dest));
+}
+
+void measure_set_phasor_harmonics_str(const char *value)
+{
+    measure_set_phasor_harmonics(measure_harmonics_from_str(value));
+}
+
+uint32_t measure_get_channel_phasor(uint16_t channel, int harmonic, measure_phasor_t *phasor)
+{
+    return (measure_get_channel_phasor_cycle(channel, harmonic, 0, phasor, NULL));
+}
+
+uint32_t measure_get_channel_phasor_cycle(uint16_t channel, int harmonic, uint32_t cycle, measure_phasor_t *phasor, int64_t *timestamp_us)
+{
+    uint32_t seq, wanted;
+    int64_t timestamp;
+
+    if (channel >= VIRTUAL_CHANNELS || harmonic < 1 || harmonic > MEASURE_MAX_HARMONIC)
+        return (0);
+    if (!(__atomic_load_n(&phasor_mask[channel], __ATOMIC_SEQ_CST) & (1 << (harmonic - 1))))
+        return (0);
+
+    // Como measure_read_analysis(), pero el lugar depende del ciclo pedido y del último publicado.
+    while (true)
+    {
+        seq = __atomic_load_n(&phasor_sequence, __ATOMIC_SEQ_CST);
+        if (seq & 1)
+            continue;
+        wanted = cycle ? cycle : seq / 2;
+        if (!wanted || wanted > seq / 2 || seq / 2 - wanted >= MEASURE_PHASOR_RING)
+            return (0);
+        int slot = (wanted - 1) % MEASURE_PHASOR_RING;
+        memcpy(phasor, &phasor_published[slot][channel][harmonic - 1], sizeof(measure_phasor_t));
+        timestamp = phasor_timestamp[slot];
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (seq == __atomic_load_n(&phasor_sequence, __ATOMIC_SEQ_CST))
+            break;
+    }
+    if (timestamp_us)
+        *timestamp_us = timestamp;
+    return (wanted);
+}
+
+bool measure_get_iec_harmonics(void)
+{
+    return (measure_config.iec_harmonics);
+}
 
-        // Calcular los valores fundamentales y armónicos.
-        harmonic_values[channel].fundamental = vReal[3] * temp;
-        harmonic_values[channel].thirdHarmonic = vReal[9] * temp;
-        harmonic_values[channel].fifthHarmonic = vReal[15] * temp;
-        harmonic_values[channel].seventhHarmonic = vReal[21] * temp;
-        harmonic_values[channel].ninthHarmonic = vReal[27] * temp;
+void measure_set_iec_harmonics(bool iec_harmonics)
+{
+    if (iec_harmonics && measure_config.window_mode != MEASURE_WINDOW_CYCLES)
+        log_w("los grupos de IEC 61000-4-7 sólo se calculan con ventanas de ciclos");
 
-        // Calcular la distorsión armónica total (THD).
-        double thd_numerator = sqrt(
-            pow(harmonic_values[channel].thirdHarmonic, 2) +
-            pow(harmonic_values[channel].fifthHarmonic, 2) +
-            pow(harmonic_values[channel].seventhHarmonic, 2) +
-            pow(harmonic_values[channel].ninthHarmonic, 2));
+    measure_config.iec_harmonics = iec_harmonics;
+}
 
-        harmonic_values[channel].thd = (harmonic_values[channel].fundamental > 0)
-            ? (thd_numerator / harmonic_values[channel].fundamental) * 100
-            : 0;
+int measure_get_iec_max_order(void)
+{
+    return (measure_config.iec_max_order);
+}
 
-        // Log para depuración.
-        // log_i("Canal %d: THD = %.2f%%, Fundamental = %.2f", channel, harmonic_values[channel].thd, harmonic_values[channel].fundamental);
+void measure_set_iec_max_order(int max_order)
+{
+    if (max_order < 2 || max_order > MEASURE_IEC_MAX_ORDER)
+    {
+        log_w("orden de los grupos fuera de rango: %d", max_order);
+        return;
     }
 
-    // Devuelve un puntero al buffer FFT.
-    return (&buffer_fft[0][0]);
+    measure_config.iec_max_order = max_order;
+}
+
+uint32_t measure_get_iec_groups(uint16_t channel, measure_iec_groups_t *groups)
+{
+    int8_t slot_channel[MEASURE_IEC_CHANNELS];
+    uint32_t version;
+
+    if (channel >= VIRTUAL_CHANNELS)
+        return (0);
+
+    // Los lugares y los grupos se leen por separado; si se publicó en el medio se repite.
+    while (true)
+    {
+        int slot;
+
+        version = measure_read_analysis(&iec_sequence, slot_channel, iec_published.channel, sizeof(slot_channel));
+        if (!version)
+            return (0);
+
+        for (slot = 0; slot < MEASURE_IEC_CHANNELS; slot++)
+            if (slot_channel[slot] == channel)
+                break;
+        if (slot == MEASURE_IEC_CHANNELS)
+            return (0);
+
+        if (measure_read_analysis(&iec_sequence, groups, &iec_published.groups[slot], sizeof(measure_iec_groups_t)) == version)
+            break;
+    }
+    return (version);
 }
 
+void measure_get_acquisition_stats(measure_acquisition_stats_t *stats)
+{
+    *stats = acquisition_stats;
+}
 
+void measure_get_iec_stats(measure_iec_stats_t *stats)
+{
+    *stats = iec_stats;
+}
 
 double measure_get_max_freq(void)
 {
@@ -937,6 +4379,9 @@ void measure_set_channel_type(uint16_t channel, channel_type_t type)
         return;
 
     channelconfig[channel].type = type;
+    // Un canal sin tipo deja de estar vivo si nadie lo lee.
+    if (!channel_programs_loading)
+        measure_update_schedule();
 }
 
 double measure_get_channel_offset(uint16_t channel)
@@ -969,6 +4414,10 @@ void measure_set_channel_ratio(uint16_t channel, double channel_ratio)
         return;
 
     channelconfig[channel].ratio = channel_ratio;
+#ifdef MEASURE_FIXED_POINT
+    // Los ratios forman parte de la escala de los planes de punto fijo.
+    measure_request_program();
+#endif
 }
 
 int measure_get_channel_phaseshift(uint16_t channel)
@@ -985,6 +4434,30 @@ void measure_set_channel_phaseshift(uint16_t channel, int value)
         return;
 
     channelconfig[channel].phaseshift = (value % 360);
+    measure_update_channel_phaseshift(channel);
+}
+
+float measure_get_channel_phase_correction(uint16_t channel)
+{
+    if (channel >= VIRTUAL_CHANNELS)
+        return (0.0);
+
+    return (channelconfig[channel].phase_correction);
+}
+
+void measure_set_channel_phase_correction(uint16_t channel, float value)
+{
+    if (channel >= VIRTUAL_CHANNELS)
+        return;
+
+    if (value < -MEASURE_PHASE_CORRECTION_MAX || value > MEASURE_PHASE_CORRECTION_MAX)
+    {
+        log_w("corrección de fase fuera de rango: %.3f grados", value);
+        return;
+    }
+
+    channelconfig[channel].phase_correction = value;
+    measure_update_channel_phaseshift(channel);
 }
 
 const char *measure_get_group_name(uint16_t group)
@@ -1017,6 +4490,39 @@ void measure_set_group_active(uint16_t group, bool active)
         return;
 
     groupconfig[group].active = active;
+    measure_request_work();
+}
+
+bool measure_get_group_power(uint16_t group, measure_group_power_t *power)
+{
+    if (group >= MAX_GROUPS)
+        return (false);
+
+    *power = group_power[group];
+    return (power->apparent > 0.0);
+}
+
+uint32_t measure_get_group_energy(uint16_t group, measure_group_energy_t *energy)
+{
+    int64_t raw[MEASURE_ENERGY_REGISTERS];
+    // kWh, kvarh o kVAh por unidad de los registros.
+    const double scale = 1.0 / ((double)(1ull << MEASURE_ENERGY_FRACTION_BITS) * 1000.0);
+
+    if (group >= MAX_GROUPS)
+        return (0);
+
+    uint32_t version = measure_read_analysis(&energy_sequence, raw, energy_published[group], sizeof(raw));
+    energy->active_import = raw[MEASURE_ENERGY_ACTIVE_IMPORT] * scale;
+    energy->active_export = raw[MEASURE_ENERGY_ACTIVE_EXPORT] * scale;
+    energy->reactive_import = raw[MEASURE_ENERGY_REACTIVE_IMPORT] * scale;
+    energy->reactive_export = raw[MEASURE_ENERGY_REACTIVE_EXPORT] * scale;
+    energy->apparent = raw[MEASURE_ENERGY_APPARENT] * scale;
+    return (version);
+}
+
+void measure_get_energy_stats(measure_energy_stats_t *stats)
+{
+    *stats = energy_stats;
 }
 
 int measure_get_channel_group_id(uint16_t channel)
@@ -1029,10 +4535,11 @@ int measure_get_channel_group_id(uint16_t channel)
 
 void measure_set_channel_group_id(uint16_t channel, int group_id)
 {
-    if (channel >= VIRTUAL_CHANNELS)
+    if (channel >= VIRTUAL_CHANNELS || group_id < 0 || group_id >= MAX_GROUPS)
         return;
 
     channelconfig[channel].group_id = group_id;
+    measure_request_work();
 }
 
 int measure_get_channel_group_id_entrys(int group_id)
@@ -1046,6 +4553,44 @@ int measure_get_channel_group_id_entrys(int group_id)
     return (groupd_id_entrys);
 }
 
+uint16_t measure_get_channel_harmonics(uint16_t channel)
+{
+    if (channel >= VIRTUAL_CHANNELS)
+        return (0);
+
+    return (channelconfig[channel].harmonics);
+}
+
+void measure_set_channel_harmonics(uint16_t channel, uint16_t harmonics)
+{
+    if (channel >= VIRTUAL_CHANNELS)
+        return;
+
+    harmonics &= (1 << MEASURE_MAX_HARMONIC) - 1;
+    // La fundamental hace falta para la THD.
+    if (harmonics)
+        harmonics |= 1;
+
+    channelconfig[channel].harmonics = harmonics;
+    goertzel_reset(&harmonic_state[channel]);
+    memset(harmonic_values[channel].harmonic, 0, sizeof(harmonic_values[channel].harmonic));
+}
+
+char *measure_get_channel_harmonics_str(uint16_t channel, uint16_t len, char *dest)
+{
+    *dest = '\0';
+
+    if (channel >= VIRTUAL_CHANNELS)
+        return (dest);
+
+    return (measure_harmonics_to_str(channelconfig[channel].harmonics, len, dest));
+}
+
+void measure_set_channel_harmonics_str(uint16_t channel, const char *value)
+{
+    measure_set_channel_harmonics(channel, measure_harmonics_from_str(value));
+}
+
 int measure_get_channel_group_id_entrys_with_type(int group_id, int type)
 {
     int groupd_id_entrys = 0;
@@ -1057,7 +4602,7 @@ int measure_get_channel_group_id_entrys_with_type(int group_id, int type)
     return (groupd_id_entrys);
 }
 
-int measure_get_channel_with_group_id_and_type(int group_id, int type)
+int measure_get_channel_with_group_id_and_type(uint16_t group_id, int type)
 {
     for (int i = 0; i < VIRTUAL_CHANNELS; i++)
         if (channelconfig[i].group_id == group_id && channelconfig[i].type == type)
@@ -1146,27 +4691,28 @@ void measure_set_measurement_invalid(int sec)
     measurement_valid = sec;
 }
 
-uint8_t *measure_get_channel_opcodeseq(uint16_t channel)
+uint8_t *measure_get_channel_opcodeseq(uint16_t channel, uint16_t *count)
 {
     if (channel >= VIRTUAL_CHANNELS)
         return (NULL);
-    return (channelconfig[channel].operation);
+    if (count)
+        *count = channel_program[channel].len;
+    return (&program_arena[channel_program[channel].offset]);
 }
 
 char *measure_get_channel_opcodeseq_str(uint16_t channel, uint16_t len, char *dest)
 {
-    char microcode_tmp[3] = "";
-    uint8_t *opcode = channelconfig[channel].operation;
-    *dest = '\0';
+    int pos = 0;
 
-    if (channel >= VIRTUAL_CHANNELS)
+    if (channel >= VIRTUAL_CHANNELS || !len)
         return (NULL);
 
-    for (int a = 0; a < MAX_MICROCODE_OPS; a++)
+    *dest = '\0';
+    // Los programas cortos se completan con BRK hasta MAX_MICROCODE_OPS, como el formato de siempre.
+    for (int a = 0; (a < channel_program[channel].len || a < MAX_MICROCODE_OPS) && pos + 2 < len; a++)
     {
-        snprintf(microcode_tmp, sizeof(microcode_tmp), "%02x", *opcode);
-        strncat(dest, microcode_tmp, len);
-        opcode++;
+        uint8_t opcode = (a < channel_program[channel].len) ? program_arena[channel_program[channel].offset + a] : BRK;
+        pos += snprintf(dest + pos, len - pos, "%02x", opcode);
     }
     return (dest);
 }
@@ -1176,40 +4722,85 @@ void measure_save_settings(void)
     measure_config.save();
 }
 
-void measure_set_channel_opcodeseq(uint16_t channel, uint8_t *value)
+bool measure_set_channel_opcodeseq(uint16_t channel, const uint8_t *value, uint16_t count, char *error, uint16_t len)
 {
-    char microcode[VIRTUAL_CHANNELS * 3] = "";
-    char microcode_tmp[3] = "";
-    uint8_t *opcode = value;
+    channel_plan_t plan[VIRTUAL_CHANNELS];
+    channel_schedule_t schedule;
+    uint8_t arena[MEASURE_PROGRAM_ARENA];
+    uint16_t used = 0;
+    uint16_t size = 0;
 
-    if (channel >= VIRTUAL_CHANNELS)
-        return;
+    if (channel >= VIRTUAL_CHANNELS || channel >= CHANNEL_END)
+    {
+        if (error && len)
+            snprintf(error, len, "canal %d fuera de rango", channel);
+        return (false);
+    }
 
-    if (channel >= CHANNEL_END)
-        return;
+    if (count > MEASURE_PROGRAM_MAX)
+    {
+        if (error && len)
+            snprintf(error, len, "canal %d: programa de más de %d bytes", channel, MEASURE_PROGRAM_MAX);
+        return (false);
+    }
+
+    // Los BRK del final no se guardan; se recorren las operaciones para no cortar un argumento.
+    for (int pos = 0; pos < count; pos += measure_opcode_size(value[pos]))
+        if (value[pos] != BRK)
+            size = pos + measure_opcode_size(value[pos]);
+    if (size > count)
+        size = count;
+
+    // Al cargar la configuración measure_init() compila y analiza todos los programas juntos.
+    if (!channel_programs_loading)
+    {
+        // El programa nuevo se prueba con los planes de los demás canales antes de aplicarlo.
+        memcpy(plan, program_stage.plan, sizeof(plan));
+        if (!measure_decode_program(channel, value, size, &plan[channel], error, len) || !measure_schedule_channels(plan, &schedule, error, len))
+            return (false);
+    }
 
-    memcpy(channelconfig[channel].operation, value, MAX_MICROCODE_OPS);
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        used += (i == channel) ? size : channel_program[i].len;
+    if (used > MEASURE_PROGRAM_ARENA)
+    {
+        if (error && len)
+            snprintf(error, len, "canal %d: no hay lugar para el programa, quedan %d bytes", channel, MEASURE_PROGRAM_ARENA - (used - size));
+        return (false);
+    }
 
-    for (int a = 0; a < MAX_MICROCODE_OPS; a++)
+    // Reempaqueta todos los programas con el nuevo en su lugar.
+    used = 0;
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
     {
-        snprintf(microcode_tmp, sizeof(microcode_tmp), "%02x", *opcode);
-        strncat(microcode, microcode_tmp, sizeof(microcode));
-        opcode++;
+        const uint8_t *program = (i == channel) ? value : &program_arena[channel_program[i].offset];
+        uint8_t program_len = (i == channel) ? size : channel_program[i].len;
+
+        memcpy(&arena[used], program, program_len);
+        channel_program[i].offset = used;
+        channel_program[i].len = program_len;
+        used += program_len;
     }
+    memcpy(program_arena, arena, used);
+
+    measure_compile_channel(channel);
+    return (true);
 }
 // esta función analiza los opcode escritos y lo guarda en la variable opcode
-void measure_set_channel_opcodeseq_str(uint16_t channel, const char *value)
+bool measure_set_channel_opcodeseq_str(uint16_t channel, const char *value, char *error, uint16_t len)
 {
     char spanset[] = "0123456789ABCDEFabcdef";
     char *ptr = (char *)value;
     uint8_t opcode_binary = 0;
+    uint8_t operation[MEASURE_PROGRAM_MAX];
     int opcode_pos = 0;
 
-    if (channel >= VIRTUAL_CHANNELS)
-        return;
-
-    if (channel >= CHANNEL_END)
-        return;
+    if (channel >= VIRTUAL_CHANNELS || channel >= CHANNEL_END)
+    {
+        if (error && len)
+            snprintf(error, len, "canal %d fuera de rango", channel);
+        return (false);
+    }
     /**
      * check string for illigal format
      */
@@ -1238,18 +4829,27 @@ void measure_set_channel_opcodeseq_str(uint16_t channel, const char *value)
         opcode_binary = opcode_binary + ((*ptr <= '9') ? *ptr - '0' : (*ptr & 0x7) + 9);
         ptr++;
         /**
-         * check if we have space for next opcode
+         * check if we have space for next opcode, trailing BRK are not stored anyway
          */
-        if (opcode_pos < MAX_MICROCODE_OPS)
+        if (opcode_pos < MEASURE_PROGRAM_MAX)
         {
-            channelconfig[channel].operation[opcode_pos] = opcode_binary;
+            operation[opcode_pos] = opcode_binary;
             opcode_pos++;
         }
-        else
+        else if (opcode_binary != BRK)
         {
-            log_e("no more space for opcodes");
-            break;
+            // Un programa cortado haría otra cuenta: se rechaza entero.
+            if (error && len)
+                snprintf(error, len, "canal %d: programa de más de %d bytes", channel, MEASURE_PROGRAM_MAX);
+            log_e("canal %d: programa de más de %d bytes", channel, MEASURE_PROGRAM_MAX);
+            return (false);
         }
     }
-    return;
+    if (!measure_set_channel_opcodeseq(channel, operation, opcode_pos, error, len))
+    {
+        if (error && len)
+            log_e("%s", error);
+        return (false);
+    }
+    return (true);
 }
@@ -1,20 +1,89 @@
 #ifndef _MEASURE_H
     #define _MEASURE_H
 
-    #define MAX_ADC_CHANNELS        8               /** @brief maximum channels from adc */
-    #define VIRTUAL_ADC_CHANNELS    6               /** @brief maximum virtual adc channels after mapping */
-    #define VIRTUAL_CHANNELS        13              /** @brief maximum virtual channels */
+    /**
+     * @brief perfiles de instalación, se elige uno con -DMEASURE_PROFILE=... en platformio.ini
+     *
+     * El perfil fija los canales del ADC, los canales virtuales y los grupos en tiempo de compilación,
+     * así los arreglos y los lazos del motor quedan del tamaño de la instalación y los canales que
+     * no existen no cuestan memoria ni tiempo. Las tablas por defecto de cada perfil están en measure.cpp.
+     */
+    #define MEASURE_PROFILE_1P      1               /** @brief una fase: corriente, tensión, potencia y reactiva */
+    #define MEASURE_PROFILE_3P      3               /** @brief tres fases y la suma de potencias */
+    #define MEASURE_PROFILE_3PN     4               /** @brief tres fases más la corriente de neutro */
+    #ifndef MEASURE_PROFILE
+        #define MEASURE_PROFILE     MEASURE_PROFILE_3P
+    #endif
 
-    #define MAX_GROUPS              6               /** @brief max groups */
-    #define MAX_MICROCODE_OPS       10              /** @brief max channel opcodes size */
+    #define MAX_ADC_CHANNELS        8               /** @brief maximum channels from adc */
+    #if MEASURE_PROFILE == MEASURE_PROFILE_1P
+        #define VIRTUAL_ADC_CHANNELS    2           /** @brief maximum virtual adc channels after mapping */
+        #define VIRTUAL_CHANNELS        4           /** @brief maximum virtual channels */
+        #define MAX_GROUPS              1           /** @brief max groups */
+    #elif MEASURE_PROFILE == MEASURE_PROFILE_3P
+        #define VIRTUAL_ADC_CHANNELS    6           /** @brief maximum virtual adc channels after mapping */
+        #define VIRTUAL_CHANNELS        13          /** @brief maximum virtual channels */
+        #define MAX_GROUPS              6           /** @brief max groups */
+    #elif MEASURE_PROFILE == MEASURE_PROFILE_3PN
+        #define VIRTUAL_ADC_CHANNELS    7           /** @brief maximum virtual adc channels after mapping */
+        #define VIRTUAL_CHANNELS        14          /** @brief maximum virtual channels */
+        #define MAX_GROUPS              6           /** @brief max groups */
+    #else
+        #error "MEASURE_PROFILE desconocido"
+    #endif
+    #define MAX_MICROCODE_OPS       10              /** @brief opcodes del editor de channel.htm, el texto de un programa más corto se completa con BRK */
+    #define MEASURE_PROGRAM_MAX     32              /** @brief bytes máximos del programa de un canal */
+    #define MEASURE_PROGRAM_ARENA   256             /** @brief bytes de todos los programas juntos */
+    #define MEASURE_REGISTERS       4               /** @brief registros por canal de los opcodes extendidos */
+    #define MEASURE_DELAY_MAX       31              /** @brief retardo máximo de SAMPLE_DELAY en muestras */
+    #define MEASURE_MAX_HARMONIC    15              /** @brief armónica más alta que se evalúa por canal */
+    #define MEASURE_HARMONICS_DEFAULT 0x0155        /** @brief armónicas 1, 3, 5, 7 y 9 */
 
     #define numbersOfSamples        256             /** @brief number of samples per time domain */
     #define numbersOfFFTSamples     32 //32              /** @brief number of sampled for fft per time domain */
     #define samplingFrequency       numbersOfSamples*VIRTUAL_ADC_CHANNELS //número de muestras (256*6)
     #define DELAY                   1000
     #define I2S_PORT                I2S_NUM_0
-    // Macros relacionados con el módulo de medición
-    #define HIGH_PASS_FILTER(current, last, sample) (high_pass_coef * ((last) + (sample) - (current)))
+
+    #define MEASURE_PLL_DEADBAND        ( 0.005 * samplingFrequency / 2 ) /** @brief error del lazo en Hz del I2S que no se corrige, 5 mHz de red en cualquier perfil */
+    #define MEASURE_PLL_MAX_STEP        ( samplingFrequency / 24 )        /** @brief corrección máxima por ventana en Hz del I2S, 83 mHz de red (64 Hz con tres fases) */
+    #define MEASURE_PLL_KP              0.5     /** @brief ganancia proporcional del lazo por ventana */
+    #define MEASURE_PLL_KI              0.125   /** @brief ganancia integral del lazo por ventana */
+    #define MEASURE_PLL_RANGE           0.05    /** @brief corrección máxima del lazo como fracción de la tasa nominal */
+    #define MEASURE_PLL_LOCK_WINDOWS    3       /** @brief ventanas seguidas dentro de la banda muerta para enganchar */
+    #define MEASURE_PLL_DRIFT_GAIN      0.25    /** @brief peso de cada ventana en el promedio de la deriva de la red */
+    #define MEASURE_PLL_MIN_DRIFT       ( MEASURE_PLL_DEADBAND / 4 )      /** @brief deriva por ventana en Hz del I2S que se adelanta dentro de la banda muerta, 1.25 mHz/s de red */
+
+    #define MEASURE_ANALYSIS_MIN_PERIOD 40      /** @brief período mínimo del análisis armónico en ms, un bloque */
+    #define MEASURE_ANALYSIS_MAX_PERIOD 60000   /** @brief período máximo del análisis armónico en ms */
+
+    #define MEASURE_PHASE_CORRECTION_MAX 10.0   /** @brief corrección fina de fase máxima en grados */
+
+    #define MEASURE_ADC_CAL_VREF        1100    /** @brief referencia en mV si los eFuse no la tienen grabada */
+    #define MEASURE_ADC_CAL_FIT_LOW     512     /** @brief primer código de la zona lineal del ADC con 11 dB */
+    #define MEASURE_ADC_CAL_FIT_HIGH    3584    /** @brief último código de la zona lineal del ADC con 11 dB */
+    #define MEASURE_ADC_CAL_SPAN        16      /** @brief códigos promediados a cada lado de un punto de los eFuse */
+
+    #define MEASURE_PHASOR_DEFAULT      0x0001  /** @brief fasores seguidos por defecto: la fundamental */
+    #define MEASURE_PHASOR_ANCHOR_BLOCKS 25     /** @brief bloques entre recálculos completos de los fasores, un segundo */
+    #define MEASURE_PHASOR_RING         4       /** @brief ciclos publicados que se pueden leer, dos bloques */
+
+    #define MEASURE_IEC_CHANNELS        VIRTUAL_ADC_CHANNELS /** @brief canales de tensión y corriente con grupos de IEC 61000-4-7 */
+    #define MEASURE_IEC_MAX_ORDER       50      /** @brief orden más alto de los grupos */
+    #define MEASURE_IEC_DEFAULT_ORDER   40      /** @brief orden de los grupos por defecto */
+    #define MEASURE_IEC_MAX_SAMPLES     2048    /** @brief muestras por canal de la captura: una ventana con la red 14 % bajo la nominal más un bloque */
+
+    #define MEASURE_RING_BLOCKS         4       /** @brief bloques entre la tarea de adquisición y la de medición, potencia de dos */
+
+    #define MEASURE_ENERGY_FRACTION_BITS 32     /** @brief bits fraccionarios de los registros de energía, en Wh */
+    #define MEASURE_ENERGY_SAVE_PERIOD  900     /** @brief segundos entre copias de los registros de energía en SPIFFS */
+    #define MEASURE_ENERGY_MAX_GAP      25      /** @brief bloques perdidos seguidos que se completan con la potencia del bloque siguiente */
+    #define MEASURE_ENERGY_FILE_A       "/energy_a.bin" /** @brief copia de los registros de energía, alterna con la B */
+    #define MEASURE_ENERGY_FILE_B       "/energy_b.bin" /** @brief copia de los registros de energía, alterna con la A */
+    /*
+     * Compilando con -DMEASURE_FIXED_POINT en build_flags los canales se procesan en punto fijo Q31
+     * con sumas de 64 bits en lugar de float; los ratios se aplican recién al calcular el RMS.
+     */
 
 
 
@@ -51,11 +120,169 @@
         MUL_SIGN = 0x90,                    /** @brief store value into buffer */
         ABS = 0xa0,                         /** @brief abs */
         MUL_REACTIVE = 0xb0,                /** @brief multiply with reactive sign from channel */
+        MUL_QUADRATURE = 0xc0,              /** @brief multiply with value from channel delayed 90° at the measured frequency */
         NEG = 0xd0,                         /** @brief change sign of a value */
         PASS_NEGATIVE = 0xe0,               /** @brief only pass negative values, otherwise set to zero */
         PASS_POSITIVE = 0xf0,               /** @brief only pass negative values, otherwise set to zero */
         OPCODE_END
     } opcode_t;
+    /**
+     * @brief opcodes extendidos, bytes 0x41 .. 0x4f del espacio de NOP
+     *
+     * Ocupan un byte más con el argumento, salvo SQRT. Un operando de DIV o CLAMP es un canal
+     * o un registro REGISTER_x del propio canal. 0x49 .. 0x4f siguen siendo NOP.
+     */
+    typedef enum {
+        STORE = 0x41,                       /** @brief registro = valor */
+        LOAD = 0x42,                        /** @brief valor = registro */
+        DIV = 0x43,                         /** @brief divide el valor por el operando, 0 si el operando es 0 */
+        SQRT = 0x44,                        /** @brief raíz cuadrada del valor, 0 si es negativo, sin argumento */
+        INTEGRATE = 0x45,                   /** @brief registro += valor por segundo de muestra, valor = registro */
+        SAMPLE_DELAY = 0x46,                /** @brief valor de hace 1 .. MEASURE_DELAY_MAX muestras, uno por programa */
+        CLAMP = 0x47,                       /** @brief limita el valor a +- |operando| */
+        BIQUAD = 0x48,                      /** @brief FILTER con el biquad predefinido del argumento en vez de la media móvil */
+        EXT_OPCODE_END
+    } ext_opcode_t;
+    /**
+     * @brief registros de un canal como operando de DIV y CLAMP
+     */
+    typedef enum {
+        REGISTER_0 = 0x10,
+        REGISTER_1,
+        REGISTER_2,
+        REGISTER_3,
+        REGISTER_END
+    } channel_register_t;
+    /**
+     * @brief dsp engine enum
+     */
+    typedef enum {
+        MEASURE_DSP_SAMPLE_MAJOR = 0,       /** @brief recorre muestra por muestra todos los canales */
+        MEASURE_DSP_BLOCK,                  /** @brief aplica cada opcode a todo el bloque, canal por canal */
+        MEASURE_DSP_MODE_END
+    } measure_dsp_mode_t;
+    /**
+     * @brief measurement window enum
+     */
+    typedef enum {
+        MEASURE_WINDOW_1S = 0,              /** @brief integra lo que entra en un segundo */
+        MEASURE_WINDOW_CYCLES,              /** @brief integra 10 ciclos a 50 Hz o 12 a 60 Hz entre cruces por cero */
+        MEASURE_WINDOW_MODE_END
+    } measure_window_mode_t;
+    /**
+     * @brief origen de la tabla de corrección del ADC
+     */
+    typedef enum {
+        MEASURE_ADC_CAL_NONE = 0,           /** @brief códigos crudos */
+        MEASURE_ADC_CAL_EFUSE,              /** @brief característica grabada en los eFuse del chip */
+        MEASURE_ADC_CAL_USER,               /** @brief puntos de un barrido de calibración */
+        MEASURE_ADC_CAL_END
+    } measure_adc_calibration_t;
+    /**
+     * @brief datos de la última ventana de medición publicada
+     */
+    typedef struct {
+        uint32_t sequence;                  /** @brief número de ventana, aumenta con cada publicación */
+        uint32_t samples;                   /** @brief muestras por canal integradas */
+        uint16_t cycles;                    /** @brief ciclos de red integrados, 0 en MEASURE_WINDOW_1S o sin cruces */
+        int64_t timestamp_us;               /** @brief fin de la ventana en esp_timer_get_time() */
+    } measure_window_t;
+    /**
+     * @brief estado del lazo de la tasa de muestreo
+     */
+    typedef enum {
+        MEASURE_PLL_OFF = 0,                /** @brief tasa fija, sólo la corrección manual */
+        MEASURE_PLL_TRACKING,               /** @brief corrigiendo, o sin tensión para medir */
+        MEASURE_PLL_LOCKED,                 /** @brief el bloque dura dos ciclos dentro de la banda muerta */
+        MEASURE_PLL_STATE_END
+    } measure_pll_state_t;
+    /**
+     * @brief fasor de una armónica de un canal en el último ciclo
+     */
+    typedef struct {
+        float magnitude;                    /** @brief valor eficaz en las unidades del canal */
+        float angle;                        /** @brief grados respecto de la fundamental de la tensión de referencia, -180 a 180 */
+    } measure_phasor_t;
+    /**
+     * @brief potencias de un grupo en la última ventana de medición
+     */
+    typedef struct {
+        float active;                       /** @brief potencia activa del canal AC_POWER del grupo */
+        float reactive;                     /** @brief potencia reactiva del canal AC_REACTIVE_POWER, positiva si la carga es inductiva */
+        float apparent;                     /** @brief tensión eficaz por corriente eficaz del grupo */
+        float power_factor;                 /** @brief |activa| / aparente, 0 a 1 */
+    } measure_group_power_t;
+    /**
+     * @brief registros de energía de un grupo
+     */
+    typedef enum {
+        MEASURE_ENERGY_ACTIVE_IMPORT = 0,   /** @brief activa con potencia positiva */
+        MEASURE_ENERGY_ACTIVE_EXPORT,       /** @brief activa con potencia negativa */
+        MEASURE_ENERGY_REACTIVE_IMPORT,     /** @brief reactiva con carga inductiva, potencia positiva */
+        MEASURE_ENERGY_REACTIVE_EXPORT,     /** @brief reactiva con carga capacitiva, potencia negativa */
+        MEASURE_ENERGY_APPARENT,            /** @brief aparente, tensión eficaz por corriente eficaz */
+        MEASURE_ENERGY_REGISTERS
+    } measure_energy_register_t;
+    /**
+     * @brief energías acumuladas de un grupo
+     */
+    typedef struct {
+        double active_import;               /** @brief kWh importados */
+        double active_export;               /** @brief kWh exportados */
+        double reactive_import;             /** @brief kvarh inductivos */
+        double reactive_export;             /** @brief kvarh capacitivos */
+        double apparent;                    /** @brief kVAh */
+    } measure_group_energy_t;
+    /**
+     * @brief origen de los registros de energía al arrancar
+     */
+    typedef enum {
+        MEASURE_ENERGY_SOURCE_NONE = 0,     /** @brief sin copia válida, arrancan en cero */
+        MEASURE_ENERGY_SOURCE_RTC,          /** @brief memoria RTC, el reinicio no cortó la alimentación */
+        MEASURE_ENERGY_SOURCE_FLASH,        /** @brief última copia en SPIFFS */
+        MEASURE_ENERGY_SOURCE_END
+    } measure_energy_source_t;
+    /**
+     * @brief estado de la persistencia de los registros de energía
+     */
+    typedef struct {
+        measure_energy_source_t source;     /** @brief de dónde se recuperaron al arrancar */
+        uint32_t saves;                     /** @brief copias escritas en SPIFFS desde el arranque */
+        uint32_t save_errors;               /** @brief copias que no se pudieron escribir */
+        uint32_t gap_blocks;                /** @brief bloques perdidos completados con la potencia del bloque siguiente */
+    } measure_energy_stats_t;
+    /**
+     * @brief grupos de IEC 61000-4-7 de un canal en la última ventana de ciclos
+     */
+    typedef struct {
+        uint16_t cycles;                                /** @brief ciclos de la ventana, 0 si no estaba sincronizada (ventana de Hann) */
+        uint16_t max_order;                             /** @brief orden más alto calculado */
+        float harmonic[ MEASURE_IEC_MAX_ORDER + 1 ];    /** @brief valor eficaz del grupo armónico h en [h], la continua en [0] */
+        float interharmonic[ MEASURE_IEC_MAX_ORDER + 1 ]; /** @brief valor eficaz del grupo interarmónico entre h y h + 1 en [h] */
+        float thd;                                      /** @brief THDG en porcentaje, grupos 2 .. max_order */
+    } measure_iec_groups_t;
+    /**
+     * @brief costo de la adquisición de un bloque
+     */
+    typedef struct {
+        uint32_t blocks;                    /** @brief bloques leídos */
+        uint32_t misaligned;                /** @brief bloques en que algún canal no recibió numbersOfSamples muestras */
+        uint32_t read_us;                   /** @brief espera del último bloque en el driver I2S en us */
+        uint32_t demux_us;                  /** @brief tiempo de CPU de la separación por canal del último bloque en us */
+        uint32_t demux_max_us;              /** @brief tiempo de CPU máximo de la separación por canal en us */
+        uint32_t lost;                      /** @brief bloques que la tarea de medición no llegó a procesar, por saltos en la secuencia */
+        uint32_t queued_max;                /** @brief bloques esperando en la cola como máximo, de MEASURE_RING_BLOCKS */
+    } measure_acquisition_stats_t;
+    /**
+     * @brief costo del análisis de IEC 61000-4-7
+     */
+    typedef struct {
+        uint32_t windows;                   /** @brief ventanas analizadas */
+        uint32_t skipped;                   /** @brief ventanas descartadas, sin memoria o con los canales cambiados */
+        uint32_t last_us;                   /** @brief tiempo de CPU de la última ventana en us */
+        uint32_t max_us;                    /** @brief tiempo de CPU máximo en us */
+        uint32_t window_us;                 /** @brief duración de la última ventana en us */
+    } measure_iec_stats_t;
     /**
      * @brief channel enum
      */
@@ -94,11 +321,11 @@ struct HarmonicData {
     float ffifth;
     float fsevent;
     float fninth;
+    float harmonic[MEASURE_MAX_HARMONIC]; // Valor eficaz de la armónica h en harmonic[h-1], 0 si no se evalúa
     char uF[3] = "Hz";
     char porcentaje[3] = "%";
 };
 
-extern HarmonicData harmonic_values[VIRTUAL_CHANNELS];  // Declaración como extern
 
     /**
      * @brief group config structure
@@ -125,7 +352,8 @@ extern HarmonicData harmonic_values[VIRTUAL_CHANNELS];  // Declaración como ext
         int             report_exp;                         /** @brief channel report exponent */
         int             group_id;                           /** @brief channel group ID for output groups */
         float           sign;                               /** @brief channel reactive power sign */
-        uint8_t         operation[ MAX_MICROCODE_OPS ];     /** @brief opcode sequence */
+        uint16_t        harmonics;                          /** @brief armónicas a evaluar, bit h-1 para la armónica h */
+        float           phase_correction;                   /** @brief corrección fina de fase en grados, se suma a phaseshift */
     };
 
     // Declara la función en measure.h
@@ -140,8 +368,8 @@ extern HarmonicData harmonic_values[VIRTUAL_CHANNELS];  // Declaración como ext
     void measure_mes(void);
     void measure_save_settings( void );
     /**
-     *@brief establece el valor de corrección de phasshift para todos los canales de voltaje en números de muestras
-    * @Param Corr Corrección Valor en la muestra
+     *@brief establece el valor de corrección de phasshift para todos los canales de tensión alterna en grados
+    * @Param Corr Corrección Valor en grados
     * @return 0 si está bien o fallido
      */
     int measure_set_phaseshift( int corr );
@@ -170,18 +398,304 @@ extern HarmonicData harmonic_values[VIRTUAL_CHANNELS];  // Declaración como ext
      * @param voltage_frequency 
      */
     void measure_set_network_frequency( float voltage_frequency );
-/**
-     * @brief Obtenga el búfer de muestra actual con un size_of virtual_channels * NumbersOfsamples
+    /**
+     * @brief Obtiene el motor de procesamiento de señales activo
+     * 
+     * @return measure_dsp_mode_t 
+     */
+    measure_dsp_mode_t measure_get_dsp_mode( void );
+    /**
+     * @brief Selecciona el motor de procesamiento de señales
      * 
-     * @return uint16_t* puntero a una matriz uint16_t [virtual_channels] [NumbersOfSamples]
+     * @param dsp_mode      MEASURE_DSP_SAMPLE_MAJOR o MEASURE_DSP_BLOCK
+     * @note el motor de bloques vuelve al de muestras si los programas de los canales no lo permiten
      */
-    uint16_t * measure_get_buffer( void );
+    void measure_set_dsp_mode( measure_dsp_mode_t dsp_mode );
     /**
-* @Brief Obtenga el búfer FFT actual con un size_of de virtual_channels * NumbersOffftSamples;
+     * @brief Obtiene el modo de ventana de medición
      * 
-     * @return uint16_t* puntero a una matriz uint16_t [virtual_channels] [NumbersOffftSamples]
+     * @return measure_window_mode_t 
      */
-    uint16_t * measure_get_fft( void );
+    measure_window_mode_t measure_get_window_mode( void );
+    /**
+     * @brief Selecciona el modo de ventana de medición
+     * 
+     * @param window_mode   MEASURE_WINDOW_1S o MEASURE_WINDOW_CYCLES
+     */
+    void measure_set_window_mode( measure_window_mode_t window_mode );
+    /**
+     * @brief Obtiene los datos de la última ventana publicada, corresponden a los RMS actuales
+     * 
+     * @param window    destino de los datos
+     */
+    void measure_get_window( measure_window_t *window );
+    /**
+     * @brief Obtiene el coeficiente del filtro pasa alto del opcode FILTER
+     * 
+     * @return float 
+     */
+    float measure_get_high_pass_coef( void );
+    /**
+     * @brief Setea el coeficiente del filtro pasa alto del opcode FILTER
+     * 
+     * @param high_pass_coef    entre 0 y 1, más cerca de 1 baja la frecuencia de corte
+     */
+    void measure_set_high_pass_coef( float high_pass_coef );
+    /**
+     * @brief Indica si el lazo de la tasa de muestreo está habilitado
+     * 
+     * @return true 
+     * @return false 
+     */
+    bool measure_get_sample_pll( void );
+    /**
+     * @brief Habilita el lazo que ajusta la tasa de muestreo a la frecuencia de red medida
+     * 
+     * @param sample_pll    true habilitado, false vuelve a la tasa nominal más samplerate_corr
+     */
+    void measure_set_sample_pll( bool sample_pll );
+    /**
+     * @brief Indica si se compensa el desfasaje entre canales del barrido del ADC
+     * 
+     * @return true 
+     * @return false 
+     */
+    bool measure_get_adc_skew_correction( void );
+    /**
+     * @brief Compensa el desfasaje entre canales que produce el barrido del ADC SAR
+     * 
+     * Los canales se convierten uno detrás de otro; cada uno se lleva al instante del primero
+     * del patrón con un retardo fraccionario en GET_ADC.
+     * 
+     * @param adc_skew_correction   true compensa, false usa las muestras como llegan
+     */
+    void measure_set_adc_skew_correction( bool adc_skew_correction );
+    /**
+     * @brief Obtiene el origen de la tabla de corrección del ADC
+     * 
+     * @return measure_adc_calibration_t 
+     */
+    measure_adc_calibration_t measure_get_adc_calibration( void );
+    /**
+     * @brief Elige el origen de la tabla de corrección del ADC y la vuelve a armar
+     * 
+     * Si los puntos no alcanzan para armar la tabla se usan los códigos crudos.
+     * 
+     * @param adc_calibration   MEASURE_ADC_CAL_NONE, MEASURE_ADC_CAL_EFUSE o MEASURE_ADC_CAL_USER
+     */
+    void measure_set_adc_calibration( measure_adc_calibration_t adc_calibration );
+    /**
+     * @brief Obtiene los puntos del barrido de calibración del ADC
+     * 
+     * @param len       tamaño de dest
+     * @param dest      destino, pares "crudo:ideal" separados por comas
+     * @return char*    dest
+     */
+    char *measure_get_adc_calibration_points_str( uint16_t len, char *dest );
+    /**
+     * @brief Setea los puntos del barrido de calibración del ADC
+     * 
+     * Cada punto es el código que entregó el ADC y el que corresponde a la tensión aplicada, por
+     * ejemplo "100:62.5,2048:2048,4000:4071". Se usan con MEASURE_ADC_CAL_USER.
+     * 
+     * @param value     pares "crudo:ideal" separados por comas, con crudo creciente
+     * @return true     puntos válidos
+     * @return false    puntos inválidos, se mantienen los anteriores
+     */
+    bool measure_set_adc_calibration_points_str( const char *value );
+    /**
+     * @brief Obtiene el factor de sobremuestreo configurado
+     * 
+     * @return int 1 sin sobremuestreo, 2 o 4
+     */
+    int measure_get_oversampling( void );
+    /**
+     * @brief Setea el factor de sobremuestreo del ADC, se aplica al reiniciar
+     * 
+     * El ADC convierte oversampling veces más rápido y cada canal se diezma con un FIR antes de
+     * los programas, que siguen viendo numbersOfSamples muestras por bloque con menos ruido y sin
+     * lo que se plegaría sobre las armónicas. El DMA y los coeficientes se dimensionan al iniciar.
+     * 
+     * @param oversampling  1, 2 o 4; otro valor se toma como 1
+     */
+    void measure_set_oversampling( int oversampling );
+    /**
+     * @brief Obtiene el estado del lazo de la tasa de muestreo
+     * 
+     * @return measure_pll_state_t 
+     */
+    measure_pll_state_t measure_get_pll_state( void );
+    /**
+     * @brief Obtiene el error del lazo: frecuencia medida menos la frecuencia a la que el bloque es coherente
+     * 
+     * @return float error en Hz de red
+     */
+    float measure_get_pll_error( void );
+    /**
+     * @brief Obtiene la corrección aplicada por el lazo a la tasa del I2S
+     * 
+     * @return int corrección en Hz, se suma a samplerate_corr
+     */
+    int measure_get_pll_offset( void );
+    /**
+     * @brief Toma el último bloque de muestras publicado, sin esperar a la tarea de medición
+     * 
+     * @param sequence  si no es NULL recibe el número de secuencia del bloque
+     * @return const uint16_t* puntero a una matriz uint16_t [virtual_channels] [NumbersOfSamples]
+     *         o NULL si todavía no se publicó ninguno
+     * @note el bloque no cambia hasta liberarlo con measure_release_buffer()
+     */
+    const uint16_t * measure_acquire_buffer( uint32_t *sequence );
+    /**
+     * @brief Libera un bloque tomado con measure_acquire_buffer()
+     * 
+     * @param sample_buffer     puntero devuelto por measure_acquire_buffer()
+     */
+    void measure_release_buffer( const uint16_t *sample_buffer );
+    /**
+     * @brief Obtiene la cantidad de bloques no publicados porque los lectores tenían todos los buffers
+     * 
+     * @return uint32_t 
+     */
+    uint32_t measure_get_buffer_dropped( void );
+    /**
+     * @brief Copia las armónicas del último análisis publicado de un canal, sin esperar a la tarea de medición
+     * 
+     * @param channel   canal virtual
+     * @param harmonics destino
+     * @return uint32_t versión del análisis, 0 si todavía no se publicó ninguno
+     */
+    uint32_t measure_get_harmonics( uint16_t channel, HarmonicData *harmonics );
+    /**
+     * @brief Copia el espectro del último análisis publicado de un canal
+     * 
+     * @param channel   canal virtual
+     * @param spectrum  destino de numbersOfFFTSamples magnitudes
+     * @return uint32_t versión del análisis, 0 si todavía no se publicó ninguno
+     */
+    uint32_t measure_get_spectrum( uint16_t channel, uint16_t *spectrum );
+    /**
+     * @brief Indica si el análisis calcula el espectro de un canal: los de corriente y tensión alterna
+     * 
+     * @param channel   canal virtual
+     * @return true     tiene espectro
+     * @return false    no existe en el perfil o es de otro tipo, su espectro queda en cero
+     */
+    bool measure_get_spectrum_channel( uint16_t channel );
+    /**
+     * @brief Obtiene la versión del último análisis publicado, aumenta con cada publicación
+     * 
+     * @return uint32_t 
+     */
+    uint32_t measure_get_analysis_version( void );
+    /**
+     * @brief Obtiene el período del análisis armónico
+     * 
+     * @return int período en ms
+     */
+    int measure_get_analysis_period( void );
+    /**
+     * @brief Setea el período del análisis armónico (espectro y publicación de armónicas)
+     * 
+     * @param analysis_period   período en ms, entre MEASURE_ANALYSIS_MIN_PERIOD y MEASURE_ANALYSIS_MAX_PERIOD
+     */
+    void measure_set_analysis_period( int analysis_period );
+    /**
+     * @brief Obtiene las armónicas cuyos fasores se siguen ciclo a ciclo
+     * 
+     * @return uint16_t máscara, bit h - 1 para la armónica h, 0 deshabilitado
+     */
+    uint16_t measure_get_phasor_harmonics( void );
+    /**
+     * @brief Selecciona las armónicas cuyos fasores se siguen ciclo a ciclo en los canales de tensión y corriente
+     * 
+     * @param harmonics     máscara, bit h - 1 para la armónica h; la fundamental se sigue siempre que haya alguna
+     */
+    void measure_set_phasor_harmonics( uint16_t harmonics );
+    /**
+     * @brief Obtiene las armónicas de los fasores como lista separada por comas
+     * 
+     * @param len       tamaño de dest
+     * @param dest      destino
+     * @return char*    dest
+     */
+    char *measure_get_phasor_harmonics_str( uint16_t len, char *dest );
+    /**
+     * @brief Selecciona las armónicas de los fasores con una lista separada por comas, por ejemplo "1,3,5"
+     * 
+     * @param value     lista
+     */
+    void measure_set_phasor_harmonics_str( const char *value );
+    /**
+     * @brief Copia el fasor de una armónica de un canal en el último ciclo publicado
+     * 
+     * Se publica un resultado por ciclo de red; la versión es el número del ciclo.
+     * 
+     * @param channel   canal virtual
+     * @param harmonic  armónica, 1 .. MEASURE_MAX_HARMONIC
+     * @param phasor    destino
+     * @return uint32_t versión de la publicación, 0 si el canal no sigue esa armónica o no se publicó ninguna
+     */
+    uint32_t measure_get_channel_phasor( uint16_t channel, int harmonic, measure_phasor_t *phasor );
+    /**
+     * @brief Copia el fasor de una armónica de un canal en un ciclo dado, con el fin del ciclo
+     * 
+     * Los ciclos de un bloque se publican juntos al procesarlo; con el número de ciclo y su marca
+     * de tiempo se pueden leer uno por uno mientras sigan entre los últimos MEASURE_PHASOR_RING.
+     * 
+     * @param channel       canal virtual
+     * @param harmonic      armónica, 1 .. MEASURE_MAX_HARMONIC
+     * @param cycle         número de ciclo, la versión de measure_get_channel_phasor(); 0 el último
+     * @param phasor        destino
+     * @param timestamp_us  destino del fin del ciclo en esp_timer_get_time(), puede ser NULL
+     * @return uint32_t número del ciclo copiado, 0 si el canal no sigue esa armónica o el ciclo no está
+     */
+    uint32_t measure_get_channel_phasor_cycle( uint16_t channel, int harmonic, uint32_t cycle, measure_phasor_t *phasor, int64_t *timestamp_us );
+    /**
+     * @brief Indica si se calculan los grupos de IEC 61000-4-7
+     * 
+     * @return true 
+     * @return false 
+     */
+    bool measure_get_iec_harmonics( void );
+    /**
+     * @brief Habilita los grupos armónicos e interarmónicos de IEC 61000-4-7 en los canales de tensión y corriente
+     * 
+     * @param iec_harmonics     true habilitado, sólo se calculan con MEASURE_WINDOW_CYCLES
+     */
+    void measure_set_iec_harmonics( bool iec_harmonics );
+    /**
+     * @brief Obtiene el orden más alto de los grupos de IEC 61000-4-7
+     * 
+     * @return int 
+     */
+    int measure_get_iec_max_order( void );
+    /**
+     * @brief Setea el orden más alto de los grupos de IEC 61000-4-7
+     * 
+     * @param max_order     entre 2 y MEASURE_IEC_MAX_ORDER, la norma pide 40 o 50
+     */
+    void measure_set_iec_max_order( int max_order );
+    /**
+     * @brief Copia los grupos de IEC 61000-4-7 publicados de un canal, sin esperar a la tarea de medición
+     * 
+     * @param channel   canal virtual
+     * @param groups    destino
+     * @return uint32_t versión de la publicación, 0 si el canal no tiene grupos publicados
+     */
+    uint32_t measure_get_iec_groups( uint16_t channel, measure_iec_groups_t *groups );
+    /**
+     * @brief Obtiene el costo de la adquisición: lectura del I2S, corrección y diezmado del ADC
+     * 
+     * @param stats     destino
+     */
+    void measure_get_acquisition_stats( measure_acquisition_stats_t *stats );
+    /**
+     * @brief Obtiene el costo del análisis de IEC 61000-4-7
+     * 
+     * @param stats     destino
+     */
+    void measure_get_iec_stats( measure_iec_stats_t *stats );
 
     /**
      * @brief Inicio de tarea de medición
@@ -240,7 +754,6 @@ extern HarmonicData harmonic_values[VIRTUAL_CHANNELS];  // Declaración como ext
      * @return channel_type_t 
      */
     void measure_set_channel_type( uint16_t channel, channel_type_t value );
-    uint16_t* measure_get_fft_for_mqtt(StaticJsonDocument<4096>& doc);
     /**
      * @brief Obtiene el offset del canal
      * 
@@ -283,6 +796,29 @@ extern HarmonicData harmonic_values[VIRTUAL_CHANNELS];  // Declaración como ext
      * @param value         phaseshift in sample
      */
     void measure_set_channel_phaseshift( uint16_t channel, int value );
+    /**
+     * @brief Recalcula los desplazamientos de índice 0° y 90° del canal dado
+     * 
+     * @param channel       channel
+     * @note se llama automáticamente al cambiar el desfase del canal; la tarea de medición lo toma antes del próximo bloque
+     */
+    void measure_update_channel_phaseshift( uint16_t channel );
+    /**
+     * @brief Obtiene la corrección fina de fase del canal dado
+     * 
+     * @param channel       channel
+     * @return float        grados de la fundamental, positivo adelanta
+     */
+    float measure_get_channel_phase_correction( uint16_t channel );
+    /**
+     * @brief Setea la corrección fina de fase del canal, para el error de fase de un TC o TV
+     * 
+     * Se suma a phaseshift con resolución menor a una muestra, interpolando en GET_ADC.
+     * 
+     * @param channel       channel
+     * @param value         grados de la fundamental, entre -MEASURE_PHASE_CORRECTION_MAX y MEASURE_PHASE_CORRECTION_MAX
+     */
+    void measure_set_channel_phase_correction( uint16_t channel, float value );
     /**
      * @brief Obtiene el nombre del grupo
      * 
@@ -312,6 +848,40 @@ extern HarmonicData harmonic_values[VIRTUAL_CHANNELS];  // Declaración como ext
      * @param active 
      */
     void measure_set_group_active( uint16_t group, bool active );
+    /**
+     * @brief Obtiene las potencias de un grupo calculadas al cerrar la última ventana de medición
+     * 
+     * @param group     grupo
+     * @param power     destino
+     * @return true     si el grupo tiene tensión y corriente, false si no hay potencia aparente
+     */
+    bool measure_get_group_power( uint16_t group, measure_group_power_t *power );
+    /**
+     * @brief Obtiene las energías acumuladas de un grupo
+     *
+     * Se integran bloque a bloque con la potencia activa y reactiva de los canales AC_POWER y
+     * AC_REACTIVE_POWER del grupo y con el producto de sus canales AC_VOLTAGE y AC_CURRENT, en
+     * registros de 64 bits con MEASURE_ENERGY_FRACTION_BITS bits fraccionarios de Wh. Se publican
+     * al cerrar cada ventana de medición.
+     *
+     * @param group     grupo
+     * @param energy    destino
+     * @return uint32_t versión, aumenta con cada ventana, 0 si el grupo no existe
+     */
+    uint32_t measure_get_group_energy( uint16_t group, measure_group_energy_t *energy );
+    /**
+     * @brief Obtiene el estado de la persistencia de los registros de energía
+     *
+     * @param stats     destino
+     */
+    void measure_get_energy_stats( measure_energy_stats_t *stats );
+    /**
+     * @brief Escribe en SPIFFS la copia de los registros de energía que dejó la tarea de medición
+     *
+     * Se llama seguido desde una tarea de menor prioridad, el loop() de Arduino, así la escritura
+     * de la flash no demora la medición. Sin copia pendiente vuelve enseguida.
+     */
+    void measure_energy_loop( void );
     /**
      * @brief Obtiene el id del grupo del canal dado
      * 
@@ -333,6 +903,37 @@ extern HarmonicData harmonic_values[VIRTUAL_CHANNELS];  // Declaración como ext
      * @return int          number of channel with group id
      */
     int measure_get_channel_group_id_entrys( int group_id );
+    /**
+     * @brief Obtiene las armónicas que se evalúan en un canal
+     * 
+     * @param channel 
+     * @return uint16_t máscara con el bit h-1 para la armónica h
+     */
+    uint16_t measure_get_channel_harmonics( uint16_t channel );
+    /**
+     * @brief Selecciona las armónicas que se evalúan en un canal con filtros de Goertzel
+     * 
+     * @param channel 
+     * @param harmonics máscara con el bit h-1 para la armónica h, hasta MEASURE_MAX_HARMONIC;
+     *                  la fundamental se agrega siempre que haya alguna, 0 no evalúa ninguna
+     */
+    void measure_set_channel_harmonics( uint16_t channel, uint16_t harmonics );
+    /**
+     * @brief Obtiene las armónicas de un canal como lista separada por comas, ej. "1,3,5,7,9"
+     * 
+     * @param channel 
+     * @param len       tamaño de dest
+     * @param dest      destino
+     * @return char*    dest
+     */
+    char * measure_get_channel_harmonics_str( uint16_t channel, uint16_t len, char *dest );
+    /**
+     * @brief Selecciona las armónicas de un canal con una lista separada por comas
+     * 
+     * @param channel 
+     * @param value     ej. "1,3,5,7,9", las armónicas fuera de 1 .. MEASURE_MAX_HARMONIC se ignoran
+     */
+    void measure_set_channel_harmonics_str( uint16_t channel, const char *value );
     /**
      * @brief Setea los números de canales para un id del grupo dado
      * 
@@ -394,11 +995,14 @@ extern HarmonicData harmonic_values[VIRTUAL_CHANNELS];  // Declaración como ext
      * @brief Obtiene la secuencia del código de opciónes (opcode) para un canal dado
      * 
      * @param channel 
-     * @return uint8_t*     pointer to a opcode sequnce with a size of MAX_MICROCODE_OPS
+     * @param count         destino de la cantidad de bytes del programa
+     * @return uint8_t*     pointer to a opcode sequnce with a size of count, NULL if failed
      */
-    uint8_t * measure_get_channel_opcodeseq( uint16_t channel );
+    uint8_t * measure_get_channel_opcodeseq( uint16_t channel, uint16_t *count );
     /**
      * @brief Obtiene la secuencia del código de opciones (opcode) como un char array terminado por un valor en cero (NULL)
+     *
+     * Dos dígitos hexadecimales por byte; un programa de menos de MAX_MICROCODE_OPS bytes se completa con "00".
      * 
      * @param channel       channel to get a opcode sequence
      * @param len           max size in len bytes
@@ -407,18 +1011,40 @@ extern HarmonicData harmonic_values[VIRTUAL_CHANNELS];  // Declaración como ext
      */
     char * measure_get_channel_opcodeseq_str( uint16_t channel, uint16_t len, char *dest );
     /**
-     * @brief Obtiene la secuencia del código de opciones (opcode) para un canal dado
+     * @brief Setea la secuencia del código de opciones (opcode) para un canal dado
+     *
+     * El programa se rechaza si tiene operandos fuera de rango, si crea una dependencia circular
+     * entre canales o si no entra en los MEASURE_PROGRAM_ARENA bytes de todos los programas; en ese
+     * caso el canal sigue con el programa anterior. Los BRK del final no se guardan.
      * 
      * @param channel       a give channel
-     * @param value         pointer to a opcode sequence as byte array with a size of MAX_MICROCODE_OPS
+     * @param value         pointer to a opcode sequence as byte array
+     * @param count         bytes de value, a lo sumo MEASURE_PROGRAM_MAX
+     * @param error         destino del mensaje de error, puede ser NULL
+     * @param len           max size of error in bytes
+     * @return true         el programa se aplicó
      */
-    void measure_set_channel_opcodeseq( uint16_t channel, uint8_t *value );
+    bool measure_set_channel_opcodeseq( uint16_t channel, const uint8_t *value, uint16_t count, char *error, uint16_t len );
     /**
      * @brief Setea la secuencia del código de opciones (opcode) para un canal dado en forma de string
+     *
+     * El programa es exactamente lo que trae value, hasta MEASURE_PROGRAM_MAX bytes; uno más largo
+     * se rechaza sin cambiar el programa del canal, salvo que lo que sobra sean BRK.
      * 
      * @param channel       a given channel
      * @param value         pointer to a opcode sequence as char array terminate with zero
+     * @param error         destino del mensaje de error, puede ser NULL
+     * @param len           max size of error in bytes
+     * @return true         el programa se aplicó, ver measure_set_channel_opcodeseq()
+     */
+    bool measure_set_channel_opcodeseq_str( uint16_t channel, const char *value, char *error, uint16_t len );
+    /**
+     * @brief Compila la secuencia de opcodes de un canal en un plan de ejecución predecodificado
+     * 
+     * @param channel       a given channel
+     * @note se llama automáticamente desde los setters de opcodes y al cargar la configuración; la tarea de
+     * medición toma el plan nuevo entre bloques, nunca a mitad de uno
      */
-    void measure_set_channel_opcodeseq_str( uint16_t channel, const char *value );
+    void measure_compile_channel( uint16_t channel );
 
 #endif // _MEASURE_H
@@ -78,9 +78,26 @@ void sendPowerDataToMongoDB(void) {
     doc["reset_state"] = reset_state;
     doc["measurement_valid"] = measure_get_measurement_valid();
     doc["frequency"] = measure_get_max_freq();
+    doc["pll_state"] = measure_get_pll_state();
+    doc["pll_error"] = measure_get_pll_error();
+    {
+        measure_acquisition_stats_t stats;
+        measure_get_acquisition_stats(&stats);
+        doc["acquisition_us"] = stats.demux_us;
+        doc["acquisition_max_us"] = stats.demux_max_us;
+        doc["acquisition_misaligned"] = stats.misaligned;
+        doc["acquisition_lost"] = stats.lost;
+        doc["acquisition_queued_max"] = stats.queued_max;
+    }
+    if (measure_get_iec_harmonics()) {
+        measure_iec_stats_t stats;
+        measure_get_iec_stats(&stats);
+        doc["iec_cpu_us"] = stats.last_us;
+        doc["iec_cpu_max_us"] = stats.max_us;
+    }
 
     // Agregar datos de los grupos y canales al nivel principal (sin cambios)
-    for (int group_id = 0; group_id < 6; group_id++) {
+    for (int group_id = 0; group_id < MAX_GROUPS; group_id++) {
         if (!measure_get_group_active(group_id) || !measure_get_channel_group_id_entrys(group_id))
             continue;
 
@@ -118,10 +135,56 @@ void sendPowerDataToMongoDB(void) {
 
                 fieldName = String(measure_get_group_name(group_id)) + "_" + quantity + "_name";
                 doc[fieldName] = measure_get_channel_name(channel);
+
+                // THD del último análisis publicado, si el canal evalúa armónicas
+                if (measure_get_channel_harmonics(channel)) {
+                    HarmonicData harmonics;
+                    measure_get_harmonics(channel, &harmonics);
+                    fieldName = String(measure_get_group_name(group_id)) + "_" + quantity + "_thd";
+                    doc[fieldName] = harmonics.thd;
+                }
+
+                // THD de los grupos de IEC 61000-4-7, si el canal los tiene publicados
+                measure_iec_groups_t groups;
+                if (measure_get_iec_groups(channel, &groups)) {
+                    fieldName = String(measure_get_group_name(group_id)) + "_" + quantity + "_thdg";
+                    doc[fieldName] = groups.thd;
+                }
+
+                // Ángulo de la fundamental respecto de la tensión de referencia, del último ciclo publicado
+                measure_phasor_t phasor;
+                if (measure_get_channel_phasor(channel, 1, &phasor)) {
+                    fieldName = String(measure_get_group_name(group_id)) + "_" + quantity + "_angle";
+                    doc[fieldName] = phasor.angle;
+                }
             }
         }
+
+        // Potencia aparente y factor de potencia del grupo, si tiene tensión y corriente
+        measure_group_power_t power;
+        if (measure_get_group_power(group_id, &power)) {
+            doc[String(measure_get_group_name(group_id)) + "_apparent_power"] = power.apparent;
+            doc[String(measure_get_group_name(group_id)) + "_power_factor"] = power.power_factor;
+        }
+
+        // Energías acumuladas del grupo, en kWh, kvarh y kVAh
+        measure_group_energy_t energy;
+        if (measure_get_group_energy(group_id, &energy)) {
+            doc[String(measure_get_group_name(group_id)) + "_energy_active_import"] = energy.active_import;
+            doc[String(measure_get_group_name(group_id)) + "_energy_active_export"] = energy.active_export;
+            doc[String(measure_get_group_name(group_id)) + "_energy_reactive_import"] = energy.reactive_import;
+            doc[String(measure_get_group_name(group_id)) + "_energy_reactive_export"] = energy.reactive_export;
+            doc[String(measure_get_group_name(group_id)) + "_energy_apparent"] = energy.apparent;
+        }
     }
 
+    // Origen de los registros de energía al arrancar y copias escritas en SPIFFS
+    measure_energy_stats_t energy_stats;
+    measure_get_energy_stats(&energy_stats);
+    doc["energy_source"] = (int)energy_stats.source;
+    doc["energy_saves"] = energy_stats.saves;
+    doc["energy_save_errors"] = energy_stats.save_errors;
+
     // Serializar JSON
     String json;
     serializeJson(doc, json);
@@ -49,6 +49,8 @@ void setup( void ) {
  * @brief Bucle principal de Arduino
  */
 void loop() {
-    // Código para el bucle principal (comentado en este caso)
+    // Copias de los registros de energía en SPIFFS, fuera de la tarea de medición
+    measure_energy_loop();
     //ioport_loop();
+    delay( 10 );
 }
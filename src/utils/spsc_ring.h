@@ -0,0 +1,79 @@
+/**
+ * @file spsc_ring.h
+ * @brief Cola circular sin bloqueos de un productor y un consumidor
+ *
+ * Los elementos viven en la cola: el productor pide el próximo lugar libre, lo llena en el lugar
+ * y lo confirma; el consumidor pide el más viejo, lo usa en el lugar y lo libera. Cada índice
+ * lo escribe una sola tarea, así alcanza con cargas y guardados atómicos con orden
+ * acquire / release, sin secciones críticas ni semáforos. Los índices corren libres y
+ * SIZE tiene que ser potencia de dos.
+ */
+#ifndef _SPSC_RING_H
+    #define _SPSC_RING_H
+
+    #include <stddef.h>
+    #include <stdint.h>
+
+    template <typename T, uint32_t SIZE>
+    class spsc_ring_t {
+        static_assert( SIZE && !( SIZE & ( SIZE - 1 ) ), "SIZE tiene que ser potencia de dos" );
+
+        public:
+            spsc_ring_t() : head( 0 ), tail( 0 ) {}
+            /**
+             * @brief próximo lugar para llenar, sólo desde el productor
+             *
+             * @return T*   lugar libre, NULL si la cola está llena
+             */
+            T *acquire_write( void ) {
+                uint32_t h = __atomic_load_n( &head, __ATOMIC_RELAXED );
+
+                if( h - __atomic_load_n( &tail, __ATOMIC_ACQUIRE ) == SIZE )
+                    return( NULL );
+                return( &slot[ h & ( SIZE - 1 ) ] );
+            }
+            /**
+             * @brief publica el lugar de acquire_write() para el consumidor
+             */
+            void commit_write( void ) {
+                __atomic_store_n( &head, __atomic_load_n( &head, __ATOMIC_RELAXED ) + 1, __ATOMIC_RELEASE );
+            }
+            /**
+             * @brief elemento más viejo, sólo desde el consumidor
+             *
+             * @return T*   elemento, NULL si la cola está vacía
+             */
+            T *acquire_read( void ) {
+                uint32_t t = __atomic_load_n( &tail, __ATOMIC_RELAXED );
+
+                if( __atomic_load_n( &head, __ATOMIC_ACQUIRE ) == t )
+                    return( NULL );
+                return( &slot[ t & ( SIZE - 1 ) ] );
+            }
+            /**
+             * @brief devuelve el lugar de acquire_read() al productor
+             */
+            void release_read( void ) {
+                __atomic_store_n( &tail, __atomic_load_n( &tail, __ATOMIC_RELAXED ) + 1, __ATOMIC_RELEASE );
+            }
+            /**
+             * @brief elementos publicados sin liberar, desde cualquier tarea
+             *
+             * Desde otra tarea es una estimación: tail se lee primero, así nunca da negativo.
+             *
+             * @return uint32_t 0 .. SIZE
+             */
+            uint32_t count( void ) {
+                uint32_t t = __atomic_load_n( &tail, __ATOMIC_ACQUIRE );
+                uint32_t n = __atomic_load_n( &head, __ATOMIC_ACQUIRE ) - t;
+
+                return( n > SIZE ? SIZE : n );
+            }
+
+        private:
+            T slot[ SIZE ];                 /** @brief elementos */
+            uint32_t head;                  /** @brief lugares confirmados por el productor */
+            uint32_t tail;                  /** @brief lugares liberados por el consumidor */
+    };
+
+#endif // _SPSC_RING_H
@@ -13,6 +13,7 @@
 #include "mqttclient.h"
 #include "webserver.h"
 #include "measure.h"
+#include "dsp/adccal.h"
 #include "wificlient.h"
 
 // Declaración del servidor web asíncrono y el socket web
@@ -149,6 +150,9 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
          */
         if (!strcmp("get_channel_list", cmd))
         {
+            // Canales del perfil, la página quita de sus listas los que sobran
+            client->printf("channel_count\\%d", VIRTUAL_CHANNELS);
+
             // Iterar sobre todos los canales virtuales
             for (int i = 0; i < VIRTUAL_CHANNELS; i++)
             {
@@ -172,13 +176,14 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
         }
         else if (!strcmp("get_channel_config", cmd))
         {
-            char tmp[64] = ""; // Buffer temporal para datos de configuración
+            char tmp[MEASURE_PROGRAM_MAX * 2 + 1] = ""; // Buffer temporal para datos de configuración
 
             // Validar el canal seleccionado
             if (selectedchannel >= VIRTUAL_CHANNELS)
             {
                 selectedchannel = 0; // Restablecer al canal 0 si es inválido
             }
+            client->printf("channel_count\\%d", VIRTUAL_CHANNELS);
 
             // Enviar la configuración básica del canal seleccionado
             client->printf("channel\\%d", selectedchannel);
@@ -186,12 +191,14 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
             client->printf("checkbox\\channel_true_rms\\%s", measure_get_channel_true_rms(selectedchannel) ? "true" : "false");
             client->printf("channel_report_exp\\%d", measure_get_channel_report_exp(selectedchannel));
             client->printf("channel_phaseshift\\%d", measure_get_channel_phaseshift(selectedchannel));
+            client->printf("channel_phase_correction\\%f", measure_get_channel_phase_correction(selectedchannel));
             client->printf("channel_opcodeseq_str\\%s", measure_get_channel_opcodeseq_str(selectedchannel, sizeof(tmp), tmp));
             client->printf("old_channel_opcodeseq_str\\%s", measure_get_channel_opcodeseq_str(selectedchannel, sizeof(tmp), tmp));
             client->printf("channel_offset\\%f", measure_get_channel_offset(selectedchannel));
             client->printf("channel_ratio\\%f", measure_get_channel_ratio(selectedchannel));
             client->printf("channel_name\\%s", measure_get_channel_name(selectedchannel));
             client->printf("channel_group_id\\%d", measure_get_channel_group_id(selectedchannel));
+            client->printf("channel_harmonics\\%s", measure_get_channel_harmonics_str(selectedchannel, sizeof(tmp), tmp));
 
             // Opciones de canales disponibles
             for (int i = 0; i < VIRTUAL_CHANNELS; i++)
@@ -255,12 +262,28 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
         else if (!strcmp("get_measurement_settings", cmd))
         {
             // Obtener valores de configuración de medición
+            char tmp[64] = "";                                         // Lista de armónicas de los fasores
             float networkFrequency = measure_get_network_frequency(); // Frecuencia de red
             int samplerateCorrection = measure_get_samplerate_corr(); // Corrección de muestreo
 
             // Enviar los valores al cliente
             client->printf("network_frequency\\%f", networkFrequency);   // Frecuencia de red
             client->printf("samplerate_corr\\%d", samplerateCorrection); // Corrección de la frecuencia de muestreo
+            client->printf("dsp_mode\\%d", measure_get_dsp_mode());         // Motor de procesamiento
+            client->printf("high_pass_coef\\%f", measure_get_high_pass_coef()); // Coeficiente del pasa alto
+            client->printf("window_mode\\%d", measure_get_window_mode());   // Ventana de medición
+            client->printf("sample_pll\\%d", measure_get_sample_pll());     // Lazo de la tasa de muestreo
+            client->printf("adc_skew_correction\\%d", measure_get_adc_skew_correction()); // Desfasaje del barrido del ADC
+            client->printf("adc_calibration\\%d", measure_get_adc_calibration());       // Origen de la corrección del ADC
+            client->printf("oversampling\\%d", measure_get_oversampling());             // Sobremuestreo del ADC
+            {
+                char points[ADCCAL_MAX_POINTS * 16] = ""; // Puntos del barrido de calibración del ADC
+                client->printf("adc_calibration_points\\%s", measure_get_adc_calibration_points_str(sizeof(points), points));
+            }
+            client->printf("analysis_period\\%d", measure_get_analysis_period()); // Período del análisis armónico
+            client->printf("iec_harmonics\\%d", measure_get_iec_harmonics());     // Grupos de IEC 61000-4-7
+            client->printf("iec_max_order\\%d", measure_get_iec_max_order());     // Orden más alto de los grupos
+            client->printf("phasor_harmonics\\%s", measure_get_phasor_harmonics_str(sizeof(tmp), tmp)); // Fasores ciclo a ciclo
         }
 
         else if (!strcmp("get_hostname_settings", cmd))
@@ -300,6 +323,7 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
             }
 
             // Enviar lista de uso de grupos y nombres de canales asociados
+            client->printf("channel_count\\%d", VIRTUAL_CHANNELS);
             for (int i = 0; i < VIRTUAL_CHANNELS; i++)
             {
                 const char *channelName = measure_get_channel_name(i); // Nombre del canal actual
@@ -330,8 +354,8 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
                  */
                 while (*group && channel_count < VIRTUAL_CHANNELS)
                 { // Limitar a los canales válidos
-                    if (*group >= '0' && *group <= '5')
-                    {                                                          // Validar que el carácter representa un ID de grupo válido (0-5)
+                    if (*group >= '0' && *group < '0' + MAX_GROUPS)
+                    {                                                          // Validar que el carácter representa un ID de grupo válido (0 .. MAX_GROUPS - 1)
                         int group_id = *group - '0';                           // Convertir el carácter a un entero (ID de grupo)
                         measure_set_channel_group_id(channel_count, group_id); // Asignar el grupo al canal actual
                     }
@@ -346,17 +370,19 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
         {
             if (value)
             { // Validar que la entrada no sea NULL
-                char request[numbersOfSamples * VIRTUAL_CHANNELS + numbersOfFFTSamples * VIRTUAL_CHANNELS + 96] = "";
+                // Peor caso: hasta cuatro canales sin reducir o todos reducidos, y el espectro de todos; 3 caracteres por valor.
+                static char request[(4 * numbersOfSamples + VIRTUAL_CHANNELS * numbersOfFFTSamples) * 3 + 96];
                 char tmp[64] = "";
-                uint16_t *mybuffer;
+                uint16_t spectrum[numbersOfFFTSamples];
+                size_t value_len = strlen(value);
                 int active_channel_count = 0;
                 int SampleScale = 4;
                 int FFTScale = 1;
 
-                // Contar canales activos
-                for (char *ptr = value; *ptr; ptr++)
+                // Contar canales activos; la lista del cliente puede ser más corta o más larga que los canales del perfil
+                for (int channel = 0; channel < VIRTUAL_CHANNELS && channel < (int)value_len; channel++)
                 {
-                    if (*ptr == '1')
+                    if (value[channel] == '1')
                         active_channel_count++;
                 }
 
@@ -367,68 +393,95 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
                     SampleScale = 1;
 
                 // Construir datos iniciales
-                snprintf(tmp, sizeof(tmp), "OScopeProbe\\%d\\%d\\%d\\%f\\",
+                snprintf(request, sizeof(request), "OScopeProbe\\%d\\%d\\%d\\%f\\",
                          active_channel_count,
                          numbersOfSamples / SampleScale,
                          numbersOfFFTSamples / FFTScale,
                          0.01);
-                strncat(request, tmp, sizeof(request));
 
-                // Procesar muestras
-                mybuffer = measure_get_buffer();
-                for (int channel = 0; channel < VIRTUAL_CHANNELS; channel++)
+                // Procesar muestras del último bloque publicado, sin esperar a la tarea de medición
+                const uint16_t *samplebuffer = measure_acquire_buffer(NULL);
+                for (int channel = 0; channel < VIRTUAL_CHANNELS && channel < (int)value_len; channel++)
                 {
-                    if (*(value + channel) == '0')
+                    if (value[channel] != '1')
                         continue;
 
                     for (int i = 0; i < numbersOfSamples; i += SampleScale)
                     {
-                        snprintf(tmp, sizeof(tmp), "%03x",
-                                 mybuffer[numbersOfSamples * channel + i] > 0x0fff ? 0x0fff : mybuffer[numbersOfSamples * channel + i]);
-                        strncat(request, tmp, sizeof(request));
+                        uint16_t sample = samplebuffer ? samplebuffer[numbersOfSamples * channel + i] : 0;
+                        snprintf(tmp, sizeof(tmp), "%03x", sample > 0x0fff ? 0x0fff : sample);
+                        strlcat(request, tmp, sizeof(request));
                     }
                 }
-                strncat(request, "\\", sizeof(request));
-
-                // Obtener datos FFT y construir el bloque de datos solo para los canales seleccionados
-                mybuffer = measure_get_fft();
-
-                // Canales específicos que queremos procesar
-                int selectedChannels[] = {0, 1, 4, 5, 8, 9};
-                size_t numSelectedChannels = sizeof(selectedChannels) / sizeof(selectedChannels[0]);
+                if (samplebuffer)
+                    measure_release_buffer(samplebuffer);
+                strlcat(request, "\\", sizeof(request));
 
-                for (size_t idx = 0; idx < numSelectedChannels; idx++)
+                // Espectro del último análisis publicado de los canales que lo tienen, en orden de canal
+                char spectrumChannelsBinary[VIRTUAL_CHANNELS + 1] = {0};
+                for (int channel = 0; channel < VIRTUAL_CHANNELS; channel++)
                 {
-                    int channel = selectedChannels[idx];
+                    spectrumChannelsBinary[channel] = measure_get_spectrum_channel(channel) ? '1' : '0';
+                    if (!measure_get_spectrum_channel(channel))
+                        continue;
+                    if (!measure_get_spectrum(channel, spectrum))
+                        memset(spectrum, 0, sizeof(spectrum));
 
-                    // Procesar únicamente los canales seleccionados
                     for (int i = 0; i < numbersOfFFTSamples; i += FFTScale)
                     {
-                        snprintf(tmp, sizeof(tmp), "%03x",
-                                 mybuffer[numbersOfFFTSamples * channel + i] > 0x0fff ? 0x0fff : mybuffer[numbersOfFFTSamples * channel + i]);
-                        strncat(request, tmp, sizeof(request));
+                        snprintf(tmp, sizeof(tmp), "%03x", spectrum[i] > 0x0fff ? 0x0fff : spectrum[i]);
+                        strlcat(request, tmp, sizeof(request));
                     }
                 }
-                strncat(request, "\\", sizeof(request));
+                strlcat(request, "\\", sizeof(request));
 
-                // Convertir canales activos a hexadecimal
+                // Convertir canales activos a hexadecimal, el canal 0 es el bit más alto
                 char activeChannelsBinary[VIRTUAL_CHANNELS + 1] = {0};
                 for (int channel = 0; channel < VIRTUAL_CHANNELS; channel++)
                 {
-                    activeChannelsBinary[channel] = (*(value + channel) == '0') ? '0' : '1';
+                    activeChannelsBinary[channel] = (channel < (int)value_len && value[channel] == '1') ? '1' : '0';
                 }
                 char hexChannels[8];
-                snprintf(hexChannels, sizeof(hexChannels), "%03X", strtol(activeChannelsBinary, NULL, 2));
-                strncat(request, hexChannels, sizeof(request));
+                snprintf(hexChannels, sizeof(hexChannels), "%03lX", strtol(activeChannelsBinary, NULL, 2));
+                strlcat(request, hexChannels, sizeof(request));
+
+                // Canales del espectro, con la misma codificación
+                snprintf(hexChannels, sizeof(hexChannels), "\\%03lX", strtol(spectrumChannelsBinary, NULL, 2));
+                strlcat(request, hexChannels, sizeof(request));
 
                 // Enviar respuesta
                 client->text(request);
             }
         }
+        /* Obtener los grupos de IEC 61000-4-7 de un canal: ciclos, THDG, grupos armónicos e interarmónicos */
+        else if (!strcmp("IEC", cmd) && value)
+        {
+            measure_iec_groups_t groups;
+            char request[1536] = "iec_groups\\";
+            char tmp[24] = "";
+
+            if (measure_get_iec_groups(atoi(value), &groups))
+            {
+                snprintf(tmp, sizeof(tmp), "%d\\%.2f\\", groups.cycles, groups.thd);
+                strlcat(request, tmp, sizeof(request));
+                for (int h = 0; h <= groups.max_order; h++)
+                {
+                    snprintf(tmp, sizeof(tmp), "%s%.4g", h ? "," : "", groups.harmonic[h]);
+                    strlcat(request, tmp, sizeof(request));
+                }
+                strlcat(request, "\\", sizeof(request));
+                for (int h = 0; h < groups.max_order; h++)
+                {
+                    snprintf(tmp, sizeof(tmp), "%s%.4g", h ? "," : "", groups.interharmonic[h]);
+                    strlcat(request, tmp, sizeof(request));
+                }
+            }
+            client->text(request);
+        }
         /* Obtener la línea de estado (STS) */
         else if (!strcmp("STS", cmd))
         {
-            char request[1024] = ""; // Buffer para construir la respuesta final
+            char request[1536] = ""; // Buffer para construir la respuesta final
             char tmp[128] = "";      // Buffer temporal para datos intermedios
 
             // Iniciar la respuesta con el estado general
@@ -437,9 +490,7 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
             // Iterar sobre los grupos para incluir su estado
             for (int group_id = 0; group_id < MAX_GROUPS; group_id++)
             {
-                int power_channel = -1;          // Canal de potencia activa
-                int reactive_power_channel = -1; // Canal de potencia reactiva
-                float cos_phi = 1.0f;            // Factor de potencia inicializado
+                measure_group_power_t power; // Potencias del grupo calculadas por la medición
 
                 // Verificar si el grupo está activo
                 if (!measure_get_group_active(group_id))
@@ -459,25 +510,9 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
                     if (measure_get_channel_group_id(channel) != group_id)
                         continue;
 
-                    // Identificar los canales de potencia activa y reactiva
-                    if (measure_get_channel_type(channel) == AC_POWER)
-                    {
-                        power_channel = channel;
-                    }
-                    if (measure_get_channel_type(channel) == AC_REACTIVE_POWER)
-                    {
-                        reactive_power_channel = channel;
-                    }
-
-                    // Calcular el factor de potencia si ambos canales están disponibles
-                    if (power_channel != -1 && reactive_power_channel != -1)
-                    {
-                        float active_power = measure_get_channel_rms(power_channel) +
-                                             measure_get_channel_rms(reactive_power_channel);
-                        cos_phi = active_power / measure_get_channel_rms(power_channel);
-                    }
-
                     // Construir información específica del canal
+                    HarmonicData harmonics;
+                    measure_get_harmonics(channel, &harmonics);
                     tmp[0] = '\0'; // Limpiar el buffer temporal
                     switch (measure_get_channel_type(channel))
                     {
@@ -486,11 +521,11 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
                         snprintf(tmp, sizeof(tmp),
                                  " U=%.1f%s | U3=%.1f%s | U5=%.1f%s | U7=%.1f%s | U9=%.1f%s | THDV=%.1f%s |",
                                  measure_get_channel_rms(channel), measure_get_channel_report_unit(channel),
-                                 harmonic_values[channel].thirdHarmonic, measure_get_channel_report_unit(channel),
-                                 harmonic_values[channel].fifthHarmonic, measure_get_channel_report_unit(channel),
-                                 harmonic_values[channel].seventhHarmonic, measure_get_channel_report_unit(channel),
-                                 harmonic_values[channel].ninthHarmonic, measure_get_channel_report_unit(channel),
-                                 harmonic_values[channel].thd, harmonic_values[channel].porcentaje);
+                                 harmonics.thirdHarmonic, measure_get_channel_report_unit(channel),
+                                 harmonics.fifthHarmonic, measure_get_channel_report_unit(channel),
+                                 harmonics.seventhHarmonic, measure_get_channel_report_unit(channel),
+                                 harmonics.ninthHarmonic, measure_get_channel_report_unit(channel),
+                                 harmonics.thd, harmonics.porcentaje);
                         break;
 
                     case AC_CURRENT:
@@ -498,11 +533,11 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
                         snprintf(tmp, sizeof(tmp),
                                  " I=%.2f%s | I3=%.2f%s | I5=%.2f%s | I7=%.2f%s | I9=%.2f%s | THDI=%.1f%s |",
                                  measure_get_channel_rms(channel), measure_get_channel_report_unit(channel),
-                                 harmonic_values[channel].thirdHarmonic, measure_get_channel_report_unit(channel),
-                                 harmonic_values[channel].fifthHarmonic, measure_get_channel_report_unit(channel),
-                                 harmonic_values[channel].seventhHarmonic, measure_get_channel_report_unit(channel),
-                                 harmonic_values[channel].ninthHarmonic, measure_get_channel_report_unit(channel),
-                                 harmonic_values[channel].thd, harmonic_values[channel].porcentaje);
+                                 harmonics.thirdHarmonic, measure_get_channel_report_unit(channel),
+                                 harmonics.fifthHarmonic, measure_get_channel_report_unit(channel),
+                                 harmonics.seventhHarmonic, measure_get_channel_report_unit(channel),
+                                 harmonics.ninthHarmonic, measure_get_channel_report_unit(channel),
+                                 harmonics.thd, harmonics.porcentaje);
                         break;
 
                     case AC_POWER:
@@ -522,10 +557,18 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
                     strncat(request, tmp, sizeof(request)); // Agregar información al buffer principal
                 }
 
-                // Agregar el factor de potencia (cos_phi) si se calcula
-                if (power_channel != -1 && reactive_power_channel != -1)
+                // Agregar la potencia aparente y el factor de potencia si el grupo tiene tensión y corriente
+                if (measure_get_group_power(group_id, &power))
                 {
-                    snprintf(tmp, sizeof(tmp), " Cos=%.2f ", cos_phi);
+                    snprintf(tmp, sizeof(tmp), " S=%.2fVA | Cos=%.2f ", power.apparent, power.power_factor);
+                    strncat(request, tmp, sizeof(request));
+                }
+
+                // Energías acumuladas del grupo
+                measure_group_energy_t energy;
+                if (measure_get_group_energy(group_id, &energy))
+                {
+                    snprintf(tmp, sizeof(tmp), "| Ei=%.3fkWh | Ee=%.3fkWh | Eqi=%.3fkvarh | Eqe=%.3fkvarh | Es=%.3fkVAh ", energy.active_import, energy.active_export, energy.reactive_import, energy.reactive_export, energy.apparent);
                     strncat(request, tmp, sizeof(request));
                 }
 
@@ -540,10 +583,36 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
                 {
                     snprintf(tmp, sizeof(tmp), " ; f = %.1f Hz ", measure_get_max_freq());
                     strncat(request, tmp, sizeof(request));
+
+                    // Estado del lazo de la tasa de muestreo, si está habilitado
+                    if (measure_get_pll_state() != MEASURE_PLL_OFF)
+                    {
+                        snprintf(tmp, sizeof(tmp), "; pll = %s %+.3f Hz ",
+                                 measure_get_pll_state() == MEASURE_PLL_LOCKED ? "enganchado" : "ajustando",
+                                 measure_get_pll_error());
+                        strncat(request, tmp, sizeof(request));
+                    }
                     break;
                 }
             }
 
+            // Costo de la adquisición por bloque
+            {
+                measure_acquisition_stats_t stats;
+                measure_get_acquisition_stats(&stats);
+                snprintf(tmp, sizeof(tmp), "; adq = %u us, cola %u, perdidos %u ", (unsigned)stats.demux_us, (unsigned)stats.queued_max, (unsigned)stats.lost);
+                strncat(request, tmp, sizeof(request));
+            }
+
+            // Costo del análisis de IEC 61000-4-7 por ventana, si está habilitado
+            if (measure_get_iec_harmonics())
+            {
+                measure_iec_stats_t stats;
+                measure_get_iec_stats(&stats);
+                snprintf(tmp, sizeof(tmp), "; iec = %u us / %u ms ", (unsigned)stats.last_us, (unsigned)(stats.window_us / 1000));
+                strncat(request, tmp, sizeof(request));
+            }
+
             // Finalizar la respuesta y enviarla al cliente
             strncat(request, " )", sizeof(request));
             client->printf(request);
@@ -656,6 +725,67 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
                 // Establecer la frecuencia de red (en Hz)
                 measure_set_network_frequency(atof(value));
             }
+            else if (!strcmp("dsp_mode", cmd))
+            {
+                // Seleccionar el motor de procesamiento (muestras o bloques)
+                measure_set_dsp_mode((measure_dsp_mode_t)atoi(value));
+            }
+            else if (!strcmp("high_pass_coef", cmd))
+            {
+                // Coeficiente del filtro pasa alto del opcode FILTER
+                measure_set_high_pass_coef(atof(value));
+            }
+            else if (!strcmp("window_mode", cmd))
+            {
+                // Ventana de medición: 1 segundo o ciclos de red entre cruces por cero
+                measure_set_window_mode((measure_window_mode_t)atoi(value));
+            }
+            else if (!strcmp("sample_pll", cmd))
+            {
+                // Lazo que ajusta la tasa de muestreo a la frecuencia de red medida
+                measure_set_sample_pll(atoi(value) ? true : false);
+            }
+            else if (!strcmp("adc_skew_correction", cmd))
+            {
+                // Compensación del desfasaje entre canales del barrido del ADC
+                measure_set_adc_skew_correction(atoi(value) ? true : false);
+            }
+            else if (!strcmp("analysis_period", cmd))
+            {
+                // Período del análisis armónico en ms
+                measure_set_analysis_period(atoi(value));
+            }
+            else if (!strcmp("iec_harmonics", cmd))
+            {
+                // Grupos armónicos e interarmónicos de IEC 61000-4-7
+                measure_set_iec_harmonics(atoi(value) ? true : false);
+            }
+            else if (!strcmp("iec_max_order", cmd))
+            {
+                // Orden más alto de los grupos, 40 o 50 según la norma
+                measure_set_iec_max_order(atoi(value));
+            }
+            else if (!strcmp("phasor_harmonics", cmd))
+            {
+                // Armónicas cuyos fasores se siguen ciclo a ciclo, lista separada por comas
+                measure_set_phasor_harmonics_str(value);
+            }
+            else if (!strcmp("oversampling", cmd))
+            {
+                // Factor de sobremuestreo del ADC, se aplica al reiniciar
+                measure_set_oversampling(atoi(value));
+            }
+            else if (!strcmp("adc_calibration", cmd))
+            {
+                // Origen de la tabla de corrección del ADC: ninguno, eFuse o barrido
+                measure_set_adc_calibration((measure_adc_calibration_t)atoi(value));
+            }
+            else if (!strcmp("adc_calibration_points", cmd))
+            {
+                // Puntos del barrido de calibración del ADC, pares crudo:ideal
+                if (!measure_set_adc_calibration_points_str(value))
+                    client->printf("status\\puntos de calibración del ADC inválidos");
+            }
             else if (!strcmp("FQ+", cmd))
             {
                 // Incrementar la frecuencia de muestreo en 1 Hz
@@ -698,6 +828,11 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
                 // Establecer el desfasaje de fase del canal
                 measure_set_channel_phaseshift(selectedchannel, atoi(value));
             }
+            else if (!strcmp("channel_phase_correction", cmd))
+            {
+                // Establecer la corrección fina de fase del canal en grados
+                measure_set_channel_phase_correction(selectedchannel, atof(value));
+            }
             else if (!strcmp("channel_true_rms", cmd))
             {
                 // Establecer si el canal reporta valores RMS verdaderos
@@ -705,8 +840,14 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
             }
             else if (!strcmp("channel_opcodeseq_str", cmd))
             {
-                // Establecer la secuencia de operación del canal
-                measure_set_channel_opcodeseq_str(selectedchannel, value);
+                // Establecer la secuencia de operación del canal; si se rechaza se avisa y se reenvía la vigente
+                char error[64] = "";
+                char tmp[MEASURE_PROGRAM_MAX * 2 + 1] = "";
+                if (!measure_set_channel_opcodeseq_str(selectedchannel, value, error, sizeof(error)))
+                {
+                    client->printf("status\\%s", error);
+                    client->printf("channel_opcodeseq_str\\%s", measure_get_channel_opcodeseq_str(selectedchannel, sizeof(tmp), tmp));
+                }
             }
             else if (!strcmp("channel_offset", cmd))
             {
@@ -728,6 +869,11 @@ static void onWsEvent(AsyncWebSocket *server, AsyncWebSocketClient *client, AwsE
                 // Asignar el canal a un grupo
                 measure_set_channel_group_id(selectedchannel, atoi(value));
             }
+            else if (!strcmp("channel_harmonics", cmd))
+            {
+                // Armónicas a evaluar en el canal, lista separada por comas
+                measure_set_channel_harmonics_str(selectedchannel, value);
+            }
 
             /* Configuraciones de grupos */
             else if (!strcmp("group_name", cmd))
@@ -0,0 +1,116 @@
+/**
+ * @file test_main.cpp
+ * @brief Ciclos de CPU del ESP32 por transformada de fft_real() y de arduinoFFT 1.5.6
+ *
+ * Corre en la placa: pio test -e esp32dev_bench. Mide con ESP.getCycleCount() el mejor de varios
+ * intentos de cada FFT a 64, 128 (el espectro del osciloscopio) y 2048 puntos, con las
+ * interrupciones activas como en la medición, y lo reporta en ciclos y microsegundos a
+ * F_CPU. El ESP32 sólo tiene FPU de simple precisión, así que la diferencia con el host
+ * (test/native/test_fft_arduinofft) es la que decide.
+ */
+#include <Arduino.h>
+#include <unity.h>
+#include <arduinoFFT.h>
+#include "dsp/fft.h"
+
+#define BENCH_REPEAT 10 // Intentos por transformada, se queda el mejor
+
+static float x[FFT_MAX_LEN];
+static double re[FFT_MAX_LEN];
+static double im[FFT_MAX_LEN];
+
+/**
+ * @brief Llena las dos entradas con la misma señal, fundamental y armónicas.
+ */
+static void fill(int len)
+{
+    for (int n = 0; n < len; n++)
+    {
+        double phase = 2.0 * M_PI * 3 * n / len;
+        x[n] = 1500.0 * sin(phase) + 240.0 * sin(3 * phase) + 90.0 * sin(5 * phase);
+        re[n] = x[n];
+        im[n] = 0.0;
+    }
+}
+
+/**
+ * @brief Mejor cantidad de ciclos de fft_real() y fft_magnitude() de len puntos.
+ */
+static uint32_t bench_fft_real(int len)
+{
+    static uint16_t magnitude[FFT_MAX_LEN / 2 + 1];
+    uint32_t best = UINT32_MAX;
+
+    for (int repeat = 0; repeat < BENCH_REPEAT; repeat++)
+    {
+        fill(len);
+        uint32_t start = ESP.getCycleCount();
+        fft_real(x, len);
+        fft_magnitude(x, len, magnitude, len / 2, 1.0 / len);
+        uint32_t cycles = ESP.getCycleCount() - start;
+        if (cycles < best)
+            best = cycles;
+    }
+    return (best);
+}
+
+/**
+ * @brief Mejor cantidad de ciclos de arduinoFFT de len puntos, con las llamadas de measure_update_spectrum().
+ */
+static uint32_t bench_arduinofft(int len)
+{
+    uint32_t best = UINT32_MAX;
+
+    for (int repeat = 0; repeat < BENCH_REPEAT; repeat++)
+    {
+        fill(len);
+        uint32_t start = ESP.getCycleCount();
+        arduinoFFT FFT(re, im, len, 1.0);
+        FFT.Windowing(FFT_WIN_TYP_RECTANGLE, FFT_REVERSE);
+        FFT.Compute(FFT_REVERSE);
+        FFT.ComplexToMagnitude();
+        uint32_t cycles = ESP.getCycleCount() - start;
+        if (cycles < best)
+            best = cycles;
+    }
+    return (best);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_fft_cycles(void)
+{
+    static const int lens[] = {64, 128, 2048};
+
+    for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++)
+    {
+        int len = lens[l];
+        uint32_t float_cycles = bench_fft_real(len);
+        uint32_t double_cycles = bench_arduinofft(len);
+        char report[160];
+
+        snprintf(report, sizeof(report), "%d puntos: arduinoFFT %u ciclos (%.1f us), fft_real %u ciclos (%.1f us), %.2fx",
+                 len, double_cycles, double_cycles * 1e6 / F_CPU, float_cycles, float_cycles * 1e6 / F_CPU, (double)double_cycles / float_cycles);
+        TEST_MESSAGE(report);
+        TEST_ASSERT_LESS_THAN_UINT32(double_cycles, float_cycles);
+    }
+}
+
+void setup()
+{
+    // Espera al monitor serie antes de empezar a reportar.
+    delay(2000);
+    UNITY_BEGIN();
+    RUN_TEST(test_fft_cycles);
+    UNITY_END();
+}
+
+void loop()
+{
+}
@@ -0,0 +1,64 @@
+/**
+ * @file Arduino.h
+ * @brief Lo mínimo del core de Arduino que usan measure.cpp y sus dependencias, para el entorno native
+ */
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+
+#ifndef PI
+    #define PI 3.1415926535897932384626433832795
+#endif
+#ifndef sq
+    #define sq(x) ((x) * (x))
+#endif
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// Los mensajes de error y aviso quedan en stderr, los de información y depuración se descartan.
+#define log_e(format, ...) fprintf(stderr, "[E] " format "\n", ##__VA_ARGS__)
+#define log_w(format, ...) fprintf(stderr, "[W] " format "\n", ##__VA_ARGS__)
+#define log_i(format, ...) do {} while (0)
+#define log_d(format, ...) do {} while (0)
+
+#define IRAM_ATTR
+#ifndef RTC_NOINIT_ATTR
+    #define RTC_NOINIT_ATTR
+#endif
+
+unsigned long millis(void);
+unsigned long micros(void);
+
+inline size_t strlcpy(char *dest, const char *src, size_t len)
+{
+    size_t count = strlen(src);
+
+    if (len)
+    {
+        size_t copy = (count < len - 1) ? count : len - 1;
+        memcpy(dest, src, copy);
+        dest[copy] = '\0';
+    }
+    return (count);
+}
+
+inline size_t strlcat(char *dest, const char *src, size_t len)
+{
+    size_t count = strlen(dest);
+
+    return (count + strlcpy(dest + count, src, (len > count) ? len - count : 0));
+}
+
+class String
+{
+public:
+    String(const char *value = "") : text(value) {}
+    const char *c_str(void) const { return (text.c_str()); }
+
+private:
+    std::string text;
+};
@@ -0,0 +1,58 @@
+/**
+ * @file ArduinoJson.h
+ * @brief Documento JSON mínimo para compilar measure_config.cpp en el entorno native
+ *
+ * Sólo guarda números en claves del primer nivel, lo que hace falta para que una prueba cargue
+ * valores con onLoad(). Toda otra lectura devuelve el valor por defecto y toda otra escritura se
+ * descarta; las pruebas no guardan la configuración.
+ */
+#pragma once
+#include <map>
+#include <string>
+#include <type_traits>
+#include "Arduino.h"
+
+class JsonVariant
+{
+public:
+    JsonVariant(void) : values(NULL) {}
+    JsonVariant(std::map<std::string, double> *values, const char *key) : values(values), key(key) {}
+    template <class T> T operator|(T value) const { return (found() ? (T)(*values)[key] : value); }
+    const char *operator|(const char *value) const { return (value); }
+    JsonVariant operator[](int) const { return (JsonVariant()); }
+    JsonVariant operator[](const char *) const { return (JsonVariant()); }
+    template <class T> typename std::enable_if<std::is_arithmetic<T>::value, JsonVariant &>::type operator=(const T &value)
+    {
+        if (values)
+            (*values)[key] = value;
+        return (*this);
+    }
+    template <class T> typename std::enable_if<!std::is_arithmetic<T>::value, JsonVariant &>::type operator=(const T &) { return (*this); }
+    template <class T> T as(void) const { return (T()); }
+    template <class T, typename std::enable_if<std::is_arithmetic<T>::value, int>::type = 0> operator T() const { return (found() ? (T)(*values)[key] : T()); }
+    template <class T, typename std::enable_if<!std::is_arithmetic<T>::value, int>::type = 0> operator T() const { return (T()); }
+    bool operator!() const { return (!found()); }
+
+private:
+    bool found(void) const { return (values && values->count(key)); }
+    std::map<std::string, double> *values;
+    std::string key;
+};
+
+class JsonDocument
+{
+public:
+    JsonVariant operator[](const char *key) { return (JsonVariant(&values, key)); }
+    void clear(void) { values.clear(); }
+
+private:
+    std::map<std::string, double> values;
+};
+
+template <size_t N> class StaticJsonDocument : public JsonDocument {};
+
+class DynamicJsonDocument : public JsonDocument
+{
+public:
+    DynamicJsonDocument(size_t) {}
+};
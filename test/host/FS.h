@@ -0,0 +1,46 @@
+/**
+ * @file FS.h
+ * @brief Sistema de archivos de Arduino sobre un directorio temporal del host
+ */
+#pragma once
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <unistd.h>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+
+namespace fs
+{
+    class File
+    {
+    public:
+        File(FILE *stream = NULL) : stream(stream) {}
+        operator bool() const { return (stream != NULL); }
+        size_t read(uint8_t *buf, size_t size) { return (fread(buf, 1, size, stream)); }
+        size_t write(const uint8_t *buf, size_t size) { return (fwrite(buf, 1, size, stream)); }
+        void close(void)
+        {
+            if (stream)
+                fclose(stream);
+            stream = NULL;
+        }
+
+    private:
+        FILE *stream;
+    };
+
+    class FS
+    {
+    public:
+        bool begin(void) { return (true); }
+        bool exists(const char *path) { return (access(resolve(path).c_str(), F_OK) == 0); }
+        File open(const char *path, const char *mode) { return (File(fopen(resolve(path).c_str(), mode))); }
+        bool remove(const char *path) { return (unlink(resolve(path).c_str()) == 0); }
+        std::string root; /** @brief directorio del host donde quedan los archivos */
+
+    private:
+        std::string resolve(const char *path) { return (root + path); }
+    };
+}
@@ -0,0 +1,21 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Tareas y notificaciones de FreeRTOS para el entorno native, sin planificador
+ */
+#pragma once
+#include "Arduino.h"
+
+typedef void *TaskHandle_t;
+typedef int BaseType_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define pdTRUE 1
+#define pdPASS 1
+#define portTICK_PERIOD_MS 1
+#define portMAX_DELAY 0xffffffff
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stack, void *parameters, int priority, TaskHandle_t *handle, int core);
+void vTaskDelay(uint32_t ticks);
+int xPortGetCoreID(void);
+uint32_t ulTaskNotifyTake(BaseType_t clear, uint32_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
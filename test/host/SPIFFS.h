@@ -0,0 +1,8 @@
+/**
+ * @file SPIFFS.h
+ * @brief SPIFFS del host, lo define measure_host.h
+ */
+#pragma once
+#include "FS.h"
+
+extern fs::FS SPIFFS;
@@ -0,0 +1,6 @@
+/**
+ * @file WProgram.h
+ * @brief arduinoFFT lo incluye cuando no compila para Arduino
+ */
+#pragma once
+#include "Arduino.h"
@@ -0,0 +1,40 @@
+/**
+ * @file i2s.h
+ * @brief Driver I2S del ESP-IDF con el ADC integrado, lo simula measure_host.h
+ */
+#pragma once
+#include "Arduino.h"
+
+typedef int esp_err_t;
+#define ESP_OK 0
+
+typedef enum { I2S_NUM_0 = 0 } i2s_port_t;
+typedef enum { I2S_MODE_MASTER = 1, I2S_MODE_RX = 4, I2S_MODE_ADC_BUILT_IN = 32 } i2s_mode_t;
+typedef enum { I2S_BITS_PER_SAMPLE_16BIT = 16 } i2s_bits_per_sample_t;
+typedef enum { I2S_CHANNEL_FMT_ONLY_RIGHT = 3 } i2s_channel_fmt_t;
+typedef enum { I2S_COMM_FORMAT_I2S_MSB = 3 } i2s_comm_format_t;
+typedef enum { ADC_UNIT_1 = 1 } adc_unit_t;
+typedef enum { ADC1_CHANNEL_0 = 0 } adc1_channel_t;
+#define ESP_INTR_FLAG_LEVEL1 2
+
+typedef struct
+{
+    i2s_mode_t mode;
+    int sample_rate;
+    i2s_bits_per_sample_t bits_per_sample;
+    i2s_channel_fmt_t channel_format;
+    i2s_comm_format_t communication_format;
+    int intr_alloc_flags;
+    int dma_buf_count;
+    int dma_buf_len;
+    bool use_apll;
+    bool tx_desc_auto_clear;
+    int fixed_mclk;
+} i2s_config_t;
+
+esp_err_t i2s_driver_install(i2s_port_t port, const i2s_config_t *config, int queue_size, void *queue);
+esp_err_t i2s_set_adc_mode(adc_unit_t unit, adc1_channel_t channel);
+esp_err_t i2s_stop(i2s_port_t port);
+esp_err_t i2s_start(i2s_port_t port);
+esp_err_t i2s_read(i2s_port_t port, void *dest, size_t size, size_t *bytes_read, uint32_t ticks);
+esp_err_t i2s_set_sample_rates(i2s_port_t port, uint32_t rate);
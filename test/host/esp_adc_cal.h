@@ -0,0 +1,18 @@
+/**
+ * @file esp_adc_cal.h
+ * @brief Caracterización del ADC del ESP-IDF sobre la transferencia simulada de measure_host.h
+ */
+#pragma once
+#include <stdint.h>
+#include "driver/i2s.h"
+
+typedef enum { ADC_ATTEN_DB_11 = 3 } adc_atten_t;
+typedef enum { ADC_WIDTH_BIT_12 = 3 } adc_bits_width_t;
+typedef int esp_adc_cal_value_t;
+typedef struct
+{
+    uint32_t vref;
+} esp_adc_cal_characteristics_t;
+
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t unit, adc_atten_t atten, adc_bits_width_t width, uint32_t vref, esp_adc_cal_characteristics_t *characteristics);
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t raw, const esp_adc_cal_characteristics_t *characteristics);
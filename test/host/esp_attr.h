@@ -0,0 +1,8 @@
+/**
+ * @file esp_attr.h
+ * @brief Atributos de sección del ESP-IDF, sin efecto en el host
+ */
+#pragma once
+#ifndef RTC_NOINIT_ATTR
+    #define RTC_NOINIT_ATTR
+#endif
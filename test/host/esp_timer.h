@@ -0,0 +1,8 @@
+/**
+ * @file esp_timer.h
+ * @brief Reloj de microsegundos del ESP-IDF, avanza con las muestras simuladas
+ */
+#pragma once
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
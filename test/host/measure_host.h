@@ -0,0 +1,259 @@
+/**
+ * @file measure_host.h
+ * @brief Plataforma simulada para probar measure.cpp en el entorno native
+ *
+ * Incluye measure.cpp y measure_config.cpp enteros, así las pruebas llegan a su estado estático, y
+ * define lo que en el ESP32 ponen el core de Arduino, FreeRTOS y el driver I2S. No hay tareas: cada
+ * vez que la medición espera un bloque, ulTaskNotifyTake() hace una adquisición en el mismo hilo, así
+ * que las pruebas son deterministas. El I2S genera las palabras del ADC a partir de host_signal, a la
+ * tasa y con el patrón de canales que programa measure.cpp, y el reloj avanza con las muestras leídas.
+ *
+ * Se incluye desde un solo archivo de cada prueba.
+ */
+#pragma once
+#include <stdlib.h>
+#include <string>
+
+#include "measure.cpp"
+#include "config/measure_config.cpp"
+
+/**
+ * @brief señal en los pines del ADC
+ *
+ * Cada canal virtual del ADC recibe 2048 + amplitude * sin( fase + phase ) más la tercera armónica y
+ * el ruido, en cuentas ideales, y curve las lleva a las cuentas que entrega el ADC.
+ */
+typedef struct
+{
+    double frequency;                                   /** @brief fundamental en Hz */
+    double drift;                                       /** @brief variación de la fundamental en Hz/s */
+    double amplitude[VIRTUAL_ADC_CHANNELS];             /** @brief amplitud por canal virtual del ADC, en cuentas */
+    double phase[VIRTUAL_ADC_CHANNELS];                 /** @brief fase por canal virtual del ADC, en radianes */
+    double third;                                       /** @brief amplitud de la tercera armónica en todos los canales, en cuentas */
+    double noise;                                       /** @brief ruido uniforme pico a pico, en cuentas */
+    double clock_error;                                 /** @brief error del reloj del ADC en ppm */
+    double (*curve)(double ideal);                      /** @brief transferencia del ADC, de cuentas ideales a crudas; NULL es lineal */
+} host_signal_t;
+
+static host_signal_t host_signal = {50.0, 0.0, {0}, {0}, 0.0, 0.0, 0.0, NULL};
+
+static double host_time_us = 0.0;      // Reloj simulado
+static double host_rate = 0.0;         // Tasa del I2S en palabras por segundo
+static double host_phase = 0.0;        // Fase de la fundamental en radianes
+static double host_elapsed = 0.0;      // Segundos de señal generados, para drift
+static uint32_t host_lcg = 12345;      // Estado del generador de ruido
+static uint64_t host_words = 0;        // Palabras generadas
+static void (*host_on_block)(void) = NULL; // Se llama cada vez que la medición termina un bloque y espera el siguiente
+static void (*host_on_load)(void) = NULL;  // Se llama al cargar una configuración, sobre los valores por defecto, como si vinieran del archivo
+static JsonDocument host_document;         // Valores del archivo de configuración; vacío carga sólo los valores por defecto
+
+fs::FS SPIFFS;
+syscon_dev_t SYSCON;
+
+unsigned long millis(void)
+{
+    return ((unsigned long)(host_time_us / 1000.0));
+}
+
+unsigned long micros(void)
+{
+    return ((unsigned long)host_time_us);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return ((int64_t)host_time_us);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stack, void *parameters, int priority, TaskHandle_t *handle, int core)
+{
+    return (pdPASS);
+}
+
+void vTaskDelay(uint32_t ticks)
+{
+}
+
+int xPortGetCoreID(void)
+{
+    return (0);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, uint32_t ticks)
+{
+    // La tarea de medición terminó un bloque y espera otro: lo adquiere ella misma.
+    if (host_on_block)
+        host_on_block();
+    measure_acquire();
+    return (1);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    return (pdPASS);
+}
+
+esp_err_t i2s_driver_install(i2s_port_t port, const i2s_config_t *config, int queue_size, void *queue)
+{
+    host_rate = config->sample_rate;
+    return (ESP_OK);
+}
+
+esp_err_t i2s_set_adc_mode(adc_unit_t unit, adc1_channel_t channel)
+{
+    return (ESP_OK);
+}
+
+esp_err_t i2s_stop(i2s_port_t port)
+{
+    return (ESP_OK);
+}
+
+esp_err_t i2s_start(i2s_port_t port)
+{
+    return (ESP_OK);
+}
+
+esp_err_t i2s_set_sample_rates(i2s_port_t port, uint32_t rate)
+{
+    host_rate = rate;
+    return (ESP_OK);
+}
+
+/**
+ * @brief Ruido uniforme en [-0.5, 0.5), reproducible.
+ */
+static double host_noise(void)
+{
+    host_lcg = host_lcg * 1103515245u + 12345u;
+    return (((host_lcg >> 16) & 0x7fff) / 32768.0 - 0.5);
+}
+
+esp_err_t i2s_read(i2s_port_t port, void *dest, size_t size, size_t *bytes_read, uint32_t ticks)
+{
+    uint16_t *word = (uint16_t *)dest;
+    double rate = host_rate * (1.0 + host_signal.clock_error * 1e-6);
+    int slots = SYSCON.saradc_ctrl.sar1_patt_len + 1;
+
+    for (size_t i = 0; i < size / sizeof(uint16_t); i++, host_words++)
+    {
+        // Canal físico del lugar del patrón que programó measure_i2s_init(), cuatro lugares por registro.
+        int slot = host_words % slots;
+        int pin = (SYSCON.saradc_sar1_patt_tab[slot / 4] >> (28 - 8 * (slot % 4))) & 0x0f;
+        int channel = channelmapping[pin];
+        double value = 2048.0;
+
+        if (channel >= 0 && channel < VIRTUAL_ADC_CHANNELS)
+            value += host_signal.amplitude[channel] * sin(host_phase + host_signal.phase[channel]) + host_signal.third * sin(3.0 * (host_phase + host_signal.phase[channel]));
+        value += host_signal.noise * host_noise();
+        if (host_signal.curve)
+            value = host_signal.curve(value);
+        long code = lround(value);
+        word[i] = (uint16_t)((pin << 12) | ((code < 0) ? 0 : (code > 4095) ? 4095 : code));
+
+        host_time_us += 1e6 / rate;
+        host_elapsed += 1.0 / rate;
+        host_phase += 2.0 * M_PI * (host_signal.frequency + host_signal.drift * host_elapsed) / rate;
+        if (host_phase > 2.0 * M_PI)
+            host_phase -= 2.0 * M_PI;
+    }
+    *bytes_read = size;
+    return (ESP_OK);
+}
+
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t unit, adc_atten_t atten, adc_bits_width_t width, uint32_t vref, esp_adc_cal_characteristics_t *characteristics)
+{
+    characteristics->vref = vref;
+    return (0);
+}
+
+/**
+ * @brief Cuentas ideales que dan el código raw con la transferencia de host_signal, por bisección.
+ */
+static double host_raw_to_ideal(double raw)
+{
+    double low = -1000.0;
+    double high = 6000.0;
+
+    if (!host_signal.curve)
+        return (raw);
+    for (int i = 0; i < 60; i++)
+    {
+        double mid = (low + high) / 2.0;
+        if (host_signal.curve(mid) < raw)
+            low = mid;
+        else
+            high = mid;
+    }
+    return ((low + high) / 2.0);
+}
+
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t raw, const esp_adc_cal_characteristics_t *characteristics)
+{
+    // Tensión de 11 dB sin alinear con la escala del código, como la del eFuse.
+    return ((uint32_t)lround(75.0 + 0.8 * host_raw_to_ideal(raw)));
+}
+
+BaseJsonConfig::BaseJsonConfig(const char *configFileName)
+{
+    strlcpy(fileName, configFileName, sizeof(fileName));
+}
+
+bool BaseJsonConfig::load(void)
+{
+    bool loaded = onDefault();
+
+    onLoad(host_document);
+    if (host_on_load)
+        host_on_load();
+    return (loaded);
+}
+
+bool BaseJsonConfig::load(uint32_t size)
+{
+    return (load());
+}
+
+bool BaseJsonConfig::save(void)
+{
+    return (true);
+}
+
+bool BaseJsonConfig::save(uint32_t size)
+{
+    return (true);
+}
+
+void BaseJsonConfig::debugPrint(void)
+{
+}
+
+/**
+ * @brief Arranca la medición como measure_Task() y la adquisición como su tarea, con la configuración por defecto.
+ *
+ * SPIFFS queda en un directorio temporal nuevo, así la energía arranca de cero.
+ */
+static void host_begin(void)
+{
+    char root[] = "/tmp/measure_host_XXXXXX";
+
+    SPIFFS.root = mkdtemp(root) ? root : "/tmp";
+    measure_init();
+    measure_i2s_init();
+}
+
+/**
+ * @brief Procesa bloques hasta cubrir la cantidad de segundos de señal dada.
+ *
+ * Después de cada ventana corre measure_energy_loop() como el loop() de Arduino.
+ *
+ * @param seconds Segundos de señal; measure_mes() integra de a uno.
+ */
+static void host_run(int seconds)
+{
+    for (int i = 0; i < seconds; i++)
+    {
+        measure_mes();
+        measure_energy_loop();
+    }
+}
@@ -0,0 +1,18 @@
+/**
+ * @file crc.h
+ * @brief CRC32 de la ROM del ESP32
+ */
+#pragma once
+#include <stdint.h>
+
+static inline uint32_t crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *buf++;
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return (~crc);
+}
@@ -0,0 +1,5 @@
+/**
+ * @file syscon_reg.h
+ * @brief Registros SYSCON del ESP32, measure.cpp sólo usa la estructura
+ */
+#pragma once
@@ -0,0 +1,18 @@
+/**
+ * @file syscon_struct.h
+ * @brief Patrón del ADC SAR que programa measure_i2s_init(), lo lee el I2S simulado
+ */
+#pragma once
+#include <stdint.h>
+
+typedef struct
+{
+    struct
+    {
+        uint32_t sar1_patt_len;
+        uint32_t sar_clk_div;
+    } saradc_ctrl;
+    uint32_t saradc_sar1_patt_tab[4];
+} syscon_dev_t;
+
+extern syscon_dev_t SYSCON;
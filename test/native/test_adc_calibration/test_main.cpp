@@ -0,0 +1,149 @@
+/**
+ * @file test_main.cpp
+ * @brief Corrección de la alinealidad del ADC con una transferencia sintética
+ *
+ * host_signal.curve hace que el ADC simulado se comprima cerca de los extremos y se arquee en el
+ * centro de la escala, como el SAR del ESP32 con 11 dB. La primera prueba arma la tabla con un
+ * barrido de 33 puntos de esa curva y la compara con su inversa código a código. Las otras miden
+ * cuatro segundos con una señal que llega cerca de los extremos y comparan el RMS de los canales
+ * de tensión y corriente con el de un ADC lineal: sin corrección el error pasa de 0.5%, con el
+ * barrido o con la característica de los eFuse (que el host simula con la misma curva) tiene que
+ * quedar por debajo de CALIBRATION_RMS_BOUND.
+ */
+#include <unity.h>
+#include "measure_host.h"
+
+#define CALIBRATION_AMPLITUDE 1900.0 // Amplitud en cuentas, de 148 a 3948
+#define CALIBRATION_TABLE_BOUND 2.5  // Error de la tabla en códigos: interpolar cada 128 códigos la curvatura de los extremos
+#define CALIBRATION_RMS_BOUND 1e-3   // Error relativo del RMS con corrección frente al ADC lineal
+#define CALIBRATION_RAW_BOUND 3e-3   // Error relativo mínimo sin corrección, para que la curva sea una prueba
+
+/**
+ * @brief Transferencia del ADC: arco de 12 códigos en el centro y compresión en los extremos.
+ */
+static double adc_curve(double ideal)
+{
+    double raw = ideal + 12.0 * sin(M_PI * ideal / 4096.0);
+
+    if (ideal > 3500.0)
+        raw -= (ideal - 3500.0) * (ideal - 3500.0) / 4000.0;
+    if (ideal < 300.0)
+        raw += (300.0 - ideal) * (300.0 - ideal) / 3000.0;
+    return (raw);
+}
+
+/**
+ * @brief Carga en measure los puntos de un barrido de la curva: cuentas ideales cada 128 y el código que da el ADC.
+ */
+static void load_sweep(void)
+{
+    char points[ADCCAL_MAX_POINTS * 24] = "";
+
+    for (int i = 0; i < ADCCAL_MAX_POINTS; i++)
+    {
+        char point[24];
+        double ideal = (i == ADCCAL_MAX_POINTS - 1) ? ADCCAL_CODES - 1 : i * ADCCAL_CODES / (ADCCAL_MAX_POINTS - 1);
+
+        snprintf(point, sizeof(point), *points ? ",%.0f:%.1f" : "%.0f:%.1f", adc_curve(ideal), ideal);
+        strlcat(points, point, sizeof(points));
+    }
+    TEST_ASSERT_TRUE(measure_set_adc_calibration_points_str(points));
+}
+
+/**
+ * @brief RMS de cada canal tras cuatro segundos de la señal, con la transferencia y la corrección dadas.
+ */
+static void measure_rms(double (*curve)(double), measure_adc_calibration_t calibration, float *rms)
+{
+    host_signal.curve = curve;
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+    {
+        host_signal.amplitude[c] = CALIBRATION_AMPLITUDE;
+        host_signal.phase[c] = 0.4 * c;
+    }
+    host_signal.noise = 2.0;
+    host_begin();
+    load_sweep();
+    measure_set_adc_calibration(calibration);
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        if (channelconfig[i].type == AC_CURRENT || channelconfig[i].type == AC_VOLTAGE)
+            measure_set_channel_true_rms(i, true);
+    host_run(4);
+
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        rms[i] = channelconfig[i].rms;
+}
+
+/**
+ * @brief Mayor error relativo del RMS de los canales de tensión y corriente frente al ADC lineal.
+ */
+static double rms_error(measure_adc_calibration_t calibration, const char *name)
+{
+    float linear[VIRTUAL_CHANNELS];
+    float curved[VIRTUAL_CHANNELS];
+    double worst = 0.0;
+
+    measure_rms(NULL, MEASURE_ADC_CAL_NONE, linear);
+    measure_rms(adc_curve, calibration, curved);
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        if (channelconfig[i].type == AC_CURRENT || channelconfig[i].type == AC_VOLTAGE)
+            worst = fmax(worst, fabs(curved[i] - linear[i]) / linear[i]);
+
+    char report[96];
+    snprintf(report, sizeof(report), "%s: error de RMS %.2e", name, worst);
+    TEST_MESSAGE(report);
+    return (worst);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    host_signal.curve = NULL;
+}
+
+void test_table_inverts_curve(void)
+{
+    double worst = 0.0;
+
+    host_signal.curve = adc_curve;
+    host_begin();
+    load_sweep();
+    measure_set_adc_calibration(MEASURE_ADC_CAL_USER);
+
+    // Los códigos que alcanza la curva; fuera de ellos la tabla prolonga el último tramo.
+    for (int code = lround(adc_curve(0.0)) + 1; code < lround(adc_curve(4095.0)); code++)
+        worst = fmax(worst, fabs(adc_calibration_lut[code] / (double)(1 << ADCCAL_FRACTION_BITS) - host_raw_to_ideal(code)));
+
+    char report[64];
+    snprintf(report, sizeof(report), "error máximo de la tabla %.2f códigos", worst);
+    TEST_MESSAGE(report);
+    TEST_ASSERT_LESS_THAN_FLOAT(CALIBRATION_TABLE_BOUND, worst);
+}
+
+void test_uncorrected_curve_is_visible(void)
+{
+    TEST_ASSERT_GREATER_THAN_FLOAT(CALIBRATION_RAW_BOUND, rms_error(MEASURE_ADC_CAL_NONE, "sin corrección"));
+}
+
+void test_user_sweep_corrects_rms(void)
+{
+    TEST_ASSERT_LESS_THAN_FLOAT(CALIBRATION_RMS_BOUND, rms_error(MEASURE_ADC_CAL_USER, "barrido"));
+}
+
+void test_efuse_corrects_rms(void)
+{
+    TEST_ASSERT_LESS_THAN_FLOAT(CALIBRATION_RMS_BOUND, rms_error(MEASURE_ADC_CAL_EFUSE, "eFuse"));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_table_inverts_curve);
+    RUN_TEST(test_uncorrected_curve_is_visible);
+    RUN_TEST(test_user_sweep_corrects_rms);
+    RUN_TEST(test_efuse_corrects_rms);
+    return (UNITY_END());
+}
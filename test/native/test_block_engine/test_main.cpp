@@ -0,0 +1,161 @@
+/**
+ * @file test_main.cpp
+ * @brief Motor de bloques frente al motor por muestras: mismos resultados y muestras por segundo de cada uno
+ *
+ * Los dos motores procesan el mismo bloque del ADC simulado partiendo del mismo estado, con los
+ * programas de fábrica. El buffer tiene que coincidir y las sumas diferir sólo por el orden de las
+ * operaciones en float; el reporte da las muestras por segundo de cada modo.
+ */
+#include <unity.h>
+#include <chrono>
+#include "measure_host.h"
+
+#ifndef MEASURE_FIXED_POINT
+static uint16_t adc[VIRTUAL_ADC_CHANNELS][numbersOfSamples];
+
+/**
+ * @brief estado que tocan los motores, para arrancar ambos del mismo punto
+ */
+typedef struct
+{
+    filter_state_t filter[VIRTUAL_CHANNELS];
+    float quadrature[VIRTUAL_CHANNELS][MEASURE_QUADRATURE_LEN];
+    uint32_t quadrature_pos;
+    float sample[VIRTUAL_CHANNELS];
+    float sum[VIRTUAL_CHANNELS];
+} engine_state_t;
+
+static void save_state(engine_state_t *state)
+{
+    memcpy(state->filter, filter_state, sizeof(filter_state));
+    memcpy(state->quadrature, quadrature_history, sizeof(quadrature_history));
+    state->quadrature_pos = quadrature_pos;
+    memcpy(state->sample, adc_sample, sizeof(adc_sample));
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        state->sum[i] = channelconfig[i].sum;
+}
+
+static void restore_state(const engine_state_t *state)
+{
+    memcpy(filter_state, state->filter, sizeof(filter_state));
+    memcpy(quadrature_history, state->quadrature, sizeof(quadrature_history));
+    quadrature_pos = state->quadrature_pos;
+    memcpy(adc_sample, state->sample, sizeof(adc_sample));
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        channelconfig[i].sum = state->sum[i];
+}
+
+static void sample_major(void)
+{
+    measure_process_sample_major(adc_extended, numbersOfSamples);
+}
+
+static void block_major(void)
+{
+    measure_process_block_major(adc_extended, numbersOfSamples);
+}
+
+/**
+ * @brief Mejor tiempo por bloque en microsegundos de varias repeticiones de process.
+ */
+static double bench_block_us(void (*process)(void))
+{
+    double best = 1e30;
+
+    for (int repeat = 0; repeat < 50; repeat++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int block = 0; block < 20; block++)
+            process();
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 20;
+        if (us < best)
+            best = us;
+    }
+    return (best);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_block_engine_matches_sample_engine(void)
+{
+    static uint16_t sample_buffer[VIRTUAL_CHANNELS][numbersOfSamples];
+    engine_state_t state;
+    float sample_sum[VIRTUAL_CHANNELS];
+
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+    {
+        host_signal.amplitude[c] = 1200.0 - 100.0 * c;
+        host_signal.phase[c] = 0.4 * c;
+    }
+    host_signal.third = 80.0;
+    host_signal.noise = 3.0;
+    host_begin();
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        measure_set_channel_harmonics(i, 0);
+    measure_set_phasor_harmonics(0);
+    host_run(2);
+    TEST_ASSERT_TRUE(channel_schedule.block);
+
+    // Un bloque del ADC simulado, ya calibrado y separado por canal.
+    measure_acquire();
+    measure_block_t *block = block_ring.acquire_read();
+    TEST_ASSERT_NOT_NULL(block);
+    memcpy(adc, block->adc_samples, sizeof(adc));
+    block_ring.release_read();
+    measure_extend_adc(adc, true);
+
+    save_state(&state);
+    measure_process_sample_major(adc_extended, numbersOfSamples);
+    memcpy(sample_buffer, buffer, sizeof(buffer));
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        sample_sum[i] = channelconfig[i].sum - state.sum[i];
+
+    restore_state(&state);
+    TEST_ASSERT_TRUE(measure_process_block_major(adc_extended, numbersOfSamples));
+
+    for (int k = 0; k < channel_work.len; k++)
+    {
+        int i = channel_work.order[k];
+        char message[64];
+
+        snprintf(message, sizeof(message), "canal %d", i);
+        for (int n = 0; n < numbersOfSamples; n++)
+            TEST_ASSERT_TRUE_MESSAGE(abs(sample_buffer[i][n] - buffer[i][n]) <= 1, message);
+        float block_sum = channelconfig[i].sum - state.sum[i];
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-5 * fabs(sample_sum[i]) + 1e-6, sample_sum[i], block_sum, message);
+    }
+
+    double sample_us = bench_block_us(sample_major);
+    double block_us = bench_block_us(block_major);
+    char report[160];
+    snprintf(report, sizeof(report), "%d canales: por muestras %.0f muestras/s, por bloques %.0f muestras/s (%.2fx)",
+             channel_work.len, channel_work.len * numbersOfSamples * 1e6 / sample_us, channel_work.len * numbersOfSamples * 1e6 / block_us, sample_us / block_us);
+    TEST_MESSAGE(report);
+}
+#else
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_block_engine_matches_sample_engine(void)
+{
+    TEST_IGNORE_MESSAGE("los motores float no existen con MEASURE_FIXED_POINT");
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_block_engine_matches_sample_engine);
+    return (UNITY_END());
+}
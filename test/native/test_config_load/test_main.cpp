@@ -0,0 +1,81 @@
+/**
+ * @file test_main.cpp
+ * @brief Valores de la configuración guardada fuera de rango
+ *
+ * measure_init() carga el archivo con onLoad(); acá el archivo es host_document. Los valores con
+ * rango tienen que pasar por los mismos controles que sus setters: uno fuera de rango deja el valor
+ * por defecto y uno dentro se carga tal cual. Con el orden de IEC 61000-4-7 fuera de rango, la
+ * medición con grupos tiene que correr y publicar grupos hasta el orden por defecto, sin pasarse
+ * de los arreglos.
+ */
+#include <unity.h>
+#include "measure_host.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    host_document.clear();
+}
+
+void test_out_of_range_values_keep_defaults(void)
+{
+    measure_iec_groups_t groups;
+
+    host_document["dsp_mode"] = -1;
+    host_document["high_pass_coef"] = 1.5;
+    host_document["window_mode"] = 7;
+    host_document["oversampling"] = 3;
+    host_document["analysis_period"] = 0;
+    host_document["phasor_harmonics"] = 0xffff;
+    host_document["iec_harmonics"] = true;
+    host_document["iec_max_order"] = 500;
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+        host_signal.amplitude[c] = 1000.0;
+    host_begin();
+
+    TEST_ASSERT_EQUAL_INT(MEASURE_DSP_SAMPLE_MAJOR, measure_get_dsp_mode());
+    TEST_ASSERT_EQUAL_FLOAT(0.9989, measure_get_high_pass_coef());
+    TEST_ASSERT_EQUAL_INT(MEASURE_WINDOW_1S, measure_get_window_mode());
+    TEST_ASSERT_EQUAL_INT(1, measure_get_oversampling());
+    TEST_ASSERT_EQUAL_INT(1000, measure_get_analysis_period());
+    TEST_ASSERT_EQUAL_HEX16((1 << MEASURE_MAX_HARMONIC) - 1, measure_get_phasor_harmonics());
+    TEST_ASSERT_EQUAL_INT(MEASURE_IEC_DEFAULT_ORDER, measure_get_iec_max_order());
+
+    // Los grupos se calculan en ventanas de ciclos.
+    measure_set_window_mode(MEASURE_WINDOW_CYCLES);
+    host_run(3);
+    TEST_ASSERT_NOT_EQUAL(0, measure_get_iec_groups(1, &groups));
+    TEST_ASSERT_EQUAL_INT(MEASURE_IEC_DEFAULT_ORDER, groups.max_order);
+}
+
+void test_in_range_values_load(void)
+{
+    host_document["dsp_mode"] = (int)MEASURE_DSP_BLOCK;
+    host_document["high_pass_coef"] = 0.995;
+    host_document["window_mode"] = (int)MEASURE_WINDOW_CYCLES;
+    host_document["oversampling"] = 2;
+    host_document["analysis_period"] = MEASURE_ANALYSIS_MIN_PERIOD;
+    host_document["phasor_harmonics"] = 0x0004;
+    host_document["iec_max_order"] = MEASURE_IEC_MAX_ORDER;
+    host_begin();
+
+    TEST_ASSERT_EQUAL_INT(MEASURE_DSP_BLOCK, measure_get_dsp_mode());
+    TEST_ASSERT_EQUAL_FLOAT(0.995, measure_get_high_pass_coef());
+    TEST_ASSERT_EQUAL_INT(MEASURE_WINDOW_CYCLES, measure_get_window_mode());
+    TEST_ASSERT_EQUAL_INT(2, measure_get_oversampling());
+    TEST_ASSERT_EQUAL_INT(MEASURE_ANALYSIS_MIN_PERIOD, measure_get_analysis_period());
+    // La fundamental se sigue siempre que haya alguna armónica.
+    TEST_ASSERT_EQUAL_HEX16(0x0005, measure_get_phasor_harmonics());
+    TEST_ASSERT_EQUAL_INT(MEASURE_IEC_MAX_ORDER, measure_get_iec_max_order());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_out_of_range_values_keep_defaults);
+    RUN_TEST(test_in_range_values_load);
+    return (UNITY_END());
+}
@@ -0,0 +1,157 @@
+/**
+ * @file test_main.cpp
+ * @brief Registros de energía con la potencia en un sentido y en el otro
+ *
+ * Las corrientes del host van en fase con las tensiones o desfasadas media vuelta, como una carga
+ * y una instalación que entrega a la red. Tras tres segundos para que pase el umbral de tensión,
+ * la prueba integra cuatro más: la potencia activa de cada grupo tiene que tener el signo del flujo,
+ * la energía tiene que ir sólo al registro de importación o sólo al de exportación, y lo acumulado
+ * tiene que coincidir con la potencia publicada por el tiempo dentro de ENERGY_BOUND. La aparente
+ * sale de los valores eficaces aunque los canales no tengan true_rms: tiene que coincidir con la
+ * aparente publicada por el tiempo y no puede ser menor que la activa. Con tres fases, el grupo de
+ * todas las potencias activado tiene que sumar las tres activas e integrarlas.
+ */
+#include <unity.h>
+#include "measure_host.h"
+
+#define ENERGY_SETTLE_SECONDS 3 // El umbral de tensión usa el RMS de la ventana anterior
+#define ENERGY_SECONDS 4        // Segundos integrados
+#define ENERGY_BOUND 0.01       // Error relativo de la energía frente a potencia por tiempo
+#define TOTAL_POWER_GROUP 3     // Grupo "all power" de fábrica, inactivo
+
+/**
+ * @brief Señal con las corrientes en fase con las tensiones o en contrafase.
+ */
+static void energy_signal(bool reversed)
+{
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+        host_signal.amplitude[c] = 1000.0;
+
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        uint16_t count;
+        const uint8_t *program = measure_get_channel_opcodeseq(i, &count);
+
+        if (channelconfig[i].type == AC_CURRENT && count && (program[0] & OPMASK) == GET_ADC)
+            host_signal.phase[program[0] & ~OPMASK] = reversed ? M_PI : 0.0;
+    }
+}
+
+/**
+ * @brief Integra unos ENERGY_SECONDS y compara cada grupo con su potencia.
+ *
+ * @return int grupos con potencia activa
+ */
+static int energy_check(bool reversed)
+{
+    measure_group_energy_t before[MAX_GROUPS];
+    measure_window_t start, end;
+    int groups = 0;
+
+    host_begin();
+    energy_signal(reversed);
+    host_run(ENERGY_SETTLE_SECONDS);
+    for (int g = 0; g < MAX_GROUPS; g++)
+        measure_get_group_energy(g, &before[g]);
+    measure_get_window(&start);
+    host_run(ENERGY_SECONDS);
+    measure_get_window(&end);
+    // Las ventanas cierran en el límite de un bloque: el tiempo integrado es el de sus finales.
+    double hours = (end.timestamp_us - start.timestamp_us) / 3600e6;
+
+    for (int g = 0; g < MAX_GROUPS; g++)
+    {
+        measure_group_power_t power;
+        measure_group_energy_t after;
+        char message[128];
+
+        if (!measure_get_group_power(g, &power) || power.active == 0.0)
+            continue;
+        measure_get_group_energy(g, &after);
+
+        double imported = after.active_import - before[g].active_import;
+        double exported = after.active_export - before[g].active_export;
+        double apparent = after.apparent - before[g].apparent;
+        double expected = fabs(power.active) * hours / 1000.0;
+
+        snprintf(message, sizeof(message), "grupo %d: %.1f W, %.3g kWh importados, %.3g kWh exportados", g, power.active, imported, exported);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_TRUE_MESSAGE(reversed ? power.active < 0.0 : power.active > 0.0, message);
+        TEST_ASSERT_EQUAL_FLOAT_MESSAGE(0.0, reversed ? imported : exported, message);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(ENERGY_BOUND * expected, expected, reversed ? exported : imported, message);
+        if (power.apparent > 0.0)
+        {
+            double expected_apparent = power.apparent * hours / 1000.0;
+
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(ENERGY_BOUND * expected_apparent, expected_apparent, apparent, message);
+            TEST_ASSERT_TRUE_MESSAGE(apparent >= expected * (1.0 - ENERGY_BOUND), message);
+        }
+        groups++;
+    }
+    return (groups);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_forward_flow_imports(void)
+{
+    TEST_ASSERT_GREATER_THAN(0, energy_check(false));
+}
+
+void test_reversed_flow_exports(void)
+{
+    TEST_ASSERT_GREATER_THAN(0, energy_check(true));
+}
+
+void test_total_power_group(void)
+{
+#if MEASURE_PROFILE == MEASURE_PROFILE_1P
+    TEST_IGNORE_MESSAGE("una sola fase, sin grupo de todas las potencias");
+#else
+    measure_group_power_t power;
+    measure_group_energy_t before, after;
+    measure_window_t start, end;
+    double total = 0.0;
+    char message[96];
+
+    // El grupo de todas las potencias suma las activas de L1, L2 y L3; sin tensión ni corriente no tiene aparente.
+    host_begin();
+    energy_signal(false);
+    measure_set_group_active(TOTAL_POWER_GROUP, true);
+    host_run(ENERGY_SETTLE_SECONDS);
+    measure_get_group_energy(TOTAL_POWER_GROUP, &before);
+    measure_get_window(&start);
+    host_run(ENERGY_SECONDS);
+    measure_get_window(&end);
+    measure_get_group_energy(TOTAL_POWER_GROUP, &after);
+
+    for (int g = 0; g < TOTAL_POWER_GROUP; g++)
+    {
+        TEST_ASSERT_TRUE(measure_get_group_power(g, &power));
+        total += power.active;
+    }
+    measure_get_group_power(TOTAL_POWER_GROUP, &power);
+    double expected = total * (end.timestamp_us - start.timestamp_us) / 3600e6 / 1000.0;
+    double imported = after.active_import - before.active_import;
+
+    snprintf(message, sizeof(message), "todas: %.1f W de %.1f W, %.3g kWh importados", power.active, total, imported);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(ENERGY_BOUND * total, total, power.active, message);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(ENERGY_BOUND * expected, expected, imported, message);
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_forward_flow_imports);
+    RUN_TEST(test_reversed_flow_exports);
+    RUN_TEST(test_total_power_group);
+    return (UNITY_END());
+}
@@ -0,0 +1,60 @@
+/**
+ * @file test_main.cpp
+ * @brief Copias de los registros de energía en SPIFFS fuera de la tarea de medición
+ *
+ * La prueba llama a measure_mes() sola, como la tarea de medición, durante más de
+ * MEASURE_ENERGY_SAVE_PERIOD: no se escribe ningún archivo. La copia que dejó pendiente la escribe
+ * measure_energy_loop(), que en el equipo corre en el loop() de Arduino, y tiene que pasar el CRC
+ * con la energía integrada hasta el pedido. Un segundo pedido va al otro archivo.
+ */
+#include <unity.h>
+#include "measure_host.h"
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_save_off_measure_task(void)
+{
+    measure_energy_stats_t stats;
+    measure_energy_store_t copy;
+
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+        host_signal.amplitude[c] = 1000.0;
+    host_begin();
+    for (int second = 0; second <= MEASURE_ENERGY_SAVE_PERIOD; second++)
+        measure_mes();
+
+    measure_get_energy_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.saves);
+    TEST_ASSERT_FALSE(measure_energy_read(MEASURE_ENERGY_FILE_B, &copy));
+
+    measure_energy_loop();
+    measure_get_energy_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.saves);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.save_errors);
+    TEST_ASSERT_TRUE(measure_energy_read(MEASURE_ENERGY_FILE_B, &copy));
+    TEST_ASSERT_EQUAL_MEMORY(energy_save_copy.energy, copy.energy, sizeof(copy.energy));
+    TEST_ASSERT_TRUE(copy.energy[0][MEASURE_ENERGY_ACTIVE_IMPORT] > 0);
+
+    // Sin pedido nuevo no se vuelve a escribir; el siguiente alterna de archivo.
+    measure_energy_loop();
+    measure_get_energy_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.saves);
+    host_run(MEASURE_ENERGY_SAVE_PERIOD + 1);
+    measure_get_energy_stats(&stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.saves);
+    TEST_ASSERT_TRUE(measure_energy_read(MEASURE_ENERGY_FILE_A, &copy));
+    TEST_ASSERT_EQUAL_UINT32(energy_save_copy.sequence, copy.sequence);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_save_off_measure_task);
+    return (UNITY_END());
+}
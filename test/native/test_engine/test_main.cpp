@@ -0,0 +1,230 @@
+/**
+ * @file test_main.cpp
+ * @brief Motor por muestras con planes precompilados frente al intérprete que decodifica cada byte
+ *
+ * reference_process() es el intérprete de antes de measure_compile_channel(): en cada muestra y cada
+ * canal recorre los bytes del programa, separa opcode y operando con OPMASK y salta los BRK. Con los
+ * mismos programas los dos tienen que dar el mismo buffer y las mismas sumas bit a bit; el tiempo de
+ * ambos queda en el reporte de la prueba.
+ */
+#include <unity.h>
+#include <chrono>
+#include "measure_host.h"
+
+#ifndef MEASURE_FIXED_POINT
+static uint16_t adc[VIRTUAL_ADC_CHANNELS][numbersOfSamples];
+static uint16_t reference_buffer[VIRTUAL_CHANNELS][numbersOfSamples];
+static float reference_sum[VIRTUAL_CHANNELS];
+
+/**
+ * @brief Un bloque del intérprete byte a byte, en el orden de channel_work como el motor.
+ */
+static void reference_process(void)
+{
+    static float sample[VIRTUAL_CHANNELS];
+
+    for (int n = 0; n < numbersOfSamples; n++)
+    {
+        for (int k = 0; k < channel_work.len; k++)
+        {
+            int i = channel_work.order[k];
+            uint16_t count = 0;
+            const uint8_t *program = measure_get_channel_opcodeseq(i, &count);
+            float value = sample[i];
+
+            for (int operation = 0; operation < MAX_MICROCODE_OPS; operation++)
+            {
+                uint8_t byte = (operation < count) ? program[operation] : BRK;
+                uint8_t op_channel = byte & ~OPMASK;
+
+                switch (byte & OPMASK)
+                {
+                case ADD:
+                    value += sample[op_channel];
+                    break;
+                case SUB:
+                    value -= sample[op_channel];
+                    break;
+                case MUL:
+                    value *= sample[op_channel];
+                    break;
+                case MUL_RATIO:
+                    value *= channelconfig[op_channel].ratio;
+                    break;
+                case MUL_SIGN:
+                    value *= (((op_channel == i) ? value : sample[op_channel]) > 0.0) ? 1.0 : -1.0;
+                    break;
+                case ABS:
+                    value = fabs(value);
+                    break;
+                case NEG:
+                    value = -value;
+                    break;
+                case PASS_NEGATIVE:
+                    if (value > 0.0)
+                        value = 0.0;
+                    break;
+                case PASS_POSITIVE:
+                    if (value < 0.0)
+                        value = 0.0;
+                    break;
+                case GET_ADC:
+                    value = measure_adc_value(adc_extended[op_channel] + MEASURE_ADC_HEAD, n + channel_phase[i].offset_0, &channel_phase[i]);
+                    break;
+                case SET_TO:
+                    value = op_channel;
+                    break;
+                default:
+                    break;
+                }
+            }
+            sample[i] = value;
+
+            if (channelconfig[i].type == AC_VOLTAGE && measure_get_channel_ratio(i) > 5)
+                reference_buffer[i][n] = 2048;
+            else
+                reference_buffer[i][n] = (value + 2048 < 0.0) ? 0 : (value * measure_get_channel_ratio(i)) + 2048;
+            if (channelconfig[i].harmonics)
+                goertzel_update(&harmonic_state[i], harmonic_coef, channelconfig[i].harmonics, value, harmonic_window[n], harmonic_restart[n]);
+            measure_iec_capture(i, n, value);
+            measure_phasor_update(i, n, value);
+
+            switch (channelconfig[i].type)
+            {
+            case AC_CURRENT:
+            case AC_VOLTAGE:
+                reference_sum[i] += channelconfig[i].true_rms ? value * value : fabs(value);
+                break;
+            case NO_CHANNEL_TYPE:
+                break;
+            default:
+                reference_sum[i] += channelconfig[i].true_rms ? value * value : value;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Mejor tiempo por bloque en microsegundos de varias repeticiones de process.
+ */
+static double bench_block_us(void (*process)(void))
+{
+    double best = 1e30;
+
+    for (int repeat = 0; repeat < 50; repeat++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int block = 0; block < 20; block++)
+            process();
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 20;
+        if (us < best)
+            best = us;
+    }
+    return (best);
+}
+
+static void engine_process(void)
+{
+    measure_process_sample_major(adc_extended, numbersOfSamples);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Programas de fábrica sin los opcodes con estado (FILTER pasa a nada, MUL_QUADRATURE a MUL_SIGN)
+ * y un canal de corriente con diez opcodes, como los del editor.
+ */
+static void load_programs(void)
+{
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        uint16_t count;
+        const uint8_t *program = measure_get_channel_opcodeseq(i, &count);
+        uint8_t stateless[MEASURE_PROGRAM_MAX];
+        uint16_t len = 0;
+        char error[64];
+
+        for (int pos = 0; pos < count; pos++)
+        {
+            if ((program[pos] & OPMASK) == FILTER)
+                continue;
+            stateless[len++] = ((program[pos] & OPMASK) == MUL_QUADRATURE) ? MUL_SIGN | (program[pos] & ~OPMASK) : program[pos];
+        }
+        TEST_ASSERT_TRUE_MESSAGE(measure_set_channel_opcodeseq(i, stateless, len, error, sizeof(error)), error);
+        measure_set_channel_harmonics(i, 0);
+    }
+
+    char error[64];
+    TEST_ASSERT_TRUE_MESSAGE(measure_set_channel_opcodeseq_str(0, "50a0d080a0d0f0d0e0a0", error, sizeof(error)), error);
+    measure_set_phasor_harmonics(0);
+}
+
+void test_compiled_plans_match_byte_interpreter(void)
+{
+    host_begin();
+    load_programs();
+    // Un segundo de medición toma los programas y arma la lista de canales.
+    host_run(1);
+
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+        for (int n = 0; n < numbersOfSamples; n++)
+            adc[c][n] = (2048 + 1500 * sin(2 * M_PI * n * 2 / numbersOfSamples + c)) * (1 << ADCCAL_FRACTION_BITS);
+    measure_extend_adc(adc, false);
+
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        channelconfig[i].sum = 0.0;
+        reference_sum[i] = 0.0;
+        adc_sample[i] = 0.0;
+    }
+    for (int block = 0; block < 3; block++)
+    {
+        measure_process_sample_major(adc_extended, numbersOfSamples);
+        reference_process();
+    }
+
+    for (int k = 0; k < channel_work.len; k++)
+    {
+        int i = channel_work.order[k];
+        char message[64];
+
+        snprintf(message, sizeof(message), "canal %d", i);
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(reference_buffer[i], buffer[i], sizeof(buffer[i]), message);
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(&reference_sum[i], &channelconfig[i].sum, sizeof(float), message);
+    }
+
+    double reference_us = bench_block_us(reference_process);
+    double engine_us = bench_block_us(engine_process);
+    char report[128];
+    snprintf(report, sizeof(report), "bloque de %d canales: intérprete %.1f us, planes %.1f us, %.2fx, %.0f muestras/s por canal",
+             channel_work.len, reference_us, engine_us, reference_us / engine_us, numbersOfSamples * 1e6 / engine_us);
+    TEST_MESSAGE(report);
+}
+#else
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_compiled_plans_match_byte_interpreter(void)
+{
+    TEST_IGNORE_MESSAGE("el motor por muestras no existe con MEASURE_FIXED_POINT");
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_compiled_plans_match_byte_interpreter);
+    return (UNITY_END());
+}
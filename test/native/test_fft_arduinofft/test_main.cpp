@@ -0,0 +1,148 @@
+/**
+ * @file test_main.cpp
+ * @brief fft_real() frente a arduinoFFT 1.5.6, la FFT en double que usaba el espectro del osciloscopio
+ *
+ * El espectro de measure_update_spectrum() se calcula con las dos: 128 muestras de un bloque con
+ * fundamental, armónicas y ruido, ventana rectangular y las magnitudes que se publican. Tienen que
+ * coincidir al LSB. Con ruido a 64, 256 y 2048 puntos las magnitudes en float no se apartan más de
+ * FFT_RELATIVE_BOUND del bin mayor de la de double, y el reporte da el tiempo por transformada de
+ * cada una en el host; el del ESP32 lo da test/embedded/test_fft_bench.
+ */
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <string.h>
+#include <arduinoFFT.h>
+#include "dsp/fft.h"
+
+#define SPECTRUM_LEN 128         // Puntos del espectro del osciloscopio, numbersOfFFTSamples * 2
+#define SPECTRUM_BINS 64         // Bins publicados, numbersOfFFTSamples
+#define FFT_RELATIVE_BOUND 1e-5  // Error de las magnitudes float respecto del bin mayor de la FFT en double
+
+static float x[FFT_MAX_LEN];
+static double re[FFT_MAX_LEN];
+static double im[FFT_MAX_LEN];
+
+static uint32_t lcg = 12345; // Estado del generador de ruido
+
+/**
+ * @brief Ruido uniforme en [-0.5, 0.5), reproducible.
+ */
+static double noise(void)
+{
+    lcg = lcg * 1103515245u + 12345u;
+    return (((lcg >> 16) & 0x7fff) / 32768.0 - 0.5);
+}
+
+/**
+ * @brief FFT de len puntos de re[] con arduinoFFT, como la llamaba measure_update_spectrum(): la
+ * transformada inversa, que ya divide por len, y magnitudes en re[].
+ */
+static void arduinofft_magnitude(int len)
+{
+    arduinoFFT FFT(re, im, len, 1.0);
+
+    memset(im, 0, len * sizeof(double));
+    FFT.Windowing(FFT_WIN_TYP_RECTANGLE, FFT_REVERSE);
+    FFT.Compute(FFT_REVERSE);
+    FFT.ComplexToMagnitude();
+}
+
+/**
+ * @brief Mejor tiempo por transformada en microsegundos de varias repeticiones.
+ */
+template <typename transform_t>
+static double bench_us(transform_t transform, int count)
+{
+    double best = 1e30;
+
+    for (int repeat = 0; repeat < 20; repeat++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; i++)
+            transform();
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / count;
+        if (us < best)
+            best = us;
+    }
+    return (best);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_spectrum_matches_arduinofft(void)
+{
+    uint16_t expected[SPECTRUM_BINS];
+    uint16_t actual[SPECTRUM_BINS];
+
+    // Tres ciclos de corriente en cuentas por el ratio, como los que muestrea el espectro.
+    for (int n = 0; n < SPECTRUM_LEN; n++)
+    {
+        double phase = 2.0 * M_PI * 3 * n / SPECTRUM_LEN;
+        x[n] = 1500.0 * sin(phase + 0.3) + 240.0 * sin(3 * phase) + 90.0 * sin(5 * phase + 1.0) + 20.0 * noise();
+        re[n] = x[n];
+    }
+
+    arduinofft_magnitude(SPECTRUM_LEN);
+    for (int k = 0; k < SPECTRUM_BINS; k++)
+        expected[k] = re[k];
+    fft_real(x, SPECTRUM_LEN);
+    fft_magnitude(x, SPECTRUM_LEN, actual, SPECTRUM_BINS, 1.0 / SPECTRUM_LEN);
+
+    for (int k = 1; k < SPECTRUM_BINS; k++)
+    {
+        char message[32];
+
+        snprintf(message, sizeof(message), "bin %d", k);
+        TEST_ASSERT_TRUE_MESSAGE(abs(expected[k] - actual[k]) <= 1, message);
+    }
+}
+
+void test_magnitudes_and_time_against_arduinofft(void)
+{
+    static const int lens[] = {64, 256, 2048};
+
+    for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++)
+    {
+        int len = lens[l];
+        double peak = 0.0;
+        double error = 0.0;
+
+        for (int n = 0; n < len; n++)
+        {
+            x[n] = 2000.0 * noise();
+            re[n] = x[n];
+        }
+        arduinofft_magnitude(len);
+        fft_real(x, len);
+        for (int k = 0; k <= len / 2; k++)
+        {
+            double magnitude = sqrt(fft_power(x, len, k)) / len;
+            peak = fmax(peak, re[k]);
+            error = fmax(error, fabs(magnitude - re[k]));
+        }
+
+        int count = 2048 * 16 / len;
+        double float_us = bench_us([len]() { fft_real(x, len); }, count);
+        double double_us = bench_us([len]() { arduinofft_magnitude(len); }, count);
+        char report[160];
+        snprintf(report, sizeof(report), "%d puntos: error %.2e del bin mayor, arduinoFFT %.2f us, fft_real %.2f us (%.2fx)",
+                 len, error / peak, double_us, float_us, double_us / float_us);
+        TEST_MESSAGE(report);
+        TEST_ASSERT_LESS_THAN_FLOAT(FFT_RELATIVE_BOUND, error / peak);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_spectrum_matches_arduinofft);
+    RUN_TEST(test_magnitudes_and_time_against_arduinofft);
+    return (UNITY_END());
+}
@@ -0,0 +1,257 @@
+/**
+ * @file test_main.cpp
+ * @brief Etapas del opcode FILTER: media móvil entre bloques, biquads y operandos guardados
+ *
+ * La media móvil lleva su ventana de un bloque al siguiente: filtrar una señal de a pedazos tiene
+ * que dar lo mismo que de una vez y lo mismo que la media de las últimas muestras del pasa alto.
+ * Los operandos 7 a 15 son la media de FILTER_BOXCAR_ALT_LEN muestras, como en el firmware original.
+ * Los biquads de filter_design_presets() se miden con senoidales ya asentadas: los pasa bajo dejan
+ * pasar la fundamental y caen 3 dB en su armónica de corte, el pasa banda tiene ganancia 1 y fase 0
+ * en la fundamental; la versión Q31 tiene que coincidir con la de float. Por último un programa con
+ * FILTER 8 o 15 tiene que medir lo mismo que con FILTER 7, y BIQUAD tiene que llegar al biquad.
+ */
+#include <unity.h>
+#include <string.h>
+#include "measure_host.h"
+
+#define FILTER_RATE 12800.0          // Muestras por segundo, deja todos los cortes por debajo de Nyquist
+#define FILTER_NETWORK 50.0          // Frecuencia de red de los presets
+#define FILTER_LEN 4096              // Muestras de cada prueba
+#define FILTER_SETTLE 2048           // Muestras descartadas hasta que el biquad se asienta
+#define FILTER_HP_COEF 0.9989        // Coeficiente del pasa alto, el de fábrica
+#define FILTER_BOXCAR_BOUND 1e-4     // Error de la media móvil respecto de la media directa
+#define FILTER_GAIN_BOUND 0.005      // Error de la ganancia de los biquads
+#define FILTER_PHASE_BOUND 0.5       // Error de la fase del pasa banda en grados
+#define FILTER_Q31_BOUND 1e-4        // Error de la versión Q31 a escala completa
+#define FILTER_RMS_BOUND 0.002       // Error relativo del valor eficaz medido con programas equivalentes
+
+static const int lowpass_harmonic[] = {40, 20, 10, 5}; // Armónica de corte de los presets 0 a 3
+
+static float input[FILTER_LEN];
+static float output[FILTER_LEN];
+
+/**
+ * @brief Senoidal de amplitud 1 y frecuencia f en input[].
+ */
+static void filter_sine(double f)
+{
+    for (int n = 0; n < FILTER_LEN; n++)
+        input[n] = sin(2.0 * M_PI * f * n / FILTER_RATE);
+}
+
+/**
+ * @brief Ganancia y fase en grados de output[] respecto de una senoidal de frecuencia f, sobre
+ * los ciclos enteros que siguen a FILTER_SETTLE.
+ */
+static void filter_response(double f, double *gain, double *phase)
+{
+    int len = (int)(floor((FILTER_LEN - FILTER_SETTLE) * f / FILTER_RATE) * FILTER_RATE / f);
+    double re = 0.0, im = 0.0;
+
+    for (int n = FILTER_SETTLE; n < FILTER_SETTLE + len; n++)
+    {
+        double w = 2.0 * M_PI * f * n / FILTER_RATE;
+        re += output[n] * sin(w);
+        im += output[n] * cos(w);
+    }
+    *gain = 2.0 * sqrt(re * re + im * im) / len;
+    *phase = atan2(im, re) * 180.0 / M_PI;
+}
+
+/**
+ * @brief Filtra input[] en output[] con el biquad de un preset, sin pasa alto (coeficiente 1).
+ */
+static void filter_biquad(int preset)
+{
+    filter_state_t state;
+
+    filter_reset(&state);
+    memcpy(output, input, sizeof(output));
+    filter_process(&state, FILTER_BIQUAD_FIRST + preset, 1.0, output, FILTER_LEN);
+}
+
+void setUp(void)
+{
+    filter_design_presets(FILTER_RATE, FILTER_NETWORK);
+}
+
+void tearDown(void)
+{
+}
+
+void test_saved_operands_keep_boxcar(void)
+{
+    for (int operand = 1; operand <= 6; operand++)
+        TEST_ASSERT_EQUAL_INT(1 << operand, filter_boxcar_len(operand));
+    for (int operand = 7; operand <= 15; operand++)
+        TEST_ASSERT_EQUAL_INT(FILTER_BOXCAR_ALT_LEN, filter_boxcar_len(operand));
+    TEST_ASSERT_EQUAL_INT(0, filter_boxcar_len(0));
+    for (int preset = 0; preset < FILTER_BIQUAD_PRESETS; preset++)
+        TEST_ASSERT_EQUAL_INT(0, filter_boxcar_len(FILTER_BIQUAD_FIRST + preset));
+}
+
+void test_boxcar_state_across_blocks(void)
+{
+    static const uint8_t operands[] = {3, 6, 7, 8, 12, 15};
+    static const int chunks[] = {1, 7, 64, 256, 300}; // Largo de los pedazos, se repiten en orden
+    static float highpass[FILTER_LEN];
+
+    for (int n = 0; n < FILTER_LEN; n++)
+        input[n] = 0.7 * sin(2.0 * M_PI * FILTER_NETWORK * n / FILTER_RATE) + 0.2 * sin(2.0 * M_PI * 7.3 * FILTER_NETWORK * n / FILTER_RATE) + 0.1;
+    // Pasa alto solo, operando 0, para la media de referencia.
+    filter_state_t state;
+    filter_reset(&state);
+    memcpy(highpass, input, sizeof(highpass));
+    filter_process(&state, 0, FILTER_HP_COEF, highpass, FILTER_LEN);
+
+    for (unsigned k = 0; k < sizeof(operands); k++)
+    {
+        int box_len = filter_boxcar_len(operands[k]);
+        static float whole[FILTER_LEN];
+        char message[64];
+
+        filter_reset(&state);
+        memcpy(whole, input, sizeof(whole));
+        filter_process(&state, operands[k], FILTER_HP_COEF, whole, FILTER_LEN);
+
+        filter_reset(&state);
+        memcpy(output, input, sizeof(output));
+        for (int pos = 0, c = 0; pos < FILTER_LEN; c++)
+        {
+            int len = chunks[c % (sizeof(chunks) / sizeof(chunks[0]))];
+            if (len > FILTER_LEN - pos)
+                len = FILTER_LEN - pos;
+            filter_process(&state, operands[k], FILTER_HP_COEF, &output[pos], len);
+            pos += len;
+        }
+
+        snprintf(message, sizeof(message), "operando %d, media de %d", operands[k], box_len);
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(whole, output, sizeof(output), message);
+        for (int n = box_len; n < FILTER_LEN; n++)
+        {
+            double mean = 0.0;
+            for (int j = 0; j < box_len; j++)
+                mean += highpass[n - j];
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(FILTER_BOXCAR_BOUND, mean / box_len, output[n], message);
+        }
+    }
+}
+
+void test_lowpass_presets(void)
+{
+    for (int preset = 0; preset < 4; preset++)
+    {
+        double gain, phase;
+        char message[96];
+
+        filter_sine(FILTER_NETWORK);
+        filter_biquad(preset);
+        filter_response(FILTER_NETWORK, &gain, &phase);
+        snprintf(message, sizeof(message), "preset %d: fundamental %.4f", preset, gain);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(FILTER_GAIN_BOUND, 1.0, gain, message);
+
+        filter_sine(FILTER_NETWORK * lowpass_harmonic[preset]);
+        filter_biquad(preset);
+        filter_response(FILTER_NETWORK * lowpass_harmonic[preset], &gain, &phase);
+        snprintf(message, sizeof(message), "preset %d: armónica %d %.4f", preset, lowpass_harmonic[preset], gain);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(FILTER_GAIN_BOUND, M_SQRT1_2, gain, message);
+    }
+}
+
+void test_bandpass_preset(void)
+{
+    double gain, phase;
+    char message[96];
+
+    filter_sine(FILTER_NETWORK);
+    filter_biquad(4);
+    filter_response(FILTER_NETWORK, &gain, &phase);
+    snprintf(message, sizeof(message), "fundamental: %.4f a %.2f grados", gain, phase);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(FILTER_GAIN_BOUND, 1.0, gain, message);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(FILTER_PHASE_BOUND, 0.0, phase, message);
+
+    // Q = 1: la quinta armónica queda en 1 / raíz( 1 + ( 5 - 1 / 5 )^2 ).
+    filter_sine(5 * FILTER_NETWORK);
+    filter_biquad(4);
+    filter_response(5 * FILTER_NETWORK, &gain, &phase);
+    snprintf(message, sizeof(message), "quinta: %.4f", gain);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(FILTER_GAIN_BOUND, 1.0 / sqrt(1.0 + 4.8 * 4.8), gain, message);
+}
+
+void test_q31_matches_float(void)
+{
+    for (int preset = 0; preset < FILTER_BIQUAD_PRESETS; preset++)
+    {
+        filter_state_q31_t state;
+        char message[32];
+
+        filter_sine(3 * FILTER_NETWORK);
+        filter_biquad(preset);
+        filter_reset_q31(&state);
+        snprintf(message, sizeof(message), "preset %d", preset);
+        for (int n = 0; n < FILTER_LEN; n++)
+        {
+            // Media escala para que el pasa bajo con sobrepico no sature.
+            int32_t y = filter_process_q31(&state, FILTER_BIQUAD_FIRST + preset, 1 << 30, llround(input[n] * 0.5 * 2147483647.0));
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(FILTER_Q31_BOUND, output[n] * 0.5, y / 2147483648.0, message);
+        }
+    }
+}
+
+/**
+ * @brief Valor eficaz de la corriente L1 con un programa cargado por texto.
+ */
+static double filter_program_rms(const char *program)
+{
+    char error[64];
+
+    TEST_ASSERT_TRUE_MESSAGE(measure_set_channel_opcodeseq_str(0, program, error, sizeof(error)), error);
+    host_run(2);
+    return (measure_get_channel_rms(0));
+}
+
+void test_programs(void)
+{
+    char error[64] = "";
+
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+        host_signal.amplitude[c] = 1000.0;
+    host_begin();
+    measure_set_channel_true_rms(0, true);
+
+    // FILTER 7, 8 y 15: la misma media de doce muestras.
+    double boxcar = filter_program_rms("5077");
+    TEST_ASSERT_FLOAT_WITHIN(FILTER_RMS_BOUND * boxcar, boxcar, filter_program_rms("5078"));
+    TEST_ASSERT_FLOAT_WITHIN(FILTER_RMS_BOUND * boxcar, boxcar, filter_program_rms("507f"));
+
+    // BIQUAD 4 es el pasa banda en la fundamental: mide lo mismo que el pasa alto solo.
+    double highpass = filter_program_rms("5070");
+    double bandpass = filter_program_rms("504804");
+    char message[96];
+    snprintf(message, sizeof(message), "pasa alto %.3f, pasa banda %.3f, media de doce %.3f", highpass, bandpass, boxcar);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(FILTER_RMS_BOUND * highpass, highpass, bandpass, message);
+    TEST_ASSERT_TRUE_MESSAGE(boxcar < (1.0 - 5 * FILTER_RMS_BOUND) * highpass, message);
+
+    // Un preset que no existe es un error y deja el programa anterior.
+    TEST_ASSERT_FALSE(measure_set_channel_opcodeseq_str(0, "504805", error, sizeof(error)));
+    TEST_ASSERT_NOT_NULL(strstr(error, "biquad fuera de rango"));
+    char program[64];
+    TEST_ASSERT_EQUAL_STRING("50480400000000000000", measure_get_channel_opcodeseq_str(0, sizeof(program), program));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_saved_operands_keep_boxcar);
+    RUN_TEST(test_boxcar_state_across_blocks);
+    RUN_TEST(test_lowpass_presets);
+    RUN_TEST(test_bandpass_preset);
+    RUN_TEST(test_q31_matches_float);
+    RUN_TEST(test_programs);
+    return (UNITY_END());
+}
@@ -0,0 +1,75 @@
+/**
+ * @file test_main.cpp
+ * @brief RMS y potencias del motor de punto fijo frente a los del motor float, con la cota de error
+ *
+ * Corre igual en native y en native_fixed: cuatro segundos de la misma señal simulada y los RMS de
+ * todos los canales contra float_rms, que son los del motor float con esta misma prueba. La cota
+ * es la de measure_compile_fixed_point(), 0.01% del valor de cada canal. Si cambian la señal, los
+ * programas de fábrica o el motor float, float_rms se regenera corriendo la prueba en native e
+ * imprimiendo channelconfig[].rms.
+ */
+#include <unity.h>
+#include "measure_host.h"
+
+#define FIXED_POINT_BOUND 1e-4 // Error relativo admitido frente al motor float
+
+#if MEASURE_PROFILE == MEASURE_PROFILE_3P
+// channelconfig[].rms del motor float tras cuatro segundos de la señal de test_fixed_vs_float().
+static const float float_rms[VIRTUAL_CHANNELS] = {
+    71.3764648, 1013.03882, 44930.8242, 55796.6094,
+    57.2478027, 357.875519, 20393.3633, 1775.30188,
+    58.1203308, 402.191406, 14444.8633, 17974.1094,
+    0};
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_fixed_vs_float(void)
+{
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+    {
+        host_signal.amplitude[c] = 1200.0 - 100.0 * c;
+        host_signal.phase[c] = 0.4 * c;
+    }
+    host_signal.third = 80.0;
+    host_signal.noise = 3.0;
+    host_begin();
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        if (channelconfig[i].type == AC_CURRENT || channelconfig[i].type == AC_VOLTAGE)
+            measure_set_channel_true_rms(i, true);
+    host_run(4);
+
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        char message[64];
+
+        snprintf(message, sizeof(message), "canal %d (%s)", i, channelconfig[i].name);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(FIXED_POINT_BOUND * fabs(float_rms[i]) + 1e-3, float_rms[i], channelconfig[i].rms, message);
+    }
+}
+#else
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_fixed_vs_float(void)
+{
+    TEST_IGNORE_MESSAGE("los valores de referencia son del perfil de tres fases");
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fixed_vs_float);
+    return (UNITY_END());
+}
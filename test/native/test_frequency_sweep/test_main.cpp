@@ -0,0 +1,131 @@
+/**
+ * @file test_main.cpp
+ * @brief Estimador de frecuencia por cruces por cero: error en un barrido de 49.5 a 50.5 Hz y asentamiento
+ *
+ * La frecuencia se mira después de cada bloque, que es cuando measure_update_frequency() la
+ * actualiza. El estimador promedia los últimos FREQTRACK_MAX_CYCLES ciclos, así que en el barrido
+ * se compara con la frecuencia media de la señal en esos ciclos; el atraso respecto de la
+ * instantánea queda en el reporte. El asentamiento es el tiempo desde un salto de 49.5 a 50.5 Hz
+ * hasta que el error queda por debajo de FREQUENCY_SETTLED_HZ.
+ *
+ * Fuera de 50 Hz el bloque no tiene ciclos enteros: la continua de zerocross_find() se promedia por
+ * ciclos, porque el promedio del bloque oscila con la fase y movía los cruces (6.7 mHz de error).
+ */
+#include <unity.h>
+#include "measure_host.h"
+
+#define SWEEP_RATE 0.1 // Hz/s, de 49.5 a 50.5 Hz en diez segundos
+#define SWEEP_MAX_ERROR_HZ 0.005 // Error admitido frente a la media de los ciclos del estimador
+#define FREQUENCY_SETTLED_HZ 0.005 // Error por debajo del cual el estimador se considera asentado
+#define FREQUENCY_MAX_SETTLING_MS 300.0 // FREQTRACK_MAX_CYCLES ciclos más un bloque
+
+static double sweep_start;          // Segundo de señal en que empieza el barrido
+static double sweep_max_error;      // Mayor error frente a la media de los ciclos del estimador
+static double sweep_max_lag;        // Mayor diferencia con la frecuencia instantánea
+static long sweep_blocks;           // Bloques medidos durante el barrido
+
+static double step_time;            // Segundo de señal del salto
+static double settled_time;         // Segundo de señal desde el que el error queda dentro de FREQUENCY_SETTLED_HZ, negativo si todavía no
+
+/**
+ * @brief Frecuencia de la señal simulada en el segundo dado.
+ */
+static double signal_frequency(double elapsed)
+{
+    return (host_signal.frequency + host_signal.drift * elapsed);
+}
+
+/**
+ * @brief Después de cada bloque del barrido: error frente a la media de la señal y frente a la instantánea.
+ */
+static void sweep_block(void)
+{
+    if (host_elapsed < sweep_start || signal_frequency(host_elapsed) > 50.5)
+        return;
+
+    // Media de la frecuencia en los ciclos que usa el estimador, que terminan en el último cruce.
+    double window = FREQTRACK_MAX_CYCLES / signal_frequency(host_elapsed);
+    double estimated = measure_get_max_freq();
+    double error = fabs(estimated - signal_frequency(host_elapsed - window / 2.0));
+    double lag = fabs(estimated - signal_frequency(host_elapsed));
+
+    // Los primeros ciclos del barrido todavía promedian frecuencia fija.
+    if (host_elapsed < sweep_start + window)
+        return;
+    sweep_max_error = fmax(sweep_max_error, error);
+    sweep_max_lag = fmax(sweep_max_lag, lag);
+    sweep_blocks++;
+}
+
+/**
+ * @brief Después de cada bloque del salto: anota desde cuándo el error queda dentro de FREQUENCY_SETTLED_HZ.
+ */
+static void step_block(void)
+{
+    if (fabs(measure_get_max_freq() - host_signal.frequency) > FREQUENCY_SETTLED_HZ)
+        settled_time = -1.0;
+    else if (settled_time < 0.0)
+        settled_time = host_elapsed;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    host_on_block = NULL;
+}
+
+void test_frequency_sweep(void)
+{
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+        host_signal.amplitude[c] = 1500.0;
+    host_signal.noise = 3.0;
+    host_signal.frequency = 49.5;
+    host_begin();
+    host_run(2);
+
+    // El barrido empieza en 49.5 Hz donde está la señal ahora.
+    sweep_start = host_elapsed;
+    host_signal.drift = SWEEP_RATE;
+    host_signal.frequency = 49.5 - SWEEP_RATE * sweep_start;
+    host_on_block = sweep_block;
+    host_run(11);
+
+    char report[128];
+    snprintf(report, sizeof(report), "barrido de %.1f Hz/s: %ld bloques, error máximo %.2f mHz, atraso máximo %.1f mHz",
+             SWEEP_RATE, sweep_blocks, sweep_max_error * 1000.0, sweep_max_lag * 1000.0);
+    TEST_MESSAGE(report);
+    TEST_ASSERT_GREATER_THAN(200, sweep_blocks);
+    TEST_ASSERT_LESS_THAN_FLOAT(SWEEP_MAX_ERROR_HZ, sweep_max_error);
+}
+
+void test_frequency_settling(void)
+{
+    host_signal.drift = 0.0;
+    host_signal.frequency = 49.5;
+    host_begin();
+    host_run(2);
+
+    step_time = host_elapsed;
+    settled_time = -1.0;
+    host_signal.frequency = 50.5;
+    host_on_block = step_block;
+    host_run(2);
+
+    TEST_ASSERT_TRUE(settled_time >= 0.0);
+    double settling_ms = (settled_time - step_time) * 1000.0;
+    char report[96];
+    snprintf(report, sizeof(report), "salto de 49.5 a 50.5 Hz: asentado en %.0f ms", settling_ms);
+    TEST_MESSAGE(report);
+    TEST_ASSERT_LESS_THAN_FLOAT(FREQUENCY_MAX_SETTLING_MS, settling_ms);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_frequency_sweep);
+    RUN_TEST(test_frequency_settling);
+    return (UNITY_END());
+}
@@ -0,0 +1,80 @@
+/**
+ * @file test_main.cpp
+ * @brief Armónicas de Goertzel con la red fuera de la frecuencia nominal
+ *
+ * Los filtros de Goertzel evalúan cada armónica en la frecuencia medida, pero el bloque sigue siendo
+ * de numbersOfSamples muestras y fuera de los 50 Hz ya no tiene un número entero de ciclos. Con una
+ * tercera armónica del HARMONIC_THIRD de la fundamental, en todas las frecuencias de la prueba la
+ * tercera tiene que medir esa relación, la fundamental el valor eficaz de la senoidal y las armónicas
+ * que la señal no tiene, 2, 4 y 5, quedar por debajo de HARMONIC_LEAK_BOUND de la fundamental.
+ */
+#include <unity.h>
+#include "measure_host.h"
+
+#define HARMONIC_AMPLITUDE 1000.0       // Amplitud de la fundamental en cuentas
+#define HARMONIC_THIRD 0.1              // Tercera armónica respecto de la fundamental
+#define HARMONIC_MASK 0x001f            // Armónicas 1 a 5
+#define HARMONIC_RATIO_BOUND 0.005      // Error relativo de la tercera y de la fundamental
+#define HARMONIC_LEAK_BOUND 0.001       // Armónica ausente respecto de la fundamental
+
+static const double frequencies[] = {50.0, 50.7, 49.3, 50.3}; // Frecuencias de red de la prueba
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    host_signal.frequency = 50.0;
+    host_signal.third = 0.0;
+}
+
+void test_off_nominal_harmonics(void)
+{
+    for (unsigned k = 0; k < sizeof(frequencies) / sizeof(frequencies[0]); k++)
+    {
+        int channels = 0;
+
+        host_signal.frequency = frequencies[k];
+        host_signal.third = HARMONIC_THIRD * HARMONIC_AMPLITUDE;
+        for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+            host_signal.amplitude[c] = HARMONIC_AMPLITUDE;
+        host_begin();
+        for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        {
+            measure_set_channel_true_rms(i, true);
+            measure_set_channel_harmonics(i, (channelconfig[i].type == AC_CURRENT || channelconfig[i].type == AC_VOLTAGE) ? HARMONIC_MASK : 0);
+        }
+        host_run(3);
+
+        for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        {
+            HarmonicData data;
+            char message[160];
+
+            if (!measure_get_channel_harmonics(i))
+                continue;
+            TEST_ASSERT_NOT_EQUAL(0, measure_get_harmonics(i, &data));
+
+            // Con true_rms el valor eficaz del canal es el de la fundamental y la tercera juntas.
+            double fundamental = measure_get_channel_rms(i) / sqrt(1.0 + HARMONIC_THIRD * HARMONIC_THIRD);
+            snprintf(message, sizeof(message), "%.1f Hz, canal %d (%s): fundamental %.3f de %.3f, 2a %.4f, 3a %.4f, 4a %.4f, 5a %.4f", frequencies[k], i, channelconfig[i].name,
+                     data.harmonic[0], fundamental, data.harmonic[1] / data.harmonic[0], data.harmonic[2] / data.harmonic[0], data.harmonic[3] / data.harmonic[0], data.harmonic[4] / data.harmonic[0]);
+            TEST_MESSAGE(message);
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(HARMONIC_RATIO_BOUND * fundamental, fundamental, data.harmonic[0], message);
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(HARMONIC_RATIO_BOUND * HARMONIC_THIRD, HARMONIC_THIRD, data.harmonic[2] / data.harmonic[0], message);
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(HARMONIC_LEAK_BOUND, 0.0, data.harmonic[1] / data.harmonic[0], message);
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(HARMONIC_LEAK_BOUND, 0.0, data.harmonic[3] / data.harmonic[0], message);
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(HARMONIC_LEAK_BOUND, 0.0, data.harmonic[4] / data.harmonic[0], message);
+            channels++;
+        }
+        TEST_ASSERT_GREATER_THAN(0, channels);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_off_nominal_harmonics);
+    return (UNITY_END());
+}
@@ -0,0 +1,79 @@
+/**
+ * @file test_main.cpp
+ * @brief Grupos de IEC 61000-4-7 con la red fuera de 50 Hz
+ *
+ * La ventana de diez ciclos se cierra en cruces por cero y se remuestrea a la FFT, así que la
+ * fundamental y la tercera tienen que caer enteras en sus grupos aunque la red esté en 49.5 o
+ * 50.5 Hz y el lazo de la tasa esté apagado. La prueba mira la tensión L1: la tercera relativa a la
+ * fundamental contra la de la señal, y lo que se escapa a los grupos interarmónicos vecinos.
+ * Cortando la ventana en muestras enteras el escape era de 0.07% a 49.5 Hz y 0.33% a 50.5 Hz.
+ */
+#include <unity.h>
+#include "measure_host.h"
+
+#define IEC_FUNDAMENTAL 1500.0 // Amplitud de la fundamental en cuentas
+#define IEC_THIRD 150.0 // Amplitud de la tercera en cuentas, 10% de la fundamental
+#define IEC_MAX_RATIO_ERROR 0.005 // Error relativo admitido de tercera / fundamental
+#define IEC_MAX_LEAKAGE 0.0005 // Interarmónico vecino admitido, relativo a la fundamental
+
+/**
+ * @brief Grupos de la tensión L1 después de unos segundos de ventanas de ciclos a la frecuencia dada.
+ */
+static void iec_check(double frequency)
+{
+    measure_iec_groups_t groups;
+    int channel = 1;
+
+    host_signal.frequency = frequency;
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+        host_signal.amplitude[c] = IEC_FUNDAMENTAL;
+    host_signal.third = IEC_THIRD;
+    host_begin();
+    measure_set_window_mode(MEASURE_WINDOW_CYCLES);
+    measure_set_iec_harmonics(true);
+    host_run(30);
+
+    TEST_ASSERT_NOT_EQUAL(0, measure_get_iec_groups(channel, &groups));
+    TEST_ASSERT_NOT_EQUAL(0, groups.cycles);
+
+    double ratio = groups.harmonic[3] / groups.harmonic[1];
+    double leakage = fmax(groups.interharmonic[1], fmax(groups.interharmonic[2], groups.interharmonic[3])) / groups.harmonic[1];
+    char report[160];
+    snprintf(report, sizeof(report), "%.1f Hz: %d ciclos, tercera %.4f de la fundamental (señal %.4f), interarmónico vecino %.5f, THDG %.3f%%",
+             frequency, groups.cycles, ratio, IEC_THIRD / IEC_FUNDAMENTAL, leakage, groups.thd);
+    TEST_MESSAGE(report);
+    TEST_ASSERT_FLOAT_WITHIN(IEC_MAX_RATIO_ERROR * IEC_THIRD / IEC_FUNDAMENTAL, IEC_THIRD / IEC_FUNDAMENTAL, ratio);
+    TEST_ASSERT_LESS_THAN_FLOAT(IEC_MAX_LEAKAGE, leakage);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_iec_groups_below_nominal(void)
+{
+    iec_check(49.5);
+}
+
+void test_iec_groups_nominal(void)
+{
+    iec_check(50.0);
+}
+
+void test_iec_groups_above_nominal(void)
+{
+    iec_check(50.5);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_iec_groups_below_nominal);
+    RUN_TEST(test_iec_groups_nominal);
+    RUN_TEST(test_iec_groups_above_nominal);
+    return (UNITY_END());
+}
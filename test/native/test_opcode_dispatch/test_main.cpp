@@ -0,0 +1,334 @@
+/**
+ * @file test_main.cpp
+ * @brief Despacho de los opcodes extendidos: resultado y costo por bloque frente a los de siempre
+ *
+ * Los opcodes extendidos entran al switch del motor por muestras por el case NOP y van a
+ * measure_extended_op(). La prueba carga en la corriente L1 una cadena de diez bytes con STORE,
+ * SAMPLE_DELAY, CLAMP, SQRT e INTEGRATE y la compara muestra a muestra con la misma cuenta hecha
+ * aparte. El costo por opcode se compara con el intérprete del firmware original, copiado acá tal
+ * cual decodificaba los diez bytes de channelconfig[].operation[] en cada muestra: con el mismo
+ * programa de diez opcodes de siempre, lo que agregan los nueve que siguen a GET_ADC por muestra no
+ * puede pasar de DISPATCH_COST_BOUND veces lo que agregaban en el intérprete original. La cadena extendida no corre en el
+ * intérprete original: el reporte da su costo por opcode, que incluye la raíz y la línea de retardo.
+ * Un programa en texto más largo que MEASURE_PROGRAM_MAX se rechaza entero, sin cortarlo.
+ */
+#include <unity.h>
+#include <chrono>
+#include "measure_host.h"
+
+#define DISPATCH_DELAY 3          // Retardo de SAMPLE_DELAY en la cadena extendida
+#define DISPATCH_COST_BOUND 1.25  // Costo por opcode admitido respecto del intérprete original, con margen para el reloj del host
+#define DISPATCH_ROUNDS 9         // Vueltas intercaladas de cada medición, vale la mejor
+
+#ifndef MEASURE_FIXED_POINT
+static uint16_t adc[VIRTUAL_ADC_CHANNELS][numbersOfSamples];
+
+/**
+ * @brief Mejor tiempo por bloque en microsegundos de varias repeticiones del motor por muestras.
+ */
+static double bench_block_us(void)
+{
+    double best = 1e30;
+
+    for (int repeat = 0; repeat < 50; repeat++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int block = 0; block < 20; block++)
+            measure_process_sample_major(adc_extended, numbersOfSamples);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 20;
+        if (us < best)
+            best = us;
+    }
+    return (best);
+}
+
+static float baseline_sample[VIRTUAL_CHANNELS];        // adc_sample[] del intérprete original
+static float baseline_temp[VIRTUAL_CHANNELS];          // temp_adc_sample[] del intérprete original
+static float baseline_last[VIRTUAL_CHANNELS];          // last_adc_sample[] del pasa alto
+static float baseline_filtered[VIRTUAL_CHANNELS];      // last_ac_filtered[] del pasa alto
+static float baseline_box[VIRTUAL_CHANNELS][64];       // dc_filtered[] de la media móvil
+static uint16_t baseline_buffer[numbersOfSamples];     // buffer[] del canal 0
+static uint8_t baseline_operation[MAX_MICROCODE_OPS];  // channelconfig[0].operation[] del firmware original
+static volatile float baseline_sink;                   // Que el compilador no descarte el resultado
+
+/**
+ * @brief Un bloque del canal 0 con el intérprete del firmware original: los diez bytes de
+ * baseline_operation[] se decodifican en cada muestra y cada uno recalcula los desfases, como en
+ * measure_mes(). El programa se lee de memoria como el de channelconfig[], no como constante.
+ */
+static void __attribute__((noinline)) baseline_block(void)
+{
+    const int i = 0;
+
+    for (int n = 0; n < numbersOfSamples; n++)
+    {
+        for (int op = 0; op < MAX_MICROCODE_OPS; op++)
+        {
+            int phaseshift_0_degree = calculate_phaseshift(channelconfig[i].phaseshift, n, numbersOfSamples);
+            if (phaseshift_0_degree == numbersOfSamples - 1)
+                phaseshift_0_degree = 0;
+            int phaseshift_90_degree = ((numbersOfSamples / 2) / 360.0) * ((channelconfig[i].phaseshift + 90) % 360);
+            phaseshift_90_degree = (n + phaseshift_90_degree) % numbersOfSamples;
+            if (phaseshift_90_degree == numbersOfSamples - 1)
+                phaseshift_90_degree = 0;
+
+            int op_channel = baseline_operation[op] & ~OPMASK;
+            if (op_channel >= VIRTUAL_CHANNELS)
+                continue;
+
+            switch (baseline_operation[op] & OPMASK)
+            {
+            case ADD:
+                baseline_sample[i] += baseline_sample[op_channel];
+                break;
+            case SUB:
+                baseline_sample[i] -= baseline_sample[op_channel];
+                break;
+            case MUL:
+                baseline_sample[i] *= baseline_sample[op_channel];
+                break;
+            case MUL_RATIO:
+                baseline_sample[i] *= channelconfig[op_channel].ratio;
+                break;
+            case MUL_SIGN:
+                baseline_sample[i] *= (baseline_sample[op_channel] > 0.0) ? 1.0 : -1.0;
+                break;
+            case MUL_REACTIVE:
+                baseline_temp[i] = baseline_buffer[phaseshift_90_degree] - 2048.0;
+                baseline_sample[i] *= (baseline_temp[i] > 0.0) ? 1.0 : -1.0;
+                break;
+            case ABS:
+                baseline_sample[i] = fabs(baseline_sample[i]);
+                break;
+            case NEG:
+                baseline_sample[i] = -baseline_sample[i];
+                break;
+            case PASS_NEGATIVE:
+                if (baseline_sample[i] > 0.0)
+                    baseline_sample[i] = 0.0;
+                break;
+            case PASS_POSITIVE:
+                if (baseline_sample[i] < 0.0)
+                    baseline_sample[i] = 0.0;
+                break;
+            case GET_ADC:
+                if (op_channel >= 0 && op_channel < VIRTUAL_ADC_CHANNELS)
+                    baseline_sample[i] = adc[op_channel][phaseshift_0_degree];
+                break;
+            case SET_TO:
+                baseline_sample[i] = op_channel;
+                break;
+            case FILTER:
+            {
+                float filtered = 0.9989 * (baseline_filtered[i] + baseline_sample[i] - baseline_last[i]);
+                baseline_filtered[i] = filtered;
+                baseline_last[i] = baseline_sample[i];
+                baseline_sample[i] = filtered;
+                if (op_channel)
+                {
+                    int mul = (op_channel <= 6) ? (1 << op_channel) : 12;
+                    float sum = 0.0;
+                    baseline_box[i][n % mul] = baseline_sample[i];
+                    for (int j = 0; j < mul; j++)
+                        sum += baseline_box[i][j];
+                    baseline_sample[i] = sum / mul;
+                }
+                break;
+            }
+            case NOP:
+                break;
+            default:
+                op = MAX_MICROCODE_OPS;
+                break;
+            }
+        }
+        baseline_buffer[n] = (baseline_sample[i] + 2048 < 0.0) ? 0 : (baseline_sample[i] * measure_get_channel_ratio(i)) + 2048;
+    }
+    baseline_sink = baseline_sample[i];
+}
+
+/**
+ * @brief Mejor tiempo por bloque en microsegundos del intérprete original con un programa.
+ */
+static double bench_baseline_us(const uint8_t *operation)
+{
+    double best = 1e30;
+
+    memcpy(baseline_operation, operation, sizeof(baseline_operation));
+    for (int repeat = 0; repeat < 50; repeat++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int block = 0; block < 20; block++)
+            baseline_block();
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 20;
+        if (us < best)
+            best = us;
+    }
+    return (best);
+}
+
+/**
+ * @brief Carga el programa del canal 0 y rearma la lista de canales como lo hace measure_mes().
+ */
+static void load_program(const char *program)
+{
+    char error[64];
+
+    TEST_ASSERT_TRUE_MESSAGE(measure_set_channel_opcodeseq_str(0, program, error, sizeof(error)), error);
+    host_run(1);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_extended_chain_matches_reference(void)
+{
+    static float history[numbersOfSamples + DISPATCH_DELAY];
+    float sample_period = VIRTUAL_ADC_CHANNELS / measure_sample_rate();
+    float integral = 0.0;
+
+    host_begin();
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        measure_set_channel_harmonics(i, 0);
+    measure_set_phasor_harmonics(0);
+    // GET_ADC 0, STORE r0, SAMPLE_DELAY 3, CLAMP r0, SQRT, INTEGRATE r1
+    load_program("50410046034710444501");
+
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+        for (int n = 0; n < numbersOfSamples; n++)
+            adc[c][n] = (2048 + 1500 * sin(2 * M_PI * n * 2 / numbersOfSamples + c)) * (1 << ADCCAL_FRACTION_BITS);
+    measure_extend_adc(adc, false);
+    memset(channel_register, 0, sizeof(channel_register));
+    memset(delay_line, 0, sizeof(delay_line));
+    memset(delay_pos, 0, sizeof(delay_pos));
+    memset(history, 0, sizeof(history));
+    measure_process_sample_major(adc_extended, numbersOfSamples);
+
+    for (int n = 0; n < numbersOfSamples; n++)
+    {
+        float x = measure_adc_value(adc_extended[0] + MEASURE_ADC_HEAD, n + channel_phase[0].offset_0, &channel_phase[0]);
+        float value = history[n];
+        float limit = fabsf(x);
+        char message[32];
+
+        history[n + DISPATCH_DELAY] = x;
+        value = (value > limit) ? limit : (value < -limit) ? -limit : value;
+        value = (value > 0.0) ? sqrtf(value) : 0.0;
+        integral += value * sample_period;
+
+        uint16_t expected = (integral + 2048 < 0.0) ? 0 : (integral * measure_get_channel_ratio(0)) + 2048;
+        snprintf(message, sizeof(message), "muestra %d", n);
+        TEST_ASSERT_EQUAL_UINT16_MESSAGE(expected, buffer[0][n], message);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(integral, channel_register[0][1]);
+}
+
+void test_dispatch_cost(void)
+{
+    host_begin();
+    // Sólo queda vivo L1, así el bloque es casi todo el programa medido.
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        measure_set_channel_harmonics(i, 0);
+        if (i)
+            measure_set_channel_type(i, NO_CHANNEL_TYPE);
+    }
+    measure_set_phasor_harmonics(0);
+    host_run(1);
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+        for (int n = 0; n < numbersOfSamples; n++)
+            adc[c][n] = (2048 + 1500 * sin(2 * M_PI * n * 2 / numbersOfSamples + c)) * (1 << ADCCAL_FRACTION_BITS);
+    measure_extend_adc(adc, false);
+
+    // Sólo GET_ADC: lo que cuesta el resto del canal, que no es despacho.
+    static const uint8_t single[MAX_MICROCODE_OPS] = {GET_ADC | CHANNEL_0};
+    // Diez opcodes de siempre: GET_ADC, ABS, NEG, MUL_RATIO, ABS, NEG, PASS_POSITIVE, NEG, PASS_NEGATIVE, ABS
+    static const uint8_t legacy[MAX_MICROCODE_OPS] = {GET_ADC | CHANNEL_0, ABS, NEG, MUL_RATIO, ABS, NEG, PASS_POSITIVE, NEG, PASS_NEGATIVE, ABS};
+
+    double baseline_single_us = 1e30, baseline_legacy_us = 1e30;
+    double single_us = 1e30, legacy_us = 1e30, extended_us = 1e30;
+
+    // Las mediciones se intercalan para que una racha del host no caiga sobre una sola.
+    for (int round = 0; round < DISPATCH_ROUNDS; round++)
+    {
+        baseline_single_us = fmin(baseline_single_us, bench_baseline_us(single));
+        baseline_legacy_us = fmin(baseline_legacy_us, bench_baseline_us(legacy));
+        load_program("50");
+        single_us = fmin(single_us, bench_block_us());
+        load_program("50a0d080a0d0f0d0e0a0");
+        legacy_us = fmin(legacy_us, bench_block_us());
+        // Diez bytes con extendidos: GET_ADC, STORE, SAMPLE_DELAY, CLAMP, SQRT, INTEGRATE
+        load_program("50410046034710444501");
+        extended_us = fmin(extended_us, bench_block_us());
+    }
+
+    // Nanosegundos por opcode y por muestra de lo que sigue a GET_ADC.
+    double baseline_op_ns = (baseline_legacy_us - baseline_single_us) * 1e3 / (9 * numbersOfSamples);
+    double legacy_op_ns = (legacy_us - single_us) * 1e3 / (9 * numbersOfSamples);
+    double extended_op_ns = (extended_us - single_us) * 1e3 / (5 * numbersOfSamples);
+
+    char report[256];
+    snprintf(report, sizeof(report), "%d canales por bloque, L1 sólo con GET_ADC %.1f us; por opcode: intérprete original %.2f ns, plan con los de siempre %.2f ns, plan con extendidos %.2f ns",
+             channel_work.len, single_us, baseline_op_ns, legacy_op_ns, extended_op_ns);
+    TEST_MESSAGE(report);
+    TEST_ASSERT_TRUE_MESSAGE(legacy_op_ns <= DISPATCH_COST_BOUND * baseline_op_ns, report);
+}
+#else
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_extended_chain_matches_reference(void)
+{
+    TEST_IGNORE_MESSAGE("el motor de punto fijo no ejecuta los opcodes extendidos");
+}
+
+void test_dispatch_cost(void)
+{
+    TEST_IGNORE_MESSAGE("el motor de punto fijo no ejecuta los opcodes extendidos");
+}
+#endif
+
+void test_long_program_rejected(void)
+{
+    char text[2 * (MEASURE_PROGRAM_MAX + 2) + 1];
+    char before[2 * MEASURE_PROGRAM_MAX + 1];
+    char after[2 * MEASURE_PROGRAM_MAX + 1];
+    char error[64] = "";
+
+    host_begin();
+    measure_get_channel_opcodeseq_str(0, sizeof(before), before);
+
+    // GET_ADC y MEASURE_PROGRAM_MAX ABS: un byte de más no se corta, se rechaza todo.
+    strcpy(text, "50");
+    for (int op = 0; op < MEASURE_PROGRAM_MAX; op++)
+        strcat(text, "a0");
+    TEST_ASSERT_FALSE(measure_set_channel_opcodeseq_str(0, text, error, sizeof(error)));
+    TEST_ASSERT_NOT_NULL(strstr(error, "más de"));
+    TEST_ASSERT_EQUAL_STRING(before, measure_get_channel_opcodeseq_str(0, sizeof(after), after));
+
+    // Con el máximo justo y BRK de relleno detrás sí entra.
+    text[2 * MEASURE_PROGRAM_MAX] = '\0';
+    strcat(text, "0000");
+    TEST_ASSERT_TRUE_MESSAGE(measure_set_channel_opcodeseq_str(0, text, error, sizeof(error)), error);
+    text[2 * MEASURE_PROGRAM_MAX] = '\0';
+    TEST_ASSERT_EQUAL_STRING(text, measure_get_channel_opcodeseq_str(0, sizeof(after), after));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_extended_chain_matches_reference);
+    RUN_TEST(test_dispatch_cost);
+    RUN_TEST(test_long_program_rejected);
+    return (UNITY_END());
+}
@@ -0,0 +1,189 @@
+/**
+ * @file test_main.cpp
+ * @brief Sobremuestreo del ADC: respuesta del diezmador, piso de ruido y RMS de la señal
+ *
+ * La primera prueba pasa senoidales por decimator_push() a x2 y x4, con 6400 muestras por segundo a
+ * la salida como un canal de la medición, y mide la salida con una DFT de un segundo: la banda de
+ * las armónicas pierde menos de DECIMATOR_PASSBAND_DB y lo que se plegaría sobre ella queda por
+ * debajo de DECIMATOR_STOPBAND_DB. Las otras corren la medición entera con el sobremuestreo cargado
+ * de la configuración: con sólo ruido en los pines el RMS de las corrientes baja cerca de 3 dB por
+ * cada duplicación, y con señal el RMS no se aparta del de sin sobremuestreo.
+ */
+#include <unity.h>
+#include "measure_host.h"
+
+#define DECIMATOR_RATE 6400           // Muestras por segundo a la salida
+#define DECIMATOR_PASSBAND 2500       // Última frecuencia de la banda de las armónicas
+#define DECIMATOR_PASSBAND_DB 0.1     // Pérdida admitida en la banda
+#define DECIMATOR_STOPBAND 4000       // Primera frecuencia que se pliega dentro de 2.4 kHz
+#define DECIMATOR_STOPBAND_DB -60.0   // Atenuación mínima de lo que se pliega
+#define NOISE_AMPLITUDE 8.0           // Ruido pico a pico en los pines, en cuentas
+#define NOISE_GAIN_X2_DB -2.3         // Cambio máximo del piso de ruido a x2: -3 dB menos lo que pasa por la banda de transición
+#define NOISE_GAIN_X4_DB -4.8         // Cambio máximo del piso de ruido a x4: -6 dB menos lo que pasa por la banda de transición
+#define SIGNAL_RMS_BOUND 1e-4         // Error relativo del RMS con sobremuestreo frente a x1
+
+static int oversampling = 1; // Factor que toma la configuración en host_begin()
+
+/**
+ * @brief Ganancia en dB del diezmador de factor dado a una senoidal de frequency Hz en la entrada.
+ */
+static double decimator_gain_db(int factor, double frequency)
+{
+    decimator_design_t design;
+    decimator_t state;
+    double amplitude = 16000.0;
+    double re = 0.0, im = 0.0;
+    int out = 0;
+    // La senoidal a la salida, plegada si pasa de la mitad de la tasa; una cantidad entera de ciclos en el segundo.
+    double folded = fabs(frequency - DECIMATOR_RATE * lround(frequency / DECIMATOR_RATE));
+
+    decimator_design(&design, factor);
+    decimator_reset(&state);
+    for (long n = 0; out < 2 * DECIMATOR_RATE; n++)
+    {
+        uint16_t x = lround(DECIMATOR_MIDSCALE + amplitude * sin(2.0 * M_PI * frequency * n / (DECIMATOR_RATE * factor)));
+        uint16_t y;
+
+        if (!decimator_push(&state, &design, x, &y))
+            continue;
+        // El primer segundo llena la historia.
+        if (out++ < DECIMATOR_RATE)
+            continue;
+        re += (y - DECIMATOR_MIDSCALE) * cos(2.0 * M_PI * folded * out / DECIMATOR_RATE);
+        im += (y - DECIMATOR_MIDSCALE) * sin(2.0 * M_PI * folded * out / DECIMATOR_RATE);
+    }
+    return (20.0 * log10(2.0 * sqrt(re * re + im * im) / DECIMATOR_RATE / amplitude));
+}
+
+/**
+ * @brief Como si measure.json tuviera el sobremuestreo de la prueba.
+ */
+static void load_oversampling(void)
+{
+    measure_config.oversampling = oversampling;
+}
+
+/**
+ * @brief RMS de cada canal tras cuatro segundos con el sobremuestreo dado.
+ */
+static void measure_rms(int factor, float *rms)
+{
+    oversampling = factor;
+    host_on_load = load_oversampling;
+    host_begin();
+    host_on_load = NULL;
+    TEST_ASSERT_EQUAL_INT(factor, adc_oversampling);
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        if (channelconfig[i].type == AC_CURRENT || channelconfig[i].type == AC_VOLTAGE)
+            measure_set_channel_true_rms(i, true);
+    host_run(4);
+
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        rms[i] = channelconfig[i].rms;
+}
+
+/**
+ * @brief Cambio en dB del RMS de ruido de las corrientes con el factor dado frente a x1, el peor de todas.
+ *
+ * Las tensiones llevan la fundamental, sin ella el bloque no tiene frecuencia y no se publica.
+ */
+static double noise_gain_db(int factor)
+{
+    float base[VIRTUAL_CHANNELS];
+    float rms[VIRTUAL_CHANNELS];
+    double worst = -1e9;
+
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        uint16_t count;
+        const uint8_t *program = measure_get_channel_opcodeseq(i, &count);
+
+        if (channelconfig[i].type == AC_VOLTAGE && count && (program[0] & OPMASK) == GET_ADC)
+            host_signal.amplitude[program[0] & ~OPMASK] = 1000.0;
+    }
+    host_signal.noise = NOISE_AMPLITUDE;
+    measure_rms(1, base);
+    measure_rms(factor, rms);
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        if (channelconfig[i].type == AC_CURRENT)
+            worst = fmax(worst, 20.0 * log10(rms[i] / base[i]));
+
+    char report[64];
+    snprintf(report, sizeof(report), "x%d: piso de ruido %+.2f dB", factor, worst);
+    TEST_MESSAGE(report);
+    return (worst);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_decimator_response(void)
+{
+    for (int factor = 2; factor <= DECIMATOR_MAX_FACTOR; factor *= 2)
+    {
+        double passband = decimator_gain_db(factor, DECIMATOR_PASSBAND);
+        double stopband = -1e9;
+
+        for (int frequency = DECIMATOR_STOPBAND; frequency < DECIMATOR_RATE * factor / 2; frequency += 100)
+            if (fabs(frequency - DECIMATOR_RATE * lround((double)frequency / DECIMATOR_RATE)) <= DECIMATOR_PASSBAND)
+                stopband = fmax(stopband, decimator_gain_db(factor, frequency));
+
+        char report[96];
+        snprintf(report, sizeof(report), "x%d: %.3f dB en %d Hz, %.1f dB como máximo plegado", factor, passband, DECIMATOR_PASSBAND, stopband);
+        TEST_MESSAGE(report);
+        TEST_ASSERT_GREATER_THAN_FLOAT(-DECIMATOR_PASSBAND_DB, passband);
+        TEST_ASSERT_LESS_THAN_FLOAT(DECIMATOR_STOPBAND_DB, stopband);
+    }
+}
+
+void test_noise_floor_x2(void)
+{
+    TEST_ASSERT_LESS_THAN_FLOAT(NOISE_GAIN_X2_DB, noise_gain_db(2));
+}
+
+void test_noise_floor_x4(void)
+{
+    TEST_ASSERT_LESS_THAN_FLOAT(NOISE_GAIN_X4_DB, noise_gain_db(4));
+}
+
+void test_signal_rms_unchanged(void)
+{
+    float base[VIRTUAL_CHANNELS];
+    float rms[VIRTUAL_CHANNELS];
+
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+    {
+        host_signal.amplitude[c] = 1200.0 - 100.0 * c;
+        host_signal.phase[c] = 0.4 * c;
+    }
+    host_signal.third = 80.0;
+    // Con algo de ruido el redondeo del ADC a x1 no deja un sesgo en el RMS.
+    host_signal.noise = 2.0;
+    measure_rms(1, base);
+    measure_rms(DECIMATOR_MAX_FACTOR, rms);
+
+    double worst = 0.0;
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        if (channelconfig[i].type == AC_CURRENT || channelconfig[i].type == AC_VOLTAGE)
+            worst = fmax(worst, fabs(rms[i] - base[i]) / base[i]);
+
+    char report[64];
+    snprintf(report, sizeof(report), "x%d: error de RMS %.2e", DECIMATOR_MAX_FACTOR, worst);
+    TEST_MESSAGE(report);
+    TEST_ASSERT_LESS_THAN_FLOAT(SIGNAL_RMS_BOUND, worst);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_decimator_response);
+    RUN_TEST(test_noise_floor_x2);
+    RUN_TEST(test_noise_floor_x4);
+    RUN_TEST(test_signal_rms_unchanged);
+    return (UNITY_END());
+}
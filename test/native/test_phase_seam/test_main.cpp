@@ -0,0 +1,84 @@
+/**
+ * @file test_main.cpp
+ * @brief Desfase de GET_ADC fuera de la frecuencia nominal, sin salto donde termina el bloque
+ *
+ * Con 90° de desfase GET_ADC lee 32 muestras más allá del bloque. Sin el lazo de la tasa, a 49.5 o
+ * 50.5 Hz el bloque no tiene dos ciclos enteros y rotarlo dejaba un salto de fase de unos 7° en la
+ * muestra 224 del canal. En una senoidal bien muestreada la diferencia segunda entre muestras
+ * seguidas es casi nula, así que la prueba busca la mayor en el buffer de la corriente L1, en el
+ * último bloque de cada segundo: el salto de antes daba 11 cuentas.
+ */
+#include <unity.h>
+#include "measure_host.h"
+
+#define SEAM_PHASESHIFT 90 // Grados de desfase del canal 0
+#define SEAM_MAX_CURVATURE 3 // Diferencia segunda admitida: dos cuentas de redondeo del buffer y la curvatura de la senoidal
+
+/**
+ * @brief Mayor diferencia segunda del canal 0 en el último bloque de ocho segundos seguidos.
+ */
+static int seam_curvature(double frequency)
+{
+    int worst = 0;
+
+    host_signal.frequency = frequency;
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+        host_signal.amplitude[c] = 1500.0;
+    host_begin();
+    measure_set_channel_phaseshift(0, SEAM_PHASESHIFT);
+    host_run(2);
+
+    for (int second = 0; second < 8; second++)
+    {
+        host_run(1);
+        for (int n = 2; n < numbersOfSamples; n++)
+        {
+            int curvature = abs(buffer[0][n] - 2 * buffer[0][n - 1] + buffer[0][n - 2]);
+            if (curvature > worst)
+                worst = curvature;
+        }
+    }
+
+    char report[96];
+    snprintf(report, sizeof(report), "%.1f Hz: diferencia segunda máxima %d cuentas", frequency, worst);
+    TEST_MESSAGE(report);
+    return (worst);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_seam_below_nominal(void)
+{
+    TEST_ASSERT_LESS_OR_EQUAL(SEAM_MAX_CURVATURE, seam_curvature(49.5));
+}
+
+void test_seam_above_nominal(void)
+{
+    TEST_ASSERT_LESS_OR_EQUAL(SEAM_MAX_CURVATURE, seam_curvature(50.5));
+}
+
+void test_seam_block_engine(void)
+{
+#ifdef MEASURE_FIXED_POINT
+    TEST_IGNORE_MESSAGE("el motor de bloques no existe con MEASURE_FIXED_POINT");
+#else
+    measure_set_dsp_mode(MEASURE_DSP_BLOCK);
+    TEST_ASSERT_LESS_OR_EQUAL(SEAM_MAX_CURVATURE, seam_curvature(49.5));
+    measure_set_dsp_mode(MEASURE_DSP_SAMPLE_MAJOR);
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_seam_below_nominal);
+    RUN_TEST(test_seam_above_nominal);
+    RUN_TEST(test_seam_block_engine);
+    return (UNITY_END());
+}
@@ -0,0 +1,173 @@
+/**
+ * @file test_main.cpp
+ * @brief Fasores de la DFT deslizante: módulo, ángulo y un resultado por ciclo de red
+ *
+ * Las tensiones y corrientes son senoidales puras, con las corrientes atrasadas PHASOR_LAG grados y
+ * sin el desfase de calibración de fábrica. Los canales quedan sin true_rms, así channelconfig[].rms
+ * es el valor medio rectificado: el módulo de la fundamental tiene que ser ese valor por
+ * pi / ( 2 raíz de 2 ), el valor eficaz de la senoidal. Con una tercera armónica, su módulo sobre el
+ * de la fundamental tiene que dar la relación de amplitudes y su ángulo respecto de la tercera de
+ * la tensión del grupo tres veces el atraso. Cada bloque publica dos ciclos con su número y con marcas de tiempo separadas un
+ * período de red.
+ */
+#include <unity.h>
+#include "measure_host.h"
+
+#define PHASOR_LAG 30.0                 // Atraso de las corrientes en grados
+#define PHASOR_AMPLITUDE 1000.0         // Amplitud de todos los canales en cuentas
+#define PHASOR_THIRD 100.0              // Amplitud de la tercera armónica en cuentas
+#define PHASOR_MAGNITUDE_BOUND 0.005    // Error relativo del módulo
+#define PHASOR_ANGLE_BOUND 0.5          // Error del ángulo en grados
+#define PHASOR_PERIOD_BOUND 0.01        // Error relativo entre marcas de tiempo de ciclos seguidos
+
+static uint32_t counted_blocks = 0; // Bloques procesados, para contar las publicaciones
+
+static void count_block(void)
+{
+    counted_blocks++;
+}
+
+/**
+ * @brief Arranca con todos los canales en fase salvo las corrientes, atrasadas PHASOR_LAG grados.
+ */
+static void phasor_signal(double third, uint16_t harmonics)
+{
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+    {
+        host_signal.amplitude[c] = PHASOR_AMPLITUDE;
+        host_signal.phase[c] = 0.0;
+    }
+    host_signal.third = third;
+    host_begin();
+    measure_set_phasor_harmonics(harmonics);
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        uint16_t count;
+        const uint8_t *program = measure_get_channel_opcodeseq(i, &count);
+
+        measure_set_channel_phaseshift(i, 0);
+        if (channelconfig[i].type == AC_CURRENT && count && (program[0] & OPMASK) == GET_ADC)
+            host_signal.phase[program[0] & ~OPMASK] = -PHASOR_LAG * M_PI / 180.0;
+    }
+    // Una ventana para el factor de escala y otra para que lo usen los fasores.
+    host_run(3);
+}
+
+/**
+ * @brief Ángulo esperado de la armónica h de un canal.
+ */
+static double phasor_expected_angle(int channel, int h)
+{
+    double angle = (channelconfig[channel].type == AC_CURRENT) ? -h * PHASOR_LAG : 0.0;
+
+    return (remainder(angle, 360.0));
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    host_signal.third = 0.0;
+    host_on_block = NULL;
+}
+
+void test_fundamental_magnitude_and_angle(void)
+{
+    int channels = 0;
+
+    phasor_signal(0.0, 0x0001);
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        measure_phasor_t phasor;
+        char message[128];
+
+        if (channelconfig[i].type != AC_CURRENT && channelconfig[i].type != AC_VOLTAGE)
+            continue;
+        TEST_ASSERT_NOT_EQUAL(0, measure_get_channel_phasor(i, 1, &phasor));
+
+        double rms = measure_get_channel_rms(i) * M_PI / (2.0 * sqrt(2.0));
+        snprintf(message, sizeof(message), "canal %d (%s): %.3f a %.2f grados, eficaz %.3f", i, channelconfig[i].name, phasor.magnitude, phasor.angle, rms);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(PHASOR_MAGNITUDE_BOUND * rms, rms, phasor.magnitude, message);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(PHASOR_ANGLE_BOUND, phasor_expected_angle(i, 1), phasor.angle, message);
+        channels++;
+    }
+    TEST_ASSERT_GREATER_THAN(0, channels);
+}
+
+void test_third_harmonic(void)
+{
+    int channels = 0;
+
+    phasor_signal(PHASOR_THIRD, 0x0005);
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        measure_phasor_t fundamental, third, voltage_third;
+        char message[128];
+
+        if (channelconfig[i].type != AC_CURRENT)
+            continue;
+        int voltage = measure_get_channel_with_group_id_and_type(channelconfig[i].group_id, AC_VOLTAGE);
+        if (voltage < 0)
+            continue;
+        uint32_t cycle = measure_get_channel_phasor(i, 1, &fundamental);
+        TEST_ASSERT_EQUAL_UINT32(cycle, measure_get_channel_phasor_cycle(i, 3, cycle, &third, NULL));
+        TEST_ASSERT_EQUAL_UINT32(cycle, measure_get_channel_phasor_cycle(voltage, 3, cycle, &voltage_third, NULL));
+
+        // El filtro de continua adelanta distinto a cada armónica: se compara con la tensión del grupo.
+        double angle = remainder(third.angle - voltage_third.angle, 360.0);
+        snprintf(message, sizeof(message), "canal %d (%s): tercera %.4f de la fundamental, %.2f grados de la tensión", i, channelconfig[i].name, third.magnitude / fundamental.magnitude, angle);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(PHASOR_MAGNITUDE_BOUND * 2, PHASOR_THIRD / PHASOR_AMPLITUDE, third.magnitude / fundamental.magnitude, message);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(PHASOR_ANGLE_BOUND * 3, phasor_expected_angle(i, 3), angle, message);
+        channels++;
+    }
+    TEST_ASSERT_GREATER_THAN(0, channels);
+}
+
+void test_one_result_per_cycle(void)
+{
+    measure_phasor_t phasor;
+    int64_t timestamp[MEASURE_PHASOR_RING];
+    int channel = measure_reference_channel();
+
+    phasor_signal(0.0, 0x0001);
+    TEST_ASSERT_TRUE(channel >= 0);
+
+    // Cada bloque publica sus dos ciclos: la versión avanza dos por bloque, cincuenta por segundo.
+    uint32_t first = measure_get_channel_phasor(channel, 1, &phasor);
+    counted_blocks = 0;
+    host_on_block = count_block;
+    host_run(1);
+    host_on_block = NULL;
+    uint32_t last = measure_get_channel_phasor(channel, 1, &phasor);
+    TEST_ASSERT_EQUAL_UINT32(MEASURE_PHASOR_CYCLES * counted_blocks, last - first);
+
+    // Los ciclos del anillo se leen uno por uno, separados un período de red.
+    for (int k = 0; k < MEASURE_PHASOR_RING; k++)
+        TEST_ASSERT_EQUAL_UINT32(last - k, measure_get_channel_phasor_cycle(channel, 1, last - k, &phasor, &timestamp[k]));
+    for (int k = 1; k < MEASURE_PHASOR_RING; k++)
+    {
+        double period_us = 1e6 / host_signal.frequency;
+        char message[64];
+
+        snprintf(message, sizeof(message), "ciclo %u: %lld us", (unsigned)(last - k), (long long)(timestamp[k - 1] - timestamp[k]));
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(PHASOR_PERIOD_BOUND * period_us, period_us, (double)(timestamp[k - 1] - timestamp[k]), message);
+    }
+    TEST_ASSERT_TRUE(timestamp[0] <= esp_timer_get_time());
+
+    // Un ciclo que ya salió del anillo o que no se publicó no se copia.
+    TEST_ASSERT_EQUAL_UINT32(0, measure_get_channel_phasor_cycle(channel, 1, last - MEASURE_PHASOR_RING, &phasor, NULL));
+    TEST_ASSERT_EQUAL_UINT32(0, measure_get_channel_phasor_cycle(channel, 1, last + 1, &phasor, NULL));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fundamental_magnitude_and_angle);
+    RUN_TEST(test_third_harmonic);
+    RUN_TEST(test_one_result_per_cycle);
+    return (UNITY_END());
+}
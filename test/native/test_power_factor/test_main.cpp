@@ -0,0 +1,97 @@
+/**
+ * @file test_main.cpp
+ * @brief Potencia aparente, factor de potencia y reactiva con la corriente atrasada
+ *
+ * Los canales de tensión y corriente quedan con la configuración de fábrica, sin true_rms, así
+ * channelconfig[].rms es el valor medio rectificado. La aparente igual tiene que salir de los
+ * valores eficaces: con senoidales puras y la corriente atrasada un ángulo phi, el factor de
+ * potencia de cada grupo tiene que ser cos(phi) y la reactiva sobre la activa tan(phi).
+ */
+#include <unity.h>
+#include "measure_host.h"
+
+#define POWER_FACTOR_BOUND 0.005 // Error absoluto del factor de potencia
+#define REACTIVE_RATIO_BOUND 0.01 // Error relativo de Q / P, 1% por el retardo de un cuarto de ciclo
+
+/**
+ * @brief Corre la medición con las corrientes atrasadas lag grados y compara cada grupo.
+ *
+ * @return int grupos con potencia
+ */
+static int power_check(double lag)
+{
+    double phi = lag * M_PI / 180.0;
+    int groups = 0;
+
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+    {
+        host_signal.amplitude[c] = 1000.0;
+        host_signal.phase[c] = 0.0;
+    }
+    host_begin();
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        uint16_t count;
+        const uint8_t *program = measure_get_channel_opcodeseq(i, &count);
+
+        // Sin el desfase de calibración de las tensiones, el ángulo es sólo el de la señal.
+        measure_set_channel_phaseshift(i, 0);
+        if (channelconfig[i].type == AC_CURRENT && count && (program[0] & OPMASK) == GET_ADC)
+            host_signal.phase[program[0] & ~OPMASK] = -phi;
+    }
+    host_run(3);
+
+    for (int g = 0; g < MAX_GROUPS; g++)
+    {
+        measure_group_power_t power;
+        char message[128];
+
+        if (!measure_get_group_power(g, &power) || power.active == 0.0 || power.apparent == 0.0)
+            continue;
+        snprintf(message, sizeof(message), "%.0f grados, grupo %d: P %.1f, Q %.1f, S %.1f, fp %.4f", lag, g, power.active, power.reactive, power.apparent, power.power_factor);
+        TEST_MESSAGE(message);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(POWER_FACTOR_BOUND, cos(phi), power.power_factor, message);
+        if (lag > 0.0)
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(REACTIVE_RATIO_BOUND * tan(phi), tan(phi), power.reactive / power.active, message);
+        groups++;
+    }
+    return (groups);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_unity_power_factor(void)
+{
+    TEST_ASSERT_GREATER_THAN(0, power_check(0.0));
+}
+
+void test_lag_30(void)
+{
+    TEST_ASSERT_GREATER_THAN(0, power_check(30.0));
+}
+
+void test_lag_60(void)
+{
+    TEST_ASSERT_GREATER_THAN(0, power_check(60.0));
+}
+
+void test_lag_80(void)
+{
+    TEST_ASSERT_GREATER_THAN(0, power_check(80.0));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_unity_power_factor);
+    RUN_TEST(test_lag_30);
+    RUN_TEST(test_lag_60);
+    RUN_TEST(test_lag_80);
+    return (UNITY_END());
+}
@@ -0,0 +1,152 @@
+/**
+ * @file test_main.cpp
+ * @brief Perfil de instalación compilado: espectro por tipo de canal y costo por bloque
+ *
+ * Corre en native (tres fases), native_1p y native_3pn. La primera prueba comprueba que el
+ * espectro del osciloscopio se calcula para todas las corrientes y tensiones del perfil, con la
+ * fundamental en el bin 3, y que los demás canales quedan en cero. La segunda reporta, para el
+ * perfil compilado, el tiempo por bloque de cada motor con los programas de fábrica y la RAM de
+ * los buffers que crecen con los canales.
+ */
+#include <unity.h>
+#include <chrono>
+#include "measure_host.h"
+
+#define SPECTRUM_FUNDAMENTAL_BIN 3 // Tres ciclos en la ventana del espectro
+
+#if MEASURE_PROFILE == MEASURE_PROFILE_1P
+    #define PROFILE_NAME "1P"
+#elif MEASURE_PROFILE == MEASURE_PROFILE_3P
+    #define PROFILE_NAME "3P"
+#else
+    #define PROFILE_NAME "3P+N"
+#endif
+
+/**
+ * @brief Mejor tiempo por bloque en microsegundos de varias repeticiones de un motor.
+ */
+static double bench_block_us(void (*process)(void))
+{
+    double best = 1e30;
+
+    for (int repeat = 0; repeat < 50; repeat++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int block = 0; block < 20; block++)
+            process();
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 20;
+        if (us < best)
+            best = us;
+    }
+    return (best);
+}
+
+#ifdef MEASURE_FIXED_POINT
+static void fixed_point(void)
+{
+    measure_process_fixed_point(adc_extended, numbersOfSamples);
+}
+#else
+static void sample_major(void)
+{
+    measure_process_sample_major(adc_extended, numbersOfSamples);
+}
+
+static void block_major(void)
+{
+    measure_process_block_major(adc_extended, numbersOfSamples);
+}
+#endif
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_spectrum_follows_channel_types(void)
+{
+    uint16_t spectrum[numbersOfFFTSamples];
+    int spectrum_channels = 0;
+
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+        host_signal.amplitude[c] = 1000.0;
+    host_begin();
+    // El umbral de tensión usa el RMS de la ventana anterior: el tercer segundo ya publica espectro.
+    measure_set_analysis_period(MEASURE_ANALYSIS_MIN_PERIOD);
+    host_run(3);
+
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+    {
+        bool expected = (channelconfig[i].type == AC_CURRENT || channelconfig[i].type == AC_VOLTAGE);
+        char message[48];
+
+        snprintf(message, sizeof(message), "canal %d (%s)", i, channelconfig[i].name);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(expected, measure_get_spectrum_channel(i), message);
+        TEST_ASSERT_NOT_EQUAL(0, measure_get_spectrum(i, spectrum));
+
+        int peak = 0;
+        for (int k = 1; k < numbersOfFFTSamples; k++)
+            if (spectrum[k] > spectrum[peak])
+                peak = k;
+        if (expected)
+        {
+            TEST_ASSERT_EQUAL_INT_MESSAGE(SPECTRUM_FUNDAMENTAL_BIN, peak, message);
+            spectrum_channels++;
+        }
+        else
+            TEST_ASSERT_EQUAL_INT_MESSAGE(0, spectrum[peak], message);
+    }
+    TEST_ASSERT_GREATER_THAN(0, spectrum_channels);
+
+    // Un canal que pasa a tensión tiene espectro desde el próximo análisis.
+    for (int i = 0; i < VIRTUAL_CHANNELS; i++)
+        if (!measure_get_spectrum_channel(i))
+        {
+            measure_set_channel_type(i, AC_VOLTAGE);
+            TEST_ASSERT_TRUE(measure_get_spectrum_channel(i));
+            measure_set_channel_type(i, AC_POWER);
+            break;
+        }
+}
+
+void test_profile_cost(void)
+{
+    static uint16_t adc[VIRTUAL_ADC_CHANNELS][numbersOfSamples];
+    char report[192];
+
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+    {
+        host_signal.amplitude[c] = 1200.0 - 100.0 * c;
+        host_signal.phase[c] = 0.4 * c;
+    }
+    host_begin();
+    host_run(2);
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+        for (int n = 0; n < numbersOfSamples; n++)
+            adc[c][n] = (2048 + 1500 * sin(2 * M_PI * n * 2 / numbersOfSamples + c)) * (1 << ADCCAL_FRACTION_BITS);
+    measure_extend_adc(adc, false);
+
+    size_t ram = sizeof(buffer) + sizeof(buffer_fft) + sizeof(adc_extended) + sizeof(block_ring) + sizeof(snapshot) + sizeof(channelconfig);
+#ifdef MEASURE_FIXED_POINT
+    double fixed_us = bench_block_us(fixed_point);
+    snprintf(report, sizeof(report), "%s: %d canales, %d del ADC; punto fijo %.1f us por bloque; buffers %.1f KB",
+             PROFILE_NAME, VIRTUAL_CHANNELS, VIRTUAL_ADC_CHANNELS, fixed_us, ram / 1024.0);
+#else
+    double sample_us = bench_block_us(sample_major);
+    double block_us = bench_block_us(block_major);
+    snprintf(report, sizeof(report), "%s: %d canales, %d del ADC; por muestras %.1f us, por bloques %.1f us por bloque; buffers %.1f KB",
+             PROFILE_NAME, VIRTUAL_CHANNELS, VIRTUAL_ADC_CHANNELS, sample_us, block_us, ram / 1024.0);
+#endif
+    TEST_MESSAGE(report);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_spectrum_follows_channel_types);
+    RUN_TEST(test_profile_cost);
+    return (UNITY_END());
+}
@@ -0,0 +1,114 @@
+/**
+ * @file test_main.cpp
+ * @brief Análisis de los programas: ciclos y operandos fuera de rango se rechazan antes de aplicarse
+ *
+ * measure_set_channel_opcodeseq_str() decodifica el programa nuevo y arma el orden de evaluación con
+ * los planes de los demás canales antes de tocar nada. Un programa de L1 Corriente que lee L1 Potencia,
+ * que a su vez lee L1 Corriente, es una dependencia circular; un ADD del canal 15 o un GET_ADC del
+ * canal 15 del ADC están fuera de rango. En todos los casos el setter devuelve false con el mensaje
+ * del error, y el texto del programa, los planes, el orden de evaluación y lo que se mide siguen
+ * siendo los de antes. Un programa válido después de los rechazos se aplica normalmente.
+ */
+#include <unity.h>
+#include <string.h>
+#include "measure_host.h"
+
+#define ANALYZER_CHANNEL 0              // L1 Corriente, la leen la potencia y la potencia reactiva de L1
+#define ANALYZER_READER 2               // L1 Potencia, lee L1 Corriente y L1 Tensión
+#define ANALYZER_RMS_BOUND 0.001        // Error relativo del valor eficaz antes y después de un rechazo
+
+static measure_program_t saved_stage;   // program_stage antes del programa rechazado
+static char saved_program[2 * MEASURE_PROGRAM_MAX + 1];
+
+void setUp(void)
+{
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+        host_signal.amplitude[c] = 1000.0;
+    host_begin();
+    host_run(3);
+    memcpy(&saved_stage, &program_stage, sizeof(saved_stage));
+    measure_get_channel_opcodeseq_str(ANALYZER_CHANNEL, sizeof(saved_program), saved_program);
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Prueba un programa inválido: false, el mensaje esperado y todo lo anterior en su lugar.
+ */
+static void analyzer_reject(const char *program, const char *expected)
+{
+    char error[96] = "";
+    char current[2 * MEASURE_PROGRAM_MAX + 1];
+    double rms = measure_get_channel_rms(ANALYZER_CHANNEL);
+    double power = measure_get_channel_rms(ANALYZER_READER);
+
+    TEST_ASSERT_FALSE(measure_set_channel_opcodeseq_str(ANALYZER_CHANNEL, program, error, sizeof(error)));
+    TEST_MESSAGE(error);
+    TEST_ASSERT_NOT_NULL_MESSAGE(strstr(error, expected), error);
+
+    // Nada de lo compilado cambió, ni antes ni después de que la tarea de medición tome los programas.
+    TEST_ASSERT_EQUAL_STRING(saved_program, measure_get_channel_opcodeseq_str(ANALYZER_CHANNEL, sizeof(current), current));
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(&saved_stage, &program_stage, sizeof(saved_stage), error);
+    host_run(1);
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(saved_stage.plan, channel_plan, sizeof(channel_plan), error);
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(&saved_stage.schedule, &channel_schedule, sizeof(channel_schedule), error);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(ANALYZER_RMS_BOUND * rms, rms, measure_get_channel_rms(ANALYZER_CHANNEL), error);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(ANALYZER_RMS_BOUND * fabs(power), power, measure_get_channel_rms(ANALYZER_READER), error);
+}
+
+void test_cycle_rejected(void)
+{
+    char expected[64];
+
+    // GET_ADC 0, ADD L1 Potencia: L1 Potencia ya lee L1 Corriente.
+    snprintf(expected, sizeof(expected), "dependencia circular entre los canales %d %d", ANALYZER_CHANNEL, ANALYZER_READER);
+    analyzer_reject("5012", expected);
+}
+
+void test_extended_cycle_rejected(void)
+{
+    char expected[64];
+
+    // GET_ADC 0, DIV L1 Potencia: DIV también lee el valor de otro canal.
+    snprintf(expected, sizeof(expected), "dependencia circular entre los canales %d %d", ANALYZER_CHANNEL, ANALYZER_READER);
+    analyzer_reject("504302", expected);
+}
+
+void test_out_of_range_rejected(void)
+{
+    // GET_ADC 0, ADD 15: no hay canal virtual 15 en ningún perfil.
+    analyzer_reject("501f", "canal 0, byte 1 (1f): operando fuera de rango");
+    // GET_ADC del canal 15 del ADC.
+    analyzer_reject("5f70", "canal 0, byte 0 (5f): canal del ADC fuera de rango");
+    // DIV de un registro que no existe.
+    analyzer_reject("504314", "canal 0, byte 1 (43): operando fuera de rango");
+}
+
+void test_valid_program_after_rejects(void)
+{
+    char error[96] = "";
+    char current[2 * MEASURE_PROGRAM_MAX + 1];
+
+    analyzer_reject("5012", "dependencia circular");
+    analyzer_reject("501f", "operando fuera de rango");
+
+    // GET_ADC 0, FILTER 0, NEG: se aplica y el valor eficaz no cambia con el signo.
+    double rms = measure_get_channel_rms(ANALYZER_CHANNEL);
+    TEST_ASSERT_TRUE_MESSAGE(measure_set_channel_opcodeseq_str(ANALYZER_CHANNEL, "5070d0", error, sizeof(error)), error);
+    TEST_ASSERT_EQUAL_STRING("5070d000000000000000", measure_get_channel_opcodeseq_str(ANALYZER_CHANNEL, sizeof(current), current));
+    host_run(2);
+    TEST_ASSERT_EQUAL_UINT8(NEG, channel_plan[ANALYZER_CHANNEL].op[2].opcode);
+    TEST_ASSERT_FLOAT_WITHIN(ANALYZER_RMS_BOUND * rms, rms, measure_get_channel_rms(ANALYZER_CHANNEL));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_cycle_rejected);
+    RUN_TEST(test_extended_cycle_rejected);
+    RUN_TEST(test_out_of_range_rejected);
+    RUN_TEST(test_valid_program_after_rejects);
+    return (UNITY_END());
+}
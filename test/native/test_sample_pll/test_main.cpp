@@ -0,0 +1,119 @@
+/**
+ * @file test_main.cpp
+ * @brief Lazo de la tasa de muestreo: enganche desde fuera de la nominal y seguimiento de una red que deriva
+ *
+ * El ADC simulado corre con un error de reloj de PLL_CLOCK_ERROR_PPM, como el cristal del ESP32. El
+ * lazo corrige una vez por ventana de un segundo, así que la prueba mira el estado, el error y la
+ * corrección después de cada host_run(1). Enganchado, el bloque dura dos ciclos: la tasa pedida
+ * dividida por los canales y la frecuencia medida dan numbersOfSamples / 2 muestras por ciclo.
+ * Durante una deriva constante el adelanto de la deriva tiene que mantener el lazo enganchado la
+ * mayor parte del tiempo, no sólo dentro del error admitido.
+ */
+#include <unity.h>
+#include "measure_host.h"
+
+#define PLL_CLOCK_ERROR_PPM 80.0 // Error del reloj del ADC simulado
+#define PLL_MAX_LOCK_SECONDS 15 // Ventanas admitidas para enganchar desde 49.6 Hz
+#define PLL_DRIFT 0.005 // Hz/s de la red en la prueba de seguimiento
+#define PLL_DRIFT_SECONDS 40 // Duración de la deriva, 0.2 Hz en total
+#define PLL_MAX_TRACKING_ERROR 0.02 // Error admitido del lazo durante la deriva, en Hz de red
+#define PLL_MIN_LOCKED_FRACTION 0.6 // Ventanas enganchadas durante la deriva, con las primeras de reenganche
+
+/**
+ * @brief Muestras por ciclo de la frecuencia medida con la tasa que pidió el lazo.
+ */
+static double samples_per_cycle(void)
+{
+    return (measure_sample_rate() / VIRTUAL_ADC_CHANNELS / measure_get_max_freq());
+}
+
+/**
+ * @brief Corre de a un segundo hasta que el lazo engancha.
+ *
+ * @return int segundos que tardó, o max_seconds + 1 si no enganchó.
+ */
+static int run_until_locked(int max_seconds)
+{
+    for (int second = 1; second <= max_seconds; second++)
+    {
+        host_run(1);
+        if (measure_get_pll_state() == MEASURE_PLL_LOCKED)
+            return (second);
+    }
+    return (max_seconds + 1);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_pll_lock_in(void)
+{
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+        host_signal.amplitude[c] = 1500.0;
+    host_signal.noise = 3.0;
+    host_signal.frequency = 49.6;
+    host_signal.clock_error = PLL_CLOCK_ERROR_PPM;
+    host_begin();
+    measure_set_sample_pll(true);
+
+    int seconds = run_until_locked(PLL_MAX_LOCK_SECONDS);
+
+    char report[160];
+    snprintf(report, sizeof(report), "49.6 Hz con %.0f ppm: enganchado en %d s, corrección %d Hz, error %.2f mHz, %.3f muestras por ciclo",
+             PLL_CLOCK_ERROR_PPM, seconds, measure_get_pll_offset(), measure_get_pll_error() * 1000.0, samples_per_cycle());
+    TEST_MESSAGE(report);
+    TEST_ASSERT_LESS_OR_EQUAL(PLL_MAX_LOCK_SECONDS, seconds);
+    TEST_ASSERT_FLOAT_WITHIN(MEASURE_PLL_DEADBAND * 2.0 / samplingFrequency, 0.0, measure_get_pll_error());
+    TEST_ASSERT_FLOAT_WITHIN(0.05, numbersOfSamples / 2, samples_per_cycle());
+}
+
+void test_pll_tracks_drift(void)
+{
+    double max_error = 0.0;
+    int locked = 0;
+
+    host_signal.frequency = 50.0;
+    host_begin();
+    // Una ventana sin lazo borra la corrección y la integral de la prueba anterior.
+    measure_set_sample_pll(false);
+    host_run(1);
+    measure_set_sample_pll(true);
+    TEST_ASSERT_LESS_OR_EQUAL(PLL_MAX_LOCK_SECONDS, run_until_locked(PLL_MAX_LOCK_SECONDS));
+
+    // La red deriva desde donde está ahora.
+    host_signal.drift = PLL_DRIFT;
+    host_signal.frequency = 50.0 - PLL_DRIFT * host_elapsed;
+    for (int second = 0; second < PLL_DRIFT_SECONDS; second++)
+    {
+        host_run(1);
+        max_error = fmax(max_error, fabs(measure_get_pll_error()));
+        locked += (measure_get_pll_state() == MEASURE_PLL_LOCKED);
+    }
+
+    // Cuando la red se detiene el lazo vuelve a enganchar.
+    host_signal.frequency += host_signal.drift * host_elapsed;
+    host_signal.drift = 0.0;
+    int relock = run_until_locked(PLL_MAX_LOCK_SECONDS);
+
+    char report[160];
+    snprintf(report, sizeof(report), "deriva de %.0f mHz/s: error máximo %.2f mHz, %d de %d ventanas enganchado, vuelve a enganchar en %d s",
+             PLL_DRIFT * 1000.0, max_error * 1000.0, locked, PLL_DRIFT_SECONDS, relock);
+    TEST_MESSAGE(report);
+    TEST_ASSERT_LESS_THAN_FLOAT(PLL_MAX_TRACKING_ERROR, max_error);
+    TEST_ASSERT_GREATER_OR_EQUAL(PLL_MIN_LOCKED_FRACTION * PLL_DRIFT_SECONDS, locked);
+    TEST_ASSERT_LESS_OR_EQUAL(PLL_MAX_LOCK_SECONDS, relock);
+    TEST_ASSERT_FLOAT_WITHIN(0.05, numbersOfSamples / 2, samples_per_cycle());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_pll_lock_in);
+    RUN_TEST(test_pll_tracks_drift);
+    return (UNITY_END());
+}
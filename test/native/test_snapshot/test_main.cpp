@@ -0,0 +1,94 @@
+/**
+ * @file test_main.cpp
+ * @brief Lectores concurrentes del bloque publicado por la medición, sin esperas ni bloques rotos
+ *
+ * Cuatro hilos toman el último bloque con measure_acquire_buffer() mientras la medición publica uno
+ * nuevo por bloque del ADC. Cada lector copia el bloque, espera y lo vuelve a comparar: si la medición
+ * escribiera sobre un bloque tomado la copia no coincidiría. Las secuencias que ve cada lector no
+ * pueden retroceder y tomar un bloque nunca espera a la medición.
+ */
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "measure_host.h"
+
+#define SNAPSHOT_READERS 4
+#define SNAPSHOT_MAX_LATENCY_US 100000 // Cota de measure_acquire_buffer(), holgada para un host cargado y lejos del segundo del TX_buffer
+
+static std::atomic<bool> readers_stop(false);
+static std::atomic<long> reads(0);
+static std::atomic<long> torn(0);
+static std::atomic<long> backwards(0);
+static std::atomic<long> latency_max_us(0);
+
+static void reader(void)
+{
+    static thread_local uint16_t copy[VIRTUAL_CHANNELS][numbersOfSamples];
+    uint32_t last = 0;
+
+    while (!readers_stop)
+    {
+        uint32_t sequence;
+        auto start = std::chrono::steady_clock::now();
+        const uint16_t *block = measure_acquire_buffer(&sequence);
+        long us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        if (us > latency_max_us)
+            latency_max_us = us;
+        if (!block)
+            continue;
+
+        memcpy(copy, block, sizeof(copy));
+        // Mientras tanto la medición publica otros bloques.
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        if (memcmp(copy, block, sizeof(copy)))
+            torn++;
+        if (sequence < last)
+            backwards++;
+        last = sequence;
+        measure_release_buffer(block);
+        reads++;
+    }
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_snapshot_readers(void)
+{
+    std::vector<std::thread> threads;
+
+    for (int c = 0; c < VIRTUAL_ADC_CHANNELS; c++)
+        host_signal.amplitude[c] = 1000.0;
+    host_signal.noise = 20.0;
+    host_begin();
+
+    for (int r = 0; r < SNAPSHOT_READERS; r++)
+        threads.emplace_back(reader);
+    host_run(20);
+    readers_stop = true;
+    for (auto &thread : threads)
+        thread.join();
+
+    char report[128];
+    snprintf(report, sizeof(report), "%ld lecturas, %u bloques sin publicar, latencia máxima %ld us", reads.load(), measure_get_buffer_dropped(), latency_max_us.load());
+    TEST_MESSAGE(report);
+    TEST_ASSERT_GREATER_THAN(0, reads.load());
+    TEST_ASSERT_EQUAL_INT(0, torn.load());
+    TEST_ASSERT_EQUAL_INT(0, backwards.load());
+    TEST_ASSERT_LESS_THAN(SNAPSHOT_MAX_LATENCY_US, latency_max_us.load());
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_snapshot_readers);
+    return (UNITY_END());
+}
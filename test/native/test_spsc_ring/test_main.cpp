@@ -0,0 +1,169 @@
+/**
+ * @file test_main.cpp
+ * @brief spsc_ring_t con un productor y un consumidor en hilos del host
+ *
+ * El productor llena cada lugar con su número de orden repetido en todo el elemento, como la
+ * adquisición llena un bloque entero, y el consumidor comprueba que le llegan todos en orden y sin
+ * mezclar dos escrituras. Uno u otro hilo se demora cada tanto para que la cola pase por vacía y
+ * por llena muchas veces; un tercer hilo lee count() mientras tanto y nunca puede ver más de SIZE.
+ * Los hilos ceden el procesador al esperar, así la prueba también avanza en un host de un núcleo.
+ */
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "utils/spsc_ring.h"
+
+#define RING_SIZE 4        // Lugares, como MEASURE_RING_BLOCKS
+#define RING_WORDS 256     // Palabras por elemento
+#define RING_ITEMS 200000  // Elementos por prueba
+
+typedef struct
+{
+    uint32_t sequence;
+    uint32_t word[RING_WORDS];
+} ring_item_t;
+
+typedef spsc_ring_t<ring_item_t, RING_SIZE> ring_t;
+
+/**
+ * @brief Demora de un hilo lento, una pausa cada 64 elementos.
+ */
+static void ring_delay(bool slow, uint32_t n)
+{
+    if (slow && !(n % 64))
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+}
+
+/**
+ * @brief Pasa RING_ITEMS elementos de un hilo a otro.
+ *
+ * @param producer_slow el productor se demora después de escribir
+ * @param consumer_slow el consumidor se demora después de leer
+ * @return long elementos rotos, fuera de orden o perdidos
+ */
+static long ring_transfer(bool producer_slow, bool consumer_slow)
+{
+    static ring_t ring;
+    std::atomic<bool> done(false);
+    std::atomic<long> full(0);
+    std::atomic<uint32_t> count_max(0);
+    long errors = 0;
+
+    std::thread producer([&]() {
+        for (uint32_t n = 0; n < RING_ITEMS; n++)
+        {
+            ring_item_t *item;
+            while (!(item = ring.acquire_write()))
+            {
+                full++;
+                std::this_thread::yield();
+            }
+            item->sequence = n;
+            for (int w = 0; w < RING_WORDS; w++)
+                item->word[w] = n * 2654435761u + w;
+            ring.commit_write();
+            ring_delay(producer_slow, n);
+        }
+    });
+
+    std::thread observer([&]() {
+        while (!done)
+        {
+            uint32_t n = ring.count();
+            if (n > count_max)
+                count_max = n;
+            std::this_thread::yield();
+        }
+    });
+
+    for (uint32_t n = 0; n < RING_ITEMS; n++)
+    {
+        const ring_item_t *item;
+        while (!(item = ring.acquire_read()))
+            std::this_thread::yield();
+        if (item->sequence != n)
+            errors++;
+        for (int w = 0; w < RING_WORDS; w++)
+            if (item->word[w] != item->sequence * 2654435761u + w)
+            {
+                errors++;
+                break;
+            }
+        ring.release_read();
+        ring_delay(consumer_slow, n);
+    }
+    producer.join();
+    done = true;
+    observer.join();
+
+    TEST_ASSERT_NULL(ring.acquire_read());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.count());
+    TEST_ASSERT_LESS_OR_EQUAL(RING_SIZE, count_max.load());
+
+    char report[96];
+    snprintf(report, sizeof(report), "%d elementos, %ld intentos con la cola llena, count() máximo %u", RING_ITEMS, full.load(), count_max.load());
+    TEST_MESSAGE(report);
+    return (errors);
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_full_and_empty(void)
+{
+    static ring_t ring;
+
+    TEST_ASSERT_NULL(ring.acquire_read());
+    for (int i = 0; i < RING_SIZE; i++)
+    {
+        ring_item_t *item = ring.acquire_write();
+        TEST_ASSERT_NOT_NULL(item);
+        item->sequence = i;
+        ring.commit_write();
+    }
+    TEST_ASSERT_NULL(ring.acquire_write());
+    TEST_ASSERT_EQUAL_UINT32(RING_SIZE, ring.count());
+
+    for (int i = 0; i < RING_SIZE; i++)
+    {
+        ring_item_t *item = ring.acquire_read();
+        TEST_ASSERT_NOT_NULL(item);
+        TEST_ASSERT_EQUAL_UINT32(i, item->sequence);
+        // Mientras no se libera, sigue siendo el mismo.
+        TEST_ASSERT_EQUAL_PTR(item, ring.acquire_read());
+        ring.release_read();
+    }
+    TEST_ASSERT_NULL(ring.acquire_read());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.count());
+}
+
+void test_slow_producer(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, ring_transfer(true, false));
+}
+
+void test_slow_consumer(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, ring_transfer(false, true));
+}
+
+void test_same_pace(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, ring_transfer(false, false));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_full_and_empty);
+    RUN_TEST(test_slow_producer);
+    RUN_TEST(test_slow_consumer);
+    RUN_TEST(test_same_pace);
+    return (UNITY_END());
+}
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""
+Genera src/dsp/fft_tables.h: factores de giro, inversión de bits y ventanas para la FFT real de
+src/dsp/fft.cpp. Las tablas son para FFT_MAX_LEN puntos; las FFT más cortas las recorren con paso
+FFT_MAX_LEN / len. Quedan como const, en flash.
+
+uso: python3 tools/gen_fft_tables.py [FFT_MAX_LEN]
+"""
+import math
+import os
+import sys
+
+MAX_LEN = int(sys.argv[1]) if len(sys.argv) > 1 else 2048
+HALF = MAX_LEN // 2
+BITS = HALF.bit_length() - 1
+OUT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src", "dsp", "fft_tables.h")
+
+if MAX_LEN < 4 or MAX_LEN & (MAX_LEN - 1):
+    sys.exit("FFT_MAX_LEN tiene que ser potencia de 2")
+
+def bitrev(i):
+    r = 0
+    for b in range(BITS):
+        r |= ((i >> b) & 1) << (BITS - 1 - b)
+    return r
+
+def cosine_window(coef):
+    # ventana de suma de cosenos periódica, normalizada a ganancia coherente 1
+    return [sum((-1) ** j * a * math.cos(2 * math.pi * j * n / MAX_LEN) for j, a in enumerate(coef)) / coef[0]
+            for n in range(HALF + 1)]
+
+def rows(values, fmt, per_line=8):
+    items = [fmt(v) for v in values]
+    return ",\n".join("    " + ", ".join(items[i:i + per_line]) for i in range(0, len(items), per_line))
+
+def f32(v):
+    s = "%.9g" % v
+    if "e" not in s and "." not in s:
+        s += ".0"
+    return s + "f"
+
+twiddle = []
+for k in range(HALF):
+    twiddle += [math.cos(2 * math.pi * k / MAX_LEN), -math.sin(2 * math.pi * k / MAX_LEN)]
+
+windows = [
+    ("FFT_WINDOW_HANN", [0.5, 0.5]),
+    ("FFT_WINDOW_HAMMING", [0.54, 0.46]),
+    ("FFT_WINDOW_FLATTOP", [0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368]),
+]
+
+with open(OUT, "w") as f:
+    f.write("/**\n")
+    f.write(" * @file fft_tables.h\n")
+    f.write(" * @brief Tablas de la FFT real, generadas por tools/gen_fft_tables.py: no editar\n")
+    f.write(" */\n")
+    f.write("#ifndef _FFT_TABLES_H\n")
+    f.write("    #define _FFT_TABLES_H\n\n")
+    f.write("    #define FFT_TABLES_LEN  %d\n\n" % MAX_LEN)
+    f.write("/**\n * @brief e^( -2 pi i k / FFT_TABLES_LEN ), k < FFT_TABLES_LEN / 2, parte real e imaginaria intercaladas\n */\n")
+    f.write("static const float fft_twiddle[ %d ] = {\n%s\n};\n\n" % (MAX_LEN, rows(twiddle, f32)))
+    f.write("/**\n * @brief índice con los %d bits invertidos, para FFT complejas más cortas se desplaza a la derecha\n */\n" % BITS)
+    f.write("static const uint16_t fft_bitrev[ %d ] = {\n%s\n};\n\n" % (HALF, rows([bitrev(i) for i in range(HALF)], str, 16)))
+    f.write("/**\n * @brief ventanas hasta la mitad, w[ N - n ] = w[ n ], normalizadas a ganancia coherente 1\n */\n")
+    f.write("static const float fft_window_table[ %d ][ %d ] = {\n" % (len(windows), HALF + 1))
+    f.write(",\n".join("    /* %s */\n    {\n%s\n    }" % (name, rows(cosine_window(coef), f32).replace("\n    ", "\n        ").replace("    ", "        ", 1)) for name, coef in windows))
+    f.write("\n};\n\n")
+    f.write("#endif // _FFT_TABLES_H\n")